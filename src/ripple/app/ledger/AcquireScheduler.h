@@ -0,0 +1,98 @@
+
+
+#ifndef RIPPLE_APP_LEDGER_ACQUIRESCHEDULER_H_INCLUDED
+#define RIPPLE_APP_LEDGER_ACQUIRESCHEDULER_H_INCLUDED
+
+#include <ripple/basics/base_uint.h>
+#include <ripple/json/json_value.h>
+#include <ripple/shamap/SHAMapNodeID.h>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace ripple {
+
+class AcquireScheduler
+{
+public:
+    using clock_type = std::chrono::steady_clock;
+    using time_point = clock_type::time_point;
+    using peer_id = std::uint32_t;
+    using Node = std::pair<SHAMapNodeID, uint256>;
+    using Batch = std::pair<peer_id, std::vector<Node>>;
+
+    struct PeerStats
+    {
+        std::uint64_t bytes = 0;
+        std::uint64_t nodes = 0;
+        double rate = 0;
+        std::chrono::milliseconds latency {0};
+        std::size_t outstanding = 0;
+        std::uint32_t stragglers = 0;
+    };
+
+    explicit AcquireScheduler (
+        std::size_t maxPerPeer = 128,
+        std::chrono::milliseconds minTimeout = std::chrono::seconds (1));
+
+    void
+    setPeers (std::vector<peer_id> const& peers);
+
+    std::vector<Batch>
+    assign (std::vector<Node> const& missing, time_point now);
+
+    std::size_t
+    onReply (peer_id peer, std::vector<SHAMapNodeID> const& ids,
+        std::size_t bytes, time_point now);
+
+    std::size_t
+    expire (time_point now);
+
+    PeerStats const*
+    getStats (peer_id peer) const;
+
+    std::size_t
+    outstanding () const
+    {
+        return requests_.size ();
+    }
+
+    std::size_t
+    peerCount () const
+    {
+        return peers_.size ();
+    }
+
+    Json::Value
+    getJson () const;
+
+private:
+    struct Request
+    {
+        peer_id peer;
+        time_point sent;
+    };
+
+    std::chrono::milliseconds
+    timeout (PeerStats const& ps) const;
+
+    double
+    weight (PeerStats const& ps, double fallback) const;
+
+    void
+    release (std::map<SHAMapNodeID, Request>::iterator it);
+
+    std::size_t const maxPerPeer_;
+    std::chrono::milliseconds const minTimeout_;
+
+    std::map<peer_id, PeerStats> peers_;
+    std::map<SHAMapNodeID, Request> requests_;
+    std::map<SHAMapNodeID, peer_id> stalled_;
+};
+
+}
+
+#endif
+
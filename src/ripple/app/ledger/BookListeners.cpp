@@ -22,7 +22,7 @@ BookListeners::removeSubscriber(std::uint64_t seq)
 
 void
 BookListeners::publish(
-    Json::Value const& jvObj,
+    InfoSub::Payload const& payload,
     hash_set<std::uint64_t>& havePublished)
 {
     std::lock_guard<std::recursive_mutex> sl(mLock);
@@ -36,7 +36,7 @@ BookListeners::publish(
         {
             if(havePublished.emplace(p->getSeq()).second)
             {
-                p->send(jvObj, true);
+                p->send(payload, true);
             }
             ++it;
         }
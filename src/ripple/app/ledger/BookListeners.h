@@ -29,7 +29,8 @@ public:
 
     
     void
-    publish(Json::Value const& jvObj, hash_set<std::uint64_t>& havePublished);
+    publish(InfoSub::Payload const& payload,
+        hash_set<std::uint64_t>& havePublished);
 
 private:
     std::recursive_mutex mLock;
@@ -4,6 +4,7 @@
 #define RIPPLE_APP_LEDGER_INBOUNDLEDGER_H_INCLUDED
 
 #include <ripple/app/main/Application.h>
+#include <ripple/app/ledger/AcquireScheduler.h>
 #include <ripple/app/ledger/Ledger.h>
 #include <ripple/overlay/PeerSet.h>
 #include <ripple/basics/CountedObject.h>
@@ -92,6 +93,11 @@ private:
 
     void trigger (std::shared_ptr<Peer> const&, TriggerReason);
 
+    bool requestStateNodes (
+        std::vector<std::pair<SHAMapNodeID, uint256>> const& nodes,
+        protocol::TMGetLedger const& tmGL,
+        TriggerReason reason);
+
     std::vector<neededHash_t> getNeededHashes ();
 
     void addPeers ();
@@ -141,6 +147,8 @@ private:
 
     std::set <uint256> mRecentNodes;
 
+    AcquireScheduler mScheduler;
+
     SHAMapAddNode mStats;
 
     std::mutex mReceivedDataLock;
@@ -97,10 +97,9 @@ public:
     sles_type::value_type
     dereference() const override
     {
-        auto const item = *iter_;
-        SerialIter sit(item.slice());
+        auto const& item = *iter_;
         return std::make_shared<SLE const>(
-            sit, item.key());
+            item.slice(), nullptr, item.key());
     }
 };
 
@@ -409,13 +408,18 @@ Ledger::read (Keylet const& k) const
     if (! item)
         return nullptr;
     auto sle = std::make_shared<SLE>(
-        SerialIter{item->data(),
-            item->size()}, item->key());
+        item->slice(), item, item->key());
     if (! k.check(*sle))
         return nullptr;
     return std::move(sle);
 }
 
+void
+Ledger::prefetch (uint256 const& key) const
+{
+    stateMap_->prefetch(key);
+}
+
 
 auto
 Ledger::slesBegin() const ->
@@ -601,7 +605,7 @@ Ledger::peek (Keylet const& k) const
     if (! value)
         return nullptr;
     auto sle = std::make_shared<SLE>(
-        SerialIter{value->data(), value->size()}, value->key());
+        value->slice(), value, value->key());
     if (! k.check(*sle))
         return nullptr;
     return sle;
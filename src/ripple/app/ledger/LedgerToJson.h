@@ -42,6 +42,7 @@ struct LedgerFill
 
 
 void addJson(Json::Value&, LedgerFill const&);
+void addJson(Json::Object&, LedgerFill const&);
 
 
 Json::Value getJson (LedgerFill const&);
@@ -1,19 +1,33 @@
 
 
 #include <ripple/app/ledger/OrderBookDB.h>
+#include <ripple/app/ledger/Ledger.h>
 #include <ripple/app/ledger/LedgerMaster.h>
 #include <ripple/app/main/Application.h>
 #include <ripple/basics/Log.h>
 #include <ripple/core/Config.h>
+#include <ripple/core/DatabaseCon.h>
 #include <ripple/core/JobQueue.h>
 #include <ripple/protocol/Indexes.h>
+#include <algorithm>
 
 namespace ripple {
 
+static constexpr std::uint32_t MAX_REPLAY {256};
+
+static constexpr std::uint32_t SNAPSHOT_INTERVAL {256};
+
+// Enough offers to answer any non-admin book_offers request
+static constexpr std::size_t MAX_SNAPSHOT_OFFERS {400};
+
+static constexpr std::size_t MAX_SNAPSHOT_BOOKS {256};
+
 OrderBookDB::OrderBookDB (Application& app, Stoppable& parent)
     : Stoppable ("OrderBookDB", parent)
     , app_ (app)
     , mSeq (0)
+    , mUpdating (false)
+    , mSnapshotChecked (false)
     , j_ (app.journal ("OrderBookDB"))
 {
 }
@@ -27,16 +41,94 @@ void OrderBookDB::invalidate ()
 void OrderBookDB::setup(
     std::shared_ptr<ReadView const> const& ledger)
 {
+    if (app_.config().PATH_SEARCH_MAX == 0)
+        return;
+
+    auto const seq = ledger->info().seq;
+    auto const isNext = [&]
+    {
+        return ! mUpdating && mSeq != 0 && seq == mSeq + 1 &&
+            ! ledger->open() && ledger->info().parentHash == mHash;
+    };
+
+    bool next;
     {
         std::lock_guard <std::recursive_mutex> sl (mLock);
-        auto seq = ledger->info().seq;
+        next = isNext ();
+    }
+
+    if (next)
+    {
+        BookDelta delta;
+        try
+        {
+            delta = getDelta (*ledger);
+        }
+        catch (std::exception const&)
+        {
+            JLOG (j_.info())
+                << "OrderBookDB::setup unable to read ledger " << seq;
+            next = false;
+        }
+
+        bool save = false;
+        if (next)
+        {
+            std::lock_guard <std::recursive_mutex> sl (mLock);
+            next = isNext ();
+            if (next)
+            {
+                for (auto const& change : delta)
+                {
+                    auto const result =
+                        adjust (mBooks, change.first, change.second);
+                    if (result > 0)
+                        rawAddBook (change.first);
+                    else if (result < 0)
+                        rawRemoveBook (change.first);
+                }
+
+                for (auto const& speculative : mSpeculative)
+                {
+                    if (mBooks.count (speculative.first) == 0)
+                        rawRemoveBook (speculative.second);
+                }
+                mSpeculative.clear ();
+
+                mSeq = seq;
+                mHash = ledger->info().hash;
+                save = (seq % SNAPSHOT_INTERVAL) == 0;
+            }
+        }
+
+        if (save)
+        {
+            if (app_.config().standalone())
+                saveSnapshot ();
+            else
+                app_.getJobQueue().addJob(
+                    jtUPDATE_PF, "OrderBookDB::saveSnapshot",
+                    [this] (Job&) { saveSnapshot (); });
+        }
+
+        if (next)
+            return;
+    }
+
+    {
+        std::lock_guard <std::recursive_mutex> sl (mLock);
+
+        if (mUpdating)
+        {
+            if (! mLatest || mLatest->info().seq < seq)
+                mLatest = ledger;
+            return;
+        }
 
         if (mSeq != 0)
         {
             if (seq == mSeq)
                 return;
-            if ((seq > mSeq) && ((seq - mSeq) < 256))
-                return;
             if ((seq < mSeq) && ((mSeq - seq) < 16))
                 return;
         }
@@ -44,13 +136,10 @@ void OrderBookDB::setup(
         JLOG (j_.debug())
             << "Advancing from " << mSeq << " to " << seq;
 
-        mSeq = seq;
+        mUpdating = true;
     }
 
-    if (app_.config().PATH_SEARCH_MAX == 0)
-    {
-    }
-    else if (app_.config().standalone())
+    if (app_.config().standalone())
         update(ledger);
     else
         app_.getJobQueue().addJob(
@@ -61,31 +150,110 @@ void OrderBookDB::setup(
 void OrderBookDB::update(
     std::shared_ptr<ReadView const> const& ledger)
 {
-    hash_set< uint256 > seen;
-    OrderBookDB::IssueToOrderBook destMap;
-    OrderBookDB::IssueToOrderBook sourceMap;
-    hash_set< Issue > XRPBooks;
+    BookIndex index;
+    std::uint32_t seq = 0;
+    uint256 hash;
 
     JLOG (j_.debug()) << "OrderBookDB::update>";
 
-    if (app_.config().PATH_SEARCH_MAX == 0)
+    auto const closed = [this](std::shared_ptr<ReadView const> const& view)
+    {
+        if (view->open ())
+        {
+            if (auto parent = app_.getLedgerMaster().getLedgerByHash (
+                    view->info().parentHash))
+                return std::shared_ptr<ReadView const> (std::move (parent));
+        }
+        return view;
+    };
+
+    // Rebuild from the state of `view`, or give up on the index
+    auto const rebuild = [&](std::shared_ptr<ReadView const> const& view)
+    {
+        index.clear ();
+        if (! scan (index, *view))
+        {
+            std::lock_guard <std::recursive_mutex> sl (mLock);
+            mSeq = 0;
+            mUpdating = false;
+            mLatest.reset ();
+            return false;
+        }
+        seq = view->info().seq;
+        hash = view->info().hash;
+        return true;
+    };
+
+    auto const target = closed (ledger);
+
+    bool loaded = false;
+    if (! mSnapshotChecked)
     {
+        mSnapshotChecked = true;
+        loaded = loadSnapshot (index, seq, hash) &&
+            replay (index, seq, hash, target);
+    }
+
+    if (! loaded)
+    {
+        // Roll the current index forward over a small gap
+        index.clear ();
+        seq = 0;
+        {
+            std::lock_guard <std::recursive_mutex> sl (mLock);
+            if (mSeq != 0)
+            {
+                index = mBooks;
+                seq = mSeq;
+                hash = mHash;
+            }
+        }
+        loaded = seq != 0 && replay (index, seq, hash, target);
+    }
+
+    if (! loaded && ! rebuild (target))
         return;
+
+    for (;;)
+    {
+        std::shared_ptr<ReadView const> latest;
+        {
+            std::lock_guard <std::recursive_mutex> sl (mLock);
+            if (! mLatest || mLatest->info().seq <= seq)
+            {
+                JLOG (j_.debug())
+                    << "OrderBookDB::update< " << index.size ()
+                    << " books at " << seq;
+
+                mLatest.reset ();
+                install (std::move (index), seq, hash);
+                mUpdating = false;
+                break;
+            }
+            latest = closed (mLatest);
+            mLatest.reset ();
+        }
+        if (latest->info().seq <= seq)
+            continue;
+        if (! replay (index, seq, hash, latest) && ! rebuild (latest))
+            return;
     }
 
-    int books = 0;
+    app_.getLedgerMaster().newOrderBookDB();
+    saveSnapshot ();
+}
 
+bool OrderBookDB::scan (BookIndex& index, ReadView const& ledger)
+{
     try
     {
-        for(auto& sle : ledger->sles)
+        for(auto& sle : ledger.sles)
         {
             if (isStopping())
             {
                 JLOG (j_.info())
                     << "OrderBookDB::update exiting due to isStopping";
-                std::lock_guard <std::recursive_mutex> sl (mLock);
-                mSeq = 0;
-                return;
+                return false;
             }
 
             if (sle->getType () == ltDIR_NODE &&
@@ -98,16 +266,7 @@ void OrderBookDB::update(
                 book.out.account = sle->getFieldH160(sfTakerGetsIssuer);
                 book.out.currency = sle->getFieldH160(sfTakerGetsCurrency);
 
-                uint256 index = getBookBase (book);
-                if (seen.insert (index).second)
-                {
-                    auto orderBook = std::make_shared<OrderBook> (index, book);
-                    sourceMap[book.in].push_back (orderBook);
-                    destMap[book.out].push_back (orderBook);
-                    if (isXRP(book.out))
-                        XRPBooks.insert(book.in);
-                    ++books;
-                }
+                adjust (index, book, 1);
             }
         }
     }
@@ -115,54 +274,326 @@ void OrderBookDB::update(
     {
         JLOG (j_.info())
             << "OrderBookDB::update encountered a missing node";
-        std::lock_guard <std::recursive_mutex> sl (mLock);
-        mSeq = 0;
-        return;
+        return false;
     }
+    return true;
+}
 
-    JLOG (j_.debug())
-        << "OrderBookDB::update< " << books << " books found";
+OrderBookDB::BookDelta OrderBookDB::getDelta (ReadView const& ledger)
+{
+    auto const field = [](STObject const& obj, SF_U160 const& f)
     {
-        std::lock_guard <std::recursive_mutex> sl (mLock);
+        return obj.isFieldPresent (f) ? obj.getFieldH160 (f) : uint160 ();
+    };
+
+    BookDelta delta;
+    for (auto const& item : ledger.txs)
+    {
+        if (! item.second)
+            continue;
+
+        for (auto const& node : item.second->getFieldArray (sfAffectedNodes))
+        {
+            if (node.getFieldU16 (sfLedgerEntryType) != ltDIR_NODE)
+                continue;
+
+            int dirs;
+            SField const* fields;
+            if (node.getFName () == sfCreatedNode)
+            {
+                dirs = 1;
+                fields = &sfNewFields;
+            }
+            else if (node.getFName () == sfDeletedNode)
+            {
+                dirs = -1;
+                fields = &sfFinalFields;
+            }
+            else
+            {
+                continue;
+            }
 
-        mXRPBooks.swap(XRPBooks);
-        mSourceMap.swap(sourceMap);
-        mDestMap.swap(destMap);
+            auto data = dynamic_cast<const STObject*> (
+                node.peekAtPField (*fields));
+
+            if (! data ||
+                ! data->isFieldPresent (sfExchangeRate) ||
+                ! data->isFieldPresent (sfRootIndex) ||
+                data->getFieldH256 (sfRootIndex) !=
+                    node.getFieldH256 (sfLedgerIndex))
+                continue;
+
+            Book book;
+            book.in.currency = field (*data, sfTakerPaysCurrency);
+            book.in.account = field (*data, sfTakerPaysIssuer);
+            book.out.account = field (*data, sfTakerGetsIssuer);
+            book.out.currency = field (*data, sfTakerGetsCurrency);
+            delta.emplace_back (book, dirs);
+        }
     }
-    app_.getLedgerMaster().newOrderBookDB();
+    return delta;
 }
 
-void OrderBookDB::addOrderBook(Book const& book)
+int OrderBookDB::adjust (BookIndex& index, Book const& book, int dirs)
 {
-    bool toXRP = isXRP (book.out);
-    std::lock_guard <std::recursive_mutex> sl (mLock);
+    auto const base = getBookBase (book);
+    auto it = index.find (base);
 
-    if (toXRP)
+    if (dirs > 0)
     {
-        for (auto ob: mSourceMap[book.in])
+        if (it != index.end ())
         {
-            if (isXRP (ob->getCurrencyOut ())) 
-                return;
+            it->second.count += dirs;
+            return 0;
         }
+        index.emplace (base, BookDirs {book, std::uint32_t (dirs)});
+        return 1;
     }
-    else
+
+    if (it == index.end ())
+        return 0;
+
+    if (it->second.count > std::uint32_t (-dirs))
+    {
+        it->second.count += dirs;
+        return 0;
+    }
+
+    index.erase (it);
+    return -1;
+}
+
+bool OrderBookDB::replay (BookIndex& index, std::uint32_t& seq, uint256& hash,
+    std::shared_ptr<ReadView const> const& ledger)
+{
+    auto const target = ledger->info().seq;
+
+    if (target <= seq)
+        return target == seq && ledger->info().hash == hash;
+
+    if (ledger->open () || (target - seq) > MAX_REPLAY)
+        return false;
+
+    BookIndex work (index);
+    uint256 parent = hash;
+
+    try
     {
-        for (auto ob: mDestMap[book.out])
+        for (auto s = seq + 1; s <= target; ++s)
         {
-            if (ob->getCurrencyIn() == book.in.currency &&
-                ob->getIssuerIn() == book.in.account)
+            if (isStopping ())
+                return false;
+
+            std::shared_ptr<ReadView const> view = (s == target)
+                ? ledger : app_.getLedgerMaster().getLedgerBySeq (s);
+
+            if (! view || view->info().parentHash != parent)
             {
-                return;
+                JLOG (j_.debug())
+                    << "OrderBookDB::replay missing ledger " << s;
+                return false;
             }
+
+            for (auto const& change : getDelta (*view))
+                adjust (work, change.first, change.second);
+            parent = view->info().hash;
+        }
+    }
+    catch (std::exception const&)
+    {
+        JLOG (j_.info())
+            << "OrderBookDB::replay unable to read ledgers";
+        return false;
+    }
+
+    JLOG (j_.debug())
+        << "OrderBookDB::replay " << seq << " to " << target;
+
+    index.swap (work);
+    seq = target;
+    hash = parent;
+    return true;
+}
+
+void OrderBookDB::install (
+    BookIndex&& index, std::uint32_t seq, uint256 const& hash)
+{
+    OrderBookDB::IssueToOrderBook destMap;
+    OrderBookDB::IssueToOrderBook sourceMap;
+    hash_set< Issue > XRPBooks;
+
+    for (auto const& item : index)
+    {
+        auto const& book = item.second.book;
+        auto orderBook = std::make_shared<OrderBook> (item.first, book);
+        sourceMap[book.in].push_back (orderBook);
+        destMap[book.out].push_back (orderBook);
+        if (isXRP(book.out))
+            XRPBooks.insert(book.in);
+    }
+
+    mBooks = std::move (index);
+    mSpeculative.clear ();
+    mXRPBooks.swap(XRPBooks);
+    mSourceMap.swap(sourceMap);
+    mDestMap.swap(destMap);
+    mSeq = seq;
+    mHash = hash;
+}
+
+bool OrderBookDB::loadSnapshot (
+    BookIndex& index, std::uint32_t& seq, uint256& hash)
+{
+    try
+    {
+        auto db = app_.getWalletDB ().checkoutDb ();
+
+        boost::optional<std::uint64_t> ledgerSeq;
+        boost::optional<std::string> ledgerHash;
+        soci::blob sociRawData (*db);
+        soci::indicator rdi;
+
+        *db << "SELECT LedgerSeq, LedgerHash, RawData "
+               "FROM OrderBookSnapshot;",
+            soci::into (ledgerSeq),
+            soci::into (ledgerHash),
+            soci::into (sociRawData, rdi);
+
+        if (! ledgerSeq || ! ledgerHash || rdi != soci::i_ok ||
+            ! hash.SetHexExact (*ledgerHash))
+            return false;
+
+        Blob rawData;
+        convert (sociRawData, rawData);
+
+        SerialIter sit (makeSlice (rawData));
+        while (! sit.empty ())
+        {
+            Book book;
+            book.in.currency = sit.getBitString<160, detail::CurrencyTag> ();
+            book.in.account = sit.getBitString<160, detail::AccountIDTag> ();
+            book.out.currency = sit.getBitString<160, detail::CurrencyTag> ();
+            book.out.account = sit.getBitString<160, detail::AccountIDTag> ();
+            auto const count = sit.get32 ();
+            if (count != 0)
+                index[getBookBase (book)] = BookDirs {book, count};
+        }
+        seq = static_cast<std::uint32_t> (*ledgerSeq);
+    }
+    catch (std::exception const& e)
+    {
+        JLOG (j_.warn())
+            << "OrderBookDB snapshot unusable: " << e.what ();
+        index.clear ();
+        return false;
+    }
+
+    JLOG (j_.info())
+        << "OrderBookDB snapshot of " << index.size ()
+        << " books at " << seq;
+    return true;
+}
+
+void OrderBookDB::saveSnapshot ()
+{
+    Serializer s;
+    std::uint32_t seq;
+    uint256 hash;
+    {
+        std::lock_guard <std::recursive_mutex> sl (mLock);
+        if (mSeq == 0 || mHash.isZero ())
+            return;
+
+        seq = mSeq;
+        hash = mHash;
+        for (auto const& item : mBooks)
+        {
+            auto const& book = item.second.book;
+            s.add160 (book.in.currency);
+            s.add160 (book.in.account);
+            s.add160 (book.out.currency);
+            s.add160 (book.out.account);
+            s.add32 (item.second.count);
         }
     }
-    uint256 index = getBookBase(book);
-    auto orderBook = std::make_shared<OrderBook> (index, book);
 
-    mSourceMap[book.in].push_back (orderBook);
+    try
+    {
+        auto db = app_.getWalletDB ().checkoutDb ();
+
+        std::uint64_t const ledgerSeq = seq;
+        std::string const ledgerHash = to_string (hash);
+        soci::blob rawData (*db);
+        convert (s.peekData (), rawData);
+
+        soci::transaction tr (*db);
+        *db << "DELETE FROM OrderBookSnapshot;";
+        *db << "INSERT INTO OrderBookSnapshot "
+               "(LedgerSeq, LedgerHash, RawData) "
+               "VALUES (:seq, :hash, :rawData);",
+            soci::use (ledgerSeq),
+            soci::use (ledgerHash),
+            soci::use (rawData);
+        tr.commit ();
+    }
+    catch (std::exception const& e)
+    {
+        JLOG (j_.warn())
+            << "OrderBookDB snapshot not saved: " << e.what ();
+    }
+}
+
+void OrderBookDB::addOrderBook(Book const& book)
+{
+    std::lock_guard <std::recursive_mutex> sl (mLock);
+
+    auto const index = getBookBase (book);
+    if (mBooks.count (index) == 0)
+        mSpeculative.emplace (index, book);
+    rawAddBook (book);
+}
+
+void OrderBookDB::rawAddBook(Book const& book)
+{
+    auto const index = getBookBase (book);
+    auto& books = mSourceMap[book.in];
+    for (auto const& ob : books)
+    {
+        if (ob->getBookBase () == index)
+            return;
+    }
+
+    auto orderBook = std::make_shared<OrderBook> (index, book);
+    books.push_back (orderBook);
     mDestMap[book.out].push_back (orderBook);
-    if (toXRP)
-        mXRPBooks.insert(book.in);
+    if (isXRP (book.out))
+        mXRPBooks.insert (book.in);
+}
+
+void OrderBookDB::rawRemoveBook(Book const& book)
+{
+    auto const index = getBookBase (book);
+    auto const remove = [&index](IssueToOrderBook& map, Issue const& issue)
+    {
+        auto it = map.find (issue);
+        if (it == map.end ())
+            return;
+
+        auto& books = it->second;
+        books.erase (std::remove_if (books.begin (), books.end (),
+            [&index](OrderBook::ref ob)
+            {
+                return ob->getBookBase () == index;
+            }), books.end ());
+        if (books.empty ())
+            map.erase (it);
+    };
+
+    remove (mSourceMap, book.in);
+    remove (mDestMap, book.out);
+    if (isXRP (book.out))
+        mXRPBooks.erase (book.in);
 }
 
 OrderBook::List OrderBookDB::getBooksByTakerPays (Issue const& issue)
@@ -212,9 +643,94 @@ BookListeners::pointer OrderBookDB::getBookListeners (Book const& book)
     return ret;
 }
 
+std::shared_ptr<OrderBookDB::BookSnapshot const>
+OrderBookDB::getBookSnapshot (
+    std::shared_ptr<ReadView const> const& ledger, Book const& book)
+{
+    if (ledger->open ())
+        return nullptr;
+
+    auto const& info = ledger->info ();
+    auto const base = getBookBase (book);
+    {
+        std::lock_guard <std::mutex> sl (mSnapshotLock);
+        if (info.seq < mSnapshotSeq ||
+            (info.seq == mSnapshotSeq && info.hash != mSnapshotHash))
+            return nullptr;
+        if (info.seq == mSnapshotSeq)
+        {
+            auto const it = mBookSnapshots.find (base);
+            if (it != mBookSnapshots.end ())
+                return it->second;
+
+            // A snapshot that would not be kept costs more than walking
+            // the book for just the offers asked for
+            if (mBookSnapshots.size () >= MAX_SNAPSHOT_BOOKS)
+                return nullptr;
+        }
+    }
+
+    auto snapshot = makeBookSnapshot (*ledger, book);
+
+    std::lock_guard <std::mutex> sl (mSnapshotLock);
+    if (info.seq > mSnapshotSeq)
+    {
+        mSnapshotSeq = info.seq;
+        mSnapshotHash = info.hash;
+        mBookSnapshots.clear ();
+    }
+    if (info.hash == mSnapshotHash &&
+        mBookSnapshots.size () < MAX_SNAPSHOT_BOOKS)
+    {
+        mBookSnapshots.emplace (base, snapshot);
+    }
+    return snapshot;
+}
+
+std::shared_ptr<OrderBookDB::BookSnapshot const>
+OrderBookDB::makeBookSnapshot (ReadView const& ledger, Book const& book)
+{
+    auto snapshot = std::make_shared<BookSnapshot> ();
+    auto const end = getQualityNext (getBookBase (book));
+    auto tip = getBookBase (book);
+
+    while (snapshot->offers.size () < MAX_SNAPSHOT_OFFERS)
+    {
+        auto const next = ledger.succ (tip, end);
+        if (! next)
+        {
+            snapshot->complete = true;
+            break;
+        }
+        tip = *next;
+
+        std::shared_ptr<SLE const> page;
+        unsigned int entry;
+        uint256 offerIndex;
+        if (! cdirFirst (ledger, tip, page, entry, offerIndex, j_))
+            continue;
+
+        uint256 prefetched;
+        do
+        {
+            if (page->key () != prefetched)
+            {
+                prefetched = page->key ();
+                prefetchDirectory (ledger, *page);
+            }
+            if (auto offer = ledger.read (keylet::offer (offerIndex)))
+                snapshot->offers.emplace_back (tip, std::move (offer));
+        }
+        while (snapshot->offers.size () < MAX_SNAPSHOT_OFFERS &&
+            cdirNext (ledger, tip, page, entry, offerIndex, j_));
+    }
+
+    return snapshot;
+}
+
 void OrderBookDB::processTxn (
     std::shared_ptr<ReadView const> const& ledger,
-        const AcceptedLedgerTx& alTx, Json::Value const& jvObj)
+        const AcceptedLedgerTx& alTx, InfoSub::Payload const& payload)
 {
     std::lock_guard <std::recursive_mutex> sl (mLock);
     if (alTx.getResult () == tesSUCCESS)
@@ -251,7 +767,7 @@ void OrderBookDB::processTxn (
                             auto listeners = getBookListeners(b);
                             if (listeners)
                             {
-                                listeners->publish(jvObj, havePublished);
+                                listeners->publish(payload, havePublished);
                             }
                         }
                     }
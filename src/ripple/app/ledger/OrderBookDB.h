@@ -21,6 +21,9 @@ public:
     void update (std::shared_ptr<ReadView const> const& ledger);
     void invalidate ();
 
+    
+    void saveSnapshot ();
+
     void addOrderBook(Book const&);
 
     
@@ -34,17 +37,67 @@ public:
     BookListeners::pointer getBookListeners (Book const&);
     BookListeners::pointer makeBookListeners (Book const&);
 
+    /** The leading offers of a book in an immutable ledger. */
+    struct BookSnapshot
+    {
+        // Each offer with the key of its quality directory, in book order
+        std::vector<std::pair<uint256, std::shared_ptr<SLE const>>> offers;
+
+        // True if offers holds every offer in the book
+        bool complete = false;
+    };
+
+    /** Return a snapshot of a book, shared by requests for the same
+        ledger. Snapshots are only kept for the newest ledger asked for,
+        and for a limited number of books; otherwise this returns nullptr.
+    */
+    std::shared_ptr<BookSnapshot const>
+    getBookSnapshot (std::shared_ptr<ReadView const> const& ledger,
+        Book const& book);
+
     void processTxn (
         std::shared_ptr<ReadView const> const& ledger,
-        const AcceptedLedgerTx& alTx, Json::Value const& jvObj);
+        const AcceptedLedgerTx& alTx, InfoSub::Payload const& payload);
 
     using IssueToOrderBook = hash_map <Issue, OrderBook::List>;
 
 private:
+    struct BookDirs
+    {
+        Book book;
+        std::uint32_t count;
+    };
+
+    using BookIndex = hash_map <uint256, BookDirs>;
+
+    using BookDelta = std::vector <std::pair <Book, int>>;
+
+    static BookDelta getDelta (ReadView const& ledger);
+
+    static int adjust (BookIndex& index, Book const& book, int dirs);
+
+    bool loadSnapshot (
+        BookIndex& index, std::uint32_t& seq, uint256& hash);
+
+    bool replay (BookIndex& index, std::uint32_t& seq, uint256& hash,
+        std::shared_ptr<ReadView const> const& ledger);
+
+    bool scan (BookIndex& index, ReadView const& ledger);
+
+    void install (BookIndex&& index, std::uint32_t seq, uint256 const& hash);
+
     void rawAddBook(Book const&);
+    void rawRemoveBook(Book const&);
+
+    std::shared_ptr<BookSnapshot const>
+    makeBookSnapshot (ReadView const& ledger, Book const& book);
 
     Application& app_;
 
+    BookIndex mBooks;
+
+    hash_map <uint256, Book> mSpeculative;
+
     IssueToOrderBook mSourceMap;
 
     IssueToOrderBook mDestMap;
@@ -59,6 +112,22 @@ private:
 
     std::uint32_t mSeq;
 
+    uint256 mHash;
+
+    bool mUpdating;
+
+    bool mSnapshotChecked;
+
+    std::shared_ptr<ReadView const> mLatest;
+
+    std::mutex mSnapshotLock;
+
+    std::uint32_t mSnapshotSeq = 0;
+
+    uint256 mSnapshotHash;
+
+    hash_map <uint256, std::shared_ptr<BookSnapshot const>> mBookSnapshots;
+
     beast::Journal j_;
 };
 
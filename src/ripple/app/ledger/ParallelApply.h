@@ -0,0 +1,30 @@
+
+
+#ifndef RIPPLE_APP_LEDGER_PARALLELAPPLY_H_INCLUDED
+#define RIPPLE_APP_LEDGER_PARALLELAPPLY_H_INCLUDED
+
+#include <ripple/ledger/OpenView.h>
+#include <ripple/beast/utility/Journal.h>
+#include <boost/optional.hpp>
+#include <memory>
+#include <set>
+
+namespace ripple {
+
+class Application;
+class CanonicalTXSet;
+class Ledger;
+
+boost::optional<std::size_t>
+applyTransactionsParallel(
+    Application& app,
+    std::shared_ptr<Ledger const> const& built,
+    CanonicalTXSet& txns,
+    std::set<TxID>& failed,
+    OpenView& view,
+    std::size_t threads,
+    beast::Journal j);
+
+}
+
+#endif
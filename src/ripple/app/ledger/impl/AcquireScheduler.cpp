@@ -0,0 +1,341 @@
+
+
+#include <ripple/app/ledger/AcquireScheduler.h>
+#include <ripple/protocol/jss.h>
+#include <boost/optional.hpp>
+#include <algorithm>
+#include <cassert>
+#include <set>
+
+namespace ripple {
+
+using namespace std::chrono_literals;
+
+AcquireScheduler::AcquireScheduler (
+        std::size_t maxPerPeer, std::chrono::milliseconds minTimeout)
+    : maxPerPeer_ (maxPerPeer)
+    , minTimeout_ (minTimeout)
+{
+    assert (maxPerPeer_ != 0);
+}
+
+void
+AcquireScheduler::setPeers (std::vector<peer_id> const& peers)
+{
+    std::set<peer_id> const live (peers.begin (), peers.end ());
+
+    for (auto it = requests_.begin (); it != requests_.end ();)
+    {
+        if (live.count (it->second.peer) == 0)
+            release (it++);
+        else
+            ++it;
+    }
+
+    for (auto it = peers_.begin (); it != peers_.end ();)
+    {
+        if (live.count (it->first) == 0)
+            it = peers_.erase (it);
+        else
+            ++it;
+    }
+
+    for (auto const id : live)
+        peers_.emplace (id, PeerStats{});
+}
+
+std::chrono::milliseconds
+AcquireScheduler::timeout (PeerStats const& ps) const
+{
+    return std::max (minTimeout_, 4 * ps.latency);
+}
+
+double
+AcquireScheduler::weight (PeerStats const& ps, double fallback) const
+{
+    if (ps.nodes == 0)
+        return fallback;
+    return std::max (ps.rate, 1.0);
+}
+
+void
+AcquireScheduler::release (std::map<SHAMapNodeID, Request>::iterator it)
+{
+    auto const p = peers_.find (it->second.peer);
+    if (p != peers_.end () && p->second.outstanding != 0)
+        --p->second.outstanding;
+    requests_.erase (it);
+}
+
+std::vector<AcquireScheduler::Batch>
+AcquireScheduler::assign (std::vector<Node> const& missing, time_point now)
+{
+    std::vector<Batch> ret;
+
+    if (peers_.empty ())
+        return ret;
+
+    std::vector<Node> retry;
+    std::map<unsigned char, std::vector<Node>> subtrees;
+    for (auto const& node : missing)
+    {
+        if (requests_.count (node.first) != 0)
+            continue;
+
+        if (stalled_.count (node.first) != 0)
+            retry.push_back (node);
+        else
+            subtrees[*node.first.getNodeID ().begin ()].push_back (node);
+    }
+
+    double known = 0;
+    int sampled = 0;
+    for (auto const& p : peers_)
+    {
+        if (p.second.nodes != 0)
+        {
+            known += std::max (p.second.rate, 1.0);
+            ++sampled;
+        }
+    }
+    double const fallback = sampled ? (known / sampled) : 1.0;
+
+    struct Slot
+    {
+        peer_id id;
+        double weight;
+        std::size_t load;
+        std::size_t room;
+        std::vector<Node> nodes;
+    };
+
+    std::vector<Slot> slots;
+    for (auto const& p : peers_)
+    {
+        if (p.second.outstanding >= maxPerPeer_)
+            continue;
+        slots.push_back ({p.first, weight (p.second, fallback),
+            p.second.outstanding, maxPerPeer_ - p.second.outstanding, {}});
+    }
+
+    auto pick = [&slots](boost::optional<peer_id> avoid) -> Slot*
+    {
+        Slot* best = nullptr;
+        double bestCost = 0;
+        for (auto& s : slots)
+        {
+            if (s.room == 0 || (avoid && *avoid == s.id))
+                continue;
+            double const cost = (s.load + 1) / s.weight;
+            if (! best || cost < bestCost)
+            {
+                best = &s;
+                bestCost = cost;
+            }
+        }
+        return best;
+    };
+
+    auto take = [](Slot& s, Node const& node)
+    {
+        s.nodes.push_back (node);
+        ++s.load;
+        --s.room;
+    };
+
+    for (auto const& node : retry)
+    {
+        Slot* s = pick (stalled_[node.first]);
+        if (! s)
+            s = pick (boost::none);
+        if (! s)
+            break;
+        take (*s, node);
+    }
+
+    std::size_t pending = 0;
+    for (auto const& st : subtrees)
+        pending += st.second.size ();
+
+    std::vector<std::size_t> quota (slots.size (), 0);
+    {
+        std::vector<std::size_t> load (slots.size ());
+        std::vector<std::size_t> room (slots.size ());
+        for (std::size_t i = 0; i < slots.size (); ++i)
+        {
+            load[i] = slots[i].load;
+            room[i] = slots[i].room;
+        }
+
+        for (; pending != 0; --pending)
+        {
+            boost::optional<std::size_t> best;
+            double bestCost = 0;
+            for (std::size_t i = 0; i < slots.size (); ++i)
+            {
+                if (room[i] == 0)
+                    continue;
+                double const cost = (load[i] + 1) / slots[i].weight;
+                if (! best || cost < bestCost)
+                {
+                    best = i;
+                    bestCost = cost;
+                }
+            }
+            if (! best)
+                break;
+            ++quota[*best];
+            ++load[*best];
+            --room[*best];
+        }
+    }
+
+    std::size_t slot = 0;
+    for (auto const& st : subtrees)
+    {
+        for (auto const& node : st.second)
+        {
+            while (slot < slots.size () && quota[slot] == 0)
+                ++slot;
+            if (slot == slots.size ())
+                break;
+            take (slots[slot], node);
+            --quota[slot];
+        }
+    }
+
+    for (auto& s : slots)
+    {
+        if (s.nodes.empty ())
+            continue;
+
+        auto& ps = peers_[s.id];
+        for (auto const& node : s.nodes)
+        {
+            requests_[node.first] = Request{s.id, now};
+            stalled_.erase (node.first);
+            ++ps.outstanding;
+        }
+        ret.emplace_back (s.id, std::move (s.nodes));
+    }
+
+    return ret;
+}
+
+std::size_t
+AcquireScheduler::onReply (peer_id peer, std::vector<SHAMapNodeID> const& ids,
+    std::size_t bytes, time_point now)
+{
+    auto const p = peers_.find (peer);
+    if (p == peers_.end ())
+        return 0;
+
+    std::size_t matched = 0;
+    time_point first = now;
+    for (auto const& id : ids)
+    {
+        stalled_.erase (id);
+
+        auto const it = requests_.find (id);
+        if (it == requests_.end ())
+            continue;
+
+        if (it->second.peer == peer)
+        {
+            first = std::min (first, it->second.sent);
+            ++matched;
+        }
+        release (it);
+    }
+
+    auto& ps = p->second;
+    ps.bytes += bytes;
+    ps.nodes += ids.size ();
+
+    if (matched != 0)
+    {
+        auto const elapsed = std::max<std::chrono::milliseconds> (1ms,
+            std::chrono::duration_cast<std::chrono::milliseconds> (
+                now - first));
+        double const sample = bytes * 1000.0 / elapsed.count ();
+
+        if (ps.rate == 0)
+        {
+            ps.rate = sample;
+            ps.latency = elapsed;
+        }
+        else
+        {
+            ps.rate = (3 * ps.rate + sample) / 4;
+            ps.latency = (3 * ps.latency + elapsed) / 4;
+        }
+    }
+
+    return matched;
+}
+
+std::size_t
+AcquireScheduler::expire (time_point now)
+{
+    std::set<peer_id> slow;
+    std::size_t count = 0;
+
+    for (auto it = requests_.begin (); it != requests_.end ();)
+    {
+        auto const p = peers_.find (it->second.peer);
+        if (p != peers_.end () &&
+            (now - it->second.sent) <= timeout (p->second))
+        {
+            ++it;
+            continue;
+        }
+
+        if (p != peers_.end ())
+        {
+            ++p->second.stragglers;
+            slow.insert (p->first);
+        }
+        stalled_[it->first] = it->second.peer;
+        release (it++);
+        ++count;
+    }
+
+    for (auto const id : slow)
+        peers_[id].rate /= 2;
+
+    return count;
+}
+
+AcquireScheduler::PeerStats const*
+AcquireScheduler::getStats (peer_id peer) const
+{
+    auto const it = peers_.find (peer);
+    if (it == peers_.end ())
+        return nullptr;
+    return &it->second;
+}
+
+Json::Value
+AcquireScheduler::getJson () const
+{
+    Json::Value ret (Json::arrayValue);
+
+    for (auto const& p : peers_)
+    {
+        Json::Value& entry = ret.append (Json::objectValue);
+        entry[jss::peer] = p.first;
+        entry[jss::bytes] = std::to_string (p.second.bytes);
+        entry[jss::nodes] = std::to_string (p.second.nodes);
+        entry[jss::rate] = static_cast<Json::UInt> (p.second.rate);
+        entry[jss::latency] = static_cast<Json::UInt> (
+            p.second.latency.count ());
+        entry[jss::outstanding] = static_cast<Json::UInt> (
+            p.second.outstanding);
+        entry[jss::stragglers] = p.second.stragglers;
+    }
+
+    return ret;
+}
+
+}
+
@@ -4,6 +4,7 @@
 #include <ripple/app/ledger/Ledger.h>
 #include <ripple/app/ledger/LedgerReplay.h>
 #include <ripple/app/ledger/OpenLedger.h>
+#include <ripple/app/ledger/ParallelApply.h>
 #include <ripple/app/main/Application.h>
 #include <ripple/app/misc/CanonicalTXSet.h>
 #include <ripple/app/tx/apply.h>
@@ -65,6 +66,13 @@ applyTransactions(
     OpenView& view,
     beast::Journal j)
 {
+    if (auto const threads = app.config().PARALLEL_APPLY)
+    {
+        if (auto const applied = applyTransactionsParallel(
+                app, built, txns, failed, view, threads, j))
+            return *applied;
+    }
+
     bool certainRetry = true;
     std::size_t count = 0;
 
@@ -52,6 +52,7 @@ InboundLedger::InboundLedger(Application& app, uint256 const& hash,
     , mByHash (true)
     , mSeq (seq)
     , mReason (reason)
+    , mScheduler (reqNodesReply)
     , mReceiveDispatched (false)
 {
     JLOG (m_journal.trace()) << "Acquiring ledger " << mHash;
@@ -404,6 +405,15 @@ void InboundLedger::addPeers ()
     app_.overlay().selectPeers (*this,
         (getPeerCount() == 0) ? peerCountStart : peerCountAdd,
         ScoreHasLedger (getHash(), mSeq));
+
+    if (mHaveHeader && !mHaveState)
+    {
+        for (auto const& peer : app_.overlay().getActivePeers())
+        {
+            if (peer->hasLedger (mHash, mSeq))
+                insert (peer);
+        }
+    }
 }
 
 std::weak_ptr<PeerSet> InboundLedger::pmDowncast ()
@@ -616,9 +626,10 @@ void InboundLedger::trigger (std::shared_ptr<Peer> const& peer, TriggerReason re
             AccountStateSF filter(mLedger->stateMap().family().db(),
                 app_.getLedgerMaster());
 
+            int const want = missingNodesFind + mScheduler.outstanding ();
             sl.unlock();
             auto nodes = mLedger->stateMap().getMissingNodes (
-                missingNodesFind, &filter);
+                want, &filter);
             sl.lock();
 
             if (!mFailed && !mComplete && !mHaveState)
@@ -635,30 +646,14 @@ void InboundLedger::trigger (std::shared_ptr<Peer> const& peer, TriggerReason re
                             mComplete = true;
                     }
                 }
+                else if (requestStateNodes (nodes, tmGL, reason))
+                {
+                    return;
+                }
                 else
                 {
-                    filterNodes (nodes, reason);
-
-                    if (!nodes.empty ())
-                    {
-                        tmGL.set_itype (protocol::liAS_NODE);
-                        for (auto const& id : nodes)
-                        {
-                            * (tmGL.add_nodeids ()) = id.first.getRawString ();
-                        }
-
-                        JLOG (m_journal.trace()) <<
-                            "Sending AS node request (" <<
-                            nodes.size () << ") to " <<
-                            (peer ? "selected peer" : "all peers");
-                        sendRequest (tmGL, peer);
-                        return;
-                    }
-                    else
-                    {
-                        JLOG (m_journal.trace()) <<
-                            "All AS nodes filtered";
-                    }
+                    JLOG (m_journal.trace()) <<
+                        "All AS nodes in flight";
                 }
             }
         }
@@ -740,6 +735,63 @@ void InboundLedger::trigger (std::shared_ptr<Peer> const& peer, TriggerReason re
     }
 }
 
+bool InboundLedger::requestStateNodes (
+    std::vector<std::pair<SHAMapNodeID, uint256>> const& nodes,
+    protocol::TMGetLedger const& tmGL,
+    TriggerReason reason)
+{
+    std::map<Peer::id_t, std::shared_ptr<Peer>> live;
+    std::map<Peer::id_t, std::shared_ptr<Peer>> withLedger;
+
+    for (auto id : mPeers)
+    {
+        if (auto p = app_.overlay ().findPeerByShortID (id))
+        {
+            if (p->hasLedger (mHash, mSeq))
+                withLedger.emplace (id, p);
+            live.emplace (id, std::move (p));
+        }
+    }
+
+    auto const& peers = withLedger.empty () ? live : withLedger;
+
+    std::vector<Peer::id_t> ids;
+    ids.reserve (peers.size ());
+    for (auto const& p : peers)
+        ids.push_back (p.first);
+
+    auto const now = m_clock.now ();
+    mScheduler.setPeers (ids);
+
+    if (auto const stragglers = mScheduler.expire (now))
+    {
+        JLOG (m_journal.debug()) <<
+            "Re-requesting " << stragglers << " AS nodes for " << mHash;
+    }
+
+    auto const batches = mScheduler.assign (nodes, now);
+
+    for (auto const& batch : batches)
+    {
+        auto const& p = peers.at (batch.first);
+
+        protocol::TMGetLedger request (tmGL);
+        request.set_itype (protocol::liAS_NODE);
+        if (reason == TriggerReason::reply)
+            request.set_querydepth (p->isHighLatency () ? 2 : 1);
+
+        for (auto const& n : batch.second)
+            * (request.add_nodeids ()) = n.first.getRawString ();
+
+        JLOG (m_journal.trace()) <<
+            "Sending AS node request (" <<
+            batch.second.size () << ") to peer " << batch.first;
+        sendRequest (request, p);
+    }
+
+    return !batches.empty ();
+}
+
 void InboundLedger::filterNodes (
     std::vector<std::pair<SHAMapNodeID, uint256>>& nodes,
     TriggerReason reason)
@@ -1152,6 +1204,14 @@ int InboundLedger::processData (std::shared_ptr<Peer> peer,
 
         SHAMapAddNode san;
 
+        if (packet.type () == protocol::liAS_NODE)
+        {
+            std::size_t bytes = 0;
+            for (auto const& d : nodeData)
+                bytes += d.size ();
+            mScheduler.onReply (peer->id (), nodeIDs, bytes, m_clock.now ());
+        }
+
         if (packet.type () == protocol::liTX_NODE)
         {
             takeTxNode (nodeIDs, nodeData, san);
@@ -1251,6 +1311,9 @@ Json::Value InboundLedger::getJson (int)
             hv.append (to_string (h));
         }
         ret[jss::needed_state_hashes] = hv;
+
+        if (mScheduler.peerCount () != 0)
+            ret[jss::peer_stats] = mScheduler.getJson ();
     }
 
     if (mHaveHeader && !mHaveTransactions)
@@ -1684,6 +1684,7 @@ void LedgerMaster::doAdvance (ScopedLockType& sl)
 
                 {
                     ScopedUnlockType sul(m_mutex);
+                    app_.getOrderBookDB().setup(ledger);
                     app_.getOPs().pubLedger(ledger);
                 }
             }
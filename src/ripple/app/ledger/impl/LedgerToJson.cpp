@@ -232,15 +232,28 @@ void fillJson (Object& json, LedgerFill const& fill)
         fillJsonState(json, fill);
 }
 
+template <class Object>
+void addLedger (Object& json, LedgerFill const& fill)
+{
+    {
+        auto&& object = Json::addObject (json, jss::ledger);
+        fillJson (object, fill);
+    }
+
+    if ((fill.options & LedgerFill::dumpQueue) && !fill.txQueue.empty())
+        fillJsonQueue(json, fill);
+}
+
 } 
 
 void addJson (Json::Value& json, LedgerFill const& fill)
 {
-    auto&& object = Json::addObject (json, jss::ledger);
-    fillJson (object, fill);
+    addLedger (json, fill);
+}
 
-    if ((fill.options & LedgerFill::dumpQueue) && !fill.txQueue.empty())
-        fillJsonQueue(json, fill);
+void addJson (Json::Object& json, LedgerFill const& fill)
+{
+    addLedger (json, fill);
 }
 
 Json::Value getJson (LedgerFill const& fill)
@@ -0,0 +1,662 @@
+
+
+#include <ripple/app/ledger/ParallelApply.h>
+#include <ripple/app/ledger/Ledger.h>
+#include <ripple/app/main/Application.h>
+#include <ripple/app/misc/CanonicalTXSet.h>
+#include <ripple/app/tx/apply.h>
+#include <ripple/basics/Log.h>
+#include <ripple/core/JobQueue.h>
+#include <ripple/ledger/RawView.h>
+#include <ripple/ledger/TxMeta.h>
+#include <ripple/protocol/Book.h>
+#include <ripple/protocol/Indexes.h>
+#include <ripple/protocol/STAccount.h>
+#include <ripple/protocol/STBitString.h>
+#include <ripple/protocol/STPathSet.h>
+#include <ripple/protocol/STTx.h>
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace ripple {
+
+namespace detail {
+
+class ReadSetView : public ReadView
+{
+public:
+    using range = std::pair<key_type, boost::optional<key_type>>;
+
+    explicit
+    ReadSetView (ReadView const& base)
+        : base_ (base)
+    {
+    }
+
+    LedgerInfo const&
+    info() const override
+    {
+        return base_.info();
+    }
+
+    bool
+    open() const override
+    {
+        return base_.open();
+    }
+
+    Fees const&
+    fees() const override
+    {
+        return base_.fees();
+    }
+
+    Rules const&
+    rules() const override
+    {
+        return base_.rules();
+    }
+
+    bool
+    exists (Keylet const& k) const override
+    {
+        keys_.insert (k.key);
+        return base_.exists (k);
+    }
+
+    boost::optional<key_type>
+    succ (key_type const& key, boost::optional<
+        key_type> const& last = boost::none) const override
+    {
+        auto const next = base_.succ (key, last);
+        ranges_.emplace_back (key, next ? next : last);
+        return next;
+    }
+
+    std::shared_ptr<SLE const>
+    read (Keylet const& k) const override
+    {
+        keys_.insert (k.key);
+        return base_.read (k);
+    }
+
+    std::unique_ptr<sles_type::iter_base>
+    slesBegin() const override
+    {
+        scanned_ = true;
+        return base_.slesBegin();
+    }
+
+    std::unique_ptr<sles_type::iter_base>
+    slesEnd() const override
+    {
+        scanned_ = true;
+        return base_.slesEnd();
+    }
+
+    std::unique_ptr<sles_type::iter_base>
+    slesUpperBound (key_type const& key) const override
+    {
+        scanned_ = true;
+        return base_.slesUpperBound (key);
+    }
+
+    std::unique_ptr<txs_type::iter_base>
+    txsBegin() const override
+    {
+        return base_.txsBegin();
+    }
+
+    std::unique_ptr<txs_type::iter_base>
+    txsEnd() const override
+    {
+        return base_.txsEnd();
+    }
+
+    bool
+    txExists (key_type const& key) const override
+    {
+        return base_.txExists (key);
+    }
+
+    tx_type
+    txRead (key_type const& key) const override
+    {
+        return base_.txRead (key);
+    }
+
+    std::set<key_type> const&
+    keys() const
+    {
+        return keys_;
+    }
+
+    std::vector<range> const&
+    ranges() const
+    {
+        return ranges_;
+    }
+
+    bool
+    scanned() const
+    {
+        return scanned_;
+    }
+
+private:
+    ReadView const& base_;
+    mutable std::set<key_type> keys_;
+    mutable std::vector<range> ranges_;
+    mutable bool scanned_ = false;
+};
+
+class WriteSetView : public TxsRawView
+{
+public:
+    enum class Action
+    {
+        erase,
+        insert,
+        replace
+    };
+
+    struct Tx
+    {
+        ReadView::key_type key;
+        std::shared_ptr<Serializer const> txn;
+        std::shared_ptr<Serializer const> meta;
+    };
+
+    void
+    rawErase (std::shared_ptr<SLE> const& sle) override
+    {
+        items_.emplace_back (Action::erase, sle);
+    }
+
+    void
+    rawInsert (std::shared_ptr<SLE> const& sle) override
+    {
+        items_.emplace_back (Action::insert, sle);
+    }
+
+    void
+    rawReplace (std::shared_ptr<SLE> const& sle) override
+    {
+        items_.emplace_back (Action::replace, sle);
+    }
+
+    void
+    rawDestroyXRP (XRPAmount const& fee) override
+    {
+        destroyed_ += fee;
+    }
+
+    void
+    rawTxInsert (ReadView::key_type const& key,
+        std::shared_ptr<Serializer const>
+            const& txn, std::shared_ptr<
+                Serializer const> const& metaData) override
+    {
+        txs_.push_back ({key, txn, metaData});
+    }
+
+    std::vector<std::pair<Action, std::shared_ptr<SLE>>> const&
+    items() const
+    {
+        return items_;
+    }
+
+    std::vector<Tx> const&
+    txs() const
+    {
+        return txs_;
+    }
+
+    XRPAmount
+    destroyed() const
+    {
+        return destroyed_;
+    }
+
+private:
+    std::vector<std::pair<Action, std::shared_ptr<SLE>>> items_;
+    std::vector<Tx> txs_;
+    XRPAmount destroyed_ {0};
+};
+
+struct ApplyGroup
+{
+    std::vector<CanonicalTXSet::const_iterator> txs;
+    std::vector<ApplyResult> results;
+    std::unique_ptr<ReadSetView> reads;
+    WriteSetView writes;
+    bool ok = false;
+};
+
+class DisjointSet
+{
+public:
+    explicit
+    DisjointSet (std::size_t size)
+        : parent_ (size)
+    {
+        for (std::size_t i = 0; i < size; ++i)
+            parent_[i] = i;
+    }
+
+    std::size_t
+    find (std::size_t i)
+    {
+        while (parent_[i] != i)
+        {
+            parent_[i] = parent_[parent_[i]];
+            i = parent_[i];
+        }
+        return i;
+    }
+
+    void
+    unite (std::size_t a, std::size_t b)
+    {
+        a = find (a);
+        b = find (b);
+        if (a != b)
+            parent_[std::max (a, b)] = std::min (a, b);
+    }
+
+private:
+    std::vector<std::size_t> parent_;
+};
+
+static
+void
+addBook (std::vector<uint256>& hints, Issue const& in, Issue const& out)
+{
+    if (in == out)
+        return;
+
+    Book const book {in, out};
+    if (! isConsistent (book))
+        return;
+
+    hints.push_back (getBookBase (book));
+    hints.push_back (getBookBase (reversed (book)));
+
+    if (! isXRP (in) && ! isXRP (out))
+    {
+        addBook (hints, in, xrpIssue ());
+        addBook (hints, xrpIssue (), out);
+    }
+}
+
+static
+std::vector<uint256>
+getHints (STTx const& tx)
+{
+    std::vector<uint256> hints;
+
+    auto addAccount = [&hints](AccountID const& id)
+    {
+        if (id != beast::zero && id != noAccount())
+            hints.push_back (keylet::account (id).key);
+    };
+
+    for (auto const& field : tx)
+    {
+        switch (field.getSType ())
+        {
+        case STI_ACCOUNT:
+            addAccount (static_cast<STAccount const&> (field).value ());
+            break;
+
+        case STI_AMOUNT:
+            addAccount (static_cast<STAmount const&> (field).getIssuer ());
+            break;
+
+        case STI_HASH256:
+            hints.push_back (static_cast<STHash256 const&> (field).value ());
+            break;
+
+        case STI_PATHSET:
+            for (auto const& path : static_cast<STPathSet const&> (field))
+            {
+                for (auto const& node : path)
+                {
+                    if (node.hasIssuer ())
+                        addAccount (node.getIssuerID ());
+                    if (node.isAccount () && node.getAccountID () != beast::zero)
+                        addAccount (node.getAccountID ());
+                }
+            }
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    auto const type = tx.getTxnType ();
+    if (type == ttOFFER_CREATE)
+    {
+        addBook (hints, tx[sfTakerPays].issue (), tx[sfTakerGets].issue ());
+    }
+    else if (type == ttPAYMENT)
+    {
+        auto const out = tx[sfAmount].issue ();
+        auto const in = tx[~sfSendMax] ? tx[sfSendMax].issue () : out;
+        addBook (hints, in, out);
+
+        if (tx.isFieldPresent (sfPaths))
+        {
+            for (auto const& path : tx.getFieldPathSet (sfPaths))
+            {
+                for (auto const& node : path)
+                {
+                    if (! node.isOffer ())
+                        continue;
+                    Issue const hop {node.getCurrency (),
+                        node.hasIssuer () ? node.getIssuerID ()
+                            : isXRP (node.getCurrency ()) ? xrpAccount ()
+                                : out.account};
+                    addBook (hints, in, hop);
+                    addBook (hints, hop, out);
+                }
+            }
+        }
+    }
+
+    return hints;
+}
+
+static
+void
+applyGroup (Application& app, ReadView const& base,
+    ApplyGroup& group, beast::Journal j)
+{
+    group.reads = std::make_unique<ReadSetView> (base);
+
+    try
+    {
+        OpenView fork (group.reads.get ());
+
+        for (auto const& it : group.txs)
+        {
+            auto const result = applyTransaction (
+                app, fork, *it->second, true, tapNONE, j);
+
+            if (result == ApplyResult::Retry)
+                return;
+
+            group.results.push_back (result);
+        }
+
+        fork.apply (group.writes);
+        group.ok = true;
+    }
+    catch (std::exception const& e)
+    {
+        JLOG (j.debug()) << "Parallel apply group throws: " << e.what ();
+    }
+}
+
+static
+bool
+independent (std::vector<ApplyGroup> const& groups)
+{
+    std::map<uint256, std::size_t> writers;
+
+    for (std::size_t i = 0; i < groups.size (); ++i)
+    {
+        for (auto const& item : groups[i].writes.items ())
+        {
+            if (! writers.emplace (item.second->key (), i).second)
+                return false;
+        }
+    }
+
+    auto touched = [&writers](std::size_t i, uint256 const& key)
+    {
+        auto const it = writers.find (key);
+        return it != writers.end () && it->second != i;
+    };
+
+    for (std::size_t i = 0; i < groups.size (); ++i)
+    {
+        auto const& reads = *groups[i].reads;
+
+        if (reads.scanned () && writers.size () !=
+                groups[i].writes.items ().size ())
+            return false;
+
+        for (auto const& key : reads.keys ())
+        {
+            if (touched (i, key))
+                return false;
+        }
+
+        for (auto const& r : reads.ranges ())
+        {
+            auto it = writers.upper_bound (r.first);
+            auto const end = r.second
+                ? writers.upper_bound (*r.second) : writers.end ();
+            for (; it != end; ++it)
+            {
+                if (it->second != i)
+                    return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+}
+
+boost::optional<std::size_t>
+applyTransactionsParallel(
+    Application& app,
+    std::shared_ptr<Ledger const> const& built,
+    CanonicalTXSet& txns,
+    std::set<TxID>& failed,
+    OpenView& view,
+    std::size_t threads,
+    beast::Journal j)
+{
+    using namespace detail;
+
+    std::vector<CanonicalTXSet::const_iterator> pending;
+    pending.reserve (txns.size ());
+    for (auto it = txns.begin (); it != txns.end (); ++it)
+    {
+        if (isPseudoTx (*it->second))
+            return boost::none;
+
+        if (! built->txExists (it->first.getTXID ()))
+            pending.push_back (it);
+    }
+
+    if (pending.size () < 2 * threads)
+        return boost::none;
+
+    DisjointSet sets (pending.size ());
+    {
+        std::unordered_map<uint256, std::size_t, beast::uhash<>> owners;
+        for (std::size_t i = 0; i < pending.size (); ++i)
+        {
+            for (auto const& hint : getHints (*pending[i]->second))
+            {
+                auto const result = owners.emplace (hint, i);
+                if (! result.second)
+                    sets.unite (i, result.first->second);
+            }
+        }
+    }
+
+    std::vector<ApplyGroup> groups;
+    {
+        std::map<std::size_t, std::size_t> index;
+        for (std::size_t i = 0; i < pending.size (); ++i)
+        {
+            auto const result = index.emplace (sets.find (i), groups.size ());
+            if (result.second)
+                groups.emplace_back ();
+            groups[result.first->second].txs.push_back (pending[i]);
+        }
+    }
+
+    if (groups.size () < 2)
+        return boost::none;
+
+    JLOG (j.debug()) << "Parallel apply: " << pending.size ()
+        << " transactions in " << groups.size () << " groups";
+
+    {
+        std::vector<std::size_t> order (groups.size ());
+        for (std::size_t i = 0; i < order.size (); ++i)
+            order[i] = i;
+        std::stable_sort (order.begin (), order.end (),
+            [&groups](std::size_t a, std::size_t b)
+            {
+                return groups[a].txs.size () > groups[b].txs.size ();
+            });
+
+        // Helpers run on the job queue. This thread applies groups too,
+        // so the work finishes even if no job thread is free. Jobs that
+        // start after it has finished return without touching the groups.
+        struct Helpers
+        {
+            std::atomic<std::size_t> next {0};
+            std::mutex mutex;
+            std::condition_variable cv;
+            std::size_t active = 0;
+            bool closed = false;
+        };
+        auto const helpers = std::make_shared<Helpers> ();
+
+        auto const work = [&]()
+        {
+            for (;;)
+            {
+                auto const i = helpers->next++;
+                if (i >= order.size ())
+                    return;
+                applyGroup (app, view, groups[order[i]], j);
+            }
+        };
+
+        threads = std::min (threads, groups.size ());
+        for (std::size_t i = 1; i < threads; ++i)
+        {
+            app.getJobQueue ().addJob (jtACCEPT, "parallelApply",
+                [helpers, &work](Job&)
+                {
+                    {
+                        std::lock_guard<std::mutex> lock (helpers->mutex);
+                        if (helpers->closed)
+                            return;
+                        ++helpers->active;
+                    }
+                    work ();
+                    std::lock_guard<std::mutex> lock (helpers->mutex);
+                    --helpers->active;
+                    helpers->cv.notify_all ();
+                });
+        }
+
+        work ();
+        std::unique_lock<std::mutex> lock (helpers->mutex);
+        helpers->closed = true;
+        helpers->cv.wait (lock, [&] { return helpers->active == 0; });
+    }
+
+    for (auto const& group : groups)
+    {
+        if (! group.ok)
+        {
+            JLOG (j.debug()) << "Parallel apply: retry, using serial apply";
+            return boost::none;
+        }
+    }
+
+    if (! independent (groups))
+    {
+        JLOG (j.debug()) << "Parallel apply: conflict, using serial apply";
+        return boost::none;
+    }
+
+    std::map<uint256, std::uint32_t> position;
+    for (auto const& group : groups)
+    {
+        for (auto const& tx : group.writes.txs ())
+            position.emplace (tx.key, 0);
+    }
+    {
+        auto index = static_cast<std::uint32_t> (view.txCount ());
+        for (auto const& it : pending)
+        {
+            auto const p = position.find (it->first.getTXID ());
+            if (p != position.end ())
+                p->second = index++;
+        }
+    }
+
+    XRPAmount destroyed {0};
+    for (auto const& group : groups)
+        destroyed += group.writes.destroyed ();
+    view.rawDestroyXRP (destroyed);
+
+    for (auto const& group : groups)
+    {
+        for (auto const& item : group.writes.items ())
+        {
+            switch (item.first)
+            {
+            case WriteSetView::Action::erase:
+                view.rawErase (item.second);
+                break;
+            case WriteSetView::Action::insert:
+                view.rawInsert (item.second);
+                break;
+            case WriteSetView::Action::replace:
+                view.rawReplace (item.second);
+                break;
+            }
+        }
+
+        for (auto const& tx : group.writes.txs ())
+        {
+            auto meta = tx.meta;
+            if (meta)
+            {
+                TxMeta m (tx.key, view.seq (), meta->peekData ());
+                auto s = std::make_shared<Serializer> ();
+                m.addRaw (*s, m.getResultTER (), position[tx.key]);
+                meta = std::move (s);
+            }
+            view.rawTxInsert (tx.key, tx.txn, meta);
+        }
+    }
+
+    std::size_t count = 0;
+    for (auto const& group : groups)
+    {
+        for (std::size_t i = 0; i < group.txs.size (); ++i)
+        {
+            if (group.results[i] == ApplyResult::Success)
+                ++count;
+            else
+                failed.insert (group.txs[i]->first.getTXID ());
+        }
+    }
+
+    for (auto it = txns.begin (); it != txns.end ();)
+        it = txns.erase (it);
+
+    return count;
+}
+
+}
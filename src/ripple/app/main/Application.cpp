@@ -41,6 +41,8 @@
 #include <ripple/protocol/STParsedJSON.h>
 #include <ripple/protocol/Protocol.h>
 #include <ripple/resource/Fees.h>
+#include <ripple/rpc/Coalescer.h>
+#include <ripple/rpc/ResultCache.h>
 #include <ripple/beast/asio/io_latency_probe.h>
 #include <ripple/beast/core/LexicalCast.h>
 #include <boost/asio/steady_timer.hpp>
@@ -312,6 +314,8 @@ public:
     std::unique_ptr <detail::AppFamily> sFamily_;
     OrderBookDB m_orderBookDB;
     std::unique_ptr <PathRequests> m_pathRequests;
+    RPC::ResultCache rpcResultCache_;
+    RPC::Coalescer rpcCoalescer_;
     std::unique_ptr <LedgerMaster> m_ledgerMaster;
     std::unique_ptr <InboundLedgers> m_inboundLedgers;
     std::unique_ptr <InboundTransactions> m_inboundTransactions;
@@ -419,6 +423,8 @@ public:
         , m_pathRequests (std::make_unique<PathRequests> (
             *this, logs_->journal("PathRequest"), m_collectorManager->collector ()))
 
+        , rpcResultCache_ (megabytes (config_->RPC_CACHE_SIZE))
+
         , m_ledgerMaster (std::make_unique<LedgerMaster> (*this, stopwatch (),
             *m_jobQueue, m_collectorManager->collector (),
             logs_->journal("LedgerMaster")))
@@ -654,6 +660,16 @@ public:
         return *m_pathRequests;
     }
 
+    RPC::ResultCache& getRPCResultCache () override
+    {
+        return rpcResultCache_;
+    }
+
+    RPC::Coalescer& getRPCCoalescer () override
+    {
+        return rpcCoalescer_;
+    }
+
     CachedSLEs&
     cachedSLEs() override
     {
@@ -710,6 +726,11 @@ public:
         return *m_shaMapStore;
     }
 
+    ServerHandler& getServerHandler () override
+    {
+        return *serverHandler_;
+    }
+
     PendingSaves& pendingSaves() override
     {
         return pendingSaves_;
@@ -875,6 +896,8 @@ public:
                 return validators().trustedPublisher (pubKey);
             });
 
+        m_orderBookDB.saveSnapshot ();
+
         stopped ();
     }
 
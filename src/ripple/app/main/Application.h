@@ -19,6 +19,7 @@ namespace unl { class Manager; }
 namespace Resource { class Manager; }
 namespace NodeStore { class Database; class DatabaseShard; }
 namespace perf { class PerfLog; }
+namespace RPC { class Coalescer; class ResultCache; }
 
 class AmendmentTable;
 class CachedSLEs;
@@ -54,6 +55,7 @@ class Cluster;
 
 class DatabaseCon;
 class SHAMapStore;
+class ServerHandlerImp;
 
 using NodeCache     = TaggedCache <SHAMapHash, Blob>;
 
@@ -134,7 +136,10 @@ public:
 
     virtual Resource::Manager&      getResourceManager () = 0;
     virtual PathRequests&           getPathRequests () = 0;
+    virtual RPC::ResultCache&       getRPCResultCache () = 0;
+    virtual RPC::Coalescer&         getRPCCoalescer () = 0;
     virtual SHAMapStore&            getSHAMapStore () = 0;
+    virtual ServerHandlerImp&       getServerHandler () = 0;
     virtual PendingSaves&           pendingSaves() = 0;
     virtual AccountIDCache const&   accountIDCache() const = 0;
     virtual OpenLedger&             openLedger() = 0;
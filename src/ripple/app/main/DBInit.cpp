@@ -112,6 +112,12 @@ const char* WalletDBInit[] =
         RawData          BLOB NOT NULL               \
     );",
 
+    "CREATE TABLE IF NOT EXISTS OrderBookSnapshot (  \
+        LedgerSeq        BIGINT UNSIGNED,            \
+        LedgerHash       CHARACTER(64),              \
+        RawData          BLOB NOT NULL               \
+    );",
+
     "DROP INDEX IF EXISTS SeedNodeNext;",
     "DROP INDEX IF EXISTS SeedDomainNext;",
     "DROP TABLE IF EXISTS Features;",
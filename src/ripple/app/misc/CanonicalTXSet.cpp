@@ -1,7 +1,7 @@
 
 
 #include <ripple/app/misc/CanonicalTXSet.h>
-#include <boost/range/adaptor/transformed.hpp>
+#include <algorithm>
 
 namespace ripple {
 
@@ -57,6 +57,55 @@ bool CanonicalTXSet::Key::operator>= (Key const& rhs)const
     return mTXid >= rhs.mTXid;
 }
 
+CanonicalTXSet::CanonicalTXSet (CanonicalTXSet const& other)
+    : salt_ (other.salt_)
+{
+    other.normalize ();
+    list_ = other.list_;
+    sorted_ = other.sorted_;
+    erased_ = other.erased_;
+}
+
+CanonicalTXSet::CanonicalTXSet (CanonicalTXSet&& other)
+    : normal_ (other.normal_.load ())
+    , list_ (std::move (other.list_))
+    , sorted_ (other.sorted_)
+    , erased_ (other.erased_)
+    , salt_ (other.salt_)
+{
+    other.reset (salt_);
+}
+
+CanonicalTXSet&
+CanonicalTXSet::operator= (CanonicalTXSet const& other)
+{
+    if (this != &other)
+    {
+        other.normalize ();
+        list_ = other.list_;
+        sorted_ = other.sorted_;
+        erased_ = other.erased_;
+        salt_ = other.salt_;
+        normal_ = true;
+    }
+    return *this;
+}
+
+CanonicalTXSet&
+CanonicalTXSet::operator= (CanonicalTXSet&& other)
+{
+    if (this != &other)
+    {
+        list_ = std::move (other.list_);
+        sorted_ = other.sorted_;
+        erased_ = other.erased_;
+        salt_ = other.salt_;
+        normal_ = other.normal_.load ();
+        other.reset (salt_);
+    }
+    return *this;
+}
+
 uint256 CanonicalTXSet::accountKey (AccountID const& account)
 {
     uint256 ret = beast::zero;
@@ -70,34 +119,95 @@ uint256 CanonicalTXSet::accountKey (AccountID const& account)
 
 void CanonicalTXSet::insert (std::shared_ptr<STTx const> const& txn)
 {
-    map_.insert (
-        std::make_pair (
-            Key (
-                accountKey (txn->getAccountID(sfAccount)),
-                txn->getSequence (),
-                txn->getTransactionID ()),
-            txn));
+    Key key (
+        accountKey (txn->getAccountID(sfAccount)),
+        txn->getSequence (),
+        txn->getTransactionID ());
+
+    bool const ordered = (sorted_ == list_.size ()) &&
+        (list_.empty () || list_.back ().first < key);
+
+    list_.emplace_back (std::move (key), txn);
+
+    if (ordered)
+        ++sorted_;
+    else
+        normal_.store (false, std::memory_order_relaxed);
+}
+
+CanonicalTXSet::const_iterator
+CanonicalTXSet::erase (const_iterator const& it)
+{
+    auto const index = it.it_ - list_.cbegin ();
+    list_[index].second.reset ();
+    ++erased_;
+    return const_iterator (list_.cbegin () + index + 1, list_.cend ());
+}
+
+void CanonicalTXSet::normalize () const
+{
+    // Concurrent readers must not sort at the same time
+    if (normal_.load (std::memory_order_acquire))
+        return;
+
+    std::lock_guard<std::mutex> lock (mutex_);
+    if (normal_.load (std::memory_order_relaxed))
+        return;
+
+    auto const sorted = std::remove_if (
+        list_.begin (), list_.begin () + sorted_,
+        [](value_type const& v) { return ! v.second; });
+    auto const unsorted = list_.erase (sorted, list_.begin () + sorted_);
+
+    auto const less = [](value_type const& a, value_type const& b)
+    {
+        return a.first < b.first;
+    };
+
+    std::stable_sort (unsorted, list_.end (), less);
+    std::inplace_merge (list_.begin (), unsorted, list_.end (), less);
+
+    list_.erase (std::unique (list_.begin (), list_.end (),
+        [](value_type const& a, value_type const& b)
+        {
+            return a.first == b.first;
+        }), list_.end ());
+
+    sorted_ = list_.size ();
+    erased_ = 0;
+    normal_.store (true, std::memory_order_release);
 }
 
 std::vector<std::shared_ptr<STTx const>>
 CanonicalTXSet::prune(AccountID const& account,
     std::uint32_t const seq)
 {
+    normalize ();
+
     auto effectiveAccount = accountKey (account);
 
     Key keyLow(effectiveAccount, seq, beast::zero);
     Key keyHigh(effectiveAccount, seq+1, beast::zero);
 
-    auto range = boost::make_iterator_range(
-        map_.lower_bound(keyLow),
-        map_.lower_bound(keyHigh));
-    auto txRange = boost::adaptors::transform(range,
-        [](auto const& p) { return p.second; });
-
-    std::vector<std::shared_ptr<STTx const>> result(
-        txRange.begin(), txRange.end());
-
-    map_.erase(range.begin(), range.end());
+    auto const less = [](value_type const& v, Key const& k)
+    {
+        return v.first < k;
+    };
+
+    auto first = std::lower_bound (
+        list_.begin (), list_.end (), keyLow, less);
+    auto const last = std::lower_bound (
+        first, list_.end (), keyHigh, less);
+
+    std::vector<std::shared_ptr<STTx const>> result;
+    for (; first != last; ++first)
+    {
+        if (first->second)
+        {
+            result.push_back (std::move (first->second));
+            ++erased_;
+        }
+    }
     return result;
 }
 
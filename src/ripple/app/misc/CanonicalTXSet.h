@@ -5,10 +5,24 @@
 
 #include <ripple/protocol/RippleLedgerHash.h>
 #include <ripple/protocol/STTx.h>
+#include <atomic>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
 
 namespace ripple {
 
+/** Transactions in the order they are applied to a ledger.
 
+    Entries out of order are sorted the next time the set is read. Reads
+    may run on several threads at once; the first one sorts under a lock.
+    Like any container, the set must not be changed while it is read.
+
+    Unlike the std::map this replaced, insert invalidates iterators.
+    erase and prune do not.
+*/
 class CanonicalTXSet
 {
 private:
@@ -50,7 +64,74 @@ private:
     uint256 accountKey (AccountID const& account);
 
 public:
-    using const_iterator = std::map <Key, std::shared_ptr<STTx const>>::const_iterator;
+    using value_type = std::pair<Key, std::shared_ptr<STTx const>>;
+
+    class const_iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = CanonicalTXSet::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = value_type const*;
+        using reference = value_type const&;
+
+        const_iterator () = default;
+
+        reference operator* () const
+        {
+            return *it_;
+        }
+
+        pointer operator-> () const
+        {
+            return &*it_;
+        }
+
+        const_iterator& operator++ ()
+        {
+            ++it_;
+            skip ();
+            return *this;
+        }
+
+        const_iterator operator++ (int)
+        {
+            auto ret = *this;
+            ++*this;
+            return ret;
+        }
+
+        bool operator== (const_iterator const& rhs) const
+        {
+            return it_ == rhs.it_;
+        }
+
+        bool operator!= (const_iterator const& rhs) const
+        {
+            return it_ != rhs.it_;
+        }
+
+    private:
+        friend class CanonicalTXSet;
+
+        using base_iterator = std::vector<value_type>::const_iterator;
+
+        const_iterator (base_iterator it, base_iterator end)
+            : it_ (it)
+            , end_ (end)
+        {
+            skip ();
+        }
+
+        void skip ()
+        {
+            while (it_ != end_ && ! it_->second)
+                ++it_;
+        }
+
+        base_iterator it_;
+        base_iterator end_;
+    };
 
 public:
     explicit CanonicalTXSet (LedgerHash const& saltHash)
@@ -58,6 +139,11 @@ public:
     {
     }
 
+    CanonicalTXSet (CanonicalTXSet const& other);
+    CanonicalTXSet (CanonicalTXSet&& other);
+    CanonicalTXSet& operator= (CanonicalTXSet const& other);
+    CanonicalTXSet& operator= (CanonicalTXSet&& other);
+
     void insert (std::shared_ptr<STTx const> const& txn);
 
     std::vector<std::shared_ptr<STTx const>>
@@ -66,31 +152,34 @@ public:
     void reset (LedgerHash const& salt)
     {
         salt_ = salt;
-        map_.clear ();
+        list_.clear ();
+        sorted_ = 0;
+        erased_ = 0;
+        normal_ = true;
     }
 
-    const_iterator erase (const_iterator const& it)
-    {
-        return map_.erase(it);
-    }
+    const_iterator erase (const_iterator const& it);
 
     const_iterator begin () const
     {
-        return map_.begin();
+        normalize ();
+        return const_iterator (list_.cbegin (), list_.cend ());
     }
 
     const_iterator end() const
     {
-        return map_.end();
+        normalize ();
+        return const_iterator (list_.cend (), list_.cend ());
     }
 
     size_t size () const
     {
-        return map_.size ();
+        normalize ();
+        return list_.size () - erased_;
     }
     bool empty () const
     {
-        return map_.empty ();
+        return size () == 0;
     }
 
     uint256 const& key() const
@@ -99,7 +188,13 @@ public:
     }
 
 private:
-    std::map <Key, std::shared_ptr<STTx const>> map_;
+    void normalize () const;
+
+    mutable std::mutex mutex_;
+    mutable std::atomic<bool> normal_ {true};
+    mutable std::vector<value_type> list_;
+    mutable std::size_t sorted_ = 0;
+    mutable std::size_t erased_ = 0;
 
     uint256 salt_;
 };
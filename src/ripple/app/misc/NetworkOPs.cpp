@@ -1397,12 +1397,13 @@ void NetworkOPsImp::pubManifest (Manifest const& mo)
             jvObj [jss::signature] = strHex (*sig);
         jvObj [jss::master_signature] = strHex (mo.getMasterSignature ());
 
+        InfoSub::Payload const payload (jvObj, "manifests");
         for (auto i = mStreamMaps[sManifests].begin ();
             i != mStreamMaps[sManifests].end (); )
         {
             if (auto p = i->second.lock())
             {
-                p->send (jvObj, true);
+                p->send (payload, true);
                 ++i;
             }
             else
@@ -1491,6 +1492,7 @@ void NetworkOPsImp::pubServer ()
 
         mLastFeeSummary = f;
 
+        InfoSub::Payload const payload (jvObj, "server", true);
         for (auto i = mStreamMaps[sServer].begin ();
             i != mStreamMaps[sServer].end (); )
         {
@@ -1498,7 +1500,7 @@ void NetworkOPsImp::pubServer ()
 
             if (p)
             {
-                p->send (jvObj, true);
+                p->send (payload, true);
                 ++i;
             }
             else
@@ -1553,12 +1555,13 @@ void NetworkOPsImp::pubValidation (STValidation::ref val)
         if (auto const reserveInc = (*val)[~sfReserveIncrement])
             jvObj [jss::reserve_inc] = *reserveInc;
 
+        InfoSub::Payload const payload (jvObj, "validations");
         for (auto i = mStreamMaps[sValidations].begin ();
             i != mStreamMaps[sValidations].end (); )
         {
             if (auto p = i->second.lock())
             {
-                p->send (jvObj, true);
+                p->send (payload, true);
                 ++i;
             }
             else
@@ -1580,6 +1583,7 @@ void NetworkOPsImp::pubPeerStatus (
 
         jvObj [jss::type]                  = "peerStatusChange";
 
+        InfoSub::Payload const payload (jvObj, "peer_status");
         for (auto i = mStreamMaps[sPeerStatus].begin ();
             i != mStreamMaps[sPeerStatus].end (); )
         {
@@ -1587,7 +1591,7 @@ void NetworkOPsImp::pubPeerStatus (
 
             if (p)
             {
-                p->send (jvObj, true);
+                p->send (payload, true);
                 ++i;
             }
             else
@@ -2191,6 +2195,7 @@ void NetworkOPsImp::pubProposedTransaction (
     std::shared_ptr<STTx const> const& stTxn, TER terResult)
 {
     Json::Value jvObj   = transJson (*stTxn, terResult, false, lpCurrent);
+    InfoSub::Payload const payload (jvObj, "transactions_proposed");
 
     {
         ScopedLockType sl (mSubLock);
@@ -2202,7 +2207,7 @@ void NetworkOPsImp::pubProposedTransaction (
 
             if (p)
             {
-                p->send (jvObj, true);
+                p->send (payload, true);
                 ++it;
             }
             else
@@ -2258,13 +2263,14 @@ void NetworkOPsImp::pubLedger (
                         = app_.getLedgerMaster ().getCompleteLedgers ();
             }
 
+            InfoSub::Payload const payload (jvObj, "ledger", true);
             auto it = mStreamMaps[sLedger].begin ();
             while (it != mStreamMaps[sLedger].end ())
             {
                 InfoSub::pointer p = it->second.lock ();
                 if (p)
                 {
-                    p->send (jvObj, true);
+                    p->send (payload, true);
                     ++it;
                 }
                 else
@@ -2359,6 +2365,8 @@ void NetworkOPsImp::pubValidatedTransaction (
             jvObj[jss::meta], *alAccepted, stTxn, *txMeta);
     }
 
+    InfoSub::Payload const payload (jvObj, "transactions");
+
     {
         ScopedLockType sl (mSubLock);
 
@@ -2369,7 +2377,7 @@ void NetworkOPsImp::pubValidatedTransaction (
 
             if (p)
             {
-                p->send (jvObj, true);
+                p->send (payload, true);
                 ++it;
             }
             else
@@ -2384,14 +2392,14 @@ void NetworkOPsImp::pubValidatedTransaction (
 
             if (p)
             {
-                p->send (jvObj, true);
+                p->send (payload, true);
                 ++it;
             }
             else
                 it = mStreamMaps[sRTTransactions].erase (it);
         }
     }
-    app_.getOrderBookDB ().processTxn (alAccepted, alTx, jvObj);
+    app_.getOrderBookDB ().processTxn (alAccepted, alTx, payload);
     pubAccountTransaction (alAccepted, alTx, true);
 }
 
@@ -2479,8 +2487,9 @@ void NetworkOPsImp::pubAccountTransaction (
             }
         }
 
+        InfoSub::Payload const payload (jvObj, "accounts");
         for (InfoSub::ref isrListener : notify)
-            isrListener->send (jvObj, true);
+            isrListener->send (payload, true);
     }
 }
 
@@ -2796,10 +2805,121 @@ void NetworkOPsImp::getBookPage (
     uint256         offerIndex;
     unsigned int    uBookEntry;
     STAmount        saDirRate;
+    uint256         prefetched;
 
     auto const rate = transferRate(view, book.out.account);
     auto viewJ = app_.journal ("View");
 
+    auto addOffer = [&](std::shared_ptr<SLE const> const& sleOffer)
+    {
+        auto const uOfferOwnerID =
+                sleOffer->getAccountID (sfAccount);
+        auto const& saTakerGets =
+                sleOffer->getFieldAmount (sfTakerGets);
+        auto const& saTakerPays =
+                sleOffer->getFieldAmount (sfTakerPays);
+        STAmount saOwnerFunds;
+        bool firstOwnerOffer (true);
+
+        if (book.out.account == uOfferOwnerID)
+        {
+            saOwnerFunds    = saTakerGets;
+        }
+        else if (bGlobalFreeze)
+        {
+            saOwnerFunds.clear (book.out);
+        }
+        else
+        {
+            auto umBalanceEntry  = umBalance.find (uOfferOwnerID);
+            if (umBalanceEntry != umBalance.end ())
+            {
+
+                saOwnerFunds    = umBalanceEntry->second;
+                firstOwnerOffer = false;
+            }
+            else
+            {
+
+                saOwnerFunds = accountHolds (view,
+                    uOfferOwnerID, book.out.currency,
+                        book.out.account, fhZERO_IF_FROZEN, viewJ);
+
+                if (saOwnerFunds < beast::zero)
+                {
+
+                    saOwnerFunds.clear ();
+                }
+            }
+        }
+
+        Json::Value jvOffer = sleOffer->getJson (JsonOptions::none);
+
+        STAmount saTakerGetsFunded;
+        STAmount saOwnerFundsLimit = saOwnerFunds;
+        Rate offerRate = parityRate;
+
+        if (rate != parityRate
+            && uTakerID != book.out.account
+            && book.out.account != uOfferOwnerID)
+        {
+            offerRate = rate;
+            saOwnerFundsLimit = divide (
+                saOwnerFunds, offerRate);
+        }
+
+        if (saOwnerFundsLimit >= saTakerGets)
+        {
+            saTakerGetsFunded   = saTakerGets;
+        }
+        else
+        {
+
+            saTakerGetsFunded = saOwnerFundsLimit;
+
+            saTakerGetsFunded.setJson (jvOffer[jss::taker_gets_funded]);
+            std::min (
+                saTakerPays, multiply (
+                    saTakerGetsFunded, saDirRate, saTakerPays.issue ())).setJson
+                    (jvOffer[jss::taker_pays_funded]);
+        }
+
+        STAmount saOwnerPays = (parityRate == offerRate)
+            ? saTakerGetsFunded
+            : std::min (
+                saOwnerFunds,
+                multiply (saTakerGetsFunded, offerRate));
+
+        umBalance[uOfferOwnerID]    = saOwnerFunds - saOwnerPays;
+
+        Json::Value& jvOf = jvOffers.append (jvOffer);
+        jvOf[jss::quality] = saDirRate.getText ();
+
+        if (firstOwnerOffer)
+            jvOf[jss::owner_funds] = saOwnerFunds.getText ();
+    };
+
+    // Hot books in closed ledgers are read once and then served from
+    // memory.
+    auto const snapshot =
+        app_.getOrderBookDB().getBookSnapshot (lpLedger, book);
+    if (snapshot && (snapshot->complete ||
+        iLimit <= snapshot->offers.size ()))
+    {
+        for (auto const& entry : snapshot->offers)
+        {
+            if (iLimit-- == 0)
+                break;
+            if (entry.first != uTipIndex)
+            {
+                uTipIndex = entry.first;
+                saDirRate = amountFromQuality (getQuality (uTipIndex));
+            }
+            addOffer (entry.second);
+        }
+        return;
+    }
+
     while (! bDone && iLimit-- > 0)
     {
         if (bDirectAdvance)
@@ -2836,95 +2956,17 @@ void NetworkOPsImp::getBookPage (
 
         if (!bDone)
         {
+            if (sleOfferDir->key() != prefetched)
+            {
+                prefetched = sleOfferDir->key();
+                prefetchDirectory (view, *sleOfferDir);
+            }
+
             auto sleOffer = view.read(keylet::offer(offerIndex));
 
             if (sleOffer)
             {
-                auto const uOfferOwnerID =
-                        sleOffer->getAccountID (sfAccount);
-                auto const& saTakerGets =
-                        sleOffer->getFieldAmount (sfTakerGets);
-                auto const& saTakerPays =
-                        sleOffer->getFieldAmount (sfTakerPays);
-                STAmount saOwnerFunds;
-                bool firstOwnerOffer (true);
-
-                if (book.out.account == uOfferOwnerID)
-                {
-                    saOwnerFunds    = saTakerGets;
-                }
-                else if (bGlobalFreeze)
-                {
-                    saOwnerFunds.clear (book.out);
-                }
-                else
-                {
-                    auto umBalanceEntry  = umBalance.find (uOfferOwnerID);
-                    if (umBalanceEntry != umBalance.end ())
-                    {
-
-                        saOwnerFunds    = umBalanceEntry->second;
-                        firstOwnerOffer = false;
-                    }
-                    else
-                    {
-
-                        saOwnerFunds = accountHolds (view,
-                            uOfferOwnerID, book.out.currency,
-                                book.out.account, fhZERO_IF_FROZEN, viewJ);
-
-                        if (saOwnerFunds < beast::zero)
-                        {
-
-                            saOwnerFunds.clear ();
-                        }
-                    }
-                }
-
-                Json::Value jvOffer = sleOffer->getJson (JsonOptions::none);
-
-                STAmount saTakerGetsFunded;
-                STAmount saOwnerFundsLimit = saOwnerFunds;
-                Rate offerRate = parityRate;
-
-                if (rate != parityRate
-                    && uTakerID != book.out.account
-                    && book.out.account != uOfferOwnerID)
-                {
-                    offerRate = rate;
-                    saOwnerFundsLimit = divide (
-                        saOwnerFunds, offerRate);
-                }
-
-                if (saOwnerFundsLimit >= saTakerGets)
-                {
-                    saTakerGetsFunded   = saTakerGets;
-                }
-                else
-                {
-
-                    saTakerGetsFunded = saOwnerFundsLimit;
-
-                    saTakerGetsFunded.setJson (jvOffer[jss::taker_gets_funded]);
-                    std::min (
-                        saTakerPays, multiply (
-                            saTakerGetsFunded, saDirRate, saTakerPays.issue ())).setJson
-                            (jvOffer[jss::taker_pays_funded]);
-                }
-
-                STAmount saOwnerPays = (parityRate == offerRate)
-                    ? saTakerGetsFunded
-                    : std::min (
-                        saOwnerFunds,
-                        multiply (saTakerGetsFunded, offerRate));
-
-                umBalance[uOfferOwnerID]    = saOwnerFunds - saOwnerPays;
-
-                Json::Value& jvOf = jvOffers.append (jvOffer);
-                jvOf[jss::quality] = saDirRate.getText ();
-
-                if (firstOwnerOffer)
-                    jvOf[jss::owner_funds] = saOwnerFunds.getText ();
+                addOffer (sleOffer);
             }
             else
             {
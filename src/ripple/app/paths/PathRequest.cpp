@@ -7,6 +7,7 @@
 #include <ripple/app/main/Application.h>
 #include <ripple/app/misc/LoadFeeTrack.h>
 #include <ripple/app/misc/NetworkOPs.h>
+#include <ripple/basics/Arena.h>
 #include <ripple/basics/Log.h>
 #include <ripple/core/Config.h>
 #include <ripple/net/RPCErr.h>
@@ -209,6 +210,9 @@ PathRequest::doCreate (
     std::shared_ptr<RippleLineCache> const& cache,
     Json::Value const& value)
 {
+    // The request outlives the response that creates it, so its values
+    // must not come from the response's arena.
+    Arena::Scope const outside (nullptr, Arena::json);
     bool valid = false;
 
     if (parseJson (value) != PFR_PJ_INVALID)
@@ -415,28 +419,25 @@ Json::Value PathRequest::doStatus (Json::Value const&)
     return jvStatus;
 }
 
-std::unique_ptr<Pathfinder> const&
+std::unique_ptr<Pathfinder>
 PathRequest::getPathFinder(std::shared_ptr<RippleLineCache> const& cache,
-    hash_map<Currency, std::unique_ptr<Pathfinder>>& currency_map,
-        Currency const& currency, STAmount const& dst_amount,
-            int const level)
+    Currency const& currency, STAmount const& dst_amount,
+        int const level, PathDiscoveryCache* shared, std::size_t threads,
+            std::shared_ptr<PathSearchBudget> const& budget)
 {
-    auto i = currency_map.find(currency);
-    if (i != currency_map.end())
-        return i->second;
     auto pathfinder = std::make_unique<Pathfinder>(
         cache, *raSrcAccount, *raDstAccount, currency,
             boost::none, dst_amount, saSendMax, app_);
-    if (pathfinder->findPaths(level))
-        pathfinder->computePathRanks(max_paths_);
+    if (pathfinder->findPaths(level, shared))
+        pathfinder->computePathRanks(max_paths_, threads, budget);
     else
         pathfinder.reset();  
-    return currency_map[currency] = std::move(pathfinder);
+    return pathfinder;
 }
 
 bool
 PathRequest::findPaths (std::shared_ptr<RippleLineCache> const& cache,
-    int const level, Json::Value& jvArray)
+    int const level, Json::Value& jvArray, PathDiscoveryCache* shared)
 {
     auto sourceCurrencies = sciSourceCurrencies;
     if (sourceCurrencies.empty ())
@@ -458,7 +459,32 @@ PathRequest::findPaths (std::shared_ptr<RippleLineCache> const& cache,
     auto const dst_amount = convert_all_ ?
         STAmount(saDstAmount.issue(), STAmount::cMaxValue, STAmount::cMaxOffset)
             : saDstAmount;
+    std::vector<Currency> currencies;
+    for (auto const& issue : sourceCurrencies)
+    {
+        if (currencies.empty() || currencies.back() != issue.currency)
+            currencies.push_back(issue.currency);
+    }
+
+    auto const threads = app_.config().PATH_SEARCH_THREADS;
+    auto const budget = std::make_shared<PathSearchBudget>(
+        app_.config().PATH_SEARCH_BUDGET);
+    std::vector<std::unique_ptr<Pathfinder>> pathfinders(currencies.size());
+    parallelPathSearch(currencies.size(), threads,
+        [&](std::size_t i)
+        {
+            pathfinders[i] = getPathFinder(cache, currencies[i], dst_amount,
+                level, shared, currencies.size() > 1 ? 1 : threads, budget);
+        });
+
     hash_map<Currency, std::unique_ptr<Pathfinder>> currency_map;
+    for (std::size_t i = 0; i < currencies.size(); ++i)
+        currency_map[currencies[i]] = std::move(pathfinders[i]);
+
+    JLOG(m_journal.debug()) << iIdentifier << " Ranked paths for " <<
+        currencies.size() << " currencies in " <<
+        budget->used().count() << "us";
+
     for (auto const& issue : sourceCurrencies)
     {
         JLOG(m_journal.debug())
@@ -466,8 +492,7 @@ PathRequest::findPaths (std::shared_ptr<RippleLineCache> const& cache,
             << " Trying to find paths: "
             << STAmount(issue, 1).getFullText();
 
-        auto& pathfinder = getPathFinder(cache, currency_map,
-            issue.currency, dst_amount, level);
+        auto& pathfinder = currency_map[issue.currency];
         if (! pathfinder)
         {
             assert(false);
@@ -573,7 +598,8 @@ PathRequest::findPaths (std::shared_ptr<RippleLineCache> const& cache,
 }
 
 Json::Value PathRequest::doUpdate(
-    std::shared_ptr<RippleLineCache> const& cache, bool fast)
+    std::shared_ptr<RippleLineCache> const& cache, bool fast,
+        PathDiscoveryCache* shared)
 {
     using namespace std::chrono;
     JLOG(m_journal.debug()) << iIdentifier
@@ -638,7 +664,7 @@ Json::Value PathRequest::doUpdate(
         << " processing at level " << iLevel;
 
     Json::Value jvArray = Json::arrayValue;
-    if (findPaths(cache, iLevel, jvArray))
+    if (findPaths(cache, iLevel, jvArray, shared))
     {
         bLastSuccess = jvArray.size() != 0;
         newStatus[jss::alternatives] = std::move (jvArray);
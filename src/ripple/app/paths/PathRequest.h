@@ -69,7 +69,8 @@ public:
     Json::Value doStatus (Json::Value const&);
 
     Json::Value doUpdate (
-        std::shared_ptr<RippleLineCache> const&, bool fast);
+        std::shared_ptr<RippleLineCache> const&, bool fast,
+            PathDiscoveryCache* shared = nullptr);
     InfoSub::pointer getSubscriber ();
     bool hasCompletion ();
 
@@ -79,14 +80,15 @@ private:
     bool isValid (std::shared_ptr<RippleLineCache> const& crCache);
     void setValid ();
 
-    std::unique_ptr<Pathfinder> const&
-    getPathFinder(std::shared_ptr<RippleLineCache> const&,
-        hash_map<Currency, std::unique_ptr<Pathfinder>>&, Currency const&,
-            STAmount const&, int const);
+    std::unique_ptr<Pathfinder>
+    getPathFinder(std::shared_ptr<RippleLineCache> const&, Currency const&,
+        STAmount const&, int const, PathDiscoveryCache*, std::size_t,
+            std::shared_ptr<PathSearchBudget> const&);
 
     
     bool
-    findPaths (std::shared_ptr<RippleLineCache> const&, int const, Json::Value&);
+    findPaths (std::shared_ptr<RippleLineCache> const&, int const,
+        Json::Value&, PathDiscoveryCache*);
 
     int parseJson (Json::Value const&);
 
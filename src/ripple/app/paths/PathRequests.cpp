@@ -13,6 +13,81 @@
 
 namespace ripple {
 
+static std::uint32_t const LINE_CACHE_MAX_GAP = 8;
+
+static std::uint32_t const LINE_CACHE_MAX_IDLE = 16;
+
+static std::size_t const LINE_CACHE_MAX_LINES = 1000000;
+
+std::shared_ptr<RippleLineCache>
+PathRequests::makeLineCache (
+    std::shared_ptr <ReadView const> const& ledger)
+{
+    if (! mLineCache || ledger->open ())
+        return std::make_shared<RippleLineCache> (ledger, mLineCacheStats);
+
+    auto const& prior = mLineCache->getLedger ()->info ();
+    auto const seq = ledger->info ().seq;
+    if (mLineCache->getLedger ()->open () || (seq <= prior.seq) ||
+            ((seq - prior.seq) > LINE_CACHE_MAX_GAP))
+        return std::make_shared<RippleLineCache> (ledger, mLineCacheStats);
+
+    hash_set<AccountID> changed;
+    std::shared_ptr<ReadView const> view = ledger;
+    try
+    {
+        for (;;)
+        {
+            if (! RippleLineCache::getChangedAccounts (*view, changed))
+                return std::make_shared<RippleLineCache> (
+                    ledger, mLineCacheStats);
+
+            if (view->info ().seq == prior.seq + 1)
+            {
+                if (view->info ().parentHash != prior.hash)
+                    return std::make_shared<RippleLineCache> (
+                        ledger, mLineCacheStats);
+                break;
+            }
+
+            view = app_.getLedgerMaster ().getLedgerByHash (
+                view->info ().parentHash);
+            if (! view)
+                return std::make_shared<RippleLineCache> (
+                    ledger, mLineCacheStats);
+        }
+    }
+    catch (std::exception const&)
+    {
+        return std::make_shared<RippleLineCache> (ledger, mLineCacheStats);
+    }
+
+    JLOG (mJournal.debug()) <<
+        "Line cache carried from " << prior.seq << " to " << seq <<
+        ", " << changed.size () << " accounts changed";
+
+    return std::make_shared<RippleLineCache> (ledger, *mLineCache, changed,
+        LINE_CACHE_MAX_LINES, LINE_CACHE_MAX_IDLE);
+}
+
+float
+PathRequests::getLineCacheHitRate () const
+{
+    auto const hits = static_cast<float> (mLineCacheStats->hits.load ());
+    auto const total = hits + mLineCacheStats->misses.load ();
+    return hits * (100.0f / std::max (1.0f, total));
+}
+
+std::size_t
+PathRequests::getLineCacheSize ()
+{
+    std::shared_ptr<RippleLineCache> cache;
+    {
+        ScopedLockType sl (mLock);
+        cache = mLineCache;
+    }
+    return cache ? cache->size () : 0;
+}
 
 std::shared_ptr<RippleLineCache>
 PathRequests::getLineCache (
@@ -29,7 +104,7 @@ PathRequests::getLineCache (
          (authoritative && ((lgrSeq + 8)  < lineSeq)) ||   
          (lgrSeq > (lineSeq + 8)))                         
     {
-        mLineCache = std::make_shared<RippleLineCache> (ledger);
+        mLineCache = makeLineCache (ledger);
     }
     return mLineCache;
 }
@@ -43,6 +118,7 @@ void PathRequests::updateAll (std::shared_ptr <ReadView const> const& inLedger,
 
     std::vector<PathRequest::wptr> requests;
     std::shared_ptr<RippleLineCache> cache;
+    PathDiscoveryCache discovery;
 
     {
         ScopedLockType sl (mLock);
@@ -79,7 +155,8 @@ void PathRequests::updateAll (std::shared_ptr <ReadView const> const& inLedger,
                     {
                         if (!ipSub->getConsumer ().warn ())
                         {
-                            Json::Value update = request->doUpdate (cache, false);
+                            Json::Value update = request->doUpdate (
+                                cache, false, &discovery);
                             request->updateComplete ();
                             update[jss::type] = "path_find";
                             ipSub->send (update, false);
@@ -89,7 +166,7 @@ void PathRequests::updateAll (std::shared_ptr <ReadView const> const& inLedger,
                     }
                     else if (request->hasCompletion ())
                     {
-                        request->doUpdate (cache, false);
+                        request->doUpdate (cache, false, &discovery);
                         request->updateComplete();
                         ++processed;
                     }
@@ -144,14 +221,19 @@ void PathRequests::updateAll (std::shared_ptr <ReadView const> const& inLedger,
             if (requests_.empty())
                 break;
             requests = requests_;
+            auto const prior = cache;
             cache = getLineCache (cache->getLedger(), false);
+            if (cache != prior)
+                discovery.clear ();
         }
     }
     while (!shouldCancel ());
 
     JLOG (mJournal.debug()) <<
         "updateAll complete: " << processed << " processed and " <<
-        removed << " removed";
+        removed << " removed, " << discovery.hits () << " of " <<
+        (discovery.hits () + discovery.misses ()) <<
+        " path searches shared";
 }
 
 void PathRequests::insertPathRequest (
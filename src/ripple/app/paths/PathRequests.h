@@ -21,6 +21,7 @@ public:
             beast::Journal journal, beast::insight::Collector::ptr const& collector)
         : app_ (app)
         , mJournal (journal)
+        , mLineCacheStats (std::make_shared<RippleLineCache::Stats> ())
         , mLastIdentifier (0)
     {
         mFast = collector->make_event ("pathfind_fast");
@@ -61,9 +62,16 @@ public:
         mFull.notify (ms);
     }
 
+    float getLineCacheHitRate () const;
+
+    std::size_t getLineCacheSize ();
+
 private:
     void insertPathRequest (PathRequest::pointer const&);
 
+    std::shared_ptr<RippleLineCache> makeLineCache (
+        std::shared_ptr <ReadView const> const& ledger);
+
     Application& app_;
     beast::Journal                   mJournal;
 
@@ -73,6 +81,7 @@ private:
     std::vector<PathRequest::wptr> requests_;
 
     std::shared_ptr<RippleLineCache>         mLineCache;
+    std::shared_ptr<RippleLineCache::Stats>  mLineCacheStats;
 
     std::atomic<int>                 mLastIdentifier;
 
@@ -123,7 +123,35 @@ Pathfinder::Pathfinder (
     assert (! uSrcIssuer || isXRP(uSrcCurrency) == isXRP(uSrcIssuer.get()));
 }
 
-bool Pathfinder::findPaths (int searchLevel)
+std::shared_ptr<STPathSet const>
+PathDiscoveryCache::find (Key const& key)
+{
+    std::lock_guard<std::mutex> sl (lock_);
+    auto const it = paths_.find (key);
+    if (it == paths_.end ())
+    {
+        ++misses_;
+        return {};
+    }
+    ++hits_;
+    return it->second;
+}
+
+void
+PathDiscoveryCache::insert (Key const& key, STPathSet const& paths)
+{
+    std::lock_guard<std::mutex> sl (lock_);
+    paths_.emplace (key, std::make_shared<STPathSet const> (paths));
+}
+
+void
+PathDiscoveryCache::clear ()
+{
+    std::lock_guard<std::mutex> sl (lock_);
+    paths_.clear ();
+}
+
+bool Pathfinder::findPaths (int searchLevel, PathDiscoveryCache* shared)
 {
     if (mDstAmount == beast::zero)
     {
@@ -236,6 +264,19 @@ bool Pathfinder::findPaths (int searchLevel)
         paymentType = pt_nonXRP_to_nonXRP;
     }
 
+    auto const key = std::make_tuple (mSrcAccount, mDstAccount,
+        mDstAmount.issue (), mSrcCurrency, mSrcIssuer, searchLevel);
+    if (shared)
+    {
+        if (auto const paths = shared->find (key))
+        {
+            mCompletePaths = *paths;
+            JLOG (j_.debug())
+                    << mCompletePaths.size () << " complete paths shared";
+            return true;
+        }
+    }
+
     for (auto const& costedPath : mPathTable[paymentType])
     {
         if (costedPath.searchLevel <= searchLevel)
@@ -250,6 +291,9 @@ bool Pathfinder::findPaths (int searchLevel)
     JLOG (j_.debug())
             << mCompletePaths.size () << " complete paths found";
 
+    if (shared)
+        shared->insert (key, mCompletePaths);
+
     return true;
 }
 
@@ -324,8 +368,13 @@ STAmount smallestUsefulAmount (STAmount const& amount, int maxPaths)
 
 } 
 
-void Pathfinder::computePathRanks (int maxPaths)
+void Pathfinder::computePathRanks (int maxPaths, std::size_t threads,
+    std::shared_ptr<PathSearchBudget> const& budget)
 {
+    mThreads = std::max<std::size_t> (1, threads);
+    mBudget = budget;
+
+    auto const start = PathSearchBudget::clock_type::now ();
     mRemainingAmount = convert_all_ ?
         STAmount(mDstAmount.issue(), STAmount::cMaxValue,
             STAmount::cMaxOffset)
@@ -364,6 +413,9 @@ void Pathfinder::computePathRanks (int maxPaths)
         JLOG (j_.debug()) << "Default path causes exception";
     }
 
+    if (mBudget)
+        mBudget->charge (start);
+
     rankPaths (maxPaths, mCompletePaths, mPathRanks);
 }
 
@@ -401,15 +453,22 @@ void Pathfinder::rankPaths (
         saMinDstAmount = smallestUsefulAmount(mDstAmount, maxPaths);
     }
 
-    for (int i = 0; i < paths.size (); ++i)
-    {
-        auto const& currentPath = paths[i];
-        if (! currentPath.empty())
+    std::vector<boost::optional<PathRank>> ranks (paths.size ());
+    parallelPathSearch (paths.size (), mThreads,
+        [&](std::size_t i)
         {
+            auto const& currentPath = paths[i];
+            if (currentPath.empty() || (mBudget && mBudget->exhausted ()))
+                return;
+
+            auto const start = PathSearchBudget::clock_type::now ();
             STAmount liquidity;
             uint64_t uQuality;
             auto const resultCode = getPathLiquidity (
                 currentPath, saMinDstAmount, liquidity, uQuality);
+            if (mBudget)
+                mBudget->charge (start);
+
             if (resultCode != tesSUCCESS)
             {
                 JLOG (j_.debug()) <<
@@ -423,10 +482,22 @@ void Pathfinder::rankPaths (
                     "findPaths: quality: " << uQuality <<
                     ": " << currentPath.getJson (JsonOptions::none);
 
-                rankedPaths.push_back ({uQuality,
-                    currentPath.size (), liquidity, i});
+                ranks[i] = PathRank {uQuality, currentPath.size (),
+                    liquidity, static_cast<int> (i)};
             }
-        }
+        });
+
+    for (auto& rank : ranks)
+    {
+        if (rank)
+            rankedPaths.push_back (std::move (*rank));
+    }
+
+    if (mBudget && mBudget->exhausted ())
+    {
+        JLOG (j_.debug()) << "findPaths: search budget exhausted after " <<
+            mBudget->used ().count () << "us, ranked " <<
+            rankedPaths.size () << " of " << paths.size () << " paths";
     }
 
     std::sort(rankedPaths.begin(), rankedPaths.end(),
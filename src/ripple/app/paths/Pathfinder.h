@@ -8,9 +8,120 @@
 #include <ripple/core/LoadEvent.h>
 #include <ripple/protocol/STAmount.h>
 #include <ripple/protocol/STPathSet.h>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <tuple>
+#include <vector>
 
 namespace ripple {
 
+class PathSearchBudget
+{
+public:
+    using clock_type = std::chrono::steady_clock;
+
+    explicit PathSearchBudget (std::chrono::microseconds limit)
+        : limit_ (limit.count ())
+    {
+    }
+
+    bool exhausted () const
+    {
+        return limit_ != 0 && used_ >= limit_;
+    }
+
+    void charge (clock_type::time_point start)
+    {
+        used_ += std::chrono::duration_cast<std::chrono::microseconds> (
+            clock_type::now () - start).count ();
+    }
+
+    std::chrono::microseconds used () const
+    {
+        return std::chrono::microseconds (used_.load ());
+    }
+
+private:
+    std::chrono::microseconds::rep const limit_;
+    std::atomic<std::chrono::microseconds::rep> used_ {0};
+};
+
+// The first exception stops the search and is rethrown once every thread
+// has been joined.
+template <class F>
+void
+parallelPathSearch (std::size_t n, std::size_t threads, F&& f)
+{
+    std::atomic<std::size_t> next {0};
+    std::exception_ptr error;
+    std::mutex errorLock;
+    auto worker = [&]()
+    {
+        try
+        {
+            for (auto i = next++; i < n; i = next++)
+                f (i);
+        }
+        catch (...)
+        {
+            next = n;
+            std::lock_guard<std::mutex> lock (errorLock);
+            if (! error)
+                error = std::current_exception ();
+        }
+    };
+
+    std::vector<std::thread> pool;
+    threads = std::min (threads, n);
+    try
+    {
+        for (std::size_t i = 1; i < threads; ++i)
+            pool.emplace_back (worker);
+    }
+    catch (std::system_error const&)
+    {
+        // Carry on with the threads that did start
+    }
+    worker ();
+    for (auto& t : pool)
+        t.join ();
+    if (error)
+        std::rethrow_exception (error);
+}
+
+class PathDiscoveryCache
+{
+public:
+    using Key = std::tuple<AccountID, AccountID, Issue, Currency,
+        boost::optional<AccountID>, int>;
+
+    std::shared_ptr<STPathSet const> find (Key const& key);
+
+    void insert (Key const& key, STPathSet const& paths);
+
+    void clear ();
+
+    std::size_t hits () const
+    {
+        return hits_;
+    }
+
+    std::size_t misses () const
+    {
+        return misses_;
+    }
+
+private:
+    std::mutex lock_;
+    std::map<Key, std::shared_ptr<STPathSet const>> paths_;
+    std::size_t hits_ = 0;
+    std::size_t misses_ = 0;
+};
 
 class Pathfinder
 {
@@ -31,10 +142,12 @@ public:
 
     static void initPathTable ();
 
-    bool findPaths (int searchLevel);
+    bool findPaths (int searchLevel,
+        PathDiscoveryCache* shared = nullptr);
 
     
-    void computePathRanks (int maxPaths);
+    void computePathRanks (int maxPaths, std::size_t threads = 1,
+        std::shared_ptr<PathSearchBudget> const& budget = {});
 
     
     STPathSet
@@ -126,6 +239,9 @@ private:
     STAmount mRemainingAmount;
     bool convert_all_;
 
+    std::size_t mThreads = 1;
+    std::shared_ptr<PathSearchBudget> mBudget;
+
     std::shared_ptr <ReadView const> mLedger;
     std::unique_ptr<LoadEvent> m_loadEvent;
     std::shared_ptr<RippleLineCache> mRLCache;
@@ -2,15 +2,103 @@
 
 #include <ripple/app/paths/RippleLineCache.h>
 #include <ripple/ledger/OpenView.h>
+#include <algorithm>
 
 namespace ripple {
 
 RippleLineCache::RippleLineCache(
-    std::shared_ptr <ReadView const> const& ledger)
+    std::shared_ptr <ReadView const> const& ledger,
+    std::shared_ptr <Stats> stats)
+    : stats_ (std::move (stats))
 {
     mLedger = std::make_shared<OpenView>(&*ledger, ledger);
 }
 
+RippleLineCache::RippleLineCache(
+    std::shared_ptr <ReadView const> const& ledger,
+    RippleLineCache& prior,
+    hash_set <AccountID> const& changed,
+    std::size_t maxLines,
+    std::uint32_t maxIdle)
+    : hasher_ (prior.hasher_)
+    , stats_ (prior.stats_)
+{
+    mLedger = std::make_shared<OpenView>(&*ledger, ledger);
+    auto const seq = ledger->info().seq;
+
+    std::lock_guard <std::mutex> sl (prior.mLock);
+
+    std::vector <decltype(lines_)::const_iterator> kept;
+    kept.reserve (prior.lines_.size ());
+    for (auto it = prior.lines_.cbegin (); it != prior.lines_.cend (); ++it)
+    {
+        if ((it->second.used + maxIdle >= seq) &&
+                (changed.count (it->first.account_) == 0))
+            kept.push_back (it);
+    }
+
+    std::sort (kept.begin (), kept.end (),
+        [](auto const& a, auto const& b)
+        {
+            return a->second.used > b->second.used;
+        });
+
+    lines_.reserve (kept.size ());
+    for (auto const& it : kept)
+    {
+        auto const n = it->second.lines->size ();
+        if (size_ + n > maxLines)
+            continue;
+        lines_.emplace (it->first, it->second);
+        size_ += n;
+    }
+}
+
+bool
+RippleLineCache::getChangedAccounts (
+    ReadView const& ledger, hash_set <AccountID>& accounts)
+{
+    for (auto const& item : ledger.txs)
+    {
+        if (! item.second)
+            return false;
+
+        for (auto const& node : item.second->getFieldArray (sfAffectedNodes))
+        {
+            auto const type = node.getFieldU16 (sfLedgerEntryType);
+            if (type != ltRIPPLE_STATE && type != ltACCOUNT_ROOT)
+                continue;
+
+            if (type == ltACCOUNT_ROOT && node.getFName () == sfModifiedNode)
+                continue;
+
+            auto data = dynamic_cast<STObject const*> (
+                node.peekAtPField (sfNewFields));
+            if (! data)
+                data = dynamic_cast<STObject const*> (
+                    node.peekAtPField (sfFinalFields));
+            if (! data)
+                return false;
+
+            if (type == ltACCOUNT_ROOT)
+            {
+                if (! data->isFieldPresent (sfAccount))
+                    return false;
+                accounts.insert (data->getAccountID (sfAccount));
+            }
+            else
+            {
+                if (! data->isFieldPresent (sfLowLimit) ||
+                        ! data->isFieldPresent (sfHighLimit))
+                    return false;
+                accounts.insert (data->getFieldAmount (sfLowLimit).getIssuer ());
+                accounts.insert (data->getFieldAmount (sfHighLimit).getIssuer ());
+            }
+        }
+    }
+    return true;
+}
+
 std::vector<RippleState::pointer> const&
 RippleLineCache::getRippleLines (AccountID const& accountID)
 {
@@ -18,14 +106,30 @@ RippleLineCache::getRippleLines (AccountID const& accountID)
 
     std::lock_guard <std::mutex> sl (mLock);
 
-    auto it = lines_.emplace (key,
-        std::vector<RippleState::pointer>());
+    auto it = lines_.emplace (key, Entry ());
 
     if (it.second)
-        it.first->second = getRippleStateItems (
-            accountID, *mLedger);
+    {
+        ++stats_->misses;
+        auto lines = std::make_shared <std::vector<RippleState::pointer>> (
+            getRippleStateItems (accountID, *mLedger));
+        size_ += lines->size ();
+        it.first->second.lines = std::move (lines);
+    }
+    else
+    {
+        ++stats_->hits;
+    }
+
+    it.first->second.used = mLedger->info().seq;
+    return *it.first->second.lines;
+}
 
-    return it.first->second;
+std::size_t
+RippleLineCache::size ()
+{
+    std::lock_guard <std::mutex> sl (mLock);
+    return size_;
 }
 
 } 
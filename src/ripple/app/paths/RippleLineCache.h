@@ -6,6 +6,7 @@
 #include <ripple/app/ledger/Ledger.h>
 #include <ripple/app/paths/RippleState.h>
 #include <ripple/basics/hardened_hash.h>
+#include <atomic>
 #include <cstddef>
 #include <memory>
 #include <mutex>
@@ -16,9 +17,30 @@ namespace ripple {
 class RippleLineCache
 {
 public:
+    struct Stats
+    {
+        std::atomic<std::uint64_t> hits {0};
+        std::atomic<std::uint64_t> misses {0};
+    };
+
     explicit
     RippleLineCache (
-        std::shared_ptr <ReadView const> const& l);
+        std::shared_ptr <ReadView const> const& l,
+        std::shared_ptr <Stats> stats = std::make_shared<Stats> ());
+
+    
+    RippleLineCache (
+        std::shared_ptr <ReadView const> const& l,
+        RippleLineCache& prior,
+        hash_set <AccountID> const& changed,
+        std::size_t maxLines,
+        std::uint32_t maxIdle);
+
+    
+    static
+    bool
+    getChangedAccounts (ReadView const& ledger,
+        hash_set <AccountID>& accounts);
 
     std::shared_ptr <ReadView const> const&
     getLedger () const
@@ -29,11 +51,16 @@ public:
     std::vector<RippleState::pointer> const&
     getRippleLines (AccountID const& accountID);
 
+    std::size_t
+    size ();
+
 private:
     std::mutex mLock;
 
     ripple::hardened_hash<> hasher_;
     std::shared_ptr <ReadView const> mLedger;
+    std::shared_ptr <Stats> stats_;
+    std::size_t size_ = 0;
 
     struct AccountKey
     {
@@ -73,9 +100,15 @@ private:
         };
     };
 
+    struct Entry
+    {
+        std::shared_ptr <std::vector <RippleState::pointer> const> lines;
+        std::uint32_t used;
+    };
+
     hash_map <
         AccountKey,
-        std::vector <RippleState::pointer>,
+        Entry,
         AccountKey::Hash> lines_;
 };
 
@@ -23,9 +23,28 @@ ApplyContext::ApplyContext(Application& app_,
     , base_ (base)
     , flags_(flags)
 {
+    if (app.config().APPLY_ARENA)
+    {
+        arena_ = Arena::create();
+        scope_.emplace(arena_);
+    }
     view_.emplace(&base_, flags_);
 }
 
+ApplyContext::~ApplyContext()
+{
+    if (arena_)
+    {
+        view_.reset();
+        scope_.reset();
+        auto const& stats = arena_->stats();
+        JLOG(journal.trace()) << "Arena: " << stats.allocations <<
+            " allocations, " << stats.bytes << " bytes in " <<
+            stats.blocks << " blocks";
+        arena_->release();
+    }
+}
+
 void
 ApplyContext::discard()
 {
@@ -5,6 +5,7 @@
 
 #include <ripple/app/main/Application.h>
 #include <ripple/ledger/ApplyViewImpl.h>
+#include <ripple/basics/Arena.h>
 #include <ripple/core/Config.h>
 #include <ripple/protocol/STTx.h>
 #include <ripple/protocol/XRPAmount.h>
@@ -25,6 +26,11 @@ public:
             std::uint64_t baseFee, ApplyFlags flags,
                 beast::Journal = beast::Journal{beast::Journal::getNullSink()});
 
+    ApplyContext (ApplyContext const&) = delete;
+    ApplyContext& operator= (ApplyContext const&) = delete;
+
+    ~ApplyContext ();
+
     Application& app;
     STTx const& tx;
     TER const preclaimResult;
@@ -96,6 +102,8 @@ private:
 
     OpenView& base_;
     ApplyFlags flags_;
+    Arena* arena_ = nullptr;
+    boost::optional<Arena::Scope> scope_;
     boost::optional<ApplyViewImpl> view_;
 };
 
@@ -38,6 +38,14 @@ BookTip::step (beast::Journal j)
 
         if (dirFirst (view_, *first_page, dir, di, m_index, j))
         {
+            // Start loading the rest of this page while the first
+            // offer on it is consumed.
+            if (dir->key() != m_prefetched)
+            {
+                m_prefetched = dir->key();
+                prefetchDirectory (view_, *dir);
+            }
+
             m_dir = dir->key();
             m_entry = view_.peek(keylet::offer(m_index));
             m_quality = Quality (getQuality (*first_page));
@@ -23,6 +23,7 @@ private:
     uint256 m_end;
     uint256 m_dir;
     uint256 m_index;
+    uint256 m_prefetched;
     std::shared_ptr<SLE> m_entry;
     Quality m_quality;
 
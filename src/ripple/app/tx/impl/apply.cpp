@@ -65,7 +65,9 @@ forceValidity(HashRouter& router, uint256 const& txid,
         flags |= SF_LOCALGOOD;
     case Validity::SigGoodOnly:
         flags |= SF_SIGGOOD;
+        break;
     case Validity::SigBad:
+        flags |= SF_SIGBAD;
         break;
     }
     if (flags)
@@ -0,0 +1,220 @@
+#ifndef RIPPLE_BASICS_ARENA_H_INCLUDED
+#define RIPPLE_BASICS_ARENA_H_INCLUDED
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
+namespace ripple {
+
+class Arena
+{
+public:
+    /** Each kind of allocation has its own current arena per thread. */
+    enum Kind
+    {
+        objects = 0,
+        json,
+        kinds
+    };
+
+    struct Stats
+    {
+        std::size_t allocations = 0;
+        std::size_t bytes = 0;
+        std::size_t blocks = 0;
+    };
+
+    class Scope
+    {
+    public:
+        explicit Scope (Arena* arena, Kind kind = objects)
+            : kind_ (kind)
+            , prior_ (current (kind))
+        {
+            current (kind) = arena;
+        }
+
+        Scope (Scope const&) = delete;
+        Scope& operator= (Scope const&) = delete;
+
+        ~Scope ()
+        {
+            current (kind_) = prior_;
+        }
+
+    private:
+        Kind kind_;
+        Arena* prior_;
+    };
+
+    /** The current arena of each kind on a thread. */
+    using Current = std::array<Arena*, kinds>;
+
+    /** Makes `arenas` the thread's current arenas and returns the ones
+        they replace. A coroutine uses this to take its arenas with it
+        when it yields, and to restore them on whichever thread resumes it.
+    */
+    static
+    Current
+    exchange (Current const& arenas)
+    {
+        auto& current = currents ();
+        auto const prior = current;
+        current = arenas;
+        return prior;
+    }
+
+    Arena (Arena const&) = delete;
+    Arena& operator= (Arena const&) = delete;
+
+    static
+    Arena*
+    create ();
+
+    void
+    release ();
+
+    Stats const&
+    stats () const
+    {
+        return stats_;
+    }
+
+    /** Totals over every arena released so far. */
+    static
+    Stats
+    totals ();
+
+    /** True if the thread has a current arena of the given kind. */
+    static
+    bool
+    active (Kind kind = objects)
+    {
+        return current (kind) != nullptr;
+    }
+
+    /** Returns memory from the thread's current arena of the given kind,
+        or nullptr if there is none or it cannot serve the request. The
+        caller then allocates from the heap as it otherwise would.
+    */
+    static
+    void*
+    allocate (std::size_t bytes, Kind kind = objects)
+    {
+        auto const arena = current (kind);
+        return arena ? arena->bump (bytes) : nullptr;
+    }
+
+    /** True if p was returned by allocate. */
+    static
+    bool
+    owns (void const* p) noexcept
+    {
+        auto const address = reinterpret_cast<std::uintptr_t> (p);
+        return address >= regionBegin_.load (std::memory_order_relaxed) &&
+            address < regionEnd_.load (std::memory_order_relaxed);
+    }
+
+    /** Frees memory returned by allocate. */
+    static
+    void
+    deallocate (void* p) noexcept;
+
+private:
+    // Arena blocks are carved from one address range reserved on first
+    // use, so owns() can tell them from the heap without a header.
+    struct Block
+    {
+        Arena* arena;
+        Block* next;
+    };
+
+    static std::atomic<std::uintptr_t> regionBegin_;
+    static std::atomic<std::uintptr_t> regionEnd_;
+
+    Arena () = default;
+    ~Arena ();
+
+    static
+    Current&
+    currents ()
+    {
+        static thread_local Current arenas = {};
+        return arenas;
+    }
+
+    static
+    Arena*&
+    current (Kind kind)
+    {
+        return currents ()[kind];
+    }
+
+    void*
+    bump (std::size_t bytes);
+
+    std::atomic<std::size_t> refs_ {1};
+    Block* blocks_ = nullptr;
+    std::uint8_t* free_ = nullptr;
+    std::size_t remain_ = 0;
+    Stats stats_;
+};
+
+template <class T, Arena::Kind kind = Arena::objects>
+class ArenaAllocator
+{
+public:
+    using value_type = T;
+
+    template <class U>
+    struct rebind
+    {
+        using other = ArenaAllocator<U, kind>;
+    };
+
+    ArenaAllocator () = default;
+
+    template <class U>
+    ArenaAllocator (ArenaAllocator<U, kind> const&)
+    {
+    }
+
+    T*
+    allocate (std::size_t n)
+    {
+        if (auto const p = Arena::allocate (n * sizeof (T), kind))
+            return static_cast<T*> (p);
+        return std::allocator<T> ().allocate (n);
+    }
+
+    void
+    deallocate (T* p, std::size_t n)
+    {
+        if (Arena::owns (p))
+            Arena::deallocate (p);
+        else
+            std::allocator<T> ().deallocate (p, n);
+    }
+
+    template <class U>
+    bool
+    operator== (ArenaAllocator<U, kind> const&) const
+    {
+        return true;
+    }
+
+    template <class U>
+    bool
+    operator!= (ArenaAllocator<U, kind> const&) const
+    {
+        return false;
+    }
+};
+
+}
+
+#endif
@@ -0,0 +1,181 @@
+#include <ripple/basics/Arena.h>
+#include <algorithm>
+#include <cstdlib>
+#include <mutex>
+#include <vector>
+
+namespace ripple {
+
+namespace {
+
+std::atomic<std::size_t> totalAllocations {0};
+std::atomic<std::size_t> totalBytes {0};
+std::atomic<std::size_t> totalBlocks {0};
+
+std::size_t constexpr blockSize = 16 * 1024;
+
+// 64MB of address space, only touched as blocks are used
+std::size_t constexpr regionBlocks = 4096;
+
+std::size_t constexpr alignment = alignof (std::max_align_t);
+
+class Region
+{
+public:
+    Region ()
+    {
+        auto const p = static_cast<std::uint8_t*> (
+            std::malloc ((regionBlocks + 1) * blockSize));
+        if (p)
+        {
+            auto const begin =
+                (reinterpret_cast<std::uintptr_t> (p) + blockSize - 1) &
+                    ~(blockSize - 1);
+            next_ = reinterpret_cast<std::uint8_t*> (begin);
+            end_ = next_ + regionBlocks * blockSize;
+        }
+    }
+
+    std::uint8_t*
+    begin () const
+    {
+        return end_ - regionBlocks * blockSize;
+    }
+
+    std::uint8_t*
+    end () const
+    {
+        return end_;
+    }
+
+    void*
+    take ()
+    {
+        std::lock_guard<std::mutex> lock (mutex_);
+        if (! free_.empty ())
+        {
+            auto const p = free_.back ();
+            free_.pop_back ();
+            return p;
+        }
+        if (next_ == end_)
+            return nullptr;
+        auto const p = next_;
+        next_ += blockSize;
+        return p;
+    }
+
+    void
+    give (void* p)
+    {
+        std::lock_guard<std::mutex> lock (mutex_);
+        free_.push_back (p);
+    }
+
+private:
+    std::mutex mutex_;
+    std::uint8_t* next_ = nullptr;
+    std::uint8_t* end_ = nullptr;
+    std::vector<void*> free_;
+};
+
+Region&
+region ()
+{
+    static Region r;
+    return r;
+}
+
+}
+
+std::atomic<std::uintptr_t> Arena::regionBegin_ {0};
+std::atomic<std::uintptr_t> Arena::regionEnd_ {0};
+
+Arena::~Arena ()
+{
+    totalAllocations += stats_.allocations;
+    totalBytes += stats_.bytes;
+    totalBlocks += stats_.blocks;
+    while (blocks_)
+    {
+        auto const next = blocks_->next;
+        region ().give (blocks_);
+        blocks_ = next;
+    }
+}
+
+Arena*
+Arena::create ()
+{
+    static bool const reserved = []
+    {
+        auto const& r = region ();
+        if (r.end ())
+        {
+            regionBegin_ = reinterpret_cast<std::uintptr_t> (r.begin ());
+            regionEnd_ = reinterpret_cast<std::uintptr_t> (r.end ());
+        }
+        return true;
+    }();
+    (void) reserved;
+    return new Arena;
+}
+
+Arena::Stats
+Arena::totals ()
+{
+    Stats stats;
+    stats.allocations = totalAllocations.load ();
+    stats.bytes = totalBytes.load ();
+    stats.blocks = totalBlocks.load ();
+    return stats;
+}
+
+void
+Arena::release ()
+{
+    if (--refs_ == 0)
+        delete this;
+}
+
+void*
+Arena::bump (std::size_t bytes)
+{
+    std::size_t constexpr header =
+        (sizeof (Block) + alignment - 1) & ~(alignment - 1);
+
+    bytes = std::max<std::size_t> (
+        (bytes + alignment - 1) & ~(alignment - 1), alignment);
+    if (bytes > remain_)
+    {
+        if (bytes > blockSize - header)
+            return nullptr;
+        auto const b = static_cast<Block*> (region ().take ());
+        if (! b)
+            return nullptr;
+        b->arena = this;
+        b->next = blocks_;
+        blocks_ = b;
+        free_ = reinterpret_cast<std::uint8_t*> (b) + header;
+        remain_ = blockSize - header;
+        ++stats_.blocks;
+    }
+
+    auto const p = free_;
+    free_ += bytes;
+    remain_ -= bytes;
+    ++stats_.allocations;
+    stats_.bytes += bytes;
+    ++refs_;
+    return p;
+}
+
+void
+Arena::deallocate (void* p) noexcept
+{
+    auto const block = reinterpret_cast<Block*> (
+        reinterpret_cast<std::uintptr_t> (p) & ~(blockSize - 1));
+    block->arena->release ();
+}
+
+}
@@ -11,6 +11,7 @@
 #include <ripple/consensus/LedgerTrie.h>
 #include <ripple/protocol/PublicKey.h>
 #include <boost/optional.hpp>
+#include <algorithm>
 #include <mutex>
 #include <utility>
 #include <vector>
@@ -121,52 +122,118 @@ class Validations
 
     using ScopedLock = std::lock_guard<Mutex>;
 
+    using SlotIndex = std::uint32_t;
+
+    struct Slot
+    {
+        explicit Slot(NodeID const& n) : nodeID(n)
+        {
+        }
+
+        NodeID nodeID;
+
+        boost::optional<Validation> current;
+
+        SeqEnforcer<Seq> enforcer;
+
+        boost::optional<Ledger> lastLedger;
+    };
+
+    struct LedgerValidations
+    {
+        std::vector<std::pair<SlotIndex, Validation>> validations;
+
+        std::size_t trusted = 0;
+    };
+
     mutable Mutex mutex_;
 
-    hash_map<NodeID, Validation> current_;
+    hash_map<NodeID, SlotIndex> index_;
 
-    SeqEnforcer<Seq> localSeqEnforcer_;
+    std::vector<Slot> slots_;
 
-    hash_map<NodeID, SeqEnforcer<Seq>> seqEnforcers_;
+    std::size_t numCurrent_ = 0;
+
+    NetClock::time_point lastNow_;
+
+    NetClock::time_point nextExpiry_;
+
+    SeqEnforcer<Seq> localSeqEnforcer_;
 
     beast::aged_unordered_map<
         ID,
-        hash_map<NodeID, Validation>,
+        LedgerValidations,
         std::chrono::steady_clock,
         beast::uhash<>>
         byLedger_;
 
     LedgerTrie<Ledger> trie_;
 
-    hash_map<NodeID, Ledger> lastLedger_;
-
-    hash_map<std::pair<Seq, ID>, hash_set<NodeID>> acquiring_;
+    hash_map<std::pair<Seq, ID>, hash_set<SlotIndex>> acquiring_;
 
     ValidationParms const parms_;
 
     Adaptor adaptor_;
 
 private:
+    static bool
+    counted(Validation const& v)
+    {
+        return v.trusted() && v.full();
+    }
+
+    SlotIndex
+    slot(ScopedLock const&, NodeID const& nodeID)
+    {
+        auto const ins = index_.emplace(nodeID, SlotIndex(slots_.size()));
+        if (ins.second)
+            slots_.emplace_back(nodeID);
+        return ins.first->second;
+    }
+
     void
-    removeTrie(ScopedLock const&, NodeID const& nodeID, Validation const& val)
+    addByLedger(ScopedLock const&, SlotIndex i, Validation const& val)
     {
+        LedgerValidations& entry = byLedger_[val.ledgerID()];
+        auto it = std::lower_bound(
+            entry.validations.begin(),
+            entry.validations.end(),
+            i,
+            [](auto const& v, SlotIndex s) { return v.first < s; });
+        if (it != entry.validations.end() && it->first == i)
         {
-            auto it =
-                acquiring_.find(std::make_pair(val.seq(), val.ledgerID()));
-            if (it != acquiring_.end())
-            {
-                it->second.erase(nodeID);
-                if (it->second.empty())
-                    acquiring_.erase(it);
-            }
+            if (counted(it->second))
+                --entry.trusted;
+            it->second = val;
         }
+        else
+            entry.validations.emplace(it, i, val);
+        if (counted(val))
+            ++entry.trusted;
+    }
+
+    void
+    removeAcquiring(std::pair<Seq, ID> const& key, SlotIndex i)
+    {
+        auto it = acquiring_.find(key);
+        if (it != acquiring_.end())
         {
-            auto it = lastLedger_.find(nodeID);
-            if (it != lastLedger_.end() && it->second.id() == val.ledgerID())
-            {
-                trie_.remove(it->second);
-                lastLedger_.erase(nodeID);
-            }
+            it->second.erase(i);
+            if (it->second.empty())
+                acquiring_.erase(it);
+        }
+    }
+
+    void
+    removeTrie(ScopedLock const&, SlotIndex i, Validation const& val)
+    {
+        removeAcquiring(std::make_pair(val.seq(), val.ledgerID()), i);
+
+        auto& last = slots_[i].lastLedger;
+        if (last && last->id() == val.ledgerID())
+        {
+            trie_.remove(*last);
+            last = boost::none;
         }
     }
 
@@ -178,8 +245,8 @@ private:
             if (boost::optional<Ledger> ledger =
                     adaptor_.acquire(it->first.second))
             {
-                for (NodeID const& nodeID : it->second)
-                    updateTrie(lock, nodeID, *ledger);
+                for (SlotIndex i : it->second)
+                    updateTrie(lock, i, *ledger);
 
                 it = acquiring_.erase(it);
             }
@@ -189,14 +256,12 @@ private:
     }
 
     void
-    updateTrie(ScopedLock const&, NodeID const& nodeID, Ledger ledger)
+    updateTrie(ScopedLock const&, SlotIndex i, Ledger ledger)
     {
-        auto ins = lastLedger_.emplace(nodeID, ledger);
-        if (!ins.second)
-        {
-            trie_.remove(ins.first->second);
-            ins.first->second = ledger;
-        }
+        auto& last = slots_[i].lastLedger;
+        if (last)
+            trie_.remove(*last);
+        last = ledger;
         trie_.insert(ledger);
     }
 
@@ -204,22 +269,14 @@ private:
     void
     updateTrie(
         ScopedLock const& lock,
-        NodeID const& nodeID,
+        SlotIndex i,
         Validation const& val,
         boost::optional<std::pair<Seq, ID>> prior)
     {
         assert(val.trusted());
 
         if (prior)
-        {
-            auto it = acquiring_.find(*prior);
-            if (it != acquiring_.end())
-            {
-                it->second.erase(nodeID);
-                if (it->second.empty())
-                    acquiring_.erase(it);
-            }
-        }
+            removeAcquiring(*prior, i);
 
         checkAcquired(lock);
 
@@ -227,15 +284,58 @@ private:
         auto it = acquiring_.find(valPair);
         if (it != acquiring_.end())
         {
-            it->second.insert(nodeID);
+            it->second.insert(i);
         }
         else
         {
             if (boost::optional<Ledger> ledger =
                     adaptor_.acquire(val.ledgerID()))
-                updateTrie(lock, nodeID, *ledger);
+                updateTrie(lock, i, *ledger);
             else
-                acquiring_[valPair].insert(nodeID);
+                acquiring_[valPair].insert(i);
+        }
+    }
+
+    
+    void
+    setCurrent(Slot& slot, Validation const& val)
+    {
+        if (!slot.current)
+            ++numCurrent_;
+        slot.current = val;
+        nextExpiry_ = std::min<NetClock::time_point>(
+            nextExpiry_, val.signTime() + parms_.validationCURRENT_EARLY);
+    }
+
+    
+    void
+    expireStale(ScopedLock const& lock, NetClock::time_point t)
+    {
+        if (t >= lastNow_ && t < nextExpiry_)
+            return;
+
+        lastNow_ = t;
+        nextExpiry_ = NetClock::time_point::max();
+        for (SlotIndex i = 0; i < slots_.size(); ++i)
+        {
+            auto& current = slots_[i].current;
+            if (!current)
+                continue;
+
+            if (!isCurrent(
+                    parms_, t, current->signTime(), current->seenTime()))
+            {
+                removeTrie(lock, i, *current);
+                adaptor_.onStale(std::move(*current));
+                current = boost::none;
+                --numCurrent_;
+            }
+            else
+            {
+                nextExpiry_ = std::min<NetClock::time_point>(
+                    nextExpiry_,
+                    current->signTime() + parms_.validationCURRENT_EARLY);
+            }
         }
     }
 
@@ -244,7 +344,7 @@ private:
     auto
     withTrie(ScopedLock const& lock, F&& f)
     {
-        current(lock, [](auto) {}, [](auto, auto) {});
+        expireStale(lock, adaptor_.now());
         checkAcquired(lock);
         return f(trie_);
     }
@@ -255,24 +355,12 @@ private:
     void
     current(ScopedLock const& lock, Pre&& pre, F&& f)
     {
-        NetClock::time_point t = adaptor_.now();
-        pre(current_.size());
-        auto it = current_.begin();
-        while (it != current_.end())
+        expireStale(lock, adaptor_.now());
+        pre(numCurrent_);
+        for (Slot const& slot : slots_)
         {
-            if (!isCurrent(
-                    parms_, t, it->second.signTime(), it->second.seenTime()))
-            {
-                removeTrie(lock, it->first, it->second);
-                adaptor_.onStale(std::move(it->second));
-                it = current_.erase(it);
-            }
-            else
-            {
-                auto cit = typename decltype(current_)::const_iterator{it};
-                f(cit->first, cit->second);
-                ++it;
-            }
+            if (slot.current)
+                f(slot.nodeID, *slot.current);
         }
     }
 
@@ -285,9 +373,9 @@ private:
         if (it != byLedger_.end())
         {
             byLedger_.touch(it);
-            pre(it->second.size());
-            for (auto const& keyVal : it->second)
-                f(keyVal.first, keyVal.second);
+            pre(it->second.validations.size());
+            for (auto const& slotVal : it->second.validations)
+                f(slots_[slotVal.first].nodeID, slotVal.second);
         }
     }
 
@@ -328,39 +416,41 @@ public:
     ValStatus
     add(NodeID const& nodeID, Validation const& val)
     {
-        if (!isCurrent(parms_, adaptor_.now(), val.signTime(), val.seenTime()))
+        NetClock::time_point const t = adaptor_.now();
+        if (!isCurrent(parms_, t, val.signTime(), val.seenTime()))
             return ValStatus::stale;
 
         {
             ScopedLock lock{mutex_};
 
             auto const now = byLedger_.clock().now();
-            SeqEnforcer<Seq>& enforcer = seqEnforcers_[nodeID];
-            if (!enforcer(now, val.seq(), parms_))
+            SlotIndex const i = slot(lock, nodeID);
+            Slot& s = slots_[i];
+            if (!s.enforcer(now, val.seq(), parms_))
                 return ValStatus::badSeq;
 
-            auto byLedgerIt = byLedger_[val.ledgerID()].emplace(nodeID, val);
-            if (!byLedgerIt.second)
-                byLedgerIt.first->second = val;
+            addByLedger(lock, i, val);
+            lastNow_ = std::max(lastNow_, t);
 
-            auto const ins = current_.emplace(nodeID, val);
-            if (!ins.second)
+            if (s.current)
             {
-                Validation& oldVal = ins.first->second;
+                Validation& oldVal = *s.current;
                 if (val.signTime() > oldVal.signTime())
                 {
                     std::pair<Seq, ID> old(oldVal.seq(), oldVal.ledgerID());
                     adaptor_.onStale(std::move(oldVal));
-                    ins.first->second = val;
+                    setCurrent(s, val);
                     if (val.trusted())
-                        updateTrie(lock, nodeID, val, old);
+                        updateTrie(lock, i, val, old);
                 }
                 else
                     return ValStatus::stale;
             }
-            else if (val.trusted())
+            else
             {
-                updateTrie(lock, nodeID, val, boost::none);
+                setCurrent(s, val);
+                if (val.trusted())
+                    updateTrie(lock, i, val, boost::none);
             }
         }
         return ValStatus::current;
@@ -380,32 +470,51 @@ public:
     {
         ScopedLock lock{mutex_};
 
-        for (auto& it : current_)
+        enum class Change : std::uint8_t { none, added, removed };
+        std::vector<Change> changes(slots_.size(), Change::none);
+
+        for (SlotIndex i = 0; i < slots_.size(); ++i)
         {
-            if (added.find(it.first) != added.end())
+            Slot& s = slots_[i];
+            if (added.find(s.nodeID) != added.end())
+                changes[i] = Change::added;
+            else if (removed.find(s.nodeID) != removed.end())
+                changes[i] = Change::removed;
+            else
+                continue;
+
+            if (!s.current)
+                continue;
+
+            if (changes[i] == Change::added)
             {
-                it.second.setTrusted();
-                updateTrie(lock, it.first, it.second, boost::none);
+                s.current->setTrusted();
+                updateTrie(lock, i, *s.current, boost::none);
             }
-            else if (removed.find(it.first) != removed.end())
+            else
             {
-                it.second.setUntrusted();
-                removeTrie(lock, it.first, it.second);
+                s.current->setUntrusted();
+                removeTrie(lock, i, *s.current);
             }
         }
 
         for (auto& it : byLedger_)
         {
-            for (auto& nodeVal : it.second)
+            for (auto& slotVal : it.second.validations)
             {
-                if (added.find(nodeVal.first) != added.end())
-                {
-                    nodeVal.second.setTrusted();
-                }
-                else if (removed.find(nodeVal.first) != removed.end())
-                {
-                    nodeVal.second.setUntrusted();
-                }
+                Validation& v = slotVal.second;
+                bool const before = counted(v);
+                if (changes[slotVal.first] == Change::added)
+                    v.setTrusted();
+                else if (changes[slotVal.first] == Change::removed)
+                    v.setUntrusted();
+                else
+                    continue;
+
+                if (before && !counted(v))
+                    --it.second.trusted;
+                else if (!before && counted(v))
+                    ++it.second.trusted;
             }
         }
     }
@@ -433,10 +542,10 @@ public:
                 acquiring_.end(),
                 [](auto const& a, auto const& b) {
                     std::pair<Seq, ID> const& aKey = a.first;
-                    typename hash_set<NodeID>::size_type const& aSize =
+                    typename hash_set<SlotIndex>::size_type const& aSize =
                         a.second.size();
                     std::pair<Seq, ID> const& bKey = b.first;
-                    typename hash_set<NodeID>::size_type const& bSize =
+                    typename hash_set<SlotIndex>::size_type const& bSize =
                         b.second.size();
                     return std::tie(aSize, aKey.second) <
                         std::tie(bSize, bKey.second);
@@ -504,10 +613,10 @@ public:
             });
 
         return std::count_if(
-            lastLedger_.begin(),
-            lastLedger_.end(),
-            [&ledgerID](auto const& it) {
-                auto const& curr = it.second;
+            slots_.begin(), slots_.end(), [&ledgerID](Slot const& s) {
+                if (!s.lastLedger)
+                    return false;
+                auto const& curr = *s.lastLedger;
                 return curr.seq() > Seq{0} &&
                     curr[curr.seq() - Seq{1}] == ledgerID;
             });
@@ -547,17 +656,12 @@ public:
     std::size_t
     numTrustedForLedger(ID const& ledgerID)
     {
-        std::size_t count = 0;
         ScopedLock lock{mutex_};
-        byLedger(
-            lock,
-            ledgerID,
-            [&](std::size_t) {},  
-            [&](NodeID const&, Validation const& v) {
-                if (v.trusted() && v.full())
-                    ++count;
-            });
-        return count;
+        auto it = byLedger_.find(ledgerID);
+        if (it == byLedger_.end())
+            return 0;
+        byLedger_.touch(it);
+        return it->second.trusted;
     }
 
     
@@ -608,11 +712,16 @@ public:
         hash_map<NodeID, Validation> flushed;
         {
             ScopedLock lock{mutex_};
-            for (auto it : current_)
+            flushed.reserve(numCurrent_);
+            for (Slot& s : slots_)
             {
-                flushed.emplace(it.first, std::move(it.second));
+                if (s.current)
+                {
+                    flushed.emplace(s.nodeID, std::move(*s.current));
+                    s.current = boost::none;
+                }
             }
-            current_.clear();
+            numCurrent_ = 0;
         }
 
         adaptor_.flush(std::move(flushed));
@@ -113,6 +113,8 @@ public:
     int                         PATH_SEARCH = 7;
     int                         PATH_SEARCH_FAST = 2;
     int                         PATH_SEARCH_MAX = 10;
+    std::size_t                 PATH_SEARCH_THREADS = 1;
+    std::chrono::milliseconds   PATH_SEARCH_BUDGET {0};
 
     boost::optional<std::size_t> VALIDATION_QUORUM;     
 
@@ -131,6 +133,14 @@ public:
 
     std::size_t                 WORKERS = 0;
 
+    std::size_t                 PARALLEL_APPLY = 0;
+
+    bool                        APPLY_ARENA = false;
+
+    std::size_t                 RPC_CACHE_SIZE = 0;
+
+    bool                        RPC_ARENA = false;
+
     boost::optional<beast::IP::Endpoint> rpc_ip;
 
     std::unordered_set<uint256, beast::uhash<>> features;
@@ -17,6 +17,7 @@ struct ConfigSection
 };
 
 #define SECTION_AMENDMENTS              "amendments"
+#define SECTION_APPLY_ARENA             "apply_arena"
 #define SECTION_CLUSTER_NODES           "cluster_nodes"
 #define SECTION_DEBUG_LOGFILE           "debug_logfile"
 #define SECTION_ELB_SUPPORT             "elb_support"
@@ -32,12 +33,17 @@ struct ConfigSection
 #define SECTION_NETWORK_QUORUM          "network_quorum"
 #define SECTION_NODE_SEED               "node_seed"
 #define SECTION_NODE_SIZE               "node_size"
+#define SECTION_PARALLEL_APPLY          "parallel_apply"
 #define SECTION_PATH_SEARCH_OLD         "path_search_old"
 #define SECTION_PATH_SEARCH             "path_search"
 #define SECTION_PATH_SEARCH_FAST        "path_search_fast"
 #define SECTION_PATH_SEARCH_MAX         "path_search_max"
+#define SECTION_PATH_SEARCH_THREADS     "path_search_threads"
+#define SECTION_PATH_SEARCH_BUDGET      "path_search_budget"
 #define SECTION_PEER_PRIVATE            "peer_private"
 #define SECTION_PEERS_MAX               "peers_max"
+#define SECTION_RPC_ARENA               "rpc_arena"
+#define SECTION_RPC_CACHE               "rpc_cache"
 #define SECTION_RPC_STARTUP             "rpc_startup"
 #define SECTION_SIGNING_SUPPORT         "signing_support"
 #define SECTION_SNTP                    "sntp_servers"
@@ -110,8 +110,11 @@ resume()
     auto saved = detail::getLocalValues().release();
     detail::getLocalValues().reset(&lvs_);
     std::lock_guard<std::mutex> lock(mutex_);
+    // Arena scopes opened in the coroutine stay with it across a yield
+    auto const arenas = Arena::exchange(arenas_);
     assert (coro_);
     coro_();
+    arenas_ = Arena::exchange(arenas);
     detail::getLocalValues().release();
     detail::getLocalValues().reset(saved);
     std::lock_guard<std::mutex> lk(mutex_run_);
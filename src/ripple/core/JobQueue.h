@@ -3,6 +3,7 @@
 #ifndef RIPPLE_CORE_JOBQUEUE_H_INCLUDED
 #define RIPPLE_CORE_JOBQUEUE_H_INCLUDED
 
+#include <ripple/basics/Arena.h>
 #include <ripple/basics/LocalValue.h>
 #include <ripple/basics/win32_workaround.h>
 #include <ripple/core/JobTypes.h>
@@ -36,6 +37,7 @@ public:
     {
     private:
         detail::LocalValues lvs_;
+        Arena::Current arenas_ {};
         JobQueue& jq_;
         JobType type_;
         std::string name_;
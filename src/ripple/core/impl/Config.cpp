@@ -355,6 +355,16 @@ void Config::loadFromString (std::string const& fileContents)
         PATH_SEARCH_FAST    = beast::lexicalCastThrow <int> (strTemp);
     if (getSingleSection (secConfig, SECTION_PATH_SEARCH_MAX, strTemp, j_))
         PATH_SEARCH_MAX     = beast::lexicalCastThrow <int> (strTemp);
+    if (getSingleSection (secConfig, SECTION_PATH_SEARCH_THREADS, strTemp, j_))
+    {
+        PATH_SEARCH_THREADS = std::max<std::size_t> (1,
+            beast::lexicalCastThrow <std::size_t> (strTemp));
+    }
+    if (getSingleSection (secConfig, SECTION_PATH_SEARCH_BUDGET, strTemp, j_))
+    {
+        PATH_SEARCH_BUDGET  = std::chrono::milliseconds (
+            beast::lexicalCastThrow <std::size_t> (strTemp));
+    }
 
     if (getSingleSection (secConfig, SECTION_DEBUG_LOGFILE, strTemp, j_))
         DEBUG_LOGFILE       = strTemp;
@@ -362,6 +372,18 @@ void Config::loadFromString (std::string const& fileContents)
     if (getSingleSection (secConfig, SECTION_WORKERS, strTemp, j_))
         WORKERS      = beast::lexicalCastThrow <std::size_t> (strTemp);
 
+    if (getSingleSection (secConfig, SECTION_PARALLEL_APPLY, strTemp, j_))
+        PARALLEL_APPLY = beast::lexicalCastThrow <std::size_t> (strTemp);
+
+    if (getSingleSection (secConfig, SECTION_APPLY_ARENA, strTemp, j_))
+        APPLY_ARENA = beast::lexicalCastThrow <bool> (strTemp);
+
+    if (getSingleSection (secConfig, SECTION_RPC_CACHE, strTemp, j_))
+        RPC_CACHE_SIZE = beast::lexicalCastThrow <std::size_t> (strTemp);
+
+    if (getSingleSection (secConfig, SECTION_RPC_ARENA, strTemp, j_))
+        RPC_ARENA = beast::lexicalCastThrow <bool> (strTemp);
+
     if (! RUN_STANDALONE)
     {
         boost::filesystem::path validatorsFile;
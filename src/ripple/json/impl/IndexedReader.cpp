@@ -0,0 +1,482 @@
+#include <ripple/json/json_reader.h>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define RIPPLE_JSON_SSE2 1
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace Json {
+
+namespace {
+
+// Stage one classifies the document 64 bytes at a time into bitmasks and
+// records the offset of every structural character, every unescaped quote
+// and the first character of every other token outside of strings.
+
+using Mask = std::uint64_t;
+
+std::size_t const blockSize = 64;
+
+struct Block
+{
+    Mask quote;
+    Mask backslash;
+    Mask structural;
+    Mask whitespace;
+};
+
+#ifdef RIPPLE_JSON_SSE2
+
+Block
+classify (char const* p)
+{
+    __m128i v[4];
+    for (int i = 0; i < 4; ++i)
+        v[i] = _mm_loadu_si128 (reinterpret_cast<__m128i const*> (p + 16 * i));
+
+    auto const match = [&v](char c)
+    {
+        auto const k = _mm_set1_epi8 (c);
+        Mask m = 0;
+        for (int i = 0; i < 4; ++i)
+            m |= static_cast<Mask> (static_cast<std::uint16_t> (
+                _mm_movemask_epi8 (_mm_cmpeq_epi8 (v[i], k)))) << (16 * i);
+        return m;
+    };
+
+    Block b;
+    b.quote = match ('"');
+    b.backslash = match ('\\');
+    b.structural = match ('{') | match ('}') | match ('[') | match (']') |
+        match (':') | match (',');
+    b.whitespace = match (' ') | match ('\t') | match ('\r') | match ('\n');
+    return b;
+}
+
+#else
+
+Block
+classify (char const* p)
+{
+    Block b {0, 0, 0, 0};
+    for (std::size_t i = 0; i < blockSize; ++i)
+    {
+        auto const bit = Mask (1) << i;
+        switch (p[i])
+        {
+        case '"':  b.quote |= bit; break;
+        case '\\': b.backslash |= bit; break;
+        case '{': case '}': case '[': case ']': case ':': case ',':
+            b.structural |= bit;
+            break;
+        case ' ': case '\t': case '\r': case '\n':
+            b.whitespace |= bit;
+            break;
+        default:
+            break;
+        }
+    }
+    return b;
+}
+
+#endif
+
+int
+trailingZeros (Mask m)
+{
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64 (&index, m);
+    return static_cast<int> (index);
+#else
+    return __builtin_ctzll (m);
+#endif
+}
+
+// Each bit is set when an odd number of quotes precede or are at it
+Mask
+prefixXor (Mask m)
+{
+    m ^= m << 1;
+    m ^= m << 2;
+    m ^= m << 4;
+    m ^= m << 8;
+    m ^= m << 16;
+    m ^= m << 32;
+    return m;
+}
+
+// The characters that follow an unescaped backslash, as Reader::readString
+// skips them.
+Mask
+escaped (Mask backslash, bool& carry)
+{
+    Mask ret = 0;
+    if (carry)
+    {
+        ret = 1;
+        backslash &= ~Mask (1);
+        carry = false;
+    }
+    while (backslash)
+    {
+        auto const bit = backslash & (0 - backslash);
+        auto const next = bit << 1;
+        if (next == 0)
+            carry = true;
+        ret |= next;
+        backslash &= ~(bit | next);
+    }
+    return ret;
+}
+
+bool
+buildIndex (char const* begin, std::size_t size,
+    std::vector<std::uint32_t>& index)
+{
+    if (size > std::numeric_limits<std::uint32_t>::max ())
+        return false;
+
+    index.reserve (size / 4 + 16);
+
+    bool escapeCarry = false;
+    Mask inStringCarry = 0;
+    Mask scalarCarry = 0;
+    char tail[blockSize];
+
+    for (std::size_t offset = 0; offset < size; offset += blockSize)
+    {
+        char const* p = begin + offset;
+        if (size - offset < blockSize)
+        {
+            std::memset (tail, ' ', blockSize);
+            std::memcpy (tail, p, size - offset);
+            p = tail;
+        }
+
+        auto const b = classify (p);
+        auto const quote = b.quote & ~escaped (b.backslash, escapeCarry);
+        auto const inString = prefixXor (quote) ^ inStringCarry;
+        inStringCarry = (inString >> 63) ? ~Mask (0) : 0;
+
+        auto const scalar =
+            ~(b.structural | b.whitespace | quote | inString);
+        auto bits = (b.structural & ~inString) | quote |
+            (scalar & ~((scalar << 1) | scalarCarry));
+        scalarCarry = scalar >> 63;
+
+        while (bits)
+        {
+            index.push_back (static_cast<std::uint32_t> (
+                offset + trailingZeros (bits)));
+            bits &= bits - 1;
+        }
+    }
+
+    return inStringCarry == 0;
+}
+
+// Stage two walks the index and builds the Value. It accepts only what
+// Reader accepts, with the same result, and declines everything else.
+class IndexedParser
+{
+public:
+    IndexedParser (char const* begin, char const* end,
+            std::vector<std::uint32_t> const& index)
+        : begin_ (begin)
+        , end_ (end)
+        , index_ (index)
+    {
+    }
+
+    bool
+    parse (Value& root)
+    {
+        if (peek () != '{' && peek () != '[')
+            return false;
+        return value (root, 0) && next_ == index_.size ();
+    }
+
+private:
+    char
+    peek () const
+    {
+        return next_ < index_.size () ? begin_[index_[next_]] : 0;
+    }
+
+    bool
+    expect (char c)
+    {
+        if (peek () != c)
+            return false;
+        ++next_;
+        return true;
+    }
+
+    bool
+    value (Value& v, unsigned depth)
+    {
+        if (depth > Reader::nest_limit || next_ == index_.size ())
+            return false;
+
+        auto const pos = index_[next_++];
+        switch (begin_[pos])
+        {
+        case '{':
+            return object (v, depth);
+        case '[':
+            return array (v, depth);
+        case '"':
+        {
+            char const* b;
+            char const* e;
+            if (! string (pos, b, e))
+                return false;
+            v = Value (b, e);
+            return true;
+        }
+        case '}': case ']': case ':': case ',':
+            return false;
+        default:
+            return scalar (pos, v);
+        }
+    }
+
+    bool
+    object (Value& v, unsigned depth)
+    {
+        v = Value (objectValue);
+        if (expect ('}'))
+            return true;
+
+        std::string name;
+        do
+        {
+            char const* b;
+            char const* e;
+            if (peek () != '"' || ! string (index_[next_++], b, e) ||
+                ! expect (':'))
+                return false;
+            name.assign (b, e);
+
+            // A repeated key leaves the size unchanged
+            auto const size = v.size ();
+            auto& member = v[name];
+            if (v.size () == size || ! value (member, depth + 1))
+                return false;
+        }
+        while (expect (','));
+
+        return expect ('}');
+    }
+
+    bool
+    array (Value& v, unsigned depth)
+    {
+        v = Value (arrayValue);
+        if (expect (']'))
+            return true;
+
+        UInt i = 0;
+        do
+        {
+            if (! value (v[i++], depth + 1))
+                return false;
+        }
+        while (expect (','));
+
+        return expect (']');
+    }
+
+    // Finds the contents of the string opening at `pos`, decoding them
+    // into scratch_ if they have escapes. Strings with unicode escapes are
+    // left to Reader.
+    bool
+    string (std::size_t pos, char const*& first, char const*& last)
+    {
+        if (peek () != '"')
+            return false;
+
+        char const* p = begin_ + pos + 1;
+        char const* const end = begin_ + index_[next_++];
+        auto slash = static_cast<char const*> (
+            std::memchr (p, '\\', end - p));
+        if (slash == nullptr)
+        {
+            first = p;
+            last = end;
+            return true;
+        }
+
+        scratch_.clear ();
+        while (slash != nullptr)
+        {
+            scratch_.append (p, slash);
+            p = slash + 1;
+            switch (*p++)
+            {
+            case '"':  scratch_ += '"'; break;
+            case '/':  scratch_ += '/'; break;
+            case '\\': scratch_ += '\\'; break;
+            case 'b':  scratch_ += '\b'; break;
+            case 'f':  scratch_ += '\f'; break;
+            case 'n':  scratch_ += '\n'; break;
+            case 'r':  scratch_ += '\r'; break;
+            case 't':  scratch_ += '\t'; break;
+            default:
+                return false;
+            }
+            slash = static_cast<char const*> (
+                std::memchr (p, '\\', end - p));
+        }
+        scratch_.append (p, end);
+
+        first = scratch_.data ();
+        last = first + scratch_.size ();
+        return true;
+    }
+
+    bool
+    scalar (std::size_t pos, Value& v)
+    {
+        char const* const start = begin_ + pos;
+        char const* end = next_ < index_.size () ?
+            begin_ + index_[next_] : end_;
+        while (end != start && (end[-1] == ' ' || end[-1] == '\t' ||
+                end[-1] == '\r' || end[-1] == '\n'))
+            --end;
+
+        auto const size = static_cast<std::size_t> (end - start);
+        auto const is = [&](char const* literal, std::size_t length)
+        {
+            return size == length && std::memcmp (start, literal, length) == 0;
+        };
+
+        switch (*start)
+        {
+        case 't':
+            if (! is ("true", 4))
+                return false;
+            v = true;
+            return true;
+        case 'f':
+            if (! is ("false", 5))
+                return false;
+            v = false;
+            return true;
+        case 'n':
+            if (! is ("null", 4))
+                return false;
+            v = Value ();
+            return true;
+        default:
+            return number (start, end, v);
+        }
+    }
+
+    // Matches Reader::readNumber, decodeNumber and decodeDouble
+    bool
+    number (char const* start, char const* end, Value& v)
+    {
+        if (*start != '-' && (*start < '0' || *start > '9'))
+            return false;
+
+        // readNumber skips a '-' after the first character
+        char const* q = start + 1;
+        if (q != end && *q == '-')
+            ++q;
+
+        bool integer = true;
+        for (; q != end; ++q)
+        {
+            if (*q >= '0' && *q <= '9')
+                continue;
+            if (*q == 0 || std::strchr (".eE+-", *q) == nullptr)
+                return false;
+            integer = false;
+        }
+
+        if (! integer)
+        {
+            double d = 0;
+            std::string const buffer (start, end);
+            if (std::sscanf (buffer.c_str (), "%lf", &d) != 1)
+                return false;
+            v = d;
+            return true;
+        }
+
+        char const* p = start;
+        bool const negative = *p == '-';
+        if (negative)
+            ++p;
+        if (p == end)
+            return false;
+
+        std::int64_t value = 0;
+        while (p < end && value <= Value::maxUInt)
+        {
+            if (*p < '0' || *p > '9')
+                return false;
+            value = value * 10 + (*p++ - '0');
+        }
+        if (p != end)
+            return false;
+
+        if (negative)
+        {
+            value = -value;
+            if (value < Value::minInt || value > Value::maxInt)
+                return false;
+            v = static_cast<Value::Int> (value);
+        }
+        else if (value > Value::maxUInt)
+        {
+            return false;
+        }
+        else if (value <= Value::maxInt)
+        {
+            v = static_cast<Value::Int> (value);
+        }
+        else
+        {
+            v = static_cast<Value::UInt> (value);
+        }
+        return true;
+    }
+
+    char const* const begin_;
+    char const* const end_;
+    std::vector<std::uint32_t> const& index_;
+    std::size_t next_ = 0;
+    std::string scratch_;
+};
+
+}
+
+bool
+parseIndexed (char const* begin, char const* end, Value& root)
+{
+    std::vector<std::uint32_t> index;
+    if (! buildIndex (begin, end - begin, index))
+        return false;
+
+    Value value;
+    if (! IndexedParser (begin, end, index).parse (value))
+        return false;
+
+    root.swap (value);
+    return true;
+}
+
+}
@@ -54,10 +54,17 @@ bool
 Reader::parse ( std::string const& document,
                 Value& root)
 {
+    if ( indexed_ && parseIndexed ( document.data (),
+            document.data () + document.size (), root ) )
+    {
+        errors_.clear ();
+        return true;
+    }
+
     document_ = document;
     const char* begin = document_.c_str ();
     const char* end = begin + document_.length ();
-    return parse ( begin, end, root );
+    return readDocument ( begin, end, root );
 }
 
 
@@ -74,6 +81,19 @@ Reader::parse ( std::istream& sin,
 bool
 Reader::parse ( const char* beginDoc, const char* endDoc,
                 Value& root)
+{
+    if ( indexed_ && parseIndexed ( beginDoc, endDoc, root ) )
+    {
+        errors_.clear ();
+        return true;
+    }
+
+    return readDocument ( beginDoc, endDoc, root );
+}
+
+bool
+Reader::readDocument ( const char* beginDoc, const char* endDoc,
+                       Value& root)
 {
     begin_ = beginDoc;
     end_ = endDoc;
@@ -5,6 +5,8 @@
 #include <ripple/json/to_string.h>
 #include <ripple/json/json_writer.h>
 #include <ripple/beast/core/LexicalCast.h>
+#include <tuple>
+#include <unordered_set>
 
 namespace Json {
 
@@ -35,7 +37,10 @@ public:
         if ( length == unknown )
             length = value ? (unsigned int)strlen ( value ) : 0;
 
-        char* newString = static_cast<char*> ( malloc ( length + 1 ) );
+        char* newString = static_cast<char*> (
+            ripple::Arena::allocate ( length + 1, ripple::Arena::json ) );
+        if ( ! newString )
+            newString = static_cast<char*> ( malloc ( length + 1 ) );
         if ( value )
             memcpy ( newString, value, length );
         newString[length] = 0;
@@ -44,7 +49,9 @@ public:
 
     void releaseStringValue ( char* value ) override
     {
-        if ( value )
+        if ( ripple::Arena::owns ( value ) )
+            ripple::Arena::deallocate ( value );
+        else if ( value )
             free ( value );
     }
 };
@@ -63,6 +70,74 @@ static struct DummyValueAllocatorInitializer
     }
 } dummyValueAllocatorInitializer;
 
+namespace {
+
+struct NameHash
+{
+    std::size_t operator() ( const char* name ) const
+    {
+        std::size_t h = 2166136261u;
+        for ( ; *name; ++name )
+            h = ( h ^ static_cast<unsigned char> ( *name ) ) * 16777619u;
+        return h;
+    }
+};
+
+struct NameEqual
+{
+    bool operator() ( const char* a, const char* b ) const
+    {
+        return strcmp ( a, b ) == 0;
+    }
+};
+
+using InternedNames =
+    std::unordered_set<const char*, NameHash, NameEqual>;
+
+InternedNames& internedNames ()
+{
+    static InternedNames names;
+    return names;
+}
+
+template <class Map, class... Args>
+Map* newMap ( Args&&... args )
+{
+    auto const p = ripple::Arena::allocate ( sizeof ( Map ), ripple::Arena::json );
+    if ( ! p )
+        return new Map ( std::forward<Args> ( args )... );
+    try
+    {
+        return new ( p ) Map ( std::forward<Args> ( args )... );
+    }
+    catch ( ... )
+    {
+        ripple::Arena::deallocate ( p );
+        throw;
+    }
+}
+
+template <class Map>
+void deleteMap ( Map* map )
+{
+    if ( ripple::Arena::owns ( map ) )
+    {
+        map->~Map ();
+        ripple::Arena::deallocate ( map );
+    }
+    else
+    {
+        delete map;
+    }
+}
+
+}
+
+void intern ( StaticString name )
+{
+    internedNames ().insert ( name.c_str () );
+}
+
 
 
 Value::CZString::CZString ( int index )
@@ -72,19 +147,24 @@ Value::CZString::CZString ( int index )
 }
 
 Value::CZString::CZString ( const char* cstr, DuplicationPolicy allocate )
-    : cstr_ ( allocate == duplicate ? valueAllocator ()->makeMemberName (cstr)
-              : cstr )
+    : cstr_ ( cstr )
     , index_ ( allocate )
 {
+    if ( allocate == duplicate )
+        intern ();
 }
 
 Value::CZString::CZString ( const CZString& other )
-    : cstr_ ( other.index_ != noDuplication&&   other.cstr_ != 0
-              ?  valueAllocator ()->makeMemberName ( other.cstr_ )
-              : other.cstr_ )
-    , index_ ( other.cstr_ ? (other.index_ == noDuplication ? noDuplication : duplicate)
-               : other.index_ )
+    : cstr_ ( other.cstr_ )
+    , index_ ( other.index_ )
 {
+    if ( cstr_ == 0  ||  index_ == noDuplication )
+        return;
+
+    if ( index_ == duplicateOnCopy )
+        intern ();
+    else
+        cstr_ = valueAllocator ()->makeMemberName ( cstr_ );
 }
 
 Value::CZString::~CZString ()
@@ -93,6 +173,23 @@ Value::CZString::~CZString ()
         valueAllocator ()->releaseMemberName ( const_cast<char*> ( cstr_ ) );
 }
 
+void
+Value::CZString::intern ()
+{
+    auto const& names = internedNames ();
+    auto const it = names.find ( cstr_ );
+    if ( it != names.end () )
+    {
+        cstr_ = *it;
+        index_ = noDuplication;
+    }
+    else
+    {
+        cstr_ = valueAllocator ()->makeMemberName ( cstr_ );
+        index_ = duplicate;
+    }
+}
+
 void
 Value::CZString::swap ( CZString& other ) noexcept
 {
@@ -150,7 +247,8 @@ Value::CZString::isStaticString () const
 
 Value::Value ( ValueType type )
     : type_ ( type )
-    , allocated_ ( 0 )
+    , allocated_ ( false )
+    , small_ ( false )
 {
     switch ( type )
     {
@@ -172,7 +270,7 @@ Value::Value ( ValueType type )
 
     case arrayValue:
     case objectValue:
-        value_.map_ = new ObjectValues ();
+        value_.map_ = newMap<ObjectValues> ();
         break;
 
     case booleanValue:
@@ -187,6 +285,8 @@ Value::Value ( ValueType type )
 
 Value::Value ( Int value )
     : type_ ( intValue )
+    , allocated_ ( false )
+    , small_ ( false )
 {
     value_.int_ = value;
 }
@@ -194,52 +294,59 @@ Value::Value ( Int value )
 
 Value::Value ( UInt value )
     : type_ ( uintValue )
+    , allocated_ ( false )
+    , small_ ( false )
 {
     value_.uint_ = value;
 }
 
 Value::Value ( double value )
     : type_ ( realValue )
+    , allocated_ ( false )
+    , small_ ( false )
 {
     value_.real_ = value;
 }
 
 Value::Value ( const char* value )
     : type_ ( stringValue )
-    , allocated_ ( true )
+    , allocated_ ( false )
+    , small_ ( false )
 {
-    value_.string_ = valueAllocator ()->duplicateStringValue ( value );
+    setString ( value, value ? (unsigned int)strlen ( value ) : 0 );
 }
 
 
 Value::Value ( const char* beginValue,
                const char* endValue )
     : type_ ( stringValue )
-    , allocated_ ( true )
+    , allocated_ ( false )
+    , small_ ( false )
 {
-    value_.string_ = valueAllocator ()->duplicateStringValue ( beginValue,
-                     UInt (endValue - beginValue) );
+    setString ( beginValue, UInt (endValue - beginValue) );
 }
 
 
 Value::Value ( std::string const& value )
     : type_ ( stringValue )
-    , allocated_ ( true )
+    , allocated_ ( false )
+    , small_ ( false )
 {
-    value_.string_ = valueAllocator ()->duplicateStringValue ( value.c_str (),
-                     (unsigned int)value.length () );
-
+    setString ( value.c_str (), (unsigned int)value.length () );
 }
 
 Value::Value ( const StaticString& value )
     : type_ ( stringValue )
     , allocated_ ( false )
+    , small_ ( false )
 {
     value_.string_ = const_cast<char*> ( value.c_str () );
 }
 
 Value::Value ( bool value )
     : type_ ( booleanValue )
+    , allocated_ ( false )
+    , small_ ( false )
 {
     value_.bool_ = value;
 }
@@ -247,6 +354,8 @@ Value::Value ( bool value )
 
 Value::Value ( const Value& other )
     : type_ ( other.type_ )
+    , allocated_ ( false )
+    , small_ ( false )
 {
     switch ( type_ )
     {
@@ -259,19 +368,23 @@ Value::Value ( const Value& other )
         break;
 
     case stringValue:
-        if ( other.value_.string_ )
+        if ( other.allocated_ )
         {
-            value_.string_ = valueAllocator ()->duplicateStringValue ( other.value_.string_ );
-            allocated_ = true;
+            setString ( other.value_.string_,
+                (unsigned int)strlen ( other.value_.string_ ) );
         }
         else
-            value_.string_ = 0;
+        {
+            value_ = other.value_;
+            allocated_ = false;
+            small_ = other.small_;
+        }
 
         break;
 
     case arrayValue:
     case objectValue:
-        value_.map_ = new ObjectValues ( *other.value_.map_ );
+        value_.map_ = newMap<ObjectValues> ( *other.value_.map_ );
         break;
 
     default:
@@ -300,7 +413,7 @@ Value::~Value ()
     case arrayValue:
     case objectValue:
         if (value_.map_)
-            delete value_.map_;
+            deleteMap ( value_.map_ );
         break;
 
     default:
@@ -320,9 +433,11 @@ Value::Value ( Value&& other ) noexcept
     : value_ ( other.value_ )
     , type_ ( other.type_ )
     , allocated_ ( other.allocated_ )
+    , small_ ( other.small_ )
 {
     other.type_ = nullValue;
     other.allocated_ = 0;
+    other.small_ = false;
 }
 
 Value&
@@ -345,6 +460,35 @@ Value::swap ( Value& other ) noexcept
     int temp2 = allocated_;
     allocated_ = other.allocated_;
     other.allocated_ = temp2;
+
+    bool const small = small_;
+    small_ = other.small_;
+    other.small_ = small;
+}
+
+void
+Value::setString ( const char* value, unsigned int length )
+{
+    if ( length < sizeof ( value_.chars_ ) )
+    {
+        if ( length )
+            memcpy ( value_.chars_, value, length );
+        value_.chars_[length] = 0;
+        allocated_ = false;
+        small_ = true;
+    }
+    else
+    {
+        value_.string_ = valueAllocator ()->duplicateStringValue ( value, length );
+        allocated_ = true;
+        small_ = false;
+    }
+}
+
+const char*
+Value::text () const
+{
+    return small_ ? value_.chars_ : value_.string_;
 }
 
 ValueType
@@ -391,9 +535,11 @@ bool operator < (const Value& x, const Value& y)
         return x.value_.bool_ < y.value_.bool_;
 
     case stringValue:
-        return (x.value_.string_ == 0  &&  y.value_.string_)
-               || (y.value_.string_ && x.value_.string_ &&
-                   strcmp (x.value_.string_, y.value_.string_) < 0);
+    {
+        auto const a = x.text ();
+        auto const b = y.text ();
+        return (a == 0  &&  b) || (b && a && strcmp (a, b) < 0);
+    }
 
     case arrayValue:
     case objectValue:
@@ -440,9 +586,11 @@ bool operator== (const Value& x, const Value& y)
         return x.value_.bool_ == y.value_.bool_;
 
     case stringValue:
-        return x.value_.string_ == y.value_.string_
-               || (y.value_.string_ && x.value_.string_ &&
-                    ! strcmp (x.value_.string_, y.value_.string_));
+    {
+        auto const a = x.text ();
+        auto const b = y.text ();
+        return a == b || (b && a && ! strcmp (a, b));
+    }
 
     case arrayValue:
     case objectValue:
@@ -460,7 +608,7 @@ const char*
 Value::asCString () const
 {
     JSON_ASSERT ( type_ == stringValue );
-    return value_.string_;
+    return text ();
 }
 
 
@@ -473,7 +621,7 @@ Value::asString () const
         return "";
 
     case stringValue:
-        return value_.string_ ? value_.string_ : "";
+        return text () ? text () : "";
 
     case booleanValue:
         return value_.bool_ ? "true" : "false";
@@ -521,7 +669,7 @@ Value::asInt () const
         return value_.bool_ ? 1 : 0;
 
     case stringValue:
-        return beast::lexicalCastThrow <int> (value_.string_);
+        return beast::lexicalCastThrow <int> (text ());
 
     case arrayValue:
     case objectValue:
@@ -557,7 +705,7 @@ Value::asUInt () const
         return value_.bool_ ? 1 : 0;
 
     case stringValue:
-        return beast::lexicalCastThrow <unsigned int> (value_.string_);
+        return beast::lexicalCastThrow <unsigned int> (text ());
 
     case arrayValue:
     case objectValue:
@@ -621,7 +769,7 @@ Value::asBool () const
         return value_.bool_;
 
     case stringValue:
-        return value_.string_  &&  value_.string_[0] != 0;
+        return text ()  &&  text ()[0] != 0;
 
     case arrayValue:
     case objectValue:
@@ -677,7 +825,7 @@ Value::isConvertibleTo ( ValueType other ) const
 
     case stringValue:
         return other == stringValue
-               || ( other == nullValue  &&  (!value_.string_  ||  value_.string_[0] == 0) );
+               || ( other == nullValue  &&  (!text ()  ||  text ()[0] == 0) );
 
     case arrayValue:
         return other == arrayValue
@@ -798,8 +946,8 @@ Value::operator[] ( UInt index )
     if ( it != value_.map_->end ()  &&  (*it).first == key )
         return (*it).second;
 
-    ObjectValues::value_type defaultValue ( key, null );
-    it = value_.map_->insert ( it, defaultValue );
+    it = value_.map_->emplace_hint ( it, std::piecewise_construct,
+        std::forward_as_tuple ( key ), std::forward_as_tuple () );
     return (*it).second;
 }
 
@@ -845,10 +993,9 @@ Value::resolveReference ( const char* key,
     if ( it != value_.map_->end ()  &&  (*it).first == actualKey )
         return (*it).second;
 
-    ObjectValues::value_type defaultValue ( actualKey, null );
-    it = value_.map_->insert ( it, defaultValue );
-    Value& value = (*it).second;
-    return value;
+    it = value_.map_->emplace_hint ( it, std::piecewise_construct,
+        std::forward_as_tuple ( actualKey ), std::forward_as_tuple () );
+    return (*it).second;
 }
 
 
@@ -81,7 +81,7 @@ ValueIteratorBase::copy ( const SelfType& other )
 Value
 ValueIteratorBase::key () const
 {
-    const Value::CZString czstring = (*current_).first;
+    const Value::CZString& czstring = (*current_).first;
 
     if ( czstring.c_str () )
     {
@@ -98,7 +98,7 @@ ValueIteratorBase::key () const
 UInt
 ValueIteratorBase::index () const
 {
-    const Value::CZString czstring = (*current_).first;
+    const Value::CZString& czstring = (*current_).first;
 
     if ( !czstring.c_str () )
         return czstring.index ();
@@ -23,6 +23,15 @@ public:
     
     Reader () = default;
 
+    /** Create a reader that, if `indexed` is false, never tries
+        parseIndexed first.
+    */
+    explicit
+    Reader (bool indexed)
+        : indexed_ (indexed)
+    {
+    }
+
     
     bool parse ( std::string const& document, Value& root);
 
@@ -83,6 +92,7 @@ private:
 
     using Errors = std::deque<ErrorInfo>;
 
+    bool readDocument ( const char* beginDoc, const char* endDoc, Value& root );
     bool expectToken ( TokenType type, Token& token, const char* message );
     bool readToken ( Token& token );
     void skipSpaces ();
@@ -133,6 +143,7 @@ private:
     Location current_;
     Location lastValueEnd_;
     Value* lastValue_;
+    bool indexed_ = true;
 };
 
 template<class BufferSequence>
@@ -148,6 +159,16 @@ Reader::parse(Value& root, BufferSequence const& bs)
 }
 
 
+/** Parse a document using a structural index built a block at a time.
+
+    This only succeeds for documents that Reader would accept and then
+    produces the same value. It returns false, leaving `root` untouched,
+    for anything else, including documents with comments, unicode escapes,
+    trailing text or errors. Reader::parse tries this first and handles
+    those documents itself, so errors are reported as before.
+*/
+bool parseIndexed (const char* beginDoc, const char* endDoc, Value& root);
+
 std::istream& operator>> ( std::istream&, Value& );
 
 } 
@@ -3,6 +3,7 @@
 #ifndef RIPPLE_JSON_JSON_VALUE_H_INCLUDED
 #define RIPPLE_JSON_JSON_VALUE_H_INCLUDED
 
+#include <ripple/basics/Arena.h>
 #include <ripple/json/json_forwards.h>
 #include <cstring>
 #include <functional>
@@ -88,6 +89,13 @@ inline bool operator!= (StaticString x, std::string const& y)
     return ! (y == x);
 }
 
+/** Makes member names equal to `name` share it instead of being copied.
+
+    Names are registered during static initialization, before any Value
+    is built.
+*/
+void intern (StaticString name);
+
 
 class Value
 {
@@ -128,12 +136,15 @@ private:
         bool isStaticString () const;
     private:
         void swap ( CZString& other ) noexcept;
+        void intern ();
         const char* cstr_;
         int index_;
     };
 
 public:
-    using ObjectValues = std::map<CZString, Value>;
+    using ObjectValues = std::map<CZString, Value, std::less<CZString>,
+        ripple::ArenaAllocator<std::pair<const CZString, Value>,
+            ripple::Arena::json>>;
 
 public:
     
@@ -238,6 +249,9 @@ private:
     Value& resolveReference ( const char* key,
                               bool isStatic );
 
+    void setString ( const char* value, unsigned int length );
+    const char* text () const;
+
 private:
     union ValueHolder
     {
@@ -246,10 +260,13 @@ private:
         double real_;
         bool bool_;
         char* string_;
+        // Short strings are kept inline without growing the holder
+        char chars_[sizeof (double)];
         ObjectValues* map_ {nullptr};
     } value_;
     ValueType type_ : 8;
     int allocated_ : 1;     
+    bool small_ : 1;
 };
 
 bool operator== (const Value&, const Value&);
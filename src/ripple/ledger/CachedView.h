@@ -45,6 +45,9 @@ public:
     std::shared_ptr<SLE const>
     read (Keylet const& k) const override;
 
+    void
+    prefetch (key_type const& key) const override;
+
     bool
     open() const override
     {
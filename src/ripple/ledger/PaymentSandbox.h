@@ -7,7 +7,8 @@
 #include <ripple/ledger/Sandbox.h>
 #include <ripple/ledger/detail/ApplyViewBase.h>
 #include <ripple/protocol/AccountID.h>
-#include <map>
+#include <boost/container/flat_map.hpp>
+#include <boost/container/small_vector.hpp>
 #include <utility>
 
 namespace ripple {
@@ -62,8 +63,13 @@ private:
         AccountID const& a2,
             Currency const& c);
 
-    std::map<Key, Value> credits_;
-    std::map<AccountID, std::uint32_t> ownerCounts_;
+    // Most sandboxes touch only a few trust lines and accounts
+    template <class K, class V>
+    using flat_map = boost::container::flat_map<K, V, std::less<K>,
+        boost::container::small_vector<std::pair<K, V>, 4>>;
+
+    flat_map<Key, Value> credits_;
+    flat_map<AccountID, std::uint32_t> ownerCounts_;
 };
 
 } 
@@ -235,6 +235,17 @@ public:
         return count;
     }
 
+    /** Hint that the state entry with this key will be read soon.
+
+        Views backed by a NodeStore may start loading it in the
+        background. The default does nothing.
+    */
+    virtual
+    void
+    prefetch (key_type const& key) const
+    {
+    }
+
     virtual
     std::unique_ptr<sles_type::iter_base>
     slesBegin() const = 0;
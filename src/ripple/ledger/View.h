@@ -94,6 +94,10 @@ cdirNext (ReadView const& view,
     uint256& uEntryIndex,       
     beast::Journal j);
 
+/** Prefetch the entries listed on a directory page and the next page. */
+void
+prefetchDirectory (ReadView const& view, SLE const& page);
+
 std::set <uint256>
 getEnabledAmendments (ReadView const& view);
 
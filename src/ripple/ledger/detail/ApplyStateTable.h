@@ -7,6 +7,7 @@
 #include <ripple/ledger/RawView.h>
 #include <ripple/ledger/ReadView.h>
 #include <ripple/ledger/TxMeta.h>
+#include <ripple/ledger/detail/StateItems.h>
 #include <ripple/protocol/TER.h>
 #include <ripple/protocol/XRPAmount.h>
 #include <ripple/beast/utility/Journal.h>
@@ -29,7 +30,7 @@ private:
         modify,
     };
 
-    using items_t = std::map<key_type,
+    using items_t = StateItems<
         std::pair<Action, std::shared_ptr<SLE>>>;
 
     items_t items_;
@@ -112,6 +113,9 @@ private:
     using Mods = hash_map<key_type,
         std::shared_ptr<SLE>>;
 
+    void
+    apply (RawView& to, bool heap) const;
+
     static
     void
     threadItem (TxMeta& meta,
@@ -51,6 +51,9 @@ public:
     std::shared_ptr<SLE const>
     read (Keylet const& k) const override;
 
+    void
+    prefetch (key_type const& key) const override;
+
     std::unique_ptr<sles_type::iter_base>
     slesBegin() const override;
 
@@ -5,8 +5,7 @@
 
 #include <ripple/ledger/RawView.h>
 #include <ripple/ledger/ReadView.h>
-#include <ripple/basics/qalloc.h>
-#include <map>
+#include <ripple/ledger/detail/StateItems.h>
 #include <utility>
 
 namespace ripple {
@@ -71,10 +70,8 @@ private:
 
     class sles_iter_impl;
 
-    using items_t = std::map<key_type,
-        std::pair<Action, std::shared_ptr<SLE>>,
-        std::less<key_type>, qalloc_type<std::pair<key_type const,
-        std::pair<Action, std::shared_ptr<SLE>>>, false>>;
+    using items_t = StateItems<
+        std::pair<Action, std::shared_ptr<SLE>>>;
 
     items_t items_;
     XRPAmount dropsDestroyed_ = 0;
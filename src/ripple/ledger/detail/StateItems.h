@@ -0,0 +1,286 @@
+#ifndef RIPPLE_LEDGER_STATEITEMS_H_INCLUDED
+#define RIPPLE_LEDGER_STATEITEMS_H_INCLUDED
+
+#include <ripple/basics/base_uint.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace ripple {
+namespace detail {
+
+template <class Value>
+class StateItems
+{
+public:
+    using key_type = uint256;
+
+private:
+    struct Entry
+    {
+        key_type key;
+        Value value;
+        bool live;
+    };
+
+    enum : std::uint32_t
+    {
+        vacant = 0,
+        tombstone = std::numeric_limits<std::uint32_t>::max()
+    };
+
+    std::vector<Entry> entries_;
+    std::vector<std::uint32_t> slots_;
+    std::size_t live_ = 0;
+
+    // Keys are sorted on the first ordered read after they change. Views
+    // are read from several threads at once, so that sort runs under a
+    // lock. generation_ counts the times sorting moved keys around.
+    mutable std::mutex mutex_;
+    mutable std::atomic<bool> normal_ {true};
+    mutable std::vector<key_type> keys_;
+    mutable std::size_t sorted_ = 0;
+    mutable std::size_t generation_ = 0;
+
+    template <class Other>
+    void
+    assign (Other&& other)
+    {
+        other.keys ();
+        entries_ = std::forward<Other> (other).entries_;
+        slots_ = std::forward<Other> (other).slots_;
+        live_ = other.live_;
+        keys_ = std::forward<Other> (other).keys_;
+        sorted_ = other.sorted_;
+        normal_ = true;
+        ++generation_;
+    }
+
+    std::size_t
+    home (key_type const& key) const
+    {
+        return key_type::hasher{} (key) & (slots_.size () - 1);
+    }
+
+    std::size_t
+    slot (key_type const& key) const
+    {
+        if (slots_.empty ())
+            return slots_.size ();
+        for (auto i = home (key);; i = (i + 1) & (slots_.size () - 1))
+        {
+            auto const s = slots_[i];
+            if (s == vacant)
+                return slots_.size ();
+            if (s != tombstone && entries_[s - 1].key == key)
+                return i;
+        }
+    }
+
+    void
+    rehash ()
+    {
+        std::size_t size = 16;
+        while (size < 2 * (live_ + 1))
+            size *= 2;
+
+        std::vector<Entry> entries;
+        entries.reserve (size / 2);
+        keys_.clear ();
+        sorted_ = 0;
+        normal_ = false;
+        ++generation_;
+        for (auto& e : entries_)
+        {
+            if (e.live)
+            {
+                keys_.push_back (e.key);
+                entries.push_back (std::move (e));
+            }
+        }
+        entries_ = std::move (entries);
+
+        slots_.assign (size, vacant);
+        for (std::size_t i = 0; i < entries_.size (); ++i)
+        {
+            auto s = home (entries_[i].key);
+            while (slots_[s] != vacant)
+                s = (s + 1) & (slots_.size () - 1);
+            slots_[s] = static_cast<std::uint32_t> (i + 1);
+        }
+    }
+
+public:
+    StateItems() = default;
+
+    StateItems (StateItems const& other)
+    {
+        assign (other);
+    }
+
+    StateItems (StateItems&& other)
+    {
+        assign (std::move (other));
+        other.clear ();
+    }
+
+    StateItems&
+    operator= (StateItems const& other)
+    {
+        if (this != &other)
+            assign (other);
+        return *this;
+    }
+
+    StateItems&
+    operator= (StateItems&& other)
+    {
+        if (this != &other)
+        {
+            assign (std::move (other));
+            other.clear ();
+        }
+        return *this;
+    }
+
+    void
+    clear ()
+    {
+        entries_.clear ();
+        slots_.clear ();
+        live_ = 0;
+        keys_.clear ();
+        sorted_ = 0;
+        normal_ = true;
+        ++generation_;
+    }
+
+    std::size_t
+    size () const
+    {
+        return live_;
+    }
+
+    bool
+    empty () const
+    {
+        return live_ == 0;
+    }
+
+    Value const*
+    find (key_type const& key) const
+    {
+        auto const i = slot (key);
+        if (i == slots_.size ())
+            return nullptr;
+        return &entries_[slots_[i] - 1].value;
+    }
+
+    Value*
+    find (key_type const& key)
+    {
+        return const_cast<Value*> (
+            static_cast<StateItems const&> (*this).find (key));
+    }
+
+    std::pair<Value*, bool>
+    emplace (key_type const& key, Value value)
+    {
+        if (auto const v = find (key))
+            return { v, false };
+
+        if (4 * (entries_.size () + 1) > 3 * slots_.size ())
+            rehash ();
+
+        auto s = home (key);
+        while (slots_[s] != vacant && slots_[s] != tombstone)
+            s = (s + 1) & (slots_.size () - 1);
+
+        entries_.push_back ({ key, std::move (value), true });
+        slots_[s] = static_cast<std::uint32_t> (entries_.size ());
+        if (normal_ && ! keys_.empty () && ! (keys_.back () < key))
+            normal_ = false;
+        if (normal_)
+            ++sorted_;
+        keys_.push_back (key);
+        ++live_;
+        return { &entries_.back ().value, true };
+    }
+
+    void
+    erase (key_type const& key)
+    {
+        auto const i = slot (key);
+        if (i == slots_.size ())
+            return;
+        auto& e = entries_[slots_[i] - 1];
+        e.live = false;
+        e.value = Value {};
+        slots_[i] = tombstone;
+        --live_;
+    }
+
+    template <class F>
+    void
+    forEachInserted (F&& f) const
+    {
+        for (auto const& e : entries_)
+        {
+            if (e.live)
+                f (e.key, e.value);
+        }
+    }
+
+    /** The keys in order, including those of erased entries.
+
+        Safe to call from several threads at once. Positions in the
+        result stay valid until generation() changes.
+    */
+    std::vector<key_type> const&
+    keys () const
+    {
+        if (normal_.load (std::memory_order_acquire))
+            return keys_;
+
+        std::lock_guard<std::mutex> lock (mutex_);
+        if (! normal_.load (std::memory_order_relaxed))
+        {
+            auto const mid = keys_.begin () + sorted_;
+            std::sort (mid, keys_.end ());
+            std::inplace_merge (keys_.begin (), mid, keys_.end ());
+            keys_.erase (std::unique (keys_.begin (), keys_.end ()),
+                keys_.end ());
+            sorted_ = keys_.size ();
+            ++generation_;
+            normal_.store (true, std::memory_order_release);
+        }
+        return keys_;
+    }
+
+    /** Changes whenever keys() reorders the keys. Call after keys(). */
+    std::size_t
+    generation () const
+    {
+        return generation_;
+    }
+
+    template <class F>
+    void
+    forEachSorted (F&& f) const
+    {
+        for (auto const& key : keys ())
+        {
+            if (auto const v = find (key))
+                f (key, *v);
+        }
+    }
+};
+
+}
+}
+
+#endif
@@ -1,55 +1,88 @@
 
 
 #include <ripple/ledger/detail/ApplyStateTable.h>
+#include <ripple/basics/Arena.h>
 #include <ripple/basics/Log.h>
 #include <ripple/json/to_string.h>
 #include <ripple/protocol/st.h>
+#include <algorithm>
 #include <cassert>
 
 namespace ripple {
 namespace detail {
 
+// Entries read from the base may be cached beyond this
+// table's lifetime, so they never come from a scoped arena.
+static
+std::shared_ptr<SLE const>
+readBase (ReadView const& base, Keylet const& k)
+{
+    Arena::Scope const outside (nullptr);
+    return base.read (k);
+}
+
+// Entries handed to the open view outlive the transaction. One entry
+// left in the transaction's arena would keep all of its blocks alive,
+// so they are copied to the heap.
+static
+std::shared_ptr<SLE>
+copyOut (std::shared_ptr<SLE> const& sle)
+{
+    if (! sle || ! Arena::active ())
+        return sle;
+    Arena::Scope const outside (nullptr);
+    return std::make_shared<SLE> (*sle);
+}
+
 void
 ApplyStateTable::apply (RawView& to) const
+{
+    apply(to, false);
+}
+
+void
+ApplyStateTable::apply (RawView& to, bool heap) const
 {
     to.rawDestroyXRP(dropsDestroyed_);
-    for (auto const& item : items_)
-    {
-        auto const& sle =
-            item.second.second;
-        switch(item.second.first)
+    items_.forEachInserted (
+        [&to, heap](key_type const&, auto const& item)
         {
-        case Action::cache:
-            break;
-        case Action::erase:
-            to.rawErase(sle);
-            break;
-        case Action::insert:
-            to.rawInsert(sle);
-            break;
-        case Action::modify:
-            to.rawReplace(sle);
-            break;
-        };
-    }
+            auto const sle = heap ?
+                copyOut (item.second) : item.second;
+            switch(item.first)
+            {
+            case Action::cache:
+                break;
+            case Action::erase:
+                to.rawErase(sle);
+                break;
+            case Action::insert:
+                to.rawInsert(sle);
+                break;
+            case Action::modify:
+                to.rawReplace(sle);
+                break;
+            };
+        });
 }
 
 std::size_t
 ApplyStateTable::size () const
 {
     std::size_t ret = 0;
-    for (auto& item : items_)
-    {
-        switch (item.second.first)
+    items_.forEachInserted (
+        [&ret](key_type const&, auto const& item)
         {
-        case Action::erase:
-        case Action::insert:
-        case Action::modify:
-            ++ret;
-        default:
-            break;
-        }
-    }
+            switch (item.first)
+            {
+            case Action::erase:
+            case Action::insert:
+            case Action::modify:
+                ++ret;
+            default:
+                break;
+            }
+        });
     return ret;
 }
 
@@ -61,29 +94,30 @@ ApplyStateTable::visit (ReadView const& to,
         std::shared_ptr <SLE const> const& before,
         std::shared_ptr <SLE const> const& after)> const& func) const
 {
-    for (auto& item : items_)
-    {
-        switch (item.second.first)
+    items_.forEachSorted (
+        [&](key_type const& key, auto const& item)
         {
-        case Action::erase:
-            func (item.first, true,
-                to.read (keylet::unchecked (item.first)), item.second.second);
-            break;
+            switch (item.first)
+            {
+            case Action::erase:
+                func (key, true,
+                    readBase (to, keylet::unchecked (key)), item.second);
+                break;
 
-        case Action::insert:
-            func (item.first, false,
-                nullptr, item.second.second);
-            break;
+            case Action::insert:
+                func (key, false,
+                    nullptr, item.second);
+                break;
 
-        case Action::modify:
-            func (item.first, false,
-                to.read (keylet::unchecked (item.first)), item.second.second);
-            break;
+            case Action::modify:
+                func (key, false,
+                    readBase (to, keylet::unchecked (key)), item.second);
+                break;
 
-        default:
-            break;
-        }
-    }
+            default:
+                break;
+            }
+        });
 }
 
 void
@@ -103,10 +137,14 @@ ApplyStateTable::apply (OpenView& to,
         if (deliver)
             meta.setDeliveredAmount(*deliver);
         Mods newMod;
-        for (auto& item : items_)
+        for (auto const& key : items_.keys())
         {
+            auto const iter = items_.find(key);
+            if (! iter)
+                continue;
+            auto const& item = *iter;
             SField const* type;
-            switch (item.second.first)
+            switch (item.first)
             {
             default:
             case Action::cache:
@@ -122,14 +160,14 @@ ApplyStateTable::apply (OpenView& to,
                 break;
             }
             auto const origNode =
-                to.read(keylet::unchecked(item.first));
-            auto curNode = item.second.second;
+                readBase(to, keylet::unchecked(key));
+            auto curNode = item.second;
             if ((type == &sfModifiedNode) && (*curNode == *origNode))
                 continue;
             std::uint16_t nodeType = curNode
                 ? curNode->getFieldU16 (sfLedgerEntryType)
                 : origNode->getFieldU16 (sfLedgerEntryType);
-            meta.setAffectedNode (item.first, *type, nodeType);
+            meta.setAffectedNode (key, *type, nodeType);
             if (type == &sfDeletedNode)
             {
                 assert (origNode && curNode);
@@ -145,7 +183,7 @@ ApplyStateTable::apply (OpenView& to,
                 }
 
                 if (!prevs.empty ())
-                    meta.getAffectedNode(item.first).emplace_back(std::move(prevs));
+                    meta.getAffectedNode(key).emplace_back(std::move(prevs));
 
                 STObject finals (sfFinalFields);
                 for (auto const& obj : *curNode)
@@ -156,7 +194,7 @@ ApplyStateTable::apply (OpenView& to,
                 }
 
                 if (!finals.empty ())
-                    meta.getAffectedNode (item.first).emplace_back (std::move(finals));
+                    meta.getAffectedNode (key).emplace_back (std::move(finals));
             }
             else if (type == &sfModifiedNode)
             {
@@ -173,7 +211,7 @@ ApplyStateTable::apply (OpenView& to,
                 }
 
                 if (!prevs.empty ())
-                    meta.getAffectedNode (item.first).emplace_back (std::move(prevs));
+                    meta.getAffectedNode (key).emplace_back (std::move(prevs));
 
                 STObject finals (sfFinalFields);
                 for (auto const& obj : *curNode)
@@ -183,7 +221,7 @@ ApplyStateTable::apply (OpenView& to,
                 }
 
                 if (!finals.empty ())
-                    meta.getAffectedNode (item.first).emplace_back (std::move(finals));
+                    meta.getAffectedNode (key).emplace_back (std::move(finals));
             }
             else if (type == &sfCreatedNode) 
             {
@@ -203,7 +241,7 @@ ApplyStateTable::apply (OpenView& to,
                 }
 
                 if (!news.empty ())
-                    meta.getAffectedNode (item.first).emplace_back (std::move(news));
+                    meta.getAffectedNode (key).emplace_back (std::move(news));
             }
             else
             {
@@ -212,7 +250,7 @@ ApplyStateTable::apply (OpenView& to,
         }
 
         for (auto& mod : newMod)
-            to.rawReplace (mod.second);
+            to.rawReplace (copyOut (mod.second));
 
         sMeta = std::make_shared<Serializer>();
         meta.addRaw (*sMeta, ter, to.txCount());
@@ -223,7 +261,7 @@ ApplyStateTable::apply (OpenView& to,
     to.rawTxInsert(
         tx.getTransactionID(),
             sTx, sMeta);
-    apply(to);
+    apply(to, true);
 }
 
 
@@ -232,9 +270,9 @@ ApplyStateTable::exists (ReadView const& base,
     Keylet const& k) const
 {
     auto const iter = items_.find(k.key);
-    if (iter == items_.end())
+    if (! iter)
         return base.exists(k);
-    auto const& item = iter->second;
+    auto const& item = *iter;
     auto const& sle = item.second;
     switch (item.first)
     {
@@ -257,23 +295,24 @@ ApplyStateTable::succ (ReadView const& base,
             boost::optional<key_type>
 {
     boost::optional<key_type> next = key;
-    items_t::const_iterator iter;
+    std::pair<Action, std::shared_ptr<SLE>> const* item;
     do
     {
         next = base.succ(*next, last);
         if (! next)
             break;
-        iter = items_.find(*next);
+        item = items_.find(*next);
     }
-    while (iter != items_.end() &&
-        iter->second.first == Action::erase);
-    for (iter = items_.upper_bound(key);
-        iter != items_.end (); ++iter)
+    while (item && item->first == Action::erase);
+    auto const& keys = items_.keys();
+    for (auto iter = std::upper_bound(keys.begin(), keys.end(), key);
+        iter != keys.end (); ++iter)
     {
-        if (iter->second.first != Action::erase)
+        item = items_.find(*iter);
+        if (item && item->first != Action::erase)
         {
-            if (! next || next > iter->first)
-                next = iter->first;
+            if (! next || next > *iter)
+                next = *iter;
             break;
         }
     }
@@ -287,9 +326,9 @@ ApplyStateTable::read (ReadView const& base,
     Keylet const& k) const
 {
     auto const iter = items_.find(k.key);
-    if (iter == items_.end())
-        return base.read(k);
-    auto const& item = iter->second;
+    if (! iter)
+        return readBase(base, k);
+    auto const& item = *iter;
     auto const& sle = item.second;
     switch (item.first)
     {
@@ -309,22 +348,17 @@ std::shared_ptr<SLE>
 ApplyStateTable::peek (ReadView const& base,
     Keylet const& k)
 {
-    auto iter = items_.lower_bound(k.key);
-    if (iter == items_.end() ||
-        iter->first != k.key)
+    auto const iter = items_.find(k.key);
+    if (! iter)
     {
-        auto const sle = base.read(k);
+        auto const sle = readBase(base, k);
         if (! sle)
             return nullptr;
-        using namespace std;
-        iter = items_.emplace_hint (iter,
-            piecewise_construct,
-                forward_as_tuple(sle->key()),
-                    forward_as_tuple(Action::cache,
-                        make_shared<SLE>(*sle)));
-        return iter->second.second;
+        return items_.emplace(sle->key(), std::make_pair(
+            Action::cache, std::allocate_shared<SLE>(
+                ArenaAllocator<SLE>{}, *sle))).first->second;
     }
-    auto const& item = iter->second;
+    auto const& item = *iter;
     auto const& sle = item.second;
     switch (item.first)
     {
@@ -347,9 +381,9 @@ ApplyStateTable::erase(
 {
     auto const iter =
         items_.find(sle->key());
-    if (iter == items_.end())
+    if (! iter)
         LogicError("ApplyStateTable::erase: missing key");
-    auto& item = iter->second;
+    auto& item = *iter;
     if (item.second != sle)
         LogicError("ApplyStateTable::erase: unknown SLE");
     switch(item.first)
@@ -358,7 +392,7 @@ ApplyStateTable::erase(
         LogicError("ApplyStateTable::erase: double erase");
         break;
     case Action::insert:
-        items_.erase(iter);
+        items_.erase(sle->key());
         break;
     case Action::cache:
     case Action::modify:
@@ -371,21 +405,18 @@ void
 ApplyStateTable::rawErase (ReadView const& base,
     std::shared_ptr<SLE> const& sle)
 {
-    using namespace std;
     auto const result = items_.emplace(
-        piecewise_construct,
-            forward_as_tuple(sle->key()),
-                forward_as_tuple(Action::erase, sle));
+        sle->key(), std::make_pair(Action::erase, sle));
     if (result.second)
         return;
-    auto& item = result.first->second;
+    auto& item = *result.first;
     switch(item.first)
     {
     case Action::erase:
         LogicError("ApplyStateTable::rawErase: double erase");
         break;
     case Action::insert:
-        items_.erase(result.first);
+        items_.erase(sle->key());
         break;
     case Action::cache:
     case Action::modify:
@@ -399,19 +430,11 @@ void
 ApplyStateTable::insert (ReadView const& base,
     std::shared_ptr<SLE> const& sle)
 {
-    auto const iter =
-        items_.lower_bound(sle->key());
-    if (iter == items_.end() ||
-        iter->first != sle->key())
-    {
-        using namespace std;
-        items_.emplace_hint(iter,
-            piecewise_construct,
-                forward_as_tuple(sle->key()),
-                    forward_as_tuple(Action::insert, sle));
+    auto const result = items_.emplace(
+        sle->key(), std::make_pair(Action::insert, sle));
+    if (result.second)
         return;
-    }
-    auto& item = iter->second;
+    auto& item = *result.first;
     switch(item.first)
     {
     case Action::cache:
@@ -431,18 +454,11 @@ void
 ApplyStateTable::replace (ReadView const& base,
     std::shared_ptr<SLE> const& sle)
 {
-    auto const iter =
-        items_.lower_bound(sle->key());
-    if (iter == items_.end() ||
-        iter->first != sle->key())
-    {
-        using namespace std;
-        items_.emplace_hint(iter, piecewise_construct,
-            forward_as_tuple(sle->key()),
-                forward_as_tuple(Action::modify, sle));
+    auto const result = items_.emplace(
+        sle->key(), std::make_pair(Action::modify, sle));
+    if (result.second)
         return;
-    }
-    auto& item = iter->second;
+    auto& item = *result.first;
     switch (item.first)
     {
     case Action::erase:
@@ -463,9 +479,9 @@ ApplyStateTable::update (ReadView const& base,
 {
     auto const iter =
         items_.find(sle->key());
-    if (iter == items_.end())
+    if (! iter)
         LogicError("ApplyStateTable::update: missing key");
-    auto& item = iter->second;
+    auto& item = *iter;
     if (item.second != sle)
         LogicError("ApplyStateTable::update: unknown SLE");
     switch (item.first)
@@ -517,10 +533,10 @@ ApplyStateTable::getForMod (ReadView const& base,
         }
     }
     {
-        auto iter = items_.find (key);
-        if (iter != items_.end ())
+        auto const iter = items_.find (key);
+        if (iter)
         {
-            auto const& item = iter->second;
+            auto const& item = *iter;
             if (item.first == Action::erase)
             {
                 JLOG(j.fatal()) <<
@@ -532,14 +548,14 @@ ApplyStateTable::getForMod (ReadView const& base,
 
         }
     }
-    auto c = base.read (keylet::unchecked (key));
+    auto c = readBase (base, keylet::unchecked (key));
     if (! c)
     {
         JLOG(j.fatal()) <<
             "ApplyStateTable::getForMod: key not found";
         return nullptr;
     }
-    auto sle = std::make_shared<SLE> (*c);
+    auto sle = std::allocate_shared<SLE> (ArenaAllocator<SLE>{}, *c);
     mods.emplace(key, sle);
     return sle;
 }
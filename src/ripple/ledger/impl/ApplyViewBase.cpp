@@ -59,6 +59,12 @@ ApplyViewBase::read (Keylet const& k) const
     return items_.read(*base_, k);
 }
 
+void
+ApplyViewBase::prefetch (key_type const& key) const
+{
+    base_->prefetch(key);
+}
+
 auto
 ApplyViewBase::slesBegin() const ->
     std::unique_ptr<sles_type::iter_base>
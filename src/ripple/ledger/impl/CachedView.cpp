@@ -13,6 +13,17 @@ CachedViewImpl::exists (Keylet const& k) const
     return read(k) != nullptr;
 }
 
+void
+CachedViewImpl::prefetch(key_type const& key) const
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (map_.find(key) != map_.end())
+            return;
+    }
+    base_.prefetch(key);
+}
+
 std::shared_ptr<SLE const>
 CachedViewImpl::read(Keylet const& k) const
 {
@@ -147,6 +147,12 @@ OpenView::read (Keylet const& k) const
     return items_.read(*base_, k);
 }
 
+void
+OpenView::prefetch (key_type const& key) const
+{
+    base_->prefetch(key);
+}
+
 auto
 OpenView::slesBegin() const ->
     std::unique_ptr<sles_type::iter_base>
@@ -14,6 +14,52 @@ namespace ripple {
 
 namespace detail {
 
+// Merge two sorted maps in a single pass, combining values of equal keys
+template <class Map, class Combine>
+static
+void
+mergeInto (Map& to, Map const& from, Combine&& combine)
+{
+    if (from.empty ())
+        return;
+    if (to.empty ())
+    {
+        to = from;
+        return;
+    }
+
+    auto const less = to.key_comp ();
+    auto seq = to.extract_sequence ();
+    typename Map::sequence_type merged;
+    merged.reserve (seq.size () + from.size ());
+
+    auto a = seq.begin ();
+    auto b = from.begin ();
+    while (a != seq.end () && b != from.end ())
+    {
+        if (less (a->first, b->first))
+        {
+            merged.push_back (std::move (*a++));
+        }
+        else if (less (b->first, a->first))
+        {
+            merged.push_back (*b++);
+        }
+        else
+        {
+            combine (a->second, b->second);
+            merged.push_back (std::move (*a++));
+            ++b;
+        }
+    }
+    merged.insert (merged.end (), std::make_move_iterator (a),
+        std::make_move_iterator (seq.end ()));
+    merged.insert (merged.end (), b, from.end ());
+
+    to.adopt_sequence (boost::container::ordered_unique_range,
+        std::move (merged));
+}
+
 auto DeferredCredits::makeKey (AccountID const& a1,
     AccountID const& a2,
     Currency const& c) -> Key
@@ -34,8 +80,8 @@ DeferredCredits::credit (AccountID const& sender,
     assert (!amount.negative());
 
     auto const k = makeKey (sender, receiver, amount.getCurrency ());
-    auto i = credits_.find (k);
-    if (i == credits_.end ())
+    auto i = credits_.lower_bound (k);
+    if (i == credits_.end () || credits_.key_comp () (k, i->first))
     {
         Value v;
 
@@ -52,7 +98,7 @@ DeferredCredits::credit (AccountID const& sender,
             v.lowAcctOrigBalance = -preCreditSenderBalance;
         }
 
-        credits_[k] = v;
+        credits_.emplace_hint (i, k, std::move (v));
     }
     else
     {
@@ -116,28 +162,18 @@ DeferredCredits::adjustments (AccountID const& main,
 void DeferredCredits::apply(
     DeferredCredits& to)
 {
-    for (auto const& i : credits_)
-    {
-        auto r = to.credits_.emplace (i);
-        if (!r.second)
+    mergeInto (to.credits_, credits_,
+        [](Value& toVal, Value const& fromVal)
         {
-            auto& toVal = r.first->second;
-            auto const& fromVal = i.second;
             toVal.lowAcctCredits += fromVal.lowAcctCredits;
             toVal.highAcctCredits += fromVal.highAcctCredits;
-        }
-    }
+        });
 
-    for (auto const& i : ownerCounts_)
-    {
-        auto r = to.ownerCounts_.emplace (i);
-        if (!r.second)
+    mergeInto (to.ownerCounts_, ownerCounts_,
+        [](std::uint32_t& toVal, std::uint32_t fromVal)
         {
-            auto& toVal = r.first->second;
-            auto const& fromVal = i.second;
             toVal = std::max (toVal, fromVal);
-        }
-    }
+        });
 }
 
 } 
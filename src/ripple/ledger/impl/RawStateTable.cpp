@@ -2,6 +2,7 @@
 
 #include <ripple/ledger/detail/RawStateTable.h>
 #include <ripple/basics/contract.h>
+#include <algorithm>
 
 namespace ripple {
 namespace detail {
@@ -10,32 +11,36 @@ class RawStateTable::sles_iter_impl
     : public ReadView::sles_type::iter_base
 {
 private:
+    // The table's keys are walked by position. If the keys are sorted
+    // again while this iterator lives, the position is found again from
+    // the current key.
+    items_t const* items_;
     std::shared_ptr<SLE const> sle0_;
     ReadView::sles_type::iterator iter0_;
     ReadView::sles_type::iterator end0_;
+    std::pair<Action, std::shared_ptr<SLE>> const* item1_ = nullptr;
     std::shared_ptr<SLE const> sle1_;
-    items_t::const_iterator iter1_;
-    items_t::const_iterator end1_;
+    std::size_t index1_;
+    std::size_t generation1_;
 
 public:
     sles_iter_impl (sles_iter_impl const&) = default;
 
-    sles_iter_impl (items_t::const_iterator iter1,
-        items_t::const_iterator end1,
-            ReadView::sles_type::iterator iter0,
-                ReadView::sles_type::iterator end0)
-        : iter0_ (iter0)
+    sles_iter_impl (items_t const& items, std::size_t index1,
+        ReadView::sles_type::iterator iter0,
+            ReadView::sles_type::iterator end0)
+        : items_ (&items)
+        , iter0_ (iter0)
         , end0_ (end0)
-        , iter1_ (iter1)
-        , end1_ (end1)
+        , index1_ (index1)
     {
         if (iter0_ != end0_)
             sle0_ = *iter0_;
-        if (iter1_ != end1)
-        {
-            sle1_ = iter1_->second.second;
+        auto const& keys = items_->keys ();
+        generation1_ = items_->generation ();
+        load1 (keys);
+        if (sle1_)
             skip ();
-        }
     }
 
     std::unique_ptr<base_type>
@@ -49,9 +54,10 @@ public:
     {
         auto const& other = dynamic_cast<
             sles_iter_impl const&>(impl);
-        assert(end1_ == other.end1_ &&
-            end0_ == other.end0_);
-        return iter1_ == other.iter1_ &&
+        assert(end0_ == other.end0_);
+        if (static_cast<bool>(sle1_) != static_cast<bool>(other.sle1_))
+            return false;
+        return (! sle1_ || sle1_->key() == other.sle1_->key()) &&
             iter0_ == other.iter0_;
     }
 
@@ -109,19 +115,38 @@ private:
             sle0_ = *iter0_;
     }
     
-    void inc1()
+    void load1(std::vector<key_type> const& keys)
     {
-        ++iter1_;
-        if (iter1_ == end1_)
+        item1_ = nullptr;
+        while (index1_ < keys.size() &&
+                (item1_ = items_->find (keys[index1_])) == nullptr)
+            ++index1_;
+        if (item1_)
+            sle1_ = item1_->second;
+        else
             sle1_ = nullptr;
+    }
+
+    void inc1()
+    {
+        auto const& keys = items_->keys();
+        if (generation1_ != items_->generation())
+        {
+            generation1_ = items_->generation();
+            index1_ = std::upper_bound(keys.begin(), keys.end(),
+                sle1_->key()) - keys.begin();
+        }
         else
-            sle1_ = iter1_->second.second;
+        {
+            ++index1_;
+        }
+        load1(keys);
     }
     
     void skip()
     {
-        while (iter1_ != end1_ &&
-            iter1_->second.first == Action::erase &&
+        while (item1_ &&
+            item1_->first == Action::erase &&
                sle0_->key() == sle1_->key())
         {
             inc1();
@@ -138,22 +163,22 @@ void
 RawStateTable::apply (RawView& to) const
 {
     to.rawDestroyXRP(dropsDestroyed_);
-    for (auto const& elem : items_)
-    {
-        auto const& item = elem.second;
-        switch(item.first)
+    items_.forEachInserted (
+        [&to](key_type const&, auto const& item)
         {
-        case Action::erase:
-            to.rawErase(item.second);
-            break;
-        case Action::insert:
-            to.rawInsert(item.second);
-            break;
-        case Action::replace:
-            to.rawReplace(item.second);
-            break;
-        }
-    }
+            switch(item.first)
+            {
+            case Action::erase:
+                to.rawErase(item.second);
+                break;
+            case Action::insert:
+                to.rawInsert(item.second);
+                break;
+            case Action::replace:
+                to.rawReplace(item.second);
+                break;
+            }
+        });
 }
 
 bool
@@ -162,9 +187,9 @@ RawStateTable::exists (ReadView const& base,
 {
     assert(k.key.isNonZero());
     auto const iter = items_.find(k.key);
-    if (iter == items_.end())
+    if (! iter)
         return base.exists(k);
-    auto const& item = iter->second;
+    auto const& item = *iter;
     if (item.first == Action::erase)
         return false;
     if (! k.check(*item.second))
@@ -180,23 +205,24 @@ RawStateTable::succ (ReadView const& base,
             boost::optional<key_type>
 {
     boost::optional<key_type> next = key;
-    items_t::const_iterator iter;
+    std::pair<Action, std::shared_ptr<SLE>> const* item;
     do
     {
         next = base.succ(*next, last);
         if (! next)
             break;
-        iter = items_.find(*next);
+        item = items_.find(*next);
     }
-    while (iter != items_.end() &&
-        iter->second.first == Action::erase);
-    for (iter = items_.upper_bound(key);
-        iter != items_.end (); ++iter)
+    while (item && item->first == Action::erase);
+    auto const& keys = items_.keys();
+    for (auto iter = std::upper_bound(keys.begin(), keys.end(), key);
+        iter != keys.end (); ++iter)
     {
-        if (iter->second.first != Action::erase)
+        item = items_.find(*iter);
+        if (item && item->first != Action::erase)
         {
-            if (! next || next > iter->first)
-                next = iter->first;
+            if (! next || next > *iter)
+                next = *iter;
             break;
         }
     }
@@ -210,20 +236,17 @@ RawStateTable::erase(
     std::shared_ptr<SLE> const& sle)
 {
     auto const result = items_.emplace(
-        std::piecewise_construct,
-            std::forward_as_tuple(sle->key()),
-                std::forward_as_tuple(
-                    Action::erase, sle));
+        sle->key(), std::make_pair(Action::erase, sle));
     if (result.second)
         return;
-    auto& item = result.first->second;
+    auto& item = *result.first;
     switch(item.first)
     {
     case Action::erase:
         LogicError("RawStateTable::erase: already erased");
         break;
     case Action::insert:
-        items_.erase(result.first);
+        items_.erase(sle->key());
         break;
     case Action::replace:
         item.first = Action::erase;
@@ -237,13 +260,10 @@ RawStateTable::insert(
     std::shared_ptr<SLE> const& sle)
 {
     auto const result = items_.emplace(
-        std::piecewise_construct,
-            std::forward_as_tuple(sle->key()),
-                std::forward_as_tuple(
-                    Action::insert, sle));
+        sle->key(), std::make_pair(Action::insert, sle));
     if (result.second)
         return;
-    auto& item = result.first->second;
+    auto& item = *result.first;
     switch(item.first)
     {
     case Action::erase:
@@ -264,13 +284,10 @@ RawStateTable::replace(
     std::shared_ptr<SLE> const& sle)
 {
     auto const result = items_.emplace(
-        std::piecewise_construct,
-            std::forward_as_tuple(sle->key()),
-                std::forward_as_tuple(
-                    Action::replace, sle));
+        sle->key(), std::make_pair(Action::replace, sle));
     if (result.second)
         return;
-    auto& item = result.first->second;
+    auto& item = *result.first;
     switch(item.first)
     {
     case Action::erase:
@@ -289,9 +306,9 @@ RawStateTable::read (ReadView const& base,
 {
     auto const iter =
         items_.find(k.key);
-    if (iter == items_.end())
+    if (! iter)
         return base.read(k);
-    auto const& item = iter->second;
+    auto const& item = *iter;
     if (item.first == Action::erase)
         return nullptr;
     std::shared_ptr<
@@ -311,24 +328,24 @@ std::unique_ptr<ReadView::sles_type::iter_base>
 RawStateTable::slesBegin (ReadView const& base) const
 {
     return std::make_unique<sles_iter_impl>(
-        items_.begin(), items_.end(),
-            base.sles.begin(), base.sles.end());
+        items_, 0, base.sles.begin(), base.sles.end());
 }
 
 std::unique_ptr<ReadView::sles_type::iter_base>
 RawStateTable::slesEnd (ReadView const& base) const
 {
+    auto const& keys = items_.keys();
     return std::make_unique<sles_iter_impl>(
-        items_.end(), items_.end(),
-            base.sles.end(), base.sles.end());
+        items_, keys.size(), base.sles.end(), base.sles.end());
 }
 
 std::unique_ptr<ReadView::sles_type::iter_base>
 RawStateTable::slesUpperBound (ReadView const& base, uint256 const& key) const
 {
+    auto const& keys = items_.keys();
     return std::make_unique<sles_iter_impl>(
-            items_.upper_bound(key), items_.end(),
-                base.sles.upper_bound(key), base.sles.end());
+        items_, std::upper_bound(keys.begin(), keys.end(), key) -
+            keys.begin(), base.sles.upper_bound(key), base.sles.end());
 }
 
 } 
@@ -554,6 +554,16 @@ cdirNext (ReadView const& view,
     return true;
 }
 
+void
+prefetchDirectory (ReadView const& view, SLE const& page)
+{
+    if (auto const next = page.getFieldU64 (sfIndexNext))
+        view.prefetch (keylet::page (
+            page.getFieldH256 (sfRootIndex), next).key);
+    for (auto const& index : page.getFieldV256 (sfIndexes))
+        view.prefetch (index);
+}
+
 std::set <uint256>
 getEnabledAmendments (ReadView const& view)
 {
@@ -9,7 +9,10 @@
 #include <ripple/resource/Consumer.h>
 #include <ripple/protocol/Book.h>
 #include <ripple/core/Stoppable.h>
+#include <ripple/server/WSDeflate.h>
+#include <memory>
 #include <mutex>
+#include <string>
 
 namespace ripple {
 
@@ -84,6 +87,60 @@ public:
         virtual bool tryRemoveRpcSub (std::string const& strUrl) = 0;
     };
 
+    /** An event published to many listeners.
+
+        The JSON text is produced on first request and shared by every
+        listener that asks for it, so an event is serialized at most once
+        however many clients are subscribed. Its compressed forms are
+        shared the same way, see WSSharedText. A payload is published from
+        a single thread and must not outlive the value it refers to.
+
+        The stream names the subscription for per-stream send policies.
+        A coalescing payload supersedes any earlier one of the same stream
+        still waiting to be delivered.
+    */
+    class Payload
+    {
+    public:
+        explicit Payload (Json::Value const& jv,
+                char const* stream = "", bool coalesce = false)
+            : jv_ (jv)
+            , stream_ (stream)
+            , coalesce_ (coalesce)
+        {
+        }
+
+        Payload (Payload const&) = delete;
+        Payload& operator= (Payload const&) = delete;
+
+        Json::Value const&
+        json () const
+        {
+            return jv_;
+        }
+
+        std::shared_ptr<WSSharedText const> const&
+        text () const;
+
+        char const*
+        stream () const
+        {
+            return stream_;
+        }
+
+        bool
+        coalesce () const
+        {
+            return coalesce_;
+        }
+
+    private:
+        Json::Value const& jv_;
+        char const* stream_;
+        bool coalesce_;
+        std::shared_ptr<WSSharedText const> mutable text_;
+    };
+
 public:
     InfoSub (Source& source);
     InfoSub (Source& source, Consumer consumer);
@@ -94,6 +151,11 @@ public:
 
     virtual void send (Json::Value const& jvObj, bool broadcast) = 0;
 
+    virtual void send (Payload const& payload, bool broadcast)
+    {
+        send (payload.json (), broadcast);
+    }
+
     std::uint64_t getSeq ();
 
     void onSendEmpty ();
@@ -1,6 +1,7 @@
 
 
 #include <ripple/net/InfoSub.h>
+#include <ripple/json/json_writer.h>
 #include <atomic>
 
 namespace ripple {
@@ -14,6 +15,22 @@ InfoSub::Source::Source (char const* name, Stoppable& parent)
 }
 
 
+std::shared_ptr<WSSharedText const> const&
+InfoSub::Payload::text () const
+{
+    if (! text_)
+    {
+        std::string text;
+        Json::stream (jv_,
+            [&](void const* data, std::size_t n)
+            {
+                text.append (static_cast<char const*> (data), n);
+            });
+        text_ = std::make_shared<WSSharedText> (std::move (text));
+    }
+    return text_;
+}
+
 InfoSub::InfoSub(Source& source)
     : m_source(source)
     , mSeq(assign_id())
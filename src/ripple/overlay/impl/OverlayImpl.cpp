@@ -14,6 +14,7 @@
 #include <ripple/overlay/predicates.h>
 #include <ripple/overlay/impl/ConnectAttempt.h>
 #include <ripple/overlay/impl/PeerImp.h>
+#include <ripple/overlay/impl/Tuning.h>
 #include <ripple/peerfinder/make_Manager.h>
 #include <ripple/rpc/json_body.h>
 #include <ripple/rpc/handlers/GetCounts.h>
@@ -138,6 +139,8 @@ OverlayImpl::OverlayImpl (
     , m_resolver (resolver)
     , next_id_(1)
     , timer_count_(0)
+    , signatures_ (app_.getJobQueue(), Tuning::signatureBatchSize,
+        Tuning::signatureBatchJobs)
 {
     beast::PropertyStream::Source::add (m_peerFinder.get());
 }
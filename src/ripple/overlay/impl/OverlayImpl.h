@@ -6,6 +6,7 @@
 #include <ripple/app/main/Application.h>
 #include <ripple/core/Job.h>
 #include <ripple/overlay/Overlay.h>
+#include <ripple/overlay/impl/SignatureBatcher.h>
 #include <ripple/overlay/impl/TrafficCount.h>
 #include <ripple/server/Handoff.h>
 #include <ripple/rpc/ServerHandler.h>
@@ -109,6 +110,8 @@ private:
     std::condition_variable csCV_;
     std::set<std::uint32_t> csIDs_;
 
+    SignatureBatcher signatures_;
+
 
 public:
     OverlayImpl (Application& app, Setup const& setup, Stoppable& parent,
@@ -139,6 +142,12 @@ public:
         return serverHandler_;
     }
 
+    SignatureBatcher&
+    signatures()
+    {
+        return signatures_;
+    }
+
     Setup const&
     setup() const
     {
@@ -1383,7 +1383,8 @@ PeerImp::onMessage (std::shared_ptr <protocol::TMTransaction> const& m)
         }
 
         constexpr int max_transactions = 250;
-        if (app_.getJobQueue().getJobCount(jtTRANSACTION) > max_transactions)
+        if (app_.getJobQueue().getJobCount(jtTRANSACTION) +
+            overlay_.signatures().size(jtTRANSACTION) > max_transactions)
         {
             overlay_.incJqTransOverflow();
             JLOG(p_journal_.info()) << "Transaction queue is full";
@@ -1394,14 +1395,26 @@ PeerImp::onMessage (std::shared_ptr <protocol::TMTransaction> const& m)
         }
         else
         {
-            app_.getJobQueue ().addJob (
-                jtTRANSACTION, "recvTransaction->checkTransaction",
-                [weak = std::weak_ptr<PeerImp>(shared_from_this()),
+            auto check = [weak = std::weak_ptr<PeerImp>(shared_from_this()),
                 flags, checkSignature, stx] (Job&) {
                     if (auto peer = weak.lock())
                         peer->checkTransaction(flags,
                             checkSignature, stx);
-                });
+                };
+
+            auto const pap = &app_;
+            if (! checkSignature || ! overlay_.signatures().add (
+                jtTRANSACTION, *stx,
+                [pap, check, txID] (Job& job, bool valid) {
+                    forceValidity(pap->getHashRouter(), txID,
+                        valid ? Validity::SigGoodOnly : Validity::SigBad);
+                    check(job);
+                }))
+            {
+                app_.getJobQueue ().addJob (
+                    jtTRANSACTION, "recvTransaction->checkTransaction",
+                    check);
+            }
         }
     }
     catch (std::exception const&)
@@ -1557,12 +1570,23 @@ PeerImp::onMessage (std::shared_ptr <protocol::TMProposeSet> const& m)
             calcNodeID(app_.validatorManifests().getMasterKey(publicKey))});
 
     std::weak_ptr<PeerImp> weak = shared_from_this();
-    app_.getJobQueue ().addJob (
-        isTrusted ? jtPROPOSAL_t : jtPROPOSAL_ut, "recvPropose->checkPropose",
-        [weak, m, proposal] (Job& job) {
+    auto check = [weak, m, proposal] (Job& job, bool valid) {
             if (auto peer = weak.lock())
-                peer->checkPropose(job, m, proposal);
-        });
+                peer->checkPropose(job, m, proposal, valid);
+        };
+
+    auto const type = isTrusted ? jtPROPOSAL_t : jtPROPOSAL_ut;
+    if (cluster())
+    {
+        app_.getJobQueue ().addJob (
+            type, "recvPropose->checkPropose",
+            [check] (Job& job) { check(job, true); });
+    }
+    else
+    {
+        overlay_.signatures().add (type, proposal.publicKey(),
+            proposal.signingHash(), proposal.signature(), false, check);
+    }
 }
 
 void
@@ -1895,14 +1919,26 @@ PeerImp::onMessage (std::shared_ptr <protocol::TMValidation> const& m)
             ! app_.getFeeTrack ().isLoadedLocal ())
         {
             std::weak_ptr<PeerImp> weak = shared_from_this();
-            app_.getJobQueue ().addJob (
-                isTrusted ? jtVALIDATION_t : jtVALIDATION_ut,
-                "recvValidation->checkValidation",
-                [weak, val, m] (Job&)
+            auto check = [weak, val, m] (Job&, bool valid)
                 {
                     if (auto peer = weak.lock())
-                        peer->checkValidation(val, m);
-                });
+                        peer->checkValidation(val, m, valid);
+                };
+
+            auto const type = isTrusted ? jtVALIDATION_t : jtVALIDATION_ut;
+            if (cluster())
+            {
+                app_.getJobQueue ().addJob (
+                    type, "recvValidation->checkValidation",
+                    [check] (Job& job) { check(job, true); });
+            }
+            else
+            {
+                overlay_.signatures().add (type, val->getSignerPublic(),
+                    val->getSigningHash(),
+                    makeSlice(val->getFieldVL(sfSignature)),
+                    val->getFlags() & vfFullyCanonicalSig, check);
+            }
         }
         else
         {
@@ -2166,7 +2202,7 @@ PeerImp::checkTransaction (int flags,
 void
 PeerImp::checkPropose (Job& job,
     std::shared_ptr <protocol::TMProposeSet> const& packet,
-        RCLCxPeerPos peerPos)
+        RCLCxPeerPos peerPos, bool sigValid)
 {
     bool isTrusted = (job.getType () == jtPROPOSAL_t);
 
@@ -2176,7 +2212,7 @@ PeerImp::checkPropose (Job& job,
     assert (packet);
     protocol::TMProposeSet& set = *packet;
 
-    if (! cluster() && !peerPos.checkSign ())
+    if (! sigValid)
     {
         JLOG(p_journal_.warn()) <<
             "Proposal fails sig check";
@@ -2207,11 +2243,11 @@ PeerImp::checkPropose (Job& job,
 
 void
 PeerImp::checkValidation (STValidation::pointer val,
-    std::shared_ptr<protocol::TMValidation> const& packet)
+    std::shared_ptr<protocol::TMValidation> const& packet, bool sigValid)
 {
     try
     {
-        if (! cluster() && !val->isValid())
+        if (! sigValid)
         {
             JLOG(p_journal_.warn()) <<
                 "Validation is invalid";
@@ -412,11 +412,12 @@ private:
     void
     checkPropose (Job& job,
         std::shared_ptr<protocol::TMProposeSet> const& packet,
-            RCLCxPeerPos peerPos);
+            RCLCxPeerPos peerPos, bool sigValid);
 
     void
     checkValidation (STValidation::pointer val,
-        std::shared_ptr<protocol::TMValidation> const& packet);
+        std::shared_ptr<protocol::TMValidation> const& packet,
+            bool sigValid);
 
     void
     getLedger (std::shared_ptr<protocol::TMGetLedger> const&packet);
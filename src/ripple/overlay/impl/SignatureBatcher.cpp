@@ -0,0 +1,100 @@
+
+
+#include <ripple/overlay/impl/SignatureBatcher.h>
+#include <ripple/core/JobQueue.h>
+
+namespace ripple {
+
+SignatureBatcher::SignatureBatcher (JobQueue& jobQueue,
+        std::size_t batchSize, std::size_t maxJobs)
+    : jobQueue_ (jobQueue)
+    , batchSize_ (batchSize)
+    , maxJobs_ (maxJobs)
+{
+}
+
+bool
+SignatureBatcher::add (JobType type, STTx const& tx, Callback cb)
+{
+    BatchVerifier items;
+    if (! tx.addSingleSign (items))
+        return false;
+
+    push (type, items, std::move (cb));
+    return true;
+}
+
+void
+SignatureBatcher::add (JobType type, PublicKey const& publicKey,
+    uint256 const& digest, Slice const& sig,
+        bool mustBeFullyCanonical, Callback cb)
+{
+    BatchVerifier items;
+    items.addDigest (publicKey, digest, sig, mustBeFullyCanonical);
+    push (type, items, std::move (cb));
+}
+
+std::size_t
+SignatureBatcher::size (JobType type) const
+{
+    std::lock_guard<std::mutex> lock (mutex_);
+    auto const it = queues_.find (type);
+    if (it == queues_.end ())
+        return 0;
+
+    std::size_t count = 0;
+    for (auto const& batch : it->second.batches)
+        count += batch.callbacks.size ();
+    return count;
+}
+
+void
+SignatureBatcher::push (JobType type, BatchVerifier& items, Callback&& cb)
+{
+    std::lock_guard<std::mutex> lock (mutex_);
+    auto& queue = queues_[type];
+    if (queue.batches.empty () ||
+            queue.batches.back ().callbacks.size () >= batchSize_)
+        queue.batches.emplace_back ();
+
+    auto& batch = queue.batches.back ();
+    batch.verifier.splice (items);
+    batch.callbacks.push_back (std::move (cb));
+    schedule (type, queue);
+}
+
+void
+SignatureBatcher::schedule (JobType type, Queue& queue)
+{
+    if (queue.jobs >= std::min (maxJobs_, queue.batches.size ()))
+        return;
+
+    if (jobQueue_.addJob (type, "verifySignatures",
+            [this] (Job& job) { process (job); }))
+        ++queue.jobs;
+}
+
+void
+SignatureBatcher::process (Job& job)
+{
+    auto const type = job.getType ();
+
+    Batch batch;
+    {
+        std::lock_guard<std::mutex> lock (mutex_);
+        auto& queue = queues_[type];
+        if (! queue.batches.empty ())
+        {
+            batch = std::move (queue.batches.front ());
+            queue.batches.pop_front ();
+        }
+        --queue.jobs;
+        schedule (type, queue);
+    }
+
+    auto const valid = batch.verifier.verify ();
+    for (std::size_t i = 0; i < batch.callbacks.size (); ++i)
+        batch.callbacks[i] (job, valid[i]);
+}
+
+} 
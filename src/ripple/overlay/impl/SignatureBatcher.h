@@ -0,0 +1,75 @@
+
+
+#ifndef RIPPLE_OVERLAY_SIGNATUREBATCHER_H_INCLUDED
+#define RIPPLE_OVERLAY_SIGNATUREBATCHER_H_INCLUDED
+
+#include <ripple/core/Job.h>
+#include <ripple/protocol/BatchVerifier.h>
+#include <ripple/protocol/STTx.h>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace ripple {
+
+class JobQueue;
+
+
+class SignatureBatcher
+{
+public:
+    using Callback = std::function<void(Job&, bool)>;
+
+    SignatureBatcher (JobQueue& jobQueue,
+        std::size_t batchSize, std::size_t maxJobs);
+
+    SignatureBatcher (SignatureBatcher const&) = delete;
+    SignatureBatcher& operator= (SignatureBatcher const&) = delete;
+
+    
+    bool
+    add (JobType type, STTx const& tx, Callback cb);
+
+    void
+    add (JobType type, PublicKey const& publicKey,
+        uint256 const& digest, Slice const& sig,
+            bool mustBeFullyCanonical, Callback cb);
+
+    std::size_t
+    size (JobType type) const;
+
+private:
+    struct Batch
+    {
+        BatchVerifier verifier;
+        std::vector<Callback> callbacks;
+    };
+
+    struct Queue
+    {
+        std::deque<Batch> batches;
+        std::size_t jobs = 0;
+    };
+
+    void
+    push (JobType type, BatchVerifier& items, Callback&& cb);
+
+    void
+    schedule (JobType type, Queue& queue);
+
+    void
+    process (Job& job);
+
+    JobQueue& jobQueue_;
+    std::size_t const batchSize_;
+    std::size_t const maxJobs_;
+
+    mutable std::mutex mutex_;
+    std::map<JobType, Queue> queues_;
+};
+
+} 
+
+#endif
@@ -50,6 +50,12 @@ enum
 
     
     sendQueueLogFreq    =    64,
+
+    
+    signatureBatchSize  =    64,
+
+    
+    signatureBatchJobs  =     4,
 };
 
 
@@ -0,0 +1,76 @@
+
+
+#ifndef RIPPLE_PROTOCOL_BATCHVERIFIER_H_INCLUDED
+#define RIPPLE_PROTOCOL_BATCHVERIFIER_H_INCLUDED
+
+#include <ripple/basics/Buffer.h>
+#include <ripple/basics/Slice.h>
+#include <ripple/basics/base_uint.h>
+#include <ripple/protocol/PublicKey.h>
+#include <boost/optional.hpp>
+#include <cstddef>
+#include <vector>
+
+namespace ripple {
+
+
+class BatchVerifier
+{
+public:
+    BatchVerifier() = default;
+    BatchVerifier (BatchVerifier&&) = default;
+    BatchVerifier& operator= (BatchVerifier&&) = default;
+
+    std::size_t
+    add (PublicKey const& publicKey,
+        Slice const& m,
+        Slice const& sig,
+        bool mustBeFullyCanonical = true);
+
+    std::size_t
+    addDigest (PublicKey const& publicKey,
+        uint256 const& digest,
+        Slice const& sig,
+        bool mustBeFullyCanonical = true);
+
+    std::size_t
+    size() const
+    {
+        return items_.size();
+    }
+
+    bool
+    empty() const
+    {
+        return items_.empty();
+    }
+
+    void
+    clear()
+    {
+        items_.clear();
+    }
+
+    void
+    splice (BatchVerifier& other);
+
+    
+    std::vector<bool>
+    verify (std::size_t threads = 1) const;
+
+private:
+    struct Item
+    {
+        PublicKey publicKey;
+        boost::optional<uint256> digest;
+        Buffer message;
+        Buffer sig;
+        bool mustBeFullyCanonical;
+    };
+
+    std::vector<Item> items_;
+};
+
+} 
+
+#endif
@@ -168,6 +168,10 @@ boost::optional<ECDSACanonicality>
 ecdsaCanonicality (Slice const& sig);
 
 
+bool
+ed25519Canonical (Slice const& sig);
+
+
 
 boost::optional<KeyType>
 publicKeyType (Slice const& slice);
@@ -3,6 +3,7 @@
 #ifndef RIPPLE_PROTOCOL_STBASE_H_INCLUDED
 #define RIPPLE_PROTOCOL_STBASE_H_INCLUDED
 
+#include <ripple/basics/Arena.h>
 #include <ripple/basics/contract.h>
 #include <ripple/protocol/SField.h>
 #include <ripple/protocol/Serializer.h>
@@ -38,6 +39,38 @@ public:
     bool operator== (const STBase& t) const;
     bool operator!= (const STBase& t) const;
 
+    static
+    void*
+    operator new (std::size_t size)
+    {
+        if (auto const p = Arena::allocate (size))
+            return p;
+        return ::operator new (size);
+    }
+
+    static
+    void*
+    operator new (std::size_t, void* p) noexcept
+    {
+        return p;
+    }
+
+    static
+    void
+    operator delete (void* p) noexcept
+    {
+        if (Arena::owns (p))
+            Arena::deallocate (p);
+        else
+            ::operator delete (p);
+    }
+
+    static
+    void
+    operator delete (void*, void*) noexcept
+    {
+    }
+
     virtual
     STBase*
     copy (std::size_t n, void* buf) const
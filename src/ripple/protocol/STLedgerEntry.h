@@ -38,6 +38,14 @@ public:
 
     STLedgerEntry (STObject const& object, uint256 const& index);
 
+    /** Create an entry whose fields are parsed from data on first access.
+
+        If owner is empty the data is copied; otherwise owner must keep
+        the data alive for as long as the entry, or any copy of it, exists.
+    */
+    STLedgerEntry (Slice data, std::shared_ptr<void const> owner,
+        uint256 const& index);
+
     STBase*
     copy (std::size_t n, void* buf) const override
     {
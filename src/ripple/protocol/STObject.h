@@ -15,6 +15,7 @@
 #include <boost/iterator/transform_iterator.hpp>
 #include <boost/optional.hpp>
 #include <cassert>
+#include <memory>
 #include <stdexcept>
 #include <type_traits>
 #include <utility>
@@ -218,10 +219,19 @@ private:
         reserveSize = 20
     };
 
-    using list_type = std::vector<detail::STVar>;
+    using list_type = std::vector<detail::STVar,
+        ArenaAllocator<detail::STVar>>;
 
-    list_type v_;
+    // Fields of a lazily parsed object are filled in on first access.
+    struct Lazy;
+
+    mutable list_type v_;
     SOTemplate const* mType;
+    std::unique_ptr<Lazy> lazy_;
+
+    void load (int index) const;
+    void loadAll () const;
+    void own ();
 
 public:
     using iterator = boost::transform_iterator<
@@ -235,7 +245,7 @@ public:
     static char const* getCountedObjectName () { return "STObject"; }
 
     STObject(STObject&&);
-    STObject(STObject const&) = default;
+    STObject(STObject const&);
     STObject (const SOTemplate & type, SField const& name);
     STObject (const SOTemplate& type,
         SerialIter& sit, SField const& name) noexcept (false);
@@ -245,7 +255,7 @@ public:
         : STObject(sit, name)
     {
     }
-    STObject& operator= (STObject const&) = default;
+    STObject& operator= (STObject const&);
     STObject& operator= (STObject&& other);
 
     explicit STObject (SField const& name);
@@ -266,11 +276,15 @@ public:
 
     iterator begin() const
     {
+        if (lazy_)
+            loadAll();
         return iterator(v_.begin());
     }
 
     iterator end() const
     {
+        if (lazy_)
+            loadAll();
         return iterator(v_.end());
     }
 
@@ -281,6 +295,7 @@ public:
 
     void reserve (std::size_t n)
     {
+        own ();
         v_.reserve (n);
     }
 
@@ -296,6 +311,15 @@ public:
     void set (const SOTemplate&);
     bool set (SerialIter& u, int depth = 0);
 
+    /** Index the fields in data against a template, deferring their parse.
+
+        Each field is parsed the first time it is accessed. Nested objects,
+        arrays and path sets are parsed immediately. If owner is empty the
+        data is copied; otherwise owner must keep the data alive.
+    */
+    void setLazy (SOTemplate const& type, Slice data,
+        std::shared_ptr<void const> owner = {});
+
     virtual SerializedTypeID getSType () const override
     {
         return STI_OBJECT;
@@ -332,6 +356,7 @@ public:
     std::size_t
     emplace_back(Args&&... args)
     {
+        own();
         v_.emplace_back(std::forward<Args>(args)...);
         return v_.size() - 1;
     }
@@ -351,18 +376,26 @@ public:
 
     const STBase& peekAtIndex (int offset) const
     {
+        if (lazy_)
+            load (offset);
         return v_[offset].get();
     }
     STBase& getIndex(int offset)
     {
+        if (lazy_)
+            load (offset);
         return v_[offset].get();
     }
     const STBase* peekAtPIndex (int offset) const
     {
+        if (lazy_)
+            load (offset);
         return &v_[offset].get();
     }
     STBase* getPIndex (int offset)
     {
+        if (lazy_)
+            load (offset);
         return &v_[offset].get();
     }
 
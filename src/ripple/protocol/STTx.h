@@ -3,6 +3,7 @@
 #ifndef RIPPLE_PROTOCOL_STTX_H_INCLUDED
 #define RIPPLE_PROTOCOL_STTX_H_INCLUDED
 
+#include <ripple/protocol/BatchVerifier.h>
 #include <ripple/protocol/PublicKey.h>
 #include <ripple/protocol/SecretKey.h>
 #include <ripple/protocol/STObject.h>
@@ -109,6 +110,10 @@ public:
     std::pair<bool, std::string>
     checkSign(bool allowMultiSign) const;
 
+    
+    bool
+    addSingleSign(BatchVerifier& batch) const;
+
     static
     std::string const&
     getMetaSQLInsertReplaceHeader ();
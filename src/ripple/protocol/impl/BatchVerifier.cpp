@@ -0,0 +1,115 @@
+
+
+#include <ripple/protocol/BatchVerifier.h>
+#include <ripple/protocol/digest.h>
+#include <ed25519-donna/ed25519.h>
+#include <algorithm>
+#include <iterator>
+#include <thread>
+
+namespace ripple {
+
+std::size_t
+BatchVerifier::add (PublicKey const& publicKey,
+    Slice const& m, Slice const& sig, bool mustBeFullyCanonical)
+{
+    if (publicKeyType (publicKey) == KeyType::secp256k1)
+        return addDigest (publicKey, sha512Half (m), sig,
+            mustBeFullyCanonical);
+
+    items_.push_back ({publicKey, boost::none,
+        Buffer (m.data(), m.size()), Buffer (sig.data(), sig.size()),
+            mustBeFullyCanonical});
+    return items_.size() - 1;
+}
+
+std::size_t
+BatchVerifier::addDigest (PublicKey const& publicKey,
+    uint256 const& digest, Slice const& sig, bool mustBeFullyCanonical)
+{
+    items_.push_back ({publicKey, digest, Buffer (),
+        Buffer (sig.data(), sig.size()), mustBeFullyCanonical});
+    return items_.size() - 1;
+}
+
+void
+BatchVerifier::splice (BatchVerifier& other)
+{
+    items_.insert (items_.end(),
+        std::make_move_iterator (other.items_.begin()),
+        std::make_move_iterator (other.items_.end()));
+    other.items_.clear();
+}
+
+std::vector<bool>
+BatchVerifier::verify (std::size_t threads) const
+{
+    std::vector<char> valid (items_.size(), 0);
+
+    std::vector<std::size_t> ecdsa;
+    std::vector<std::size_t> eddsa;
+    for (std::size_t i = 0; i < items_.size(); ++i)
+    {
+        auto const type = publicKeyType (items_[i].publicKey);
+        if (type == KeyType::secp256k1 && items_[i].digest)
+            ecdsa.push_back (i);
+        else if (type == KeyType::ed25519 && ! items_[i].digest &&
+                ed25519Canonical (items_[i].sig))
+            eddsa.push_back (i);
+    }
+
+    auto checkEdDSA = [&](std::size_t first, std::size_t last)
+    {
+        if (first >= last)
+            return;
+
+        std::vector<unsigned char const*> m;
+        std::vector<std::size_t> mlen;
+        std::vector<unsigned char const*> pk;
+        std::vector<unsigned char const*> rs;
+        std::vector<int> ok (last - first, 0);
+
+        for (auto i = first; i < last; ++i)
+        {
+            auto const& item = items_[eddsa[i]];
+            m.push_back (item.message.data());
+            mlen.push_back (item.message.size());
+            pk.push_back (item.publicKey.data() + 1);
+            rs.push_back (item.sig.data());
+        }
+
+        ed25519_sign_open_batch (m.data(), mlen.data(), pk.data(),
+            rs.data(), ok.size(), ok.data());
+
+        for (auto i = first; i < last; ++i)
+            valid[eddsa[i]] = (ok[i - first] == 1);
+    };
+
+    threads = std::max<std::size_t> (1,
+        std::min (threads, ecdsa.size() + eddsa.size()));
+    auto const chunk = (eddsa.size() + threads - 1) / threads;
+
+    auto check = [&](std::size_t t)
+    {
+        for (auto i = t; i < ecdsa.size(); i += threads)
+        {
+            auto const& item = items_[ecdsa[i]];
+            valid[ecdsa[i]] = verifyDigest (item.publicKey,
+                *item.digest, item.sig, item.mustBeFullyCanonical);
+        }
+
+        auto const first = std::min (eddsa.size(), t * chunk);
+        checkEdDSA (first, std::min (eddsa.size(), first + chunk));
+    };
+
+    std::vector<std::thread> pool;
+    for (std::size_t t = 1; t < threads; ++t)
+        pool.emplace_back (check, t);
+    check (0);
+    for (auto& t : pool)
+        t.join();
+
+    return std::vector<bool> (valid.begin(), valid.end());
+}
+
+} 
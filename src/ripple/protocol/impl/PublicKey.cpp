@@ -113,7 +113,6 @@ ecdsaCanonicality (Slice const& sig)
     return ECDSACanonicality::fullyCanonical;
 }
 
-static
 bool
 ed25519Canonical (Slice const& sig)
 {
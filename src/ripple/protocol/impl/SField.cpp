@@ -1,6 +1,7 @@
 
 
 #include <ripple/protocol/SField.h>
+#include <ripple/protocol/jss.h>
 #include <cassert>
 #include <string>
 #include <utility>
@@ -18,6 +19,18 @@ struct SField::private_access_tag_t
 
 static SField::private_access_tag_t access;
 
+// Member names parsed from requests or built from strings share these
+// instead of being copied.
+static struct InternedNames
+{
+    InternedNames ()
+    {
+#define JSS(x) Json::intern (jss::x)
+#include <ripple/protocol/impl/jss.ipp>
+#undef JSS
+    }
+} const internedNames;
+
 
 SField const sfInvalid      (access, -1);
 SField const sfGeneric      (access, 0);
@@ -204,6 +217,7 @@ SField::SField(private_access_tag_t,
     , jsonName (fieldName.c_str())
 {
     knownCodeToField[fieldCode] = this;
+    Json::intern (jsonName);
 }
 
 SField::SField(private_access_tag_t, int fc)
@@ -51,6 +51,37 @@ STLedgerEntry::STLedgerEntry (
     setSLEType ();
 }
 
+STLedgerEntry::STLedgerEntry (
+        Slice data,
+        std::shared_ptr<void const> owner,
+        uint256 const& index)
+    : STObject (sfLedgerEntry)
+    , key_ (index)
+{
+    // Canonical entries start with their type
+    SerialIter sit (data);
+    int type;
+    int field;
+    sit.getFieldID (type, field);
+    if (type != sfLedgerEntryType.fieldType ||
+        field != sfLedgerEntryType.fieldValue)
+    {
+        SerialIter all (data);
+        set (all);
+        setSLEType ();
+        return;
+    }
+
+    auto const format = LedgerFormats::getInstance().findByType (
+        safe_cast <LedgerEntryType> (sit.get16 ()));
+
+    if (format == nullptr)
+        Throw<std::runtime_error> ("invalid ledger entry type");
+
+    type_ = format->getType ();
+    setLazy (format->getSOTemplate(), data, std::move (owner));
+}
+
 void STLedgerEntry::setSLEType ()
 {
     auto format = LedgerFormats::getInstance().findByType (
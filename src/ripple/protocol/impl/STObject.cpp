@@ -5,10 +5,83 @@
 #include <ripple/protocol/STAccount.h>
 #include <ripple/protocol/STArray.h>
 #include <ripple/protocol/STBlob.h>
+#include <ripple/basics/Buffer.h>
 #include <ripple/basics/Log.h>
+#include <atomic>
+#include <mutex>
 
 namespace ripple {
 
+struct STObject::Lazy
+{
+    std::shared_ptr<void const> owner;
+    Slice data;
+    // Offset and size of each deferred field's value within data
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> fields;
+    std::unique_ptr<std::atomic<bool>[]> ready;
+    std::mutex mutex;
+
+    Lazy (std::shared_ptr<void const> owner_, Slice data_, std::size_t size)
+        : owner (std::move (owner_))
+        , data (data_)
+        , fields (size)
+        , ready (new std::atomic<bool>[size])
+    {
+        for (std::size_t i = 0; i < size; ++i)
+            ready[i].store (true, std::memory_order_relaxed);
+    }
+
+    // The caller must hold other.mutex
+    Lazy (Lazy const& other)
+        : owner (other.owner)
+        , data (other.data)
+        , fields (other.fields)
+        , ready (new std::atomic<bool>[other.fields.size ()])
+    {
+        for (std::size_t i = 0; i < fields.size (); ++i)
+            ready[i].store (other.ready[i].load (std::memory_order_relaxed),
+                std::memory_order_relaxed);
+    }
+};
+
+static
+void
+throwFieldErr (std::string const& field, char const* description)
+{
+    std::stringstream ss;
+    ss << "Field '" << field << "' " << description;
+    std::string text {ss.str()};
+    JLOG (debugLog().error()) << "STObject::applyTemplate failed: " << text;
+    Throw<STObject::FieldErr> (text);
+}
+
+static
+void
+skipField (SerialIter& sit, int type)
+{
+    switch (type)
+    {
+    case STI_UINT8:     sit.skip (1); return;
+    case STI_UINT16:    sit.skip (2); return;
+    case STI_UINT32:    sit.skip (4); return;
+    case STI_UINT64:    sit.skip (8); return;
+    case STI_HASH128:   sit.skip (16); return;
+    case STI_HASH160:   sit.skip (20); return;
+    case STI_HASH256:   sit.skip (32); return;
+    case STI_AMOUNT:
+        if (sit.get64 () & STAmount::cNotNative)
+            sit.skip (40);
+        return;
+    case STI_VL:
+    case STI_ACCOUNT:
+    case STI_VECTOR256:
+        sit.skip (sit.getVLDataLength ());
+        return;
+    default:
+        Throw<std::runtime_error> ("Unknown field type");
+    }
+}
+
 STObject::~STObject()
 {
 #if 0
@@ -21,9 +94,27 @@ STObject::STObject(STObject&& other)
     : STBase(other.getFName())
     , v_(std::move(other.v_))
     , mType(other.mType)
+    , lazy_(std::move(other.lazy_))
 {
 }
 
+STObject::STObject (STObject const& other)
+    : STBase (other)
+    , CountedObject<STObject> (other)
+    , mType (other.mType)
+{
+    if (other.lazy_)
+    {
+        std::lock_guard<std::mutex> lock (other.lazy_->mutex);
+        v_ = other.v_;
+        lazy_ = std::make_unique<Lazy> (*other.lazy_);
+    }
+    else
+    {
+        v_ = other.v_;
+    }
+}
+
 STObject::STObject (SField const& name)
     : STBase (name)
     , mType (nullptr)
@@ -56,17 +147,72 @@ STObject::STObject (
     set(sit, depth);
 }
 
+STObject&
+STObject::operator= (STObject const& other)
+{
+    if (this == &other)
+        return *this;
+    STBase::operator= (other);
+    mType = other.mType;
+    if (other.lazy_)
+    {
+        std::lock_guard<std::mutex> lock (other.lazy_->mutex);
+        v_ = other.v_;
+        lazy_ = std::make_unique<Lazy> (*other.lazy_);
+    }
+    else
+    {
+        v_ = other.v_;
+        lazy_.reset ();
+    }
+    return *this;
+}
+
 STObject&
 STObject::operator= (STObject&& other)
 {
     setFName(other.getFName());
     mType = other.mType;
     v_ = std::move(other.v_);
+    lazy_ = std::move(other.lazy_);
     return *this;
 }
 
+void STObject::load (int index) const
+{
+    auto& lazy = *lazy_;
+    if (lazy.ready[index].load (std::memory_order_acquire))
+        return;
+
+    std::lock_guard<std::mutex> lock (lazy.mutex);
+    if (lazy.ready[index].load (std::memory_order_relaxed))
+        return;
+
+    // Objects shared between threads must not pin a scoped arena
+    Arena::Scope const outside (nullptr);
+    auto const& field = lazy.fields[index];
+    SerialIter sit (lazy.data.data () + field.first, field.second);
+    v_[index] = detail::STVar (sit, v_[index]->getFName (), 1);
+    lazy.ready[index].store (true, std::memory_order_release);
+}
+
+void STObject::loadAll () const
+{
+    if (! lazy_)
+        return;
+    for (std::size_t i = 0; i < v_.size (); ++i)
+        load (i);
+}
+
+void STObject::own ()
+{
+    loadAll ();
+    lazy_.reset ();
+}
+
 void STObject::set (const SOTemplate& type)
 {
+    lazy_.reset();
     v_.clear();
     v_.reserve(type.size());
     mType = &type;
@@ -82,15 +228,7 @@ void STObject::set (const SOTemplate& type)
 
 void STObject::applyTemplate (const SOTemplate& type) noexcept (false)
 {
-    auto throwFieldErr = [] (std::string const& field, char const* description)
-    {
-        std::stringstream ss;
-        ss << "Field '" << field << "' " << description;
-        std::string text {ss.str()};
-        JLOG (debugLog().error()) << "STObject::applyTemplate failed: " << text;
-        Throw<FieldErr> (text);
-    };
-
+    own ();
     mType = &type;
     decltype(v_) v;
     v.reserve(type.size());
@@ -142,6 +280,7 @@ bool STObject::set (SerialIter& sit, int depth) noexcept (false)
 {
     bool reachedEndOfObject = false;
 
+    lazy_.reset();
     v_.clear();
 
     while (!sit.empty ())
@@ -192,6 +331,101 @@ bool STObject::set (SerialIter& sit, int depth) noexcept (false)
     return reachedEndOfObject;
 }
 
+void STObject::setLazy (SOTemplate const& type, Slice data,
+    std::shared_ptr<void const> owner)
+{
+    if (! owner)
+    {
+        auto const copy = std::make_shared<Buffer> (data.data (), data.size ());
+        data = Slice (copy->data (), copy->size ());
+        owner = copy;
+    }
+
+    lazy_.reset();
+    v_.clear();
+    v_.reserve(type.size());
+    mType = &type;
+    for (auto const& e : type)
+        v_.emplace_back(detail::nonPresentObject, e.sField());
+
+    auto lazy = std::make_unique<Lazy> (std::move (owner), data, type.size ());
+    std::vector<bool> present (type.size (), false);
+
+    SerialIter sit (data);
+    while (!sit.empty ())
+    {
+        int id;
+        int field;
+
+        sit.getFieldID (id, field);
+
+        if (id == STI_OBJECT && field == 1)
+            break;
+
+        if (id == STI_ARRAY && field == 1)
+            Throw<std::runtime_error>("Illegal end-of-array marker in object");
+
+        auto const& fn = SField::getField (id, field);
+
+        if (fn.isInvalid ())
+        {
+            JLOG (debugLog().error())
+                << "Unknown field: field_type=" << id
+                << ", field_name=" << field;
+            Throw<std::runtime_error> ("Unknown field");
+        }
+
+        auto const index = type.getIndex (fn);
+        if (index != -1 && present[index])
+            Throw<std::runtime_error> ("Duplicate field detected");
+
+        if (index == -1 || id == STI_OBJECT ||
+            id == STI_ARRAY || id == STI_PATHSET)
+        {
+            detail::STVar v (sit, fn, 1);
+            if (index == -1)
+            {
+                if (! fn.isDiscardable ())
+                    throwFieldErr (fn.getName (),
+                        "found in disallowed location.");
+                continue;
+            }
+            if (auto const obj = dynamic_cast<STObject*>(&v.get()))
+                obj->applyTemplateFromSField (fn);
+            v_[index] = std::move (v);
+        }
+        else
+        {
+            auto const start = data.size () - sit.getBytesLeft ();
+            skipField (sit, id);
+            auto const end = data.size () - sit.getBytesLeft ();
+            lazy->fields[index] = { static_cast<std::uint32_t> (start),
+                static_cast<std::uint32_t> (end - start) };
+            lazy->ready[index].store (false, std::memory_order_relaxed);
+        }
+        present[index] = true;
+    }
+
+    lazy_ = std::move (lazy);
+
+    int i = 0;
+    for (auto const& e : type)
+    {
+        if (! present[i])
+        {
+            if (e.style () == soeREQUIRED)
+                throwFieldErr (e.sField ().fieldName,
+                    "is required but missing.");
+        }
+        else if (e.style () == soeDEFAULT && peekAtIndex (i).isDefault ())
+        {
+            throwFieldErr (e.sField ().fieldName,
+                "may not be explicitly set to default.");
+        }
+        ++i;
+    }
+}
+
 bool STObject::hasMatchingEntry (const STBase& t)
 {
     const STBase* o = peekAtPField (t.getFName ());
@@ -214,6 +448,7 @@ std::string STObject::getFullText () const
     }
     else ret = "{";
 
+    loadAll ();
     for (auto const& elem : v_)
     {
         if (elem->getSType () != STI_NOTPRESENT)
@@ -235,6 +470,7 @@ std::string STObject::getText () const
 {
     std::string ret = "{";
     bool first = false;
+    loadAll ();
     for (auto const& elem : v_)
     {
         if (! first)
@@ -329,7 +565,7 @@ STBase& STObject::getField (SField const& field)
 SField const&
 STObject::getFieldSType (int index) const
 {
-    return v_[index]->getFName ();
+    return peekAtIndex (index).getFName ();
 }
 
 const STBase* STObject::peekAtPField (SField const& field) const
@@ -364,7 +600,11 @@ bool STObject::isFieldPresent (SField const& field) const
     if (index == -1)
         return false;
 
-    return peekAtIndex (index).getSType () != STI_NOTPRESENT;
+    // A deferred field was present in the serialized form
+    if (lazy_ && ! lazy_->ready[index].load (std::memory_order_acquire))
+        return true;
+
+    return v_[index]->getSType () != STI_NOTPRESENT;
 }
 
 STObject& STObject::peekFieldObject (SField const& field)
@@ -464,6 +704,7 @@ bool STObject::delField (SField const& field)
 
 void STObject::delField (int index)
 {
+    own ();
     v_.erase (v_.begin () + index);
 }
 
@@ -545,6 +786,8 @@ STObject::set (std::unique_ptr<STBase> v)
         getFieldIndex(v->getFName());
     if (i != -1)
     {
+        if (lazy_)
+            load (i);
         v_[i] = std::move(*v);
     }
     else
@@ -552,6 +795,7 @@ STObject::set (std::unique_ptr<STBase> v)
         if (! isFree())
             Throw<std::runtime_error> (
                 "missing field in templated STObject");
+        own();
         v_.emplace_back(std::move(*v));
     }
 }
@@ -626,6 +870,7 @@ Json::Value STObject::getJson (JsonOptions options) const
 {
     Json::Value ret (Json::objectValue);
 
+    loadAll ();
     for (auto const& elem : v_)
     {
         if (elem->getSType () != STI_NOTPRESENT)
@@ -636,6 +881,9 @@ Json::Value STObject::getJson (JsonOptions options) const
 
 bool STObject::operator== (const STObject& obj) const
 {
+    loadAll ();
+    obj.loadAll ();
+
     int matches = 0;
     for (auto const& t1 : v_)
     {
@@ -696,6 +944,7 @@ STObject::getSortedFields (
 {
     std::vector<STBase const*> sf;
     sf.reserve (objToSort.getCount());
+    objToSort.loadAll ();
 
     for (detail::STVar const& elem : objToSort.v_)
     {
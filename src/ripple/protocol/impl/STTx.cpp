@@ -270,6 +270,30 @@ std::pair<bool, std::string> STTx::checkSingleSign () const
     return {true, ""};
 }
 
+bool STTx::addSingleSign (BatchVerifier& batch) const
+{
+    if (isFieldPresent (sfSigners))
+        return false;
+
+    try
+    {
+        auto const spk = getFieldVL (sfSigningPubKey);
+        if (! publicKeyType (makeSlice(spk)))
+            return false;
+
+        batch.add (
+            PublicKey (makeSlice(spk)),
+            makeSlice(getSigningData (*this)),
+            makeSlice(getFieldVL (sfTxnSignature)),
+            getFlags() & tfFullyCanonicalSig);
+    }
+    catch (std::exception const&)
+    {
+        return false;
+    }
+    return true;
+}
+
 std::pair<bool, std::string> STTx::checkMultiSign () const
 {
     if (!isFieldPresent (sfSigners))
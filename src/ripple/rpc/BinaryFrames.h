@@ -0,0 +1,131 @@
+#ifndef RIPPLE_RPC_BINARYFRAMES_H_INCLUDED
+#define RIPPLE_RPC_BINARYFRAMES_H_INCLUDED
+
+#include <ripple/basics/Slice.h>
+#include <ripple/basics/base_uint.h>
+#include <ripple/json/json_value.h>
+#include <ripple/json/Output.h>
+#include <ripple/ledger/ReadView.h>
+#include <cstdint>
+#include <string>
+
+namespace ripple {
+namespace RPC {
+
+/** A compact binary form of a bulk RPC response.
+
+    Requests with "frames": true are answered with a sequence of frames
+    instead of JSON. Each frame is a four byte big-endian payload length,
+    a one byte type and the payload. The frames hold the serialized
+    objects; the last one holds the JSON result without its bulk array.
+
+    Handlers that support this form append to Context::frames when it is
+    set. Handlers that do not leave it untouched and answer in JSON.
+*/
+class BinaryFrames
+{
+public:
+    BinaryFrames() = default;
+
+    /** Passes frames to `output` as they are added instead of keeping
+        them, so a large response can be sent while it is produced.
+    */
+    explicit
+    BinaryFrames (Json::Output output)
+        : output_ (std::move (output))
+    {
+    }
+
+    BinaryFrames (BinaryFrames const&) = delete;
+    BinaryFrames& operator= (BinaryFrames const&) = delete;
+
+    enum Type : std::uint8_t
+    {
+        /** The JSON result as text. */
+        header = 0,
+
+        /** A serialized ledger header. */
+        ledger = 1,
+
+        /** A 32 byte key followed by a serialized ledger entry. */
+        entry = 2,
+
+        /** A four byte ledger sequence, a four byte transaction length,
+            the serialized transaction and then its serialized metadata.
+        */
+        transaction = 3,
+    };
+
+    /** Marks the response as binary, even if no frames follow.
+
+        Frames are held until this is called and passed to the output
+        from then on. Handlers call it once the request is validated,
+        since an error after the first frame is sent can no longer be
+        answered in JSON.
+    */
+    void
+    accept();
+
+    bool
+    accepted() const
+    {
+        return accepted_;
+    }
+
+    void
+    addLedger (LedgerInfo const& info);
+
+    void
+    addEntry (uint256 const& key, Slice const& data);
+
+    void
+    addTransaction (std::uint32_t seq, Slice const& txn, Slice const& meta);
+
+    /** The number of frames added, not counting the header. */
+    std::size_t
+    count() const
+    {
+        return count_;
+    }
+
+    /** Returns `true` if frames were passed to the output. */
+    bool
+    streamed() const
+    {
+        return streamed_;
+    }
+
+    /** Ends the response with a header frame for `result`.
+
+        @return The frames not passed to the output, including the header
+                frame. This is the complete response if there is no output.
+    */
+    std::string
+    finish (Json::Value const& result);
+
+    /** The number of bytes in the response, once it is finished. */
+    std::size_t
+    size() const
+    {
+        return size_;
+    }
+
+private:
+    void
+    start (Type type, std::size_t size);
+
+    void
+    append (void const* data, std::size_t size);
+
+    Json::Output output_;
+    std::string data_;
+    std::size_t size_ = 0;
+    std::size_t count_ = 0;
+    bool accepted_ = false;
+    bool streamed_ = false;
+};
+
+}
+}
+
+#endif
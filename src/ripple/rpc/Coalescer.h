@@ -0,0 +1,84 @@
+#ifndef RIPPLE_RPC_COALESCER_H_INCLUDED
+#define RIPPLE_RPC_COALESCER_H_INCLUDED
+
+#include <ripple/core/JobQueue.h>
+#include <ripple/json/json_value.h>
+#include <ripple/resource/Charge.h>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ripple {
+namespace RPC {
+
+/** Shares the work of identical requests that are in flight together.
+
+    The first request for a key computes the result. Requests for the
+    same key that arrive before it finishes wait for it and receive the
+    same serialized result instead of computing their own. Nothing is
+    kept once the computation finishes.
+*/
+class Coalescer
+{
+public:
+    /** The outcome of a request, shared by everyone who asked for it. */
+    struct Result
+    {
+        /** The result object as JSON text, without a status. */
+        std::string text;
+
+        /** Whether the result is an error. */
+        bool error;
+
+        Resource::Charge loadType;
+    };
+
+    using Compute = std::function<std::shared_ptr<Result const> ()>;
+
+    /** Returns the result for `key`, computing it unless it is in flight.
+
+        A request that waits suspends `coro` until the result is ready, so
+        it does not hold a job thread. Without a coroutine it blocks.
+        If `compute` throws, the exception is rethrown to every request
+        waiting on it.
+    */
+    std::shared_ptr<Result const>
+    join (std::string const& method, std::string const& key,
+        std::shared_ptr<JobQueue::Coro> const& coro, Compute const& compute);
+
+    /** Computed and coalesced request counts, by method. */
+    Json::Value
+    getJson () const;
+
+private:
+    struct Flight
+    {
+        std::shared_ptr<Result const> result;
+        std::exception_ptr exception;
+        bool done = false;
+        std::vector<std::shared_ptr<JobQueue::Coro>> waiters;
+    };
+
+    struct Stats
+    {
+        std::uint64_t computed = 0;
+        std::uint64_t coalesced = 0;
+    };
+
+    std::mutex mutable mutex_;
+    std::condition_variable cv_;
+    std::unordered_map<std::string, std::shared_ptr<Flight>> flights_;
+    std::map<std::string, Stats> stats_;
+};
+
+}
+}
+
+#endif
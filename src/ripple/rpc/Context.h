@@ -15,9 +15,11 @@ namespace ripple {
 class Application;
 class NetworkOPs;
 class LedgerMaster;
+class ReadView;
 
 namespace RPC {
 
+class BinaryFrames;
 
 struct Context
 {
@@ -39,6 +41,10 @@ struct Context
     std::shared_ptr<JobQueue::Coro> coro;
     InfoSub::pointer infoSub;
     Headers headers;
+    BinaryFrames* frames = nullptr;
+
+    /** The ledger named by params, once it has been looked up. */
+    std::shared_ptr<ReadView const> ledger;
 };
 
 } 
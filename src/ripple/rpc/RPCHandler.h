@@ -5,9 +5,14 @@
 
 #include <ripple/core/Config.h>
 #include <ripple/net/InfoSub.h>
+#include <ripple/rpc/Coalescer.h>
 #include <ripple/rpc/Context.h>
 #include <ripple/rpc/Status.h>
 
+namespace Json {
+class Object;
+}
+
 namespace ripple {
 namespace RPC {
 
@@ -16,6 +21,21 @@ struct Context;
 
 Status doCommand (RPC::Context&, Json::Value&);
 
+/** Execute an RPC command, writing its result as it is produced. */
+Status doCommand (RPC::Context&, Json::Object&);
+
+/** Execute an RPC command whose result may be shared.
+
+    Identical requests in flight together share one computation and its
+    serialized result. Returns nullptr, without running the command, if
+    the request can not be shared.
+*/
+std::shared_ptr<Coalescer::Result const>
+doSharedCommand (RPC::Context&);
+
+/** Returns true if the method can write its result incrementally. */
+bool streamsResult (std::string const& method);
+
 Role roleRequired (std::string const& method );
 
 } 
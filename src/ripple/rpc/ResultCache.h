@@ -0,0 +1,87 @@
+#ifndef RIPPLE_RPC_RESULTCACHE_H_INCLUDED
+#define RIPPLE_RPC_RESULTCACHE_H_INCLUDED
+
+#include <ripple/json/json_value.h>
+#include <ripple/resource/Charge.h>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace ripple {
+namespace RPC {
+
+/** Results of RPC requests that can never change.
+
+    A request against a validated ledger, named by hash or sequence,
+    always produces the same answer. Such results are kept here, keyed
+    by the normalized request and the ledger hash, and the least recently
+    used ones are dropped once the byte budget is exceeded. A budget of
+    zero disables the cache.
+*/
+class ResultCache
+{
+public:
+    explicit
+    ResultCache (std::size_t maxBytes)
+        : maxBytes_ (maxBytes)
+    {
+    }
+
+    bool
+    enabled () const
+    {
+        return maxBytes_ != 0;
+    }
+
+    /** A cached result and the charge for computing it. */
+    struct Result
+    {
+        Json::Value value;
+        Resource::Charge loadType;
+    };
+
+    /** Returns the cached result for `key`, or nullptr. */
+    std::shared_ptr<Result const>
+    fetch (std::string const& key);
+
+    void
+    insert (std::string const& key, Json::Value const& result,
+        Resource::Charge const& loadType);
+
+    float
+    getHitRate () const;
+
+    std::size_t
+    size () const;
+
+    /** The approximate number of bytes held. */
+    std::size_t
+    bytes () const;
+
+private:
+    struct Entry
+    {
+        std::string key;
+        std::shared_ptr<Result const> result;
+        std::size_t bytes;
+    };
+
+    using List = std::list<Entry>;
+
+    std::size_t const maxBytes_;
+
+    mutable std::mutex mutex_;
+    List entries_;
+    std::unordered_map<std::string, List::iterator> index_;
+    std::size_t bytes_ = 0;
+    std::uint64_t hits_ = 0;
+    std::uint64_t misses_ = 0;
+};
+
+}
+}
+
+#endif
@@ -4,6 +4,7 @@
 #include <ripple/app/main/Application.h>
 #include <ripple/app/misc/NetworkOPs.h>
 #include <ripple/app/misc/Transaction.h>
+#include <ripple/basics/StringUtilities.h>
 #include <ripple/json/json_value.h>
 #include <ripple/ledger/ReadView.h>
 #include <ripple/net/RPCErr.h>
@@ -11,6 +12,7 @@
 #include <ripple/protocol/jss.h>
 #include <ripple/protocol/UintTypes.h>
 #include <ripple/resource/Fees.h>
+#include <ripple/rpc/BinaryFrames.h>
 #include <ripple/rpc/Context.h>
 #include <ripple/rpc/DeliveredAmount.h>
 #include <ripple/rpc/impl/RPCHelpers.h>
@@ -103,7 +105,23 @@ Json::Value doAccountTx (RPC::Context& context)
         ret[jss::account] = context.app.accountIDCache().toBase58(*account);
         Json::Value& jvTxns = (ret[jss::transactions] = Json::arrayValue);
 
-        if (bBinary)
+        if (auto const frames = context.frames)
+        {
+            auto txns = context.netOps.getTxsAccountB (
+                *account, uLedgerMin, uLedgerMax, bForward, resumeToken, limit,
+                isUnlimited (context.role));
+
+            frames->accept ();
+            for (auto& it: txns)
+            {
+                auto const txn = strUnHex (std::get<0> (it));
+                auto const meta = strUnHex (std::get<1> (it));
+                frames->addTransaction (std::get<2> (it),
+                    makeSlice (txn.first), makeSlice (meta.first));
+            }
+            ret.removeMember (jss::transactions);
+        }
+        else if (bBinary)
         {
             auto txns = context.netOps.getTxsAccountB (
                 *account, uLedgerMin, uLedgerMax, bForward, resumeToken, limit,
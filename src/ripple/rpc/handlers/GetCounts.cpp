@@ -5,6 +5,7 @@
 #include <ripple/app/ledger/LedgerMaster.h>
 #include <ripple/app/main/Application.h>
 #include <ripple/app/misc/NetworkOPs.h>
+#include <ripple/app/paths/PathRequests.h>
 #include <ripple/basics/UptimeClock.h>
 #include <ripple/core/DatabaseCon.h>
 #include <ripple/json/json_value.h>
@@ -14,7 +15,9 @@
 #include <ripple/nodestore/DatabaseShard.h>
 #include <ripple/protocol/ErrorCodes.h>
 #include <ripple/protocol/jss.h>
+#include <ripple/rpc/Coalescer.h>
 #include <ripple/rpc/Context.h>
+#include <ripple/rpc/ResultCache.h>
 
 namespace ripple {
 
@@ -81,6 +84,20 @@ Json::Value getCountsJson(Application& app, int minObjectCount)
     ret[jss::node_hit_rate] = app.getNodeStore ().getCacheHitRate ();
     ret[jss::ledger_hit_rate] = app.getLedgerMaster ().getCacheHitRate ();
     ret[jss::AL_hit_rate] = app.getAcceptedLedgerCache ().getHitRate ();
+    ret[jss::line_cache_hit_rate] =
+        app.getPathRequests ().getLineCacheHitRate ();
+    ret[jss::line_cache_size] = static_cast<Json::UInt> (
+        app.getPathRequests ().getLineCacheSize ());
+
+    auto& rpcCache = app.getRPCResultCache ();
+    if (rpcCache.enabled ())
+    {
+        ret[jss::rpc_cache_hit_rate] = rpcCache.getHitRate ();
+        ret[jss::rpc_cache_size] = static_cast<Json::UInt> (rpcCache.size ());
+        ret[jss::rpc_cache_bytes] = static_cast<Json::UInt> (
+            rpcCache.bytes ());
+    }
+    ret[jss::rpc_coalesced] = app.getRPCCoalescer ().getJson ();
 
     ret[jss::fullbelow_size] = static_cast<int>(app.family().fullbelow().size());
     ret[jss::treenode_cache_size] = app.family().treecache().getCacheSize();
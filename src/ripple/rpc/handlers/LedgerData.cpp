@@ -5,6 +5,7 @@
 #include <ripple/protocol/ErrorCodes.h>
 #include <ripple/protocol/jss.h>
 #include <ripple/protocol/LedgerFormats.h>
+#include <ripple/rpc/BinaryFrames.h>
 #include <ripple/rpc/impl/RPCHelpers.h>
 #include <ripple/rpc/impl/Tuning.h>
 #include <ripple/rpc/Context.h>
@@ -30,7 +31,8 @@ Json::Value doLedgerData (RPC::Context& context)
             return RPC::expected_field_error (jss::marker, "valid");
     }
 
-    bool const isBinary = params[jss::binary].asBool();
+    auto const frames = context.frames;
+    bool const isBinary = frames || params[jss::binary].asBool();
 
     int limit = -1;
     if (params.isMember (jss::limit))
@@ -46,24 +48,31 @@ Json::Value doLedgerData (RPC::Context& context)
     if ((limit < 0) || ((limit > maxLimit) && (! isUnlimited (context.role))))
         limit = maxLimit;
 
+    auto type = RPC::chooseLedgerEntryType(params);
+    if (type.first)
+    {
+        jvResult.clear();
+        type.first.inject(jvResult);
+        return jvResult;
+    }
+
     jvResult[jss::ledger_hash] = to_string (lpLedger->info().hash);
     jvResult[jss::ledger_index] = lpLedger->info().seq;
 
-    if (! isMarker)
+    if (frames)
+    {
+        frames->accept ();
+        if (! isMarker)
+            frames->addLedger (lpLedger->info());
+    }
+    else if (! isMarker)
     {
         jvResult[jss::ledger] = getJson (
             LedgerFill (*lpLedger, isBinary ?
                 LedgerFill::Options::binary : 0));
     }
 
-    auto type = RPC::chooseLedgerEntryType(params);
-    if (type.first)
-    {
-        jvResult.clear();
-        type.first.inject(jvResult);
-        return jvResult;
-    }
-    Json::Value& nodes = jvResult[jss::state];
+    Json::Value nodes (Json::arrayValue);
 
     auto e = lpLedger->sles.end();
     for (auto i = lpLedger->sles.upper_bound(key); i != e; ++i)
@@ -78,7 +87,11 @@ Json::Value doLedgerData (RPC::Context& context)
 
         if (type.second == ltINVALID || sle->getType () == type.second)
         {
-            if (isBinary)
+            if (frames)
+            {
+                frames->addEntry (sle->key(), sle->getSerializer().slice());
+            }
+            else if (isBinary)
             {
                 Json::Value& entry = nodes.append (Json::objectValue);
                 entry[jss::data] = serializeHex(*sle);
@@ -92,6 +105,9 @@ Json::Value doLedgerData (RPC::Context& context)
         }
     }
 
+    if (! frames)
+        jvResult[jss::state] = std::move (nodes);
+
     return jvResult;
 }
 
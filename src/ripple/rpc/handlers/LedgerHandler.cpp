@@ -8,6 +8,7 @@
 #include <ripple/protocol/ErrorCodes.h>
 #include <ripple/protocol/jss.h>
 #include <ripple/resource/Fees.h>
+#include <ripple/rpc/BinaryFrames.h>
 #include <ripple/rpc/impl/RPCHelpers.h>
 #include <ripple/rpc/Role.h>
 
@@ -76,6 +77,38 @@ Status LedgerHandler::check()
     return Status::OK;
 }
 
+int LedgerHandler::writeFrames (BinaryFrames& frames) const
+{
+    auto const& ledger = *ledger_;
+    bool const full = options_ & LedgerFill::full;
+
+    frames.accept ();
+    frames.addLedger (ledger.info());
+
+    if (full || options_ & LedgerFill::dumpTxrp)
+    {
+        for (auto const& tx : ledger.txs)
+        {
+            auto const meta = tx.second ?
+                tx.second->getSerializer() : Serializer();
+            frames.addTransaction (ledger.info().seq,
+                tx.first->getSerializer().slice(), meta.slice());
+        }
+    }
+
+    if (full || options_ & LedgerFill::dumpState)
+    {
+        for (auto const& sle : ledger.sles)
+        {
+            if (type_ == ltINVALID || sle->getType () == type_)
+                frames.addEntry (sle->key(), sle->getSerializer().slice());
+        }
+    }
+
+    return options_ & ~(LedgerFill::full | LedgerFill::expand |
+        LedgerFill::dumpTxrp | LedgerFill::dumpState);
+}
+
 } 
 } 
 
@@ -49,6 +49,12 @@ public:
     }
 
 private:
+    /** Appends the ledger contents to `frames`.
+
+        @return The options left for the JSON result.
+    */
+    int writeFrames (BinaryFrames& frames) const;
+
     Context& context_;
     std::shared_ptr<ReadView const> ledger_;
     std::vector<TxQ::TxDetails> queueTxs_;
@@ -64,7 +70,9 @@ void LedgerHandler::writeResult (Object& value)
     if (ledger_)
     {
         Json::copyFrom (value, result_);
-        addJson (value, {*ledger_, options_, queueTxs_, type_});
+        auto const options = context_.frames ?
+            writeFrames (*context_.frames) : options_;
+        addJson (value, {*ledger_, options, queueTxs_, type_});
     }
     else
     {
@@ -1,10 +1,12 @@
 
 
+#include <ripple/app/main/Application.h>
 #include <ripple/app/misc/NetworkOPs.h>
 #include <ripple/json/json_value.h>
 #include <ripple/net/RPCErr.h>
 #include <ripple/protocol/jss.h>
 #include <ripple/rpc/Context.h>
+#include <ripple/rpc/ServerHandler.h>
 #include <ripple/rpc/impl/TransactionSign.h>
 #include <ripple/rpc/Role.h>
 
@@ -14,10 +16,19 @@ Json::Value doServerInfo (RPC::Context& context)
 {
     Json::Value ret (Json::objectValue);
 
-    ret[jss::info] = context.netOps.getServerInfo (
-        true, context.role == Role::ADMIN,
-        context.params.isMember(jss::counters) &&
-            context.params[jss::counters].asBool());
+    bool const admin = context.role == Role::ADMIN;
+    bool const counters = context.params.isMember(jss::counters) &&
+        context.params[jss::counters].asBool();
+
+    ret[jss::info] = context.netOps.getServerInfo (true, admin, counters);
+
+    if (admin && counters)
+    {
+        ret[jss::info][jss::websocket_sessions] =
+            context.app.getServerHandler().getWSSessionsJson();
+        ret[jss::info][jss::websocket_compression] =
+            context.app.getServerHandler().getWSCompressionJson();
+    }
 
     return ret;
 }
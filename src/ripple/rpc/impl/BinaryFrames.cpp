@@ -0,0 +1,89 @@
+#include <ripple/rpc/BinaryFrames.h>
+#include <ripple/json/to_string.h>
+#include <ripple/protocol/Serializer.h>
+
+namespace ripple {
+namespace RPC {
+
+void
+BinaryFrames::append (void const* data, std::size_t size)
+{
+    size_ += size;
+    if (output_ && accepted_)
+    {
+        output_ ({static_cast<char const*> (data), size});
+        streamed_ = true;
+    }
+    else
+        data_.append (static_cast<char const*> (data), size);
+}
+
+void
+BinaryFrames::start (Type type, std::size_t size)
+{
+    std::uint8_t const head[] = {
+        static_cast<std::uint8_t> (size >> 24),
+        static_cast<std::uint8_t> (size >> 16),
+        static_cast<std::uint8_t> (size >> 8),
+        static_cast<std::uint8_t> (size),
+        type};
+    append (head, sizeof (head));
+    if (type != header)
+        ++count_;
+}
+
+void
+BinaryFrames::accept ()
+{
+    accepted_ = true;
+    if (output_ && ! data_.empty ())
+    {
+        output_ (data_);
+        data_.clear ();
+        streamed_ = true;
+    }
+}
+
+void
+BinaryFrames::addLedger (LedgerInfo const& info)
+{
+    Serializer s;
+    addRaw (info, s);
+    start (ledger, s.size ());
+    append (s.data (), s.size ());
+}
+
+void
+BinaryFrames::addEntry (uint256 const& key, Slice const& data)
+{
+    start (entry, key.size () + data.size ());
+    append (key.data (), key.size ());
+    append (data.data (), data.size ());
+}
+
+void
+BinaryFrames::addTransaction (
+    std::uint32_t seq, Slice const& txn, Slice const& meta)
+{
+    start (transaction, 8 + txn.size () + meta.size ());
+    Serializer s (8);
+    s.add32 (seq);
+    s.add32 (static_cast<std::uint32_t> (txn.size ()));
+    append (s.data (), s.size ());
+    append (txn.data (), txn.size ());
+    append (meta.data (), meta.size ());
+}
+
+std::string
+BinaryFrames::finish (Json::Value const& result)
+{
+    auto const text = to_string (result);
+
+    output_ = nullptr;
+    start (header, text.size ());
+    append (text.data (), text.size ());
+    return std::move (data_);
+}
+
+}
+}
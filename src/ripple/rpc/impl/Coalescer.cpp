@@ -0,0 +1,87 @@
+#include <ripple/rpc/Coalescer.h>
+#include <ripple/protocol/jss.h>
+#include <cassert>
+
+namespace ripple {
+namespace RPC {
+
+std::shared_ptr<Coalescer::Result const>
+Coalescer::join (std::string const& method, std::string const& key,
+    std::shared_ptr<JobQueue::Coro> const& coro, Compute const& compute)
+{
+    auto const flight = std::make_shared<Flight> ();
+    {
+        std::unique_lock<std::mutex> lock (mutex_);
+        auto const it = flights_.find (key);
+        if (it != flights_.end ())
+        {
+            ++stats_[method].coalesced;
+            auto const leader = it->second;
+            if (coro)
+            {
+                leader->waiters.push_back (coro);
+                lock.unlock ();
+                coro->yield ();
+                lock.lock ();
+            }
+            else
+            {
+                cv_.wait (lock, [&] { return leader->done; });
+            }
+            assert (leader->done);
+            if (leader->exception)
+                std::rethrow_exception (leader->exception);
+            return leader->result;
+        }
+        flights_.emplace (key, flight);
+        ++stats_[method].computed;
+    }
+
+    std::shared_ptr<Result const> result;
+    std::exception_ptr exception;
+    try
+    {
+        result = compute ();
+    }
+    catch (...)
+    {
+        exception = std::current_exception ();
+    }
+
+    std::vector<std::shared_ptr<JobQueue::Coro>> waiters;
+    {
+        std::lock_guard<std::mutex> lock (mutex_);
+        flight->result = result;
+        flight->exception = exception;
+        flight->done = true;
+        flights_.erase (key);
+        waiters.swap (flight->waiters);
+    }
+    cv_.notify_all ();
+    for (auto const& waiter : waiters)
+    {
+        if (! waiter->post ())
+            waiter->resume ();
+    }
+
+    if (exception)
+        std::rethrow_exception (exception);
+    return result;
+}
+
+Json::Value
+Coalescer::getJson () const
+{
+    Json::Value ret (Json::objectValue);
+    std::lock_guard<std::mutex> lock (mutex_);
+    for (auto const& stats : stats_)
+    {
+        auto& jv = ret[stats.first] = Json::objectValue;
+        jv[jss::computed] = std::to_string (stats.second.computed);
+        jv[jss::coalesced] = std::to_string (stats.second.coalesced);
+    }
+    return ret;
+}
+
+}
+}
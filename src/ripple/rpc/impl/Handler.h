@@ -31,6 +31,7 @@ struct Handler
     Method<Json::Value> valueMethod_;
     Role role_;
     RPC::Condition condition_;
+    Method<Json::Object> objectMethod_;
 };
 
 Handler const* getHandler (std::string const&);
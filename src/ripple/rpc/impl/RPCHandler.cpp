@@ -7,6 +7,7 @@
 #include <ripple/app/main/Application.h>
 #include <ripple/app/ledger/LedgerMaster.h>
 #include <ripple/app/misc/NetworkOPs.h>
+#include <ripple/basics/Arena.h>
 #include <ripple/basics/contract.h>
 #include <ripple/basics/Log.h>
 #include <ripple/basics/PerfLog.h>
@@ -18,10 +19,16 @@
 #include <ripple/net/RPCErr.h>
 #include <ripple/protocol/jss.h>
 #include <ripple/resource/Fees.h>
+#include <ripple/rpc/Coalescer.h>
+#include <ripple/rpc/ResultCache.h>
 #include <ripple/rpc/Role.h>
+#include <ripple/rpc/impl/RPCHelpers.h>
 #include <ripple/resource/Fees.h>
+#include <algorithm>
+#include <array>
 #include <atomic>
 #include <chrono>
+#include <cstring>
 
 namespace ripple {
 namespace RPC {
@@ -143,6 +150,26 @@ Status callMethod (
     }
 }
 
+template <class Object, class Method>
+Status logMethod (
+    Context& context, Method method, std::string const& name, Object& result)
+{
+    if (context.headers.user.empty() && context.headers.forwardedFor.empty())
+        return callMethod (context, method, name, result);
+
+    JLOG(context.j.debug()) << "start command: " << name <<
+        ", user: " << context.headers.user << ", forwarded for: " <<
+            context.headers.forwardedFor;
+
+    auto ret = callMethod (context, method, name, result);
+
+    JLOG(context.j.debug()) << "finish command: " << name <<
+        ", user: " << context.headers.user << ", forwarded for: " <<
+            context.headers.forwardedFor;
+
+    return ret;
+}
+
 template <class Method, class Object>
 void getResult (
     Context& context, Method method, Object& object, std::string const& name)
@@ -175,6 +202,185 @@ void getResult (
     }
 }
 
+// The request without the fields that do not affect its result.
+std::string normalize (Context const& context, Handler const& handler,
+    bool anyLedger)
+{
+    auto params = context.params;
+    for (auto const field : {jss::command, jss::method, jss::id,
+        jss::jsonrpc, jss::ripplerpc})
+        params.removeMember (field.c_str ());
+    if (anyLedger)
+    {
+        params.removeMember (jss::ledger_hash.c_str ());
+        params.removeMember (jss::ledger_index.c_str ());
+    }
+
+    return std::string (handler.name_) + "/" +
+        std::to_string (static_cast<int> (context.role)) + "/" +
+        to_string (params);
+}
+
+template <std::size_t N>
+bool contains (std::array<char const*, N> const& methods,
+    Handler const& handler)
+{
+    return std::find_if (methods.begin (), methods.end (),
+        [&](char const* name)
+        {
+            return std::strcmp (name, handler.name_) == 0;
+        }) != methods.end ();
+}
+
+// Returns the key under which the result of this request may be cached,
+// or an empty string if the result could change.
+std::string resultCacheKey (Context& context, Handler const& handler)
+{
+    static std::array<char const*, 5> const methods {{
+        "account_objects", "book_offers", "ledger", "ledger_entry", "tx"}};
+
+    if (context.frames || ! contains (methods, handler))
+        return {};
+
+    auto const key = normalize (context, handler, true);
+    if (std::strcmp (handler.name_, "tx") == 0)
+        return key;
+
+    // Only ledgers named by hash, sequence or "validated" are immutable
+    auto const& index = context.params[jss::ledger_index];
+    if (context.params.isMember (jss::ledger) ||
+        ! (context.params.isMember (jss::ledger_hash) ||
+            index.isNumeric () || index == jss::validated))
+        return {};
+
+    std::shared_ptr<ReadView const> ledger;
+    Json::Value jv;
+    if (lookupLedger (ledger, context, jv))
+        return {};
+
+    // The handler uses this ledger instead of looking it up again
+    context.ledger = ledger;
+    if (! jv[jss::validated].asBool ())
+        return {};
+
+    return key + "/" + to_string (ledger->info ().hash);
+}
+
+// Returns the key under which identical requests in flight together may
+// share one result, or an empty string if they may not.
+std::string coalesceKey (Context& context, Handler const& handler)
+{
+    static std::array<char const*, 7> const methods {{
+        "book_offers", "fee", "ledger", "ledger_closed", "ledger_current",
+        "server_info", "server_state"}};
+
+    if (context.frames || ! contains (methods, handler))
+        return {};
+
+    // Ledger dumps are left to stream; only admins may ask for them
+    if (std::strcmp (handler.name_, "ledger") == 0 &&
+        (context.params[jss::full].asBool () ||
+            context.params[jss::accounts].asBool ()))
+        return {};
+
+    return normalize (context, handler, false);
+}
+
+template <class Method>
+Status cachedMethod (Context& context, Method method, std::string const& name,
+    std::string const& key, Json::Value& result)
+{
+    auto& cache = context.app.getRPCResultCache ();
+    if (auto const cached = cache.fetch (key))
+    {
+        // A hit costs what computing the result did
+        context.loadType = cached->loadType;
+        result = cached->value;
+        return Status();
+    }
+
+    auto ret = logMethod (context, method, name, result);
+    if (! ret && ! result.isMember (jss::error) &&
+        (name != "tx" || result[jss::validated].asBool ()))
+        cache.insert (key, result, context.loadType);
+    return ret;
+}
+
+Status valueCommand (
+    Context& context, Handler const& handler, Json::Value& result)
+{
+    if (context.app.getRPCResultCache ().enabled ())
+    {
+        auto const key = resultCacheKey (context, handler);
+        if (! key.empty ())
+            return cachedMethod (context, handler.valueMethod_,
+                handler.name_, key, result);
+    }
+    return logMethod (context, handler.valueMethod_, handler.name_, result);
+}
+
+template <class Object>
+Status objectCommand (
+    Context& context, Handler const& handler, Object& result)
+{
+    // Cached results are written straight from the cache. A miss is
+    // streamed and not cached, since no Json::Value is built for it;
+    // buffered requests for the same result fill the cache.
+    auto& cache = context.app.getRPCResultCache ();
+    if (cache.enabled ())
+    {
+        auto const key = resultCacheKey (context, handler);
+        auto const cached = key.empty () ? nullptr : cache.fetch (key);
+        if (cached)
+        {
+            context.loadType = cached->loadType;
+            Json::copyFrom (result, cached->value);
+            return Status();
+        }
+    }
+    return logMethod (context, handler.objectMethod_, handler.name_, result);
+}
+
+// Builds the Values of a response from an arena of their own. The arena
+// stays alive while any of its Values do, so results handed back to the
+// caller are copied out first.
+class ResponseArena
+{
+public:
+    explicit ResponseArena (Config const& config)
+    {
+        if (config.RPC_ARENA)
+        {
+            arena_ = Arena::create ();
+            scope_.emplace (arena_, Arena::json);
+        }
+    }
+
+    ResponseArena (ResponseArena const&) = delete;
+    ResponseArena& operator= (ResponseArena const&) = delete;
+
+    ~ResponseArena ()
+    {
+        scope_ = boost::none;
+        if (arena_)
+            arena_->release ();
+    }
+
+    void
+    copyOut (Json::Value& value) const
+    {
+        if (! arena_)
+            return;
+        Arena::Scope const outside (nullptr, Arena::json);
+        Json::Value copy (value);
+        value.swap (copy);
+    }
+
+private:
+    Arena* arena_ = nullptr;
+    boost::optional<Arena::Scope> scope_;
+};
+
 } 
 
 Status doCommand (
@@ -187,32 +393,81 @@ Status doCommand (
         return error;
     }
 
-    if (auto method = handler->valueMethod_)
+    if (handler->valueMethod_)
     {
-        if (! context.headers.user.empty() ||
-            ! context.headers.forwardedFor.empty())
-        {
-            JLOG(context.j.debug()) << "start command: " << handler->name_ <<
-                ", user: " << context.headers.user << ", forwarded for: " <<
-                    context.headers.forwardedFor;
-
-            auto ret = callMethod (context, method, handler->name_, result);
+        ResponseArena const arena (context.app.config ());
+        auto const status = valueCommand (context, *handler, result);
+        arena.copyOut (result);
+        return status;
+    }
 
-            JLOG(context.j.debug()) << "finish command: " << handler->name_ <<
-                ", user: " << context.headers.user << ", forwarded for: " <<
-                    context.headers.forwardedFor;
+    return rpcUNKNOWN_COMMAND;
+}
 
-            return ret;
-        }
-        else
-        {
-            return callMethod (context, method, handler->name_, result);
-        }
+Status doCommand (
+    RPC::Context& context, Json::Object& result)
+{
+    Handler const * handler = nullptr;
+    if (auto error = fillHandler (context, handler))
+    {
+        inject_error (error, result);
+        return error;
     }
 
+    if (handler->objectMethod_)
+        return objectCommand (context, *handler, result);
+
+    inject_error (rpcUNKNOWN_COMMAND, result);
     return rpcUNKNOWN_COMMAND;
 }
 
+std::shared_ptr<Coalescer::Result const>
+doSharedCommand (RPC::Context& context)
+{
+    Handler const * handler = nullptr;
+    if (fillHandler (context, handler) || ! handler->valueMethod_)
+        return nullptr;
+
+    auto const key = coalesceKey (context, *handler);
+    if (key.empty ())
+        return nullptr;
+
+    auto const shared = context.app.getRPCCoalescer ().join (
+        handler->name_, key, context.coro, [&]
+        {
+            std::string text;
+            bool error;
+            if (handler->objectMethod_)
+            {
+                // Written as text without building a Json::Value
+                Json::Writer writer (Json::stringOutput (text));
+                Json::Object::Root root (writer);
+                error = static_cast<bool> (
+                    objectCommand (context, *handler, root));
+            }
+            else
+            {
+                ResponseArena const arena (context.app.config ());
+                Json::Value value;
+                auto const status = valueCommand (context, *handler, value);
+                error = status || value.isMember (jss::error);
+                text = to_string (value);
+            }
+            return std::make_shared<Coalescer::Result const> (
+                Coalescer::Result {std::move (text), error,
+                    context.loadType});
+        });
+
+    context.loadType = shared->loadType;
+    return shared;
+}
+
+bool streamsResult (std::string const& method)
+{
+    auto handler = RPC::getHandler(method);
+    return handler && handler->objectMethod_;
+}
+
 Role roleRequired (std::string const& method)
 {
     auto handler = RPC::getHandler(method);
@@ -303,7 +303,9 @@ Status
 lookupLedger(std::shared_ptr<ReadView const>& ledger, Context& context,
     Json::Value& result)
 {
-    if (auto status = ledgerFromRequest (ledger, context))
+    if (context.ledger)
+        ledger = context.ledger;
+    else if (auto status = ledgerFromRequest (ledger, context))
         return status;
 
     auto& info = ledger->info();
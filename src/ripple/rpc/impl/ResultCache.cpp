@@ -0,0 +1,82 @@
+#include <ripple/rpc/ResultCache.h>
+#include <ripple/basics/Arena.h>
+#include <ripple/json/to_string.h>
+#include <algorithm>
+
+namespace ripple {
+namespace RPC {
+
+std::shared_ptr<ResultCache::Result const>
+ResultCache::fetch (std::string const& key)
+{
+    std::lock_guard<std::mutex> lock (mutex_);
+    auto const it = index_.find (key);
+    if (it == index_.end ())
+    {
+        ++misses_;
+        return nullptr;
+    }
+    ++hits_;
+    entries_.splice (entries_.begin (), entries_, it->second);
+    return it->second->result;
+}
+
+void
+ResultCache::insert (std::string const& key, Json::Value const& result,
+    Resource::Charge const& loadType)
+{
+    auto const bytes = key.size () + to_string (result).size ();
+    if (bytes > maxBytes_)
+        return;
+
+    // Cached results must not keep a response arena alive
+    Arena::Scope const outside (nullptr, Arena::json);
+    auto value = std::make_shared<Result const> (Result {result, loadType});
+
+    std::lock_guard<std::mutex> lock (mutex_);
+    auto const it = index_.find (key);
+    if (it != index_.end ())
+    {
+        bytes_ -= it->second->bytes;
+        entries_.erase (it->second);
+        index_.erase (it);
+    }
+
+    entries_.push_front ({key, std::move (value), bytes});
+    index_.emplace (key, entries_.begin ());
+    bytes_ += bytes;
+
+    while (bytes_ > maxBytes_)
+    {
+        auto const& last = entries_.back ();
+        bytes_ -= last.bytes;
+        index_.erase (last.key);
+        entries_.pop_back ();
+    }
+}
+
+float
+ResultCache::getHitRate () const
+{
+    std::lock_guard<std::mutex> lock (mutex_);
+    auto const hits = static_cast<float> (hits_);
+    auto const total = hits + misses_;
+    return hits * (100.0f / std::max (1.0f, total));
+}
+
+std::size_t
+ResultCache::size () const
+{
+    std::lock_guard<std::mutex> lock (mutex_);
+    return entries_.size ();
+}
+
+std::size_t
+ResultCache::bytes () const
+{
+    std::lock_guard<std::mutex> lock (mutex_);
+    return bytes_;
+}
+
+}
+}
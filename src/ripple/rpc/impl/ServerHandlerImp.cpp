@@ -6,6 +6,7 @@
 #include <ripple/beast/rfc2616.h>
 #include <ripple/beast/net/IPAddressConversion.h>
 #include <ripple/json/json_reader.h>
+#include <ripple/json/Object.h>
 #include <ripple/rpc/json_body.h>
 #include <ripple/rpc/ServerHandler.h>
 #include <ripple/server/Server.h>
@@ -20,6 +21,7 @@
 #include <ripple/overlay/Overlay.h>
 #include <ripple/resource/ResourceManager.h>
 #include <ripple/resource/Fees.h>
+#include <ripple/rpc/BinaryFrames.h>
 #include <ripple/rpc/impl/Tuning.h>
 #include <ripple/rpc/Role.h>
 #include <ripple/rpc/RPCHandler.h>
@@ -32,6 +34,7 @@
 #include <boost/regex.hpp>
 #include <algorithm>
 #include <stdexcept>
+#include <utility>
 
 namespace ripple {
 
@@ -126,6 +129,15 @@ void
 ServerHandlerImp::onStop()
 {
     m_server->close();
+
+    // Requests still waiting for a worker are dropped. Destroying them,
+    // outside the lock, closes their connections without a response.
+    std::vector<std::deque<std::function<bool(void)>>> waiting;
+    {
+        std::lock_guard<std::mutex> lock(workersLock_);
+        for (auto& workers : workers_)
+            waiting.push_back(std::exchange(workers.second.waiting, {}));
+    }
 }
 
 
@@ -189,6 +201,15 @@ ServerHandlerImp::onHandoff(
             is->user(),
             is->forwarded_for());
         ws->appDefined = std::move(is);
+        {
+            std::lock_guard<std::mutex> lock(sessionsLock_);
+            sessions_.erase(std::remove_if(sessions_.begin(), sessions_.end(),
+                [](std::weak_ptr<WSSession> const& s)
+                {
+                    return s.expired();
+                }), sessions_.end());
+            sessions_.push_back(ws);
+        }
         ws->run();
 
         Handoff handoff;
@@ -215,6 +236,67 @@ Json::Output makeOutput (Session& session)
     };
 }
 
+// Writes to the session, suspending the coroutine while the client is
+// behind so that a large response is never queued in full.
+static inline
+Json::Output makeOutput (Session& session,
+    std::shared_ptr<JobQueue::Coro> const& coro)
+{
+    return [&session, coro](boost::beast::string_view const& b)
+    {
+        session.write (b.data(), b.size());
+        if (session.waitForDrain (RPC::Tuning::streamQueueLimit,
+            [coro]
+            {
+                if (! coro->post ())
+                    coro->resume ();
+            }))
+        {
+            coro->yield ();
+        }
+    };
+}
+
+static
+bool
+wantsFrames(Json::Value const& params)
+{
+    return params.isObject() && params[jss::frames] == true;
+}
+
+// Appends the members of the serialized JSON object `from` to the object
+// being built in `to`.
+static
+void
+appendMembers(std::string& to, std::string const& from)
+{
+    if (from.size() <= 2)
+        return;
+    if (to.back() != '{')
+        to += ',';
+    to.append(from, 1, from.size() - 2);
+}
+
+// Serializes a response around a shared result, adding `members` to the
+// result and the members of `envelope` beside it. The shared text is
+// copied as it is instead of being parsed.
+static
+std::string
+sharedResponse(std::string const& result,
+    Json::Value const& members, Json::Value const& envelope)
+{
+    std::string s;
+    s.reserve(result.size() + 256);
+    s = "{\"result\":{";
+    appendMembers(s, result);
+    if (members)
+        appendMembers(s, to_string(members));
+    s += '}';
+    appendMembers(s, to_string(envelope));
+    s += '}';
+    return s;
+}
+
 static
 std::map<std::string, std::string>
 build_map(boost::beast::http::fields const& h)
@@ -268,17 +350,75 @@ ServerHandlerImp::onRequest (Session& session)
     }
 
     std::shared_ptr<Session> detachedSession = session.detach();
+    startWork(session.port(),
+        [this, detachedSession]
+        {
+            return postSession(detachedSession);
+        });
+}
+
+void
+ServerHandlerImp::startWork (Port const& port,
+    std::function<bool(void)> post)
+{
+    if (port.workers != 0)
+    {
+        std::lock_guard<std::mutex> lock(workersLock_);
+        auto& workers = workers_[port];
+        if (workers.active >= port.workers)
+        {
+            workers.waiting.push_back(std::move(post));
+            return;
+        }
+        ++workers.active;
+    }
+
+    if (! post())
+        onWorkDone(port);
+}
+
+bool
+ServerHandlerImp::postSession (std::shared_ptr<Session> const& session)
+{
     auto const postResult = m_jobQueue.postCoro(jtCLIENT, "RPC-Client",
-        [this, detachedSession](std::shared_ptr<JobQueue::Coro> coro)
+        [this, session](std::shared_ptr<JobQueue::Coro> coro)
         {
-            processSession(detachedSession, coro);
+            processSession(session, coro);
+            onWorkDone(session->port());
         });
     if (postResult == nullptr)
     {
         HTTPReply(503, "Service Unavailable",
-            makeOutput(*detachedSession), app_.journal("RPC"));
-        detachedSession->close(true);
+            makeOutput(*session), app_.journal("RPC"));
+        session->close(true);
+        return false;
+    }
+    return true;
+}
+
+void
+ServerHandlerImp::onWorkDone (Port const& port)
+{
+    if (port.workers == 0)
         return;
+
+    // Hand the worker to the oldest waiting request on the port
+    for (;;)
+    {
+        std::function<bool(void)> next;
+        {
+            std::lock_guard<std::mutex> lock(workersLock_);
+            auto& workers = workers_[port];
+            if (workers.waiting.empty())
+            {
+                --workers.active;
+                return;
+            }
+            next = std::move(workers.waiting.front());
+            workers.waiting.pop_front();
+        }
+        if (next())
+            return;
     }
 }
 
@@ -315,25 +455,51 @@ ServerHandlerImp::onWSMessage(
     JLOG(m_journal.trace())
         << "Websocket received '" << jv << "'";
 
-    auto const postResult = m_jobQueue.postCoro(jtCLIENT, "WS-Client",
+    // Websocket requests count against the port's workers like HTTP ones
+    startWork(session->port(),
         [this, session, jv = std::move(jv)]
+        {
+            return postWSMessage(session, jv);
+        });
+}
+
+bool
+ServerHandlerImp::postWSMessage (std::shared_ptr<WSSession> const& session,
+    Json::Value const& jv)
+{
+    auto const postResult = m_jobQueue.postCoro(jtCLIENT, "WS-Client",
+        [this, session, jv]
         (std::shared_ptr<JobQueue::Coro> const& coro)
         {
-            auto const jr =
-                this->processSession(session, coro, jv);
-            auto const s = to_string(jr);
-            auto const n = s.length();
-            boost::beast::multi_buffer sb(n);
-            sb.commit(boost::asio::buffer_copy(
-                sb.prepare(n), boost::asio::buffer(s.c_str(), n)));
-            session->send(std::make_shared<
-                StreambufWSMsg<decltype(sb)>>(std::move(sb)));
+            RPC::BinaryFrames frames;
+            std::shared_ptr<RPC::Coalescer::Result const> shared;
+            auto const jr = this->processSession(session, coro, jv,
+                wantsFrames(jv) ? &frames : nullptr, shared);
+            if (frames.accepted() && jr[jss::status] == "success")
+            {
+                session->send(std::make_shared<BinaryWSMsg>(
+                    std::make_shared<std::string const>(frames.finish(jr))));
+            }
+            else
+            {
+                auto const s = shared ?
+                    sharedResponse(shared->text, {}, jr) : to_string(jr);
+                auto const n = s.length();
+                boost::beast::multi_buffer sb(n);
+                sb.commit(boost::asio::buffer_copy(
+                    sb.prepare(n), boost::asio::buffer(s.c_str(), n)));
+                session->send(std::make_shared<
+                    StreambufWSMsg<decltype(sb)>>(std::move(sb)));
+            }
             session->complete();
+            onWorkDone(session->port());
         });
     if (postResult == nullptr)
     {
         session->close({boost::beast::websocket::going_away, "Shutting Down"});
+        return false;
     }
+    return true;
 }
 
 void
@@ -350,12 +516,62 @@ ServerHandlerImp::onStopped (Server&)
     stopped();
 }
 
+Json::Value
+ServerHandlerImp::getWSSessionsJson() const
+{
+    std::vector<std::shared_ptr<WSSession>> sessions;
+    {
+        std::lock_guard<std::mutex> lock(sessionsLock_);
+        sessions.reserve(sessions_.size());
+        for (auto const& s : sessions_)
+            if (auto sp = s.lock())
+                sessions.push_back(std::move(sp));
+    }
+
+    Json::Value ret(Json::arrayValue);
+    for (auto const& session : sessions)
+    {
+        auto const stats = session->stats();
+        Json::Value& jv = ret.append(Json::objectValue);
+        jv[jss::ip] = session->remote_endpoint().address().to_string();
+        jv[jss::port] = session->port().name;
+        jv[jss::queued] = std::to_string(stats.queued);
+        jv[jss::queued_bytes] = std::to_string(stats.queuedBytes);
+        jv[jss::peak_bytes] = std::to_string(stats.peakBytes);
+        jv[jss::sent] = std::to_string(stats.sent);
+        jv[jss::dropped] = std::to_string(stats.dropped);
+        jv[jss::coalesced] = std::to_string(stats.coalesced);
+        jv[jss::sent_bytes] = std::to_string(stats.sentBytes);
+        jv[jss::wire_bytes] = std::to_string(stats.wireBytes);
+        jv[jss::write_us] = std::to_string(stats.writeTime.count());
+        jv[jss::shared_deflated] = std::to_string(stats.sharedDeflated);
+        jv[jss::lag_ms] = std::to_string(stats.lag.count());
+    }
+    return ret;
+}
+
+Json::Value
+ServerHandlerImp::getWSCompressionJson() const
+{
+    auto const totals = getWSWriteTotals();
+    Json::Value ret(Json::objectValue);
+    ret[jss::sent_bytes] = std::to_string(totals.sentBytes);
+    ret[jss::wire_bytes] = std::to_string(totals.wireBytes);
+    ret[jss::saved_bytes] = std::to_string(
+        totals.sentBytes > totals.wireBytes ?
+            totals.sentBytes - totals.wireBytes : 0);
+    ret[jss::write_us] = std::to_string(totals.writeTime.count());
+    ret[jss::shared_deflated] = std::to_string(totals.sharedDeflated);
+    return ret;
+}
+
 
 Json::Value
 ServerHandlerImp::processSession(
     std::shared_ptr<WSSession> const& session,
         std::shared_ptr<JobQueue::Coro> const& coro,
-            Json::Value const& jv)
+            Json::Value const& jv, RPC::BinaryFrames* frames,
+                std::shared_ptr<RPC::Coalescer::Result const>& shared)
 {
     auto is = std::static_pointer_cast<WSInfoSub> (session->appDefined);
     if (is->getConsumer().disconnect())
@@ -416,9 +632,20 @@ ServerHandlerImp::processSession(
                 role,
                 coro,
                 is,
-                {is->user(), is->forwarded_for()}
+                {is->user(), is->forwarded_for()},
+                frames
                 };
-            RPC::doCommand(context, jr[jss::result]);
+            shared = RPC::doSharedCommand(context);
+            if (! shared)
+            {
+                RPC::doCommand(context, jr[jss::result]);
+            }
+            else if (shared->error)
+            {
+                // Errors are reshaped below
+                Json::Reader().parse(shared->text, jr[jss::result]);
+                shared = nullptr;
+            }
         }
     }
     catch (std::exception const& ex)
@@ -433,7 +660,7 @@ ServerHandlerImp::processSession(
     if (is->getConsumer().warn())
         jr[jss::warning] = jss::load;
 
-    if (jr[jss::result].isMember(jss::error))
+    if (! shared && jr[jss::result].isMember(jss::error))
     {
         jr = jr[jss::result];
         jr[jss::status] = jss::error;
@@ -477,7 +704,7 @@ ServerHandlerImp::processSession (std::shared_ptr<Session> const& session,
         session->port(), buffers_to_string(
             session->request().body().data()),
                 session->remoteAddress().at_port (0),
-                    makeOutput (*session), coro,
+                    makeOutput (*session, coro), coro,
         forwardedFor(session->request()),
         [&]{
             auto const iter =
@@ -486,7 +713,8 @@ ServerHandlerImp::processSession (std::shared_ptr<Session> const& session,
             if(iter != session->request().end())
                 return iter->value();
             return boost::beast::string_view{};
-        }());
+        }(),
+        session->request().version() >= 11);
 
     if(beast::rfc2616::is_keep_alive(session->request()))
         session->complete();
@@ -506,6 +734,24 @@ make_json_error(Json::Int code, Json::Value&& message)
     return r;
 }
 
+static
+Json::Value
+maskSecrets(Json::Value rq)
+{
+    if (rq.isObject())
+    {
+        if (rq.isMember(jss::passphrase.c_str()))
+            rq[jss::passphrase.c_str()] = "<masked>";
+        if (rq.isMember(jss::secret.c_str()))
+            rq[jss::secret.c_str()] = "<masked>";
+        if (rq.isMember(jss::seed.c_str()))
+            rq[jss::seed.c_str()] = "<masked>";
+        if (rq.isMember(jss::seed_hex.c_str()))
+            rq[jss::seed_hex.c_str()] = "<masked>";
+    }
+    return rq;
+}
+
 Json::Int constexpr method_not_found  = -32601;
 Json::Int constexpr server_overloaded = -32604;
 Json::Int constexpr forbidden         = -32605;
@@ -514,7 +760,8 @@ void
 ServerHandlerImp::processRequest (Port const& port,
     std::string const& request, beast::IP::Endpoint const& remoteIPAddress,
         Output&& output, std::shared_ptr<JobQueue::Coro> coro,
-        boost::string_view forwardedFor, boost::string_view user)
+        boost::string_view forwardedFor, boost::string_view user,
+        bool chunked)
 {
     auto rpcJ = app_.journal ("RPC");
 
@@ -546,6 +793,20 @@ ServerHandlerImp::processRequest (Port const& port,
     }
 
     Json::Value reply(batch ? Json::arrayValue : Json::objectValue);
+
+    // HTTP/1.1 binary responses are sent as the frames are produced. The
+    // reply starts once the handler has validated the request and accepted
+    // the frames, so request errors are still answered in JSON.
+    boost::optional<HTTPChunkedReply> framesReply;
+    RPC::BinaryFrames frames (chunked ? Json::Output (
+        [&](boost::beast::string_view const& bytes)
+        {
+            if (! framesReply)
+                framesReply.emplace (output, RPC::Tuning::streamChunkSize,
+                    "application/octet-stream");
+            framesReply->write (bytes);
+        }) : Json::Output ());
+    boost::optional<std::string> sharedReply;
     auto const start (std::chrono::high_resolution_clock::now ());
     for (unsigned i = 0; i < size; ++i)
     {
@@ -733,9 +994,88 @@ ServerHandlerImp::processRequest (Port const& port,
 
         RPC::Context context {m_journal, params, app_, loadType, m_networkOPs,
             app_.getLedgerMaster(), usage, role, coro, InfoSub::pointer(),
-            {user, forwardedFor}};
+            {user, forwardedFor},
+            ! batch && wantsFrames (params) ? &frames : nullptr};
+
+        // Identical requests in flight share one serialized result
+        std::shared_ptr<RPC::Coalescer::Result const> shared;
+        if (! batch)
+            shared = RPC::doSharedCommand (context);
+        if (shared && ! shared->error)
+        {
+            usage.charge (loadType);
+            Json::Value members (Json::objectValue);
+            if (usage.warn())
+                members[jss::warning] = jss::load;
+            members[jss::status] = jss::success;
+
+            Json::Value envelope (Json::objectValue);
+            if (params.isMember(jss::jsonrpc))
+                envelope[jss::jsonrpc] = params[jss::jsonrpc];
+            if (params.isMember(jss::ripplerpc))
+                envelope[jss::ripplerpc] = params[jss::ripplerpc];
+            if (params.isMember(jss::id))
+                envelope[jss::id] = params[jss::id];
+            sharedReply = sharedResponse (shared->text, members, envelope);
+            continue;
+        }
+
+        // Large results are written to the client as they are produced
+        // instead of being built up as a Json::Value and then a string.
+        if (chunked && ! batch && ! shared && ! context.frames &&
+            ripplerpc < "2.0" && RPC::streamsResult (strMethod))
+        {
+            HTTPChunkedReply chunkedReply (
+                output, RPC::Tuning::streamChunkSize);
+            {
+                Json::Writer writer (chunkedReply.output ());
+                Json::Object::Root root (writer);
+                {
+                    auto result = Json::addObject (root, jss::result);
+                    auto const status = RPC::doCommand (context, result);
+                    usage.charge (loadType);
+                    if (usage.warn())
+                        result[jss::warning] = jss::load;
+
+                    if (status)
+                    {
+                        JLOG (m_journal.debug()) <<
+                            "rpcError: " << status.toString();
+                        result[jss::status] = jss::error;
+                        result[jss::request] = maskSecrets (params);
+                    }
+                    else
+                    {
+                        result[jss::status] = jss::success;
+                    }
+                }
+
+                if (params.isMember(jss::jsonrpc))
+                    root[jss::jsonrpc] = params[jss::jsonrpc];
+                if (params.isMember(jss::ripplerpc))
+                    root[jss::ripplerpc] = params[jss::ripplerpc];
+                if (params.isMember(jss::id))
+                    root[jss::id] = params[jss::id];
+            }
+            chunkedReply.write ("\n");
+            auto const bytes = chunkedReply.finish ();
+
+            rpc_time_.notify (
+                std::chrono::duration_cast <std::chrono::milliseconds> (
+                    std::chrono::high_resolution_clock::now () - start));
+            ++rpc_requests_;
+            rpc_size_.notify (beast::insight::Event::value_type{bytes});
+
+            JLOG (m_journal.debug()) << "Reply: " << bytes <<
+                " bytes streamed for " << strMethod;
+            return;
+        }
+
         Json::Value result;
-        RPC::doCommand (context, result);
+        if (shared)
+            Json::Reader ().parse (shared->text, result);
+        else
+            RPC::doCommand (context, result);
         usage.charge (loadType);
         if (usage.warn())
             result[jss::warning] = jss::load;
@@ -764,22 +1104,8 @@ ServerHandlerImp::processRequest (Port const& port,
         {
             if (result.isMember (jss::error))
             {
-                auto rq = params;
-
-                if (rq.isObject())
-                { 
-                    if (rq.isMember(jss::passphrase.c_str()))
-                        rq[jss::passphrase.c_str()] = "<masked>";
-                    if (rq.isMember(jss::secret.c_str()))
-                        rq[jss::secret.c_str()] = "<masked>";
-                    if (rq.isMember(jss::seed.c_str()))
-                        rq[jss::seed.c_str()] = "<masked>";
-                    if (rq.isMember(jss::seed_hex.c_str()))
-                        rq[jss::seed_hex.c_str()] = "<masked>";
-                }
-
                 result[jss::status] = jss::error;
-                result[jss::request] = rq;
+                result[jss::request] = maskSecrets (params);
 
                 JLOG (m_journal.debug())  <<
                     "rpcError: " << result [jss::error] <<
@@ -803,7 +1129,35 @@ ServerHandlerImp::processRequest (Port const& port,
         else
             reply = std::move(r);
     }
-    auto response = to_string (reply);
+    Json::Value const& header = reply;
+    if (frames.streamed() || (frames.accepted() &&
+        header[jss::result][jss::status] == "success"))
+    {
+        auto const response = frames.finish (reply);
+
+        rpc_time_.notify (
+            std::chrono::duration_cast <std::chrono::milliseconds> (
+                std::chrono::high_resolution_clock::now () - start));
+        ++rpc_requests_;
+        rpc_size_.notify (beast::insight::Event::value_type{frames.size()});
+
+        JLOG (m_journal.debug()) << "Reply: " << frames.count () <<
+            " binary frames, " << frames.size () << " bytes";
+
+        if (framesReply)
+        {
+            framesReply->write (response);
+            framesReply->finish ();
+        }
+        else
+        {
+            HTTPBinaryReply (response, output);
+        }
+        return;
+    }
+
+    auto response = sharedReply ?
+        std::move (*sharedReply) : to_string (reply);
 
     rpc_time_.notify (
         std::chrono::duration_cast <std::chrono::milliseconds> (
@@ -930,7 +1284,12 @@ to_Port(ParsedPort const& parsed, std::ostream& log)
     p.ssl_ciphers = parsed.ssl_ciphers;
     p.pmd_options = parsed.pmd_options;
     p.ws_queue_limit = parsed.ws_queue_limit;
+    p.ws_queue_bytes = parsed.ws_queue_bytes;
+    p.ws_overflow = parsed.ws_overflow;
+    p.ws_stream_overflow = parsed.ws_stream_overflow;
     p.limit = parsed.limit;
+    p.pipeline = parsed.pipeline;
+    p.workers = parsed.workers;
 
     return p;
 }
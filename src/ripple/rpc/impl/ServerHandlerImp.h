@@ -12,6 +12,8 @@
 #include <ripple/app/main/CollectorManager.h>
 #include <ripple/json/Output.h>
 #include <boost/utility/string_view.hpp>
+#include <deque>
+#include <functional>
 #include <map>
 #include <mutex>
 #include <vector>
@@ -78,6 +80,18 @@ private:
     std::mutex countlock_;
     std::map<std::reference_wrapper<Port const>, int> count_;
 
+    struct Workers
+    {
+        int active = 0;
+        std::deque<std::function<bool(void)>> waiting;
+    };
+
+    std::mutex workersLock_;
+    std::map<std::reference_wrapper<Port const>, Workers> workers_;
+
+    std::mutex mutable sessionsLock_;
+    std::vector<std::weak_ptr<WSSession>> sessions_;
+
 public:
     ServerHandlerImp (Application& app, Stoppable& parent,
         boost::asio::io_service& io_service, JobQueue& jobQueue,
@@ -140,22 +154,48 @@ public:
     void
     onStopped (Server&);
 
+    /** Send queue statistics for every open websocket session. */
+    Json::Value
+    getWSSessionsJson() const;
+
+    /** Bytes saved by permessage-deflate and the time spent framing and
+        compressing, over every websocket session since startup. */
+    Json::Value
+    getWSCompressionJson() const;
+
 private:
     Json::Value
     processSession(
         std::shared_ptr<WSSession> const& session,
             std::shared_ptr<JobQueue::Coro> const& coro,
-                Json::Value const& jv);
+                Json::Value const& jv, RPC::BinaryFrames* frames,
+                    std::shared_ptr<RPC::Coalescer::Result const>& shared);
 
     void
     processSession (std::shared_ptr<Session> const&,
         std::shared_ptr<JobQueue::Coro> coro);
 
+    bool
+    postSession (std::shared_ptr<Session> const& session);
+
+    bool
+    postWSMessage (std::shared_ptr<WSSession> const& session,
+        Json::Value const& jv);
+
+    // Calls `post` once the port has a free worker. `post` returns false
+    // if its job could not be posted.
+    void
+    startWork (Port const& port, std::function<bool(void)> post);
+
+    void
+    onWorkDone (Port const& port);
+
     void
     processRequest (Port const& port, std::string const& request,
         beast::IP::Endpoint const& remoteIPAddress, Output&&,
         std::shared_ptr<JobQueue::Coro> coro,
-        boost::string_view forwardedFor, boost::string_view user);
+        boost::string_view forwardedFor, boost::string_view user,
+        bool chunked);
 
     Handoff
     statusResponse(http_request_type const& request) const;
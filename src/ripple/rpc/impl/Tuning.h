@@ -41,6 +41,12 @@ static int const maxJobQueueClients = 500;
 auto constexpr maxValidatedLedgerAge = std::chrono::minutes {2};
 static int const maxRequestSize = 1000000;
 
+/** Bytes buffered before a streamed HTTP response is sent as a chunk. */
+static std::size_t const streamChunkSize = 64 * 1024;
+
+/** Bytes queued for a slow client before a streamed response waits. */
+static std::size_t const streamQueueLimit = 4 * streamChunkSize;
+
 
 static int const binaryPageLength = 2048;
 
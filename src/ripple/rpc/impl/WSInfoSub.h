@@ -66,6 +66,16 @@ public:
                 std::move(sb));
         sp->send(m);
     }
+
+    void
+    send(Payload const& payload, bool) override
+    {
+        auto sp = ws_.lock();
+        if(! sp)
+            return;
+        sp->send(std::make_shared<SharedWSMsg>(payload.text(),
+            payload.stream(), payload.coalesce()));
+    }
 };
 
 } 
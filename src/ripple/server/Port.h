@@ -9,6 +9,7 @@
 #include <boost/beast/websocket/option.hpp>
 #include <boost/asio/ip/address.hpp>
 #include <cstdint>
+#include <map>
 #include <memory>
 #include <set>
 #include <string>
@@ -17,6 +18,18 @@ namespace boost { namespace asio { namespace ssl { class context; } } }
 
 namespace ripple {
 
+/** What a websocket session does when its send queue is over the limit.
+
+    The policy is chosen by the stream of the message that overflowed the
+    queue. Responses to requests always use close.
+*/
+enum class WSOverflow
+{
+    close,          // disconnect the client
+    drop_oldest,    // discard the oldest queued messages of the stream
+    drop_stream,    // discard every queued message of the stream
+    pause           // stop queueing the stream until the backlog drains
+};
 
 struct Port
 {
@@ -41,8 +54,24 @@ struct Port
 
     int limit = 0;
 
+    // Requests read ahead of their responses on one connection
+    std::size_t pipeline = 8;
+
+    // HTTP and websocket requests handled at once across the port, or 0
+    // for no limit
+    int workers = 0;
+
     std::uint16_t ws_queue_limit;
 
+    std::size_t ws_queue_bytes = 0;
+
+    WSOverflow ws_overflow = WSOverflow::close;
+
+    std::map<std::string, WSOverflow> ws_stream_overflow;
+
+    WSOverflow
+    overflow (boost::beast::string_view stream) const;
+
     bool websockets() const;
 
     bool secure() const;
@@ -70,7 +99,12 @@ struct ParsedPort
     std::string ssl_ciphers;
     boost::beast::websocket::permessage_deflate pmd_options;
     int limit = 0;
+    std::size_t pipeline = 8;
+    int workers = 0;
     std::uint16_t ws_queue_limit;
+    std::size_t ws_queue_bytes = 0;
+    WSOverflow ws_overflow = WSOverflow::close;
+    std::map<std::string, WSOverflow> ws_stream_overflow;
 
     boost::optional<boost::asio::ip::address> ip;
     boost::optional<std::uint16_t> port;
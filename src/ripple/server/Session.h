@@ -79,6 +79,18 @@ public:
     write (std::shared_ptr <Writer> const& writer,
         bool keep_alive) = 0;
 
+    /** Waits for written output to drain.
+
+        If more than `limit` bytes are queued for the client, returns `true`
+        and later calls `resume` once, when the queue is down to `limit`
+        bytes or the connection is gone. Otherwise returns `false` and
+        `resume` is not called.
+    */
+    virtual
+    bool
+    waitForDrain (std::size_t limit,
+        std::function<void(void)> resume) = 0;
+
     
 
     
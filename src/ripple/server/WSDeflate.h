@@ -0,0 +1,180 @@
+#ifndef RIPPLE_SERVER_WSDEFLATE_H_INCLUDED
+#define RIPPLE_SERVER_WSDEFLATE_H_INCLUDED
+
+#include <boost/beast/core/string.hpp>
+#include <boost/beast/http/fields.hpp>
+#include <boost/beast/http/rfc7230.hpp>
+#include <boost/beast/websocket/option.hpp>
+#include <boost/beast/zlib/deflate_stream.hpp>
+#include <boost/optional.hpp>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+
+namespace ripple {
+
+/** The permessage-deflate settings a session compresses its messages with.
+
+    A session that keeps no context between messages compresses each one
+    on its own, so its output depends only on these settings. Any other
+    such session with the same settings can be sent the same bytes.
+*/
+struct WSDeflateParams
+{
+    int windowBits = 15;
+    int level = 8;
+    int memLevel = 4;
+};
+
+inline
+bool
+operator< (WSDeflateParams const& lhs, WSDeflateParams const& rhs)
+{
+    return std::tie (lhs.windowBits, lhs.level, lhs.memLevel) <
+        std::tie (rhs.windowBits, rhs.level, rhs.memLevel);
+}
+
+/** Returns the settings of a handshake response that can share messages.
+
+    This is the case when the response agreed to permessage-deflate
+    with server_no_context_takeover. The level and memory level are the
+    port's, since they are not part of the negotiation.
+*/
+inline
+boost::optional<WSDeflateParams>
+wsSharedDeflate (boost::beast::http::fields const& response,
+    boost::beast::websocket::permessage_deflate const& options)
+{
+    using boost::beast::iequals;
+
+    if (! options.server_enable)
+        return boost::none;
+    boost::beast::http::ext_list const extensions {
+        response[boost::beast::http::field::sec_websocket_extensions]};
+    for (auto const& ext : extensions)
+    {
+        if (! iequals (ext.first, "permessage-deflate"))
+            continue;
+        WSDeflateParams params;
+        params.level = options.compLevel;
+        params.memLevel = options.memLevel;
+        bool noContext = false;
+        for (auto const& param : ext.second)
+        {
+            if (iequals (param.first, "server_no_context_takeover"))
+            {
+                noContext = true;
+            }
+            else if (iequals (param.first, "server_max_window_bits"))
+            {
+                if (param.second.size () != 1 && param.second.size () != 2)
+                    return boost::none;
+                params.windowBits = 0;
+                for (auto const c : param.second)
+                {
+                    if (c < '0' || c > '9')
+                        return boost::none;
+                    params.windowBits = params.windowBits * 10 + (c - '0');
+                }
+            }
+        }
+        if (! noContext || params.windowBits < 9 || params.windowBits > 15)
+            return boost::none;
+        return params;
+    }
+    return boost::none;
+}
+
+/** Compresses a whole message as one permessage-deflate payload.
+
+    As beast does in a session without context takeover, the message is
+    deflated from a fresh state, and the four bytes that end the final
+    flush are left off as RFC 7692 requires.
+*/
+inline
+std::string
+wsDeflate (std::string const& text, WSDeflateParams const& params)
+{
+    namespace zlib = boost::beast::zlib;
+
+    zlib::deflate_stream zo;
+    zo.reset (params.level, params.windowBits, params.memLevel,
+        zlib::Strategy::normal);
+    std::string out (zo.upper_bound (text.size ()) + 16, '\0');
+    zlib::z_params zs;
+    zs.next_in = text.data ();
+    zs.avail_in = text.size ();
+    zs.next_out = &out[0];
+    zs.avail_out = out.size ();
+    boost::system::error_code ec;
+    zo.write (zs, zlib::Flush::sync, ec);
+    while (! ec && zs.avail_out == 0)
+    {
+        out.resize (out.size () * 2);
+        zs.next_out = &out[zs.total_out];
+        zs.avail_out = out.size () - zs.total_out;
+        zo.write (zs, zlib::Flush::sync, ec);
+    }
+    if (ec == zlib::error::need_buffers)
+        ec = {};
+    if (ec || zs.total_out < 4)
+        return {};
+    out.resize (zs.total_out - 4);
+    return out;
+}
+
+/** The text of a message sent to many websocket sessions.
+
+    The compressed forms are made the first time a session asks for
+    them, and shared with every later session that uses the same
+    settings.
+*/
+class WSSharedText
+{
+public:
+    explicit
+    WSSharedText (std::string text)
+        : text_ (std::move (text))
+    {
+    }
+
+    WSSharedText (WSSharedText const&) = delete;
+    WSSharedText& operator= (WSSharedText const&) = delete;
+
+    std::string const&
+    text () const
+    {
+        return text_;
+    }
+
+    /** Returns the message compressed with params, or nullptr on error.
+        May be called from any thread.
+    */
+    std::shared_ptr<std::string const>
+    deflated (WSDeflateParams const& params) const
+    {
+        std::lock_guard<std::mutex> lock (mutex_);
+        auto& result = deflated_[params];
+        if (! result)
+        {
+            auto out = wsDeflate (text_, params);
+            if (out.empty ())
+                return nullptr;
+            result = std::make_shared<std::string const> (std::move (out));
+        }
+        return result;
+    }
+
+private:
+    std::string const text_;
+    std::mutex mutable mutex_;
+    std::map<WSDeflateParams,
+        std::shared_ptr<std::string const>> mutable deflated_;
+};
+
+}
+
+#endif
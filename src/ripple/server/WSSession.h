@@ -5,14 +5,19 @@
 
 #include <ripple/server/Handoff.h>
 #include <ripple/server/Port.h>
+#include <ripple/server/WSDeflate.h>
 #include <ripple/server/Writer.h>
 #include <boost/beast/core/buffers_prefix.hpp>
 #include <boost/asio/buffer.hpp>
 #include <boost/asio/ip/tcp.hpp>
 #include <boost/logic/tribool.hpp>
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <functional>
 #include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -32,6 +37,49 @@ public:
         std::vector<boost::asio::const_buffer>>
     prepare(std::size_t bytes,
         std::function<void(void)> resume) = 0;
+
+    /** Bytes held by the message until it is written. */
+    virtual
+    std::size_t
+    size() const
+    {
+        return 0;
+    }
+
+    /** The subscription stream of the message, empty for responses. */
+    virtual
+    boost::beast::string_view
+    stream() const
+    {
+        return {};
+    }
+
+    /** True if a newer message of the same stream supersedes this one. */
+    virtual
+    bool
+    coalesce() const
+    {
+        return false;
+    }
+
+    /** True if the message is sent as a binary frame rather than text. */
+    virtual
+    bool
+    binary() const
+    {
+        return false;
+    }
+
+    /** The whole message already compressed with params, or nullptr if
+        the session has to compress it while writing. Only asked before
+        the first call to prepare.
+    */
+    virtual
+    std::shared_ptr<std::string const>
+    deflated(WSDeflateParams const&) const
+    {
+        return nullptr;
+    }
 };
 
 template<class Streambuf>
@@ -71,8 +119,173 @@ public:
         std::copy(pb.begin(), pb.end(), std::back_inserter(vb));
         return{done, vb};
     }
+
+    std::size_t
+    size() const override
+    {
+        return sb_.size();
+    }
 };
 
+class SharedWSMsg : public WSMsg
+{
+    std::shared_ptr<WSSharedText const> shared_;
+    std::shared_ptr<std::string const> data_;
+    std::string stream_;
+    bool coalesce_;
+    std::size_t pos_ = 0;
+    std::size_t n_ = 0;
+
+public:
+    explicit
+    SharedWSMsg(std::shared_ptr<std::string const> data,
+        std::string stream = {}, bool coalesce = false)
+        : data_(std::move(data))
+        , stream_(std::move(stream))
+        , coalesce_(coalesce)
+    {
+    }
+
+    /** A message whose compressed forms are shared with other sessions. */
+    explicit
+    SharedWSMsg(std::shared_ptr<WSSharedText const> shared,
+        std::string stream = {}, bool coalesce = false)
+        : shared_(std::move(shared))
+        , data_(shared_, &shared_->text())
+        , stream_(std::move(stream))
+        , coalesce_(coalesce)
+    {
+    }
+
+    std::pair<boost::tribool,
+        std::vector<boost::asio::const_buffer>>
+    prepare(std::size_t bytes,
+        std::function<void(void)>) override
+    {
+        pos_ += n_;
+        auto const remain = data_->size() - pos_;
+        if (remain == 0)
+            return{true, {}};
+        n_ = std::min(bytes, remain);
+        boost::tribool const done = n_ == remain;
+        return{done, {boost::asio::const_buffer(data_->data() + pos_, n_)}};
+    }
+
+    std::size_t
+    size() const override
+    {
+        return data_->size() - pos_;
+    }
+
+    boost::beast::string_view
+    stream() const override
+    {
+        return stream_;
+    }
+
+    bool
+    coalesce() const override
+    {
+        return coalesce_;
+    }
+
+    std::shared_ptr<std::string const>
+    deflated(WSDeflateParams const& params) const override
+    {
+        if (! shared_ || pos_ != 0 || n_ != 0)
+            return nullptr;
+        return shared_->deflated(params);
+    }
+};
+
+/** A shared message sent as a binary frame. */
+class BinaryWSMsg : public SharedWSMsg
+{
+public:
+    using SharedWSMsg::SharedWSMsg;
+
+    bool
+    binary() const override
+    {
+        return true;
+    }
+};
+
+/** Send queue statistics for a websocket session. */
+struct WSSendStats
+{
+    std::size_t queued = 0;
+    std::size_t queuedBytes = 0;
+    std::size_t peakBytes = 0;
+    std::uint64_t sent = 0;
+    std::uint64_t dropped = 0;
+    std::uint64_t coalesced = 0;
+
+    // Bytes of the messages written, and what they took on the connection
+    // after framing and permessage-deflate
+    std::uint64_t sentBytes = 0;
+    std::uint64_t wireBytes = 0;
+
+    // Time spent framing and compressing
+    std::chrono::microseconds writeTime {0};
+
+    // Messages sent as a frame compressed once for many sessions
+    std::uint64_t sharedDeflated = 0;
+
+    // Age of the oldest message still waiting to be written
+    std::chrono::milliseconds lag {0};
+};
+
+namespace detail {
+
+struct WSWriteTotals
+{
+    std::atomic<std::uint64_t> sentBytes {0};
+    std::atomic<std::uint64_t> wireBytes {0};
+    std::atomic<std::uint64_t> writeMicros {0};
+    std::atomic<std::uint64_t> sharedDeflated {0};
+};
+
+inline
+WSWriteTotals&
+wsWriteTotals()
+{
+    static WSWriteTotals totals;
+    return totals;
+}
+
+}
+
+inline
+void
+addWSWriteTotals(std::uint64_t sentBytes, std::uint64_t wireBytes,
+    std::chrono::microseconds writeTime, bool sharedDeflated = false)
+{
+    auto& totals = detail::wsWriteTotals();
+    totals.sentBytes += sentBytes;
+    totals.wireBytes += wireBytes;
+    totals.writeMicros += writeTime.count();
+    if (sharedDeflated)
+        ++totals.sharedDeflated;
+}
+
+/** Returns the bytes written, the write time and the shared frames sent
+    summed over every websocket session since startup. Other fields are
+    left at zero.
+*/
+inline
+WSSendStats
+getWSWriteTotals()
+{
+    auto const& totals = detail::wsWriteTotals();
+    WSSendStats result;
+    result.sentBytes = totals.sentBytes;
+    result.wireBytes = totals.wireBytes;
+    result.writeTime = std::chrono::microseconds(totals.writeMicros);
+    result.sharedDeflated = totals.sharedDeflated;
+    return result;
+}
+
 struct WSSession
 {
     std::shared_ptr<void> appDefined;
@@ -103,6 +316,11 @@ struct WSSession
     void
     send(std::shared_ptr<WSMsg> w) = 0;
 
+    /** Returns send queue statistics. May be called from any thread. */
+    virtual
+    WSSendStats
+    stats() const = 0;
+
     virtual void
     close() = 0;
 
@@ -3,11 +3,13 @@
 #ifndef RIPPLE_SERVER_BASEHTTPPEER_H_INCLUDED
 #define RIPPLE_SERVER_BASEHTTPPEER_H_INCLUDED
 
+#include <ripple/basics/contract.h>
 #include <ripple/basics/Log.h>
 #include <ripple/server/Session.h>
 #include <ripple/server/impl/io_list.h>
 #include <ripple/beast/net/IPAddressConversion.h>
 #include <ripple/beast/asio/ssl_error.h> 
+#include <ripple/beast/rfc2616.h>
 #include <boost/beast/http/read.hpp>
 #include <boost/beast/http/message.hpp>
 #include <boost/beast/http/parser.hpp>
@@ -16,9 +18,11 @@
 #include <boost/asio/ssl/stream.hpp>
 #include <boost/asio/streambuf.hpp>
 #include <boost/asio/spawn.hpp>
+#include <algorithm>
 #include <atomic>
 #include <cassert>
 #include <chrono>
+#include <deque>
 #include <functional>
 #include <memory>
 #include <mutex>
@@ -63,6 +67,122 @@ protected:
         std::size_t used;
     };
 
+    // The output of one request. Requests on a connection are handled
+    // concurrently but their responses are written in arrival order, so
+    // output is held here until the requests before it are done.
+    struct Response
+    {
+        std::vector<buffer> held;       // guarded by mutex_
+        std::size_t held_bytes = 0;     // guarded by mutex_
+        bool head = false;              // guarded by mutex_
+        bool closed = false;            // guarded by mutex_
+        std::size_t limit = 0;          // guarded by mutex_
+        std::function<void(void)> resume; // guarded by mutex_
+        bool done = false;
+        bool keep_alive = true;
+    };
+
+    // The session handed to the handler for each request
+    class RequestSession
+        : public Session
+        , public std::enable_shared_from_this<RequestSession>
+    {
+    public:
+        RequestSession(std::shared_ptr<Impl> peer,
+                std::shared_ptr<Response> response,
+                    http_request_type&& message)
+            : peer_(std::move(peer))
+            , response_(std::move(response))
+            , message_(std::move(message))
+        {
+        }
+
+        ~RequestSession()
+        {
+            if(! finished_)
+                peer_->finish(response_, false);
+        }
+
+        beast::Journal
+        journal() override
+        {
+            return peer_->journal_;
+        }
+
+        Port const&
+        port() override
+        {
+            return peer_->port_;
+        }
+
+        beast::IP::Endpoint
+        remoteAddress() override
+        {
+            return peer_->remoteAddress();
+        }
+
+        http_request_type&
+        request() override
+        {
+            return message_;
+        }
+
+        void
+        write(void const* buffer, std::size_t bytes) override
+        {
+            peer_->write(*response_, buffer, bytes);
+        }
+
+        void
+        write(std::shared_ptr <Writer> const&, bool) override
+        {
+            LogicError("HTTP writer used for a pipelined request");
+        }
+
+        bool
+        waitForDrain(std::size_t limit,
+            std::function<void(void)> resume) override
+        {
+            return peer_->wait_for_drain(
+                *response_, limit, std::move(resume));
+        }
+
+        std::shared_ptr<Session>
+        detach() override
+        {
+            return this->shared_from_this();
+        }
+
+        void
+        complete() override
+        {
+            finished_ = true;
+            peer_->finish(response_, true);
+        }
+
+        void
+        close(bool graceful) override
+        {
+            finished_ = true;
+            if(! graceful)
+                peer_->close(false);
+            peer_->finish(response_, false);
+        }
+
+        // Upgrades are handed off before a request gets a session
+        std::shared_ptr<WSSession>
+        websocketUpgrade() override
+        {
+            return nullptr;
+        }
+
+    private:
+        std::shared_ptr<Impl> peer_;
+        std::shared_ptr<Response> response_;
+        http_request_type message_;
+        bool finished_ = false;
+    };
+
     Port const& port_;
     Handler& handler_;
     boost::asio::executor_work_guard<boost::asio::executor> work_;
@@ -78,11 +198,19 @@ protected:
     http_request_type message_;
     std::vector<buffer> wq_;
     std::vector<buffer> wq2_;
+    std::size_t queued_ = 0;    // bytes in wq_ and wq2_, guarded by mutex_
     std::mutex mutex_;
     bool graceful_ = false;
-    bool complete_ = false;
     boost::system::error_code ec_;
 
+    std::deque<std::shared_ptr<Response>> pending_;
+    std::shared_ptr<Writer> writer_;
+    bool writer_keep_alive_ = false;
+    bool streaming_ = false;
+    bool reading_ = false;
+    bool held_ = false;
+    bool keep_alive_ = true;
+
     int request_count_ = 0;
     std::size_t bytes_in_ = 0;
     std::size_t bytes_out_ = 0;
@@ -140,6 +268,28 @@ protected:
     do_writer(std::shared_ptr <Writer> const& writer,
         bool keep_alive, yield_context do_yield);
 
+    void
+    read_next();
+
+    void
+    dispatch();
+
+    void
+    write(Response& response, void const* buffer, std::size_t bytes);
+
+    void
+    finish(std::shared_ptr<Response> const& response, bool keep_alive);
+
+    bool
+    wait_for_drain(Response& response, std::size_t limit,
+        std::function<void(void)> resume);
+
+    void
+    drain(bool all);
+
+    void
+    proceed();
+
     virtual
     void
     do_request() = 0;
@@ -180,6 +330,13 @@ protected:
     write(std::shared_ptr <Writer> const& writer,
         bool keep_alive) override;
 
+    bool
+    waitForDrain(std::size_t,
+        std::function<void(void)>) override
+    {
+        return false;
+    }
+
     std::shared_ptr<Session>
     detach() override;
 
@@ -256,6 +413,8 @@ fail(error_code ec, char const* what)
             std::string(what) << ": " << ec.message();
         impl().stream_.lowest_layer().close(ec);
     }
+    // Nothing queued will be written now
+    drain(true);
 }
 
 template<class Handler, class Impl>
@@ -308,16 +467,30 @@ void
 BaseHTTPPeer<Handler, Impl>::
 do_read(yield_context do_yield)
 {
-    complete_ = false;
+    reading_ = true;
+    message_ = {};
     error_code ec;
-    start_timer();
+    // The client may wait for responses before sending more
+    if(pending_.empty())
+        start_timer();
     boost::beast::http::async_read(impl().stream_,
         read_buf_, message_, do_yield[ec]);
+    reading_ = false;
     cancel_timer();
     if(ec == boost::beast::http::error::end_of_stream)
-        return do_close();
+    {
+        keep_alive_ = false;
+        graceful_ = true;
+        return proceed();
+    }
     if(ec)
         return fail(ec, "http::read");
+    // Upgrades take over the stream, so they wait for earlier responses
+    if(message_.find(boost::beast::http::field::upgrade) != message_.end())
+    {
+        held_ = true;
+        return proceed();
+    }
     do_request();
 }
 
@@ -333,10 +506,13 @@ on_write(error_code const& ec,
     bytes_out_ += bytes_transferred;
     {
         std::lock_guard<std::mutex> lock(mutex_);
+        for(auto const& b : wq2_)
+            queued_ -= b.bytes;
         wq2_.clear();
         wq2_.reserve(wq_.size());
         std::swap(wq2_, wq_);
     }
+    drain(false);
     if(! wq2_.empty())
     {
         std::vector<boost::asio::const_buffer> v;
@@ -355,13 +531,7 @@ on_write(error_code const& ec,
                     std::placeholders::_1,
                     std::placeholders::_2)));
     }
-    if(! complete_)
-        return;
-    if(graceful_)
-        return do_close();
-    boost::asio::spawn(strand_,
-        std::bind(&BaseHTTPPeer<Handler, Impl>::do_read,
-            impl().shared_from_this(), std::placeholders::_1));
+    proceed();
 }
 
 template<class Handler, class Impl>
@@ -397,11 +567,52 @@ do_writer(std::shared_ptr <Writer> const& writer,
             break;
     }
 
+    streaming_ = false;
     if(! keep_alive)
         return do_close();
 
-    boost::asio::spawn(strand_, std::bind(&BaseHTTPPeer<Handler, Impl>::do_read,
-        impl().shared_from_this(), std::placeholders::_1));
+    proceed();
+}
+
+template<class Handler, class Impl>
+void
+BaseHTTPPeer<Handler, Impl>::
+read_next()
+{
+    if(reading_)
+    {
+        if(pending_.empty())
+            start_timer();
+        return;
+    }
+    if(ec_ || graceful_ || ! keep_alive_ || held_ || writer_ ||
+            streaming_ || pending_.size() >= port_.pipeline)
+        return;
+    reading_ = true;
+    boost::asio::spawn(bind_executor(
+        strand_,
+        std::bind(
+            &BaseHTTPPeer<Handler, Impl>::do_read,
+            impl().shared_from_this(),
+            std::placeholders::_1)));
+}
+
+template<class Handler, class Impl>
+void
+BaseHTTPPeer<Handler, Impl>::
+dispatch()
+{
+    if(! beast::rfc2616::is_keep_alive(message_))
+        keep_alive_ = false;
+    auto const response = std::make_shared<Response>();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        response->head = pending_.empty();
+    }
+    pending_.push_back(response);
+    handler_.onRequest(*std::make_shared<RequestSession>(
+        impl().shared_from_this(), response, std::move(message_)));
+    read_next();
 }
 
 
@@ -417,6 +628,7 @@ write(
         {
             std::lock_guard<std::mutex> lock(mutex_);
             wq_.emplace_back(buffer, bytes);
+            queued_ += bytes;
             return wq_.size() == 1 && wq2_.size() == 0;
         }())
     {
@@ -433,20 +645,44 @@ write(
     }
 }
 
+template<class Handler, class Impl>
+void
+BaseHTTPPeer<Handler, Impl>::
+write(Response& response, void const* buffer, std::size_t bytes)
+{
+    if(bytes == 0)
+        return;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if(! response.head)
+        {
+            response.held.emplace_back(buffer, bytes);
+            response.held_bytes += bytes;
+            return;
+        }
+    }
+    write(buffer, bytes);
+}
+
 template<class Handler, class Impl>
 void
 BaseHTTPPeer<Handler, Impl>::
 write(std::shared_ptr <Writer> const& writer,
     bool keep_alive)
 {
-    boost::asio::spawn(bind_executor(
-        strand_,
-        std::bind(
-            &BaseHTTPPeer<Handler, Impl>::do_writer,
-            impl().shared_from_this(),
-            writer,
-            keep_alive,
-            std::placeholders::_1)));
+    if(! strand_.running_in_this_thread())
+        return post(
+            strand_,
+            std::bind(
+                (void (BaseHTTPPeer::*)(std::shared_ptr <Writer> const&, bool))
+                    &BaseHTTPPeer<Handler, Impl>::write,
+                impl().shared_from_this(),
+                writer,
+                keep_alive));
+
+    writer_ = writer;
+    writer_keep_alive_ = keep_alive;
+    proceed();
 }
 
 template<class Handler, class Impl>
@@ -469,21 +705,144 @@ complete()
                 &BaseHTTPPeer<Handler, Impl>::complete,
                 impl().shared_from_this()));
 
-    message_ = {};
-    complete_ = true;
+    proceed();
+}
+
+template<class Handler, class Impl>
+void
+BaseHTTPPeer<Handler, Impl>::
+finish(std::shared_ptr<Response> const& response, bool keep_alive)
+{
+    if(! strand_.running_in_this_thread())
+        return post(
+            strand_,
+            std::bind(
+                &BaseHTTPPeer<Handler, Impl>::finish,
+                impl().shared_from_this(),
+                response,
+                keep_alive));
+
+    // Requests after one that closed the connection are already dropped
+    if(std::find(pending_.begin(), pending_.end(), response) ==
+            pending_.end())
+        return;
+    response->done = true;
+    response->keep_alive = keep_alive;
+    proceed();
+}
 
+template<class Handler, class Impl>
+bool
+BaseHTTPPeer<Handler, Impl>::
+wait_for_drain(Response& response, std::size_t limit,
+    std::function<void(void)> resume)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    // Output held behind earlier responses only counts against its own
+    if(response.closed ||
+            (response.head ? queued_ : response.held_bytes) <= limit)
+        return false;
+    response.limit = limit;
+    response.resume = std::move(resume);
+    return true;
+}
+
+// Resumes requests waiting for their output to drain. With `all` the
+// connection is going away, so every waiter is resumed and later waits
+// return at once.
+template<class Handler, class Impl>
+void
+BaseHTTPPeer<Handler, Impl>::
+drain(bool all)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    for(auto const& response : pending_)
     {
-        std::lock_guard<std::mutex> lock(mutex_);
-        if(! wq_.empty() && ! wq2_.empty())
+        if(all)
+            response->closed = true;
+        if(response->resume && (response->closed ||
+            (response->head && queued_ <= response->limit)))
+        {
+            post(strand_, std::move(response->resume));
+            response->resume = nullptr;
+        }
+    }
+}
+
+// Retires finished requests in order, then starts whatever is waiting for
+// the connection: the next response, a close, a handoff response, a held
+// upgrade or the next read.
+template<class Handler, class Impl>
+void
+BaseHTTPPeer<Handler, Impl>::
+proceed()
+{
+    if(streaming_)
+        return;
+
+    while(! pending_.empty() && pending_.front()->done)
+    {
+        auto const response = std::move(pending_.front());
+        pending_.pop_front();
+        if(! response->keep_alive)
+        {
+            drain(true);
+            pending_.clear();
+            keep_alive_ = false;
+            graceful_ = true;
+            break;
+        }
+        if(pending_.empty())
+            break;
+
+        auto& next = *pending_.front();
+        bool start;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            next.head = true;
+            start = ! next.held.empty() && wq_.empty() && wq2_.empty();
+            for(auto& b : next.held)
+                wq_.push_back(std::move(b));
+            next.held.clear();
+            queued_ += next.held_bytes;
+            next.held_bytes = 0;
+        }
+        if(start)
+            on_write(error_code{}, 0);
+    }
+
+    if(pending_.empty())
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if(! wq_.empty() || ! wq2_.empty())
+                return;
+        }
+        if(graceful_)
+            return do_close();
+        if(writer_)
+        {
+            auto const writer = std::move(writer_);
+            writer_ = nullptr;
+            streaming_ = true;
+            boost::asio::spawn(bind_executor(
+                strand_,
+                std::bind(
+                    &BaseHTTPPeer<Handler, Impl>::do_writer,
+                    impl().shared_from_this(),
+                    writer,
+                    writer_keep_alive_,
+                    std::placeholders::_1)));
             return;
+        }
+        if(held_)
+        {
+            held_ = false;
+            return do_request();
+        }
     }
 
-    boost::asio::spawn(bind_executor(
-        strand_,
-        std::bind(
-            &BaseHTTPPeer<Handler, Impl>::do_read,
-            impl().shared_from_this(),
-            std::placeholders::_1)));
+    read_next();
 }
 
 template<class Handler, class Impl>
@@ -500,7 +859,6 @@ close(bool graceful)
                 impl().shared_from_this(),
                 graceful));
 
-    complete_ = true;
     if(graceful)
     {
         graceful_ = true;
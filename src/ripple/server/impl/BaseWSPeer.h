@@ -12,8 +12,13 @@
 #include <boost/beast/websocket.hpp>
 #include <boost/beast/core/multi_buffer.hpp>
 #include <boost/beast/http/message.hpp>
+#include <boost/optional.hpp>
+#include <array>
 #include <cassert>
 #include <functional>
+#include <list>
+#include <mutex>
+#include <set>
 
 namespace ripple {
 
@@ -36,9 +41,23 @@ private:
     http_request_type request_;
     boost::beast::multi_buffer rb_;
     boost::beast::multi_buffer wb_;
-    std::list<std::shared_ptr<WSMsg>> wq_;
+    struct Queued
+    {
+        std::shared_ptr<WSMsg> msg;
+        std::size_t bytes;
+        std::chrono::steady_clock::time_point when;
+    };
+
+    std::list<Queued> wq_;
+    std::set<std::string> paused_;
+    std::mutex mutable statsLock_;
+    WSSendStats stats_;
+    std::chrono::steady_clock::time_point oldest_;
     bool do_close_ = false;
     boost::beast::websocket::close_reason cr_;
+    boost::optional<WSDeflateParams> deflate_;
+    std::array<std::uint8_t, 10> frameHeader_;
+    std::shared_ptr<std::string const> frame_;
     waitable_timer timer_;
     bool close_on_timer_ = false;
     bool ping_active_ = false;
@@ -81,6 +100,9 @@ public:
     void
     send(std::shared_ptr<WSMsg> w) override;
 
+    WSSendStats
+    stats() const override;
+
     void
     close() override;
 
@@ -109,6 +131,28 @@ protected:
     void
     on_write_fin(error_code const& ec);
 
+    // Writes the front message as a frame compressed once for every
+    // session with the same settings.
+    void
+    write_frame(bool binary, std::shared_ptr<std::string const> frame);
+
+    void
+    enqueue(std::shared_ptr<WSMsg> w);
+
+    // Removes a queued message, or counts one that was never queued
+    // when passed end().
+    typename std::list<Queued>::iterator
+    drop(typename std::list<Queued>::iterator iter, bool coalesced = false);
+
+    void
+    pop_front();
+
+    bool
+    over_limit() const;
+
+    bool
+    drained() const;
+
     void
     do_read();
 
@@ -179,9 +223,10 @@ run()
     close_on_timer_ = true;
     impl().ws_.async_accept_ex(
         request_,
-        [](auto& res) {
+        [this](auto& res) {
             res.set(boost::beast::http::field::server,
                 BuildInfo::getFullVersionString());
+            deflate_ = wsSharedDeflate(res, port().pmd_options);
         },
         bind_executor(
             strand_,
@@ -203,21 +248,170 @@ send(std::shared_ptr<WSMsg> w)
                 &BaseWSPeer::send, impl().shared_from_this(), std::move(w)));
     if(do_close_)
         return;
-    if(wq_.size() > port().ws_queue_limit)
+
+    auto const stream = w->stream().to_string();
+    if(! paused_.empty())
     {
-        cr_.code = safe_cast<decltype(cr_.code)>
-                      (boost::beast::websocket::close_code::policy_error);
-        cr_.reason = "Policy error: client is too slow.";
-        JLOG(this->j_.info()) << cr_.reason;
-        wq_.erase(std::next(wq_.begin()), wq_.end());
-        close(cr_);
-        return;
+        if(drained())
+            paused_.clear();
+        else if(paused_.count(stream))
+        {
+            drop(wq_.end());
+            return;
+        }
     }
-    wq_.emplace_back(std::move(w));
-    if(wq_.size() == 1)
+
+    // The front message may be partly written so it is never removed.
+    if(w->coalesce() && wq_.size() > 1)
+    {
+        auto iter = std::find_if(std::next(wq_.begin()), wq_.end(),
+            [&](Queued const& q)
+            {
+                return q.msg->coalesce() && q.msg->stream() == stream;
+            });
+        if(iter != wq_.end())
+            drop(iter, true);
+    }
+
+    enqueue(w);
+    if(over_limit() && wq_.size() > 1)
+    {
+        auto const same = [&](Queued const& q)
+        {
+            return q.msg->stream() == stream;
+        };
+        switch(port().overflow(stream))
+        {
+        case WSOverflow::close:
+            cr_.code = safe_cast<decltype(cr_.code)>
+                          (boost::beast::websocket::close_code::policy_error);
+            cr_.reason = "Policy error: client is too slow.";
+            JLOG(this->j_.info()) << cr_.reason;
+            while(wq_.size() > 1)
+                drop(std::prev(wq_.end()));
+            close(cr_);
+            return;
+
+        case WSOverflow::drop_oldest:
+            for(auto iter = std::next(wq_.begin());
+                over_limit() && iter->msg != w;)
+            {
+                iter = same(*iter) ? drop(iter) : std::next(iter);
+            }
+            if(over_limit())
+                drop(std::prev(wq_.end()));
+            break;
+
+        case WSOverflow::drop_stream:
+            for(auto iter = std::next(wq_.begin()); iter != wq_.end();)
+                iter = same(*iter) ? drop(iter) : std::next(iter);
+            break;
+
+        case WSOverflow::pause:
+            drop(std::prev(wq_.end()));
+            paused_.insert(stream);
+            JLOG(this->j_.debug()) <<
+                "pausing stream '" << stream << "'";
+            break;
+        }
+    }
+    if(wq_.size() == 1 && wq_.front().msg == w)
         on_write({});
 }
 
+template<class Handler, class Impl>
+WSSendStats
+BaseWSPeer<Handler, Impl>::
+stats() const
+{
+    std::lock_guard<std::mutex> lock(statsLock_);
+    auto result = stats_;
+    if(result.queued != 0)
+        result.lag = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - oldest_);
+    return result;
+}
+
+template<class Handler, class Impl>
+void
+BaseWSPeer<Handler, Impl>::
+enqueue(std::shared_ptr<WSMsg> w)
+{
+    auto const bytes = w->size();
+    auto const now = std::chrono::steady_clock::now();
+    wq_.push_back({std::move(w), bytes, now});
+
+    std::lock_guard<std::mutex> lock(statsLock_);
+    if(stats_.queued++ == 0)
+        oldest_ = now;
+    stats_.queuedBytes += bytes;
+    stats_.peakBytes = std::max(stats_.peakBytes, stats_.queuedBytes);
+}
+
+template<class Handler, class Impl>
+auto
+BaseWSPeer<Handler, Impl>::
+drop(typename std::list<Queued>::iterator iter, bool coalesced) ->
+    typename std::list<Queued>::iterator
+{
+    std::lock_guard<std::mutex> lock(statsLock_);
+    ++(coalesced ? stats_.coalesced : stats_.dropped);
+    if(iter == wq_.end())
+        return iter;
+    assert(iter != wq_.begin());
+    --stats_.queued;
+    stats_.queuedBytes -= iter->bytes;
+    return wq_.erase(iter);
+}
+
+template<class Handler, class Impl>
+void
+BaseWSPeer<Handler, Impl>::
+pop_front()
+{
+    auto const& stream = impl().ws_.next_layer();
+    auto const wireBytes = stream.bytes_written();
+    auto const writeTime = std::chrono::duration_cast<
+        std::chrono::microseconds>(stream.time_writing());
+
+    std::lock_guard<std::mutex> lock(statsLock_);
+    --stats_.queued;
+    stats_.queuedBytes -= wq_.front().bytes;
+    ++stats_.sent;
+    addWSWriteTotals(wq_.front().bytes, wireBytes - stats_.wireBytes,
+        writeTime - stats_.writeTime, frame_ != nullptr);
+    stats_.sentBytes += wq_.front().bytes;
+    stats_.wireBytes = wireBytes;
+    stats_.writeTime = writeTime;
+    if(frame_)
+        ++stats_.sharedDeflated;
+    wq_.pop_front();
+    if(! wq_.empty())
+        oldest_ = wq_.front().when;
+}
+
+template<class Handler, class Impl>
+bool
+BaseWSPeer<Handler, Impl>::
+over_limit() const
+{
+    std::lock_guard<std::mutex> lock(statsLock_);
+    return stats_.queued > port().ws_queue_limit ||
+        (port().ws_queue_bytes != 0 &&
+            stats_.queuedBytes > port().ws_queue_bytes);
+}
+
+template<class Handler, class Impl>
+bool
+BaseWSPeer<Handler, Impl>::
+drained() const
+{
+    std::lock_guard<std::mutex> lock(statsLock_);
+    return stats_.queued <= port().ws_queue_limit / 2u &&
+        (port().ws_queue_bytes == 0 ||
+            stats_.queuedBytes <= port().ws_queue_bytes / 2);
+}
+
 template <class Handler, class Impl>
 void
 BaseWSPeer<Handler, Impl>::close()
@@ -292,15 +486,27 @@ void
 BaseWSPeer<Handler, Impl>::
 on_write(error_code const& ec)
 {
+    impl().ws_.next_layer().stop_timing();
     if(ec)
         return fail(ec, "write");
-    auto& w = *wq_.front();
+    auto& w = *wq_.front().msg;
+    if(deflate_ && impl().ws_.is_open())
+    {
+        // Compressing counts toward the write time of the first session
+        // to ask for the message.
+        impl().ws_.next_layer().start_timing();
+        if(auto frame = w.deflated(*deflate_))
+            return write_frame(w.binary(), std::move(frame));
+        impl().ws_.next_layer().stop_timing();
+    }
     auto const result = w.prepare(65536,
         std::bind(&BaseWSPeer::do_write,
             impl().shared_from_this()));
     if(boost::indeterminate(result.first))
         return;
     start_timer();
+    impl().ws_.binary(w.binary());
+    impl().ws_.next_layer().start_timing();
     if(! result.first)
         impl().ws_.async_write_some(
             static_cast<bool>(result.first),
@@ -323,14 +529,56 @@ on_write(error_code const& ec)
                     std::placeholders::_1)));
 }
 
+template<class Handler, class Impl>
+void
+BaseWSPeer<Handler, Impl>::
+write_frame(bool binary, std::shared_ptr<std::string const> frame)
+{
+    // A final frame with RSV1 set, unmasked since it is from the server
+    std::size_t n = 0;
+    frameHeader_[n++] = binary ? 0xc2 : 0xc1;
+    std::uint64_t const size = frame->size();
+    if(size < 126)
+    {
+        frameHeader_[n++] = static_cast<std::uint8_t>(size);
+    }
+    else if(size < 65536)
+    {
+        frameHeader_[n++] = 126;
+        frameHeader_[n++] = static_cast<std::uint8_t>(size >> 8);
+        frameHeader_[n++] = static_cast<std::uint8_t>(size);
+    }
+    else
+    {
+        frameHeader_[n++] = 127;
+        for(int shift = 56; shift >= 0; shift -= 8)
+            frameHeader_[n++] = static_cast<std::uint8_t>(size >> shift);
+    }
+    frame_ = std::move(frame);
+    start_timer();
+    std::array<boost::asio::const_buffer, 2> const buffers{{
+        boost::asio::buffer(frameHeader_.data(), n),
+        boost::asio::buffer(*frame_)}};
+    impl().ws_.next_layer().async_write_frame(
+        buffers,
+        bind_executor(
+            strand_,
+            std::bind(
+                &BaseWSPeer::on_write_fin,
+                impl().shared_from_this(),
+                std::placeholders::_1)));
+}
+
 template<class Handler, class Impl>
 void
 BaseWSPeer<Handler, Impl>::
 on_write_fin(error_code const& ec)
 {
+    impl().ws_.next_layer().stop_timing();
     if(ec)
         return fail(ec, "write_fin");
-    wq_.pop_front();
+    pop_front();
+    frame_.reset();
     if(do_close_)
         impl().ws_.async_close(
             cr_,
@@ -7,6 +7,7 @@
 #include <ripple/protocol/SystemParameters.h>
 #include <ripple/json/to_string.h>
 #include <boost/algorithm/string.hpp>
+#include <cstdio>
 
 namespace ripple {
 
@@ -88,6 +89,78 @@ void HTTPReply (
     output ("\r\n");
 }
 
+void HTTPBinaryReply (std::string const& content, Json::Output const& output)
+{
+    output ("HTTP/1.1 200 OK\r\n");
+    output (getHTTPHeaderTimestamp ());
+    output ("Connection: Keep-Alive\r\n"
+            "Content-Length: ");
+    output (std::to_string (content.size ()));
+    output ("\r\n"
+            "Content-Type: application/octet-stream\r\n");
+    output ("Server: " + systemName () + "-json-rpc/");
+    output (BuildInfo::getFullVersionString ());
+    output ("\r\n"
+            "\r\n");
+    output (content);
+}
+
+HTTPChunkedReply::HTTPChunkedReply (Json::Output const& output,
+        std::size_t chunkSize, char const* contentType)
+    : output_ (output)
+    , chunkSize_ (chunkSize)
+{
+    buffer_.reserve (chunkSize_);
+
+    output_ ("HTTP/1.1 200 OK\r\n");
+    output_ (getHTTPHeaderTimestamp ());
+    output_ ("Connection: Keep-Alive\r\n"
+             "Transfer-Encoding: chunked\r\n"
+             "Content-Type: ");
+    output_ (contentType);
+    output_ ("\r\n");
+    output_ ("Server: " + systemName () + "-json-rpc/");
+    output_ (BuildInfo::getFullVersionString ());
+    output_ ("\r\n"
+             "\r\n");
+}
+
+void HTTPChunkedReply::write (boost::beast::string_view const& bytes)
+{
+    size_ += bytes.size ();
+    buffer_.append (bytes.data (), bytes.size ());
+    if (buffer_.size () >= chunkSize_)
+        flush ();
+}
+
+Json::Output HTTPChunkedReply::output ()
+{
+    return [this](boost::beast::string_view const& bytes)
+    {
+        write (bytes);
+    };
+}
+
+void HTTPChunkedReply::flush ()
+{
+    if (buffer_.empty ())
+        return;
+
+    char size[20];
+    std::snprintf (size, sizeof (size), "%zx\r\n", buffer_.size ());
+    output_ (size);
+    buffer_ += "\r\n";
+    output_ (buffer_);
+    buffer_.clear ();
+}
+
+std::size_t HTTPChunkedReply::finish ()
+{
+    flush ();
+    output_ ("0\r\n\r\n");
+    return size_;
+}
+
 } 
 
 
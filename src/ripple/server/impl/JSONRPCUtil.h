@@ -11,6 +11,42 @@ namespace ripple {
 void HTTPReply (
     int nStatus, std::string const& strMsg, Json::Output const&, beast::Journal j);
 
+/** A 200 response carrying `content` as application/octet-stream. */
+void HTTPBinaryReply (std::string const& content, Json::Output const&);
+
+/** A 200 response whose body is sent with chunked transfer encoding.
+
+    Bytes written are buffered and passed on in chunks of about
+    `chunkSize` bytes, so the body never has to exist as one string.
+*/
+class HTTPChunkedReply
+{
+public:
+    HTTPChunkedReply (Json::Output const& output, std::size_t chunkSize,
+        char const* contentType = "application/json; charset=UTF-8");
+    HTTPChunkedReply (HTTPChunkedReply const&) = delete;
+    HTTPChunkedReply& operator= (HTTPChunkedReply const&) = delete;
+
+    void write (boost::beast::string_view const& bytes);
+
+    /** Returns an output that writes to this reply. */
+    Json::Output output ();
+
+    /** Sends what remains and ends the body.
+
+        @return The size of the body.
+    */
+    std::size_t finish ();
+
+private:
+    void flush ();
+
+    Json::Output output_;
+    std::size_t const chunkSize_;
+    std::string buffer_;
+    std::size_t size_ = 0;
+};
+
 } 
 
 #endif
@@ -0,0 +1,276 @@
+#ifndef RIPPLE_SERVER_METEREDSTREAM_H_INCLUDED
+#define RIPPLE_SERVER_METEREDSTREAM_H_INCLUDED
+
+#include <boost/asio/associated_allocator.hpp>
+#include <boost/asio/associated_executor.hpp>
+#include <boost/beast/websocket/teardown.hpp>
+#if BOOST_VERSION >= 107000
+#include <boost/beast/core/role.hpp>
+#endif
+#include <boost/system/error_code.hpp>
+#include <boost/asio/write.hpp>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace ripple {
+
+#if BOOST_VERSION >= 107000
+using boost::beast::role_type;
+#else
+using boost::beast::websocket::role_type;
+#endif
+
+// A stream layer that meters the writes started while timing. It counts
+// their bytes, and adds up the time from a write being started, or from
+// the last one reaching the connection, until the layer above hands it the
+// next bytes. Under a websocket that is the time spent framing and
+// compressing a message. Handshakes, pings and close frames are written
+// outside of timing and are not counted.
+//
+// Each write goes out whole, and a write started while another is on the
+// connection waits for it. That lets a session put frames it built itself
+// between the frames written by the websocket stream above.
+template<class NextLayer>
+class MeteredStream
+{
+public:
+    using next_layer_type = std::remove_reference_t<NextLayer>;
+    using executor_type = typename next_layer_type::executor_type;
+    using clock_type = std::chrono::steady_clock;
+
+private:
+    template<class Handler>
+    class Counter
+    {
+        MeteredStream& stream_;
+        Handler handler_;
+        bool const metered_;
+
+    public:
+        using executor_type = boost::asio::associated_executor_t<
+            Handler, typename MeteredStream::executor_type>;
+        using allocator_type = boost::asio::associated_allocator_t<Handler>;
+
+        template<class DeducedHandler>
+        Counter(MeteredStream& stream, DeducedHandler&& handler)
+            : stream_(stream)
+            , handler_(std::forward<DeducedHandler>(handler))
+            , metered_(stream.timing_)
+        {
+        }
+
+        executor_type
+        get_executor() const noexcept
+        {
+            return boost::asio::get_associated_executor(
+                handler_, stream_.get_executor());
+        }
+
+        allocator_type
+        get_allocator() const noexcept
+        {
+            return boost::asio::get_associated_allocator(handler_);
+        }
+
+        void
+        operator()(boost::system::error_code const& ec, std::size_t bytes)
+        {
+            if(metered_)
+                stream_.written_ += bytes;
+            if(stream_.timing_)
+                stream_.since_ = clock_type::now();
+            stream_.writing_ = false;
+            if(! stream_.waiting_.empty())
+            {
+                auto next = std::move(stream_.waiting_.front());
+                stream_.waiting_.pop_front();
+                next->start();
+            }
+            handler_(ec, bytes);
+        }
+    };
+
+    struct Waiting
+    {
+        virtual ~Waiting() = default;
+
+        virtual
+        void
+        start() = 0;
+    };
+
+    template<class ConstBufferSequence, class Handler>
+    class WaitingWrite : public Waiting
+    {
+        MeteredStream& stream_;
+        ConstBufferSequence buffers_;
+        Counter<Handler> handler_;
+
+    public:
+        WaitingWrite(MeteredStream& stream,
+            ConstBufferSequence const& buffers, Counter<Handler>&& handler)
+            : stream_(stream)
+            , buffers_(buffers)
+            , handler_(std::move(handler))
+        {
+        }
+
+        void
+        start() override
+        {
+            stream_.write(buffers_, std::move(handler_));
+        }
+    };
+
+    NextLayer next_;
+    std::uint64_t written_ = 0;
+    clock_type::duration busy_ {0};
+    clock_type::time_point since_;
+    bool timing_ = false;
+    bool writing_ = false;
+    std::deque<std::unique_ptr<Waiting>> waiting_;
+
+    template<class ConstBufferSequence, class Handler>
+    void
+    write(ConstBufferSequence const& buffers, Counter<Handler>&& handler)
+    {
+        writing_ = true;
+        boost::asio::async_write(next_, buffers, std::move(handler));
+    }
+
+    template<class ConstBufferSequence, class WriteHandler>
+    void
+    enqueue(ConstBufferSequence const& buffers, WriteHandler&& handler)
+    {
+        if(timing_)
+            busy_ += clock_type::now() - since_;
+        using handler_type = std::decay_t<WriteHandler>;
+        Counter<handler_type> counter(
+            *this, std::forward<WriteHandler>(handler));
+        if(! writing_)
+            return write(buffers, std::move(counter));
+        waiting_.push_back(std::make_unique<
+            WaitingWrite<ConstBufferSequence, handler_type>>(
+                *this, buffers, std::move(counter)));
+    }
+
+public:
+    template<class... Args>
+    explicit
+    MeteredStream(Args&&... args)
+        : next_(std::forward<Args>(args)...)
+    {
+    }
+
+    next_layer_type&
+    next_layer()
+    {
+        return next_;
+    }
+
+    next_layer_type const&
+    next_layer() const
+    {
+        return next_;
+    }
+
+    decltype(auto)
+    lowest_layer()
+    {
+        return next_.lowest_layer();
+    }
+
+    executor_type
+    get_executor() noexcept
+    {
+        return next_.get_executor();
+    }
+
+    void
+    start_timing()
+    {
+        timing_ = true;
+        since_ = clock_type::now();
+    }
+
+    void
+    stop_timing()
+    {
+        timing_ = false;
+    }
+
+    std::uint64_t
+    bytes_written() const
+    {
+        return written_;
+    }
+
+    clock_type::duration
+    time_writing() const
+    {
+        return busy_;
+    }
+
+    template<class MutableBufferSequence, class ReadHandler>
+    decltype(auto)
+    async_read_some(MutableBufferSequence const& buffers,
+        ReadHandler&& handler)
+    {
+        return next_.async_read_some(
+            buffers, std::forward<ReadHandler>(handler));
+    }
+
+    template<class ConstBufferSequence, class WriteHandler>
+    void
+    async_write_some(ConstBufferSequence const& buffers,
+        WriteHandler&& handler)
+    {
+        enqueue(buffers, std::forward<WriteHandler>(handler));
+    }
+
+    /** Writes bytes that already form whole websocket frames.
+
+        They go out between the frames of the websocket stream above,
+        never inside one, so the caller must not start them while the
+        stream is partway through a message. The buffers must stay valid
+        until the handler is called.
+    */
+    template<class ConstBufferSequence, class WriteHandler>
+    void
+    async_write_frame(ConstBufferSequence const& buffers,
+        WriteHandler&& handler)
+    {
+        enqueue(buffers, std::forward<WriteHandler>(handler));
+    }
+};
+
+template<class NextLayer>
+void
+teardown(
+    role_type role,
+    MeteredStream<NextLayer>& stream,
+    boost::system::error_code& ec)
+{
+    using boost::beast::websocket::teardown;
+    teardown(role, stream.next_layer(), ec);
+}
+
+template<class NextLayer, class TeardownHandler>
+void
+async_teardown(
+    role_type role,
+    MeteredStream<NextLayer>& stream,
+    TeardownHandler&& handler)
+{
+    using boost::beast::websocket::async_teardown;
+    async_teardown(role, stream.next_layer(),
+        std::forward<TeardownHandler>(handler));
+}
+
+}
+
+#endif
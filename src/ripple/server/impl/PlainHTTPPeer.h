@@ -128,7 +128,7 @@ do_request()
         stream_.shutdown(socket_type::shutdown_receive, ec);
     if (ec)
         return this->fail(ec, "request");
-    this->handler_.onRequest(this->session());
+    this->dispatch();
 }
 
 template<class Handler>
@@ -4,6 +4,7 @@
 #define RIPPLE_SERVER_PLAINWSPEER_H_INCLUDED
 
 #include <ripple/server/impl/BaseWSPeer.h>
+#include <ripple/server/impl/MeteredStream.h>
 #include <ripple/beast/asio/waitable_timer.h>
 #include <memory>
 
@@ -23,7 +24,7 @@ class PlainWSPeer
     using waitable_timer = boost::asio::basic_waitable_timer <clock_type>;
     using socket_type = boost::asio::ip::tcp::socket;
 
-    boost::beast::websocket::stream<socket_type> ws_;
+    boost::beast::websocket::stream<MeteredStream<socket_type>> ws_;
 
 public:
     template<class Body, class Headers>
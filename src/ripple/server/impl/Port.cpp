@@ -26,6 +26,17 @@ Port::protocols() const
     return s;
 }
 
+WSOverflow
+Port::overflow (boost::beast::string_view stream) const
+{
+    if (stream.empty())
+        return WSOverflow::close;
+    auto const iter = ws_stream_overflow.find (stream.to_string());
+    if (iter != ws_stream_overflow.end())
+        return iter->second;
+    return ws_overflow;
+}
+
 std::ostream&
 operator<< (std::ostream& os, Port const& p)
 {
@@ -50,6 +61,22 @@ operator<< (std::ostream& os, Port const& p)
 }
 
 
+static
+WSOverflow
+toOverflow (std::string const& s)
+{
+    if (s == "close")
+        return WSOverflow::close;
+    if (s == "drop_oldest")
+        return WSOverflow::drop_oldest;
+    if (s == "drop_stream")
+        return WSOverflow::drop_stream;
+    if (s == "pause")
+        return WSOverflow::pause;
+    Throw<std::exception>();
+    return WSOverflow::close;
+}
+
 static
 void
 populate (Section const& section, std::string const& field, std::ostream& log,
@@ -187,6 +214,47 @@ parse_Port (ParsedPort& port, Section const& section, std::ostream& log)
         }
     }
 
+    {
+        auto const result = section.find("pipeline");
+        if (result.second)
+        {
+            try
+            {
+                port.pipeline =
+                    beast::lexicalCastThrow<std::uint16_t>(result.first);
+
+                if (port.pipeline == 0)
+                    Throw<std::exception>();
+            }
+            catch (std::exception const&)
+            {
+                log <<
+                    "Invalid value '" << result.first << "' for key " <<
+                    "'pipeline' in [" << section.name() << "]";
+                Rethrow();
+            }
+        }
+    }
+
+    {
+        auto const result = section.find("workers");
+        if (result.second)
+        {
+            try
+            {
+                port.workers = safe_cast<int> (
+                    beast::lexicalCastThrow<std::uint16_t>(result.first));
+            }
+            catch (std::exception const&)
+            {
+                log <<
+                    "Invalid value '" << result.first << "' for key " <<
+                    "'workers' in [" << section.name() << "]";
+                Rethrow();
+            }
+        }
+    }
+
     {
         auto const result = section.find("send_queue_limit");
         if (result.second)
@@ -213,6 +281,56 @@ parse_Port (ParsedPort& port, Section const& section, std::ostream& log)
         }
     }
 
+    {
+        auto const result = section.find("send_queue_bytes");
+        if (result.second)
+        {
+            try
+            {
+                port.ws_queue_bytes =
+                    beast::lexicalCastThrow<std::size_t>(result.first);
+            }
+            catch (std::exception const&)
+            {
+                log <<
+                    "Invalid value '" << result.first << "' for key " <<
+                    "'send_queue_bytes' in [" << section.name() << "]";
+                Rethrow();
+            }
+        }
+    }
+
+    {
+        // A default policy and per stream overrides, for example
+        // "drop_oldest, transactions:pause, validations:drop_stream"
+        auto const result = section.find("send_queue_overflow");
+        if (result.second)
+        {
+            std::stringstream ss (result.first);
+            std::string item;
+            while (std::getline (ss, item, ','))
+            {
+                item = beast::rfc2616::trim (item);
+                auto const colon = item.find (':');
+                try
+                {
+                    if (colon == std::string::npos)
+                        port.ws_overflow = toOverflow (item);
+                    else
+                        port.ws_stream_overflow[item.substr (0, colon)] =
+                            toOverflow (item.substr (colon + 1));
+                }
+                catch (std::exception const&)
+                {
+                    log <<
+                        "Invalid value '" << item << "' for key " <<
+                        "'send_queue_overflow' in [" << section.name() << "]";
+                    Rethrow();
+                }
+            }
+        }
+    }
+
     populate (section, "admin", log, port.admin_ip, true, {});
     populate (section, "secure_gateway", log, port.secure_gateway_ip, false,
         port.admin_ip.get_value_or({}));
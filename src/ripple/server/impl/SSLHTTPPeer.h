@@ -155,7 +155,7 @@ do_request()
         return;
     if(what.response)
         return this->write(what.response, what.keep_alive);
-    this->handler_.onRequest(this->session());
+    this->dispatch();
 }
 
 template<class Handler>
@@ -4,6 +4,7 @@
 #define RIPPLE_SERVER_SSLWSPEER_H_INCLUDED
 
 #include <ripple/server/impl/BaseHTTPPeer.h>
+#include <ripple/server/impl/MeteredStream.h>
 #include <ripple/server/WSSession.h>
 #include <ripple/beast/asio/ssl_bundle.h>
 #include <ripple/beast/asio/waitable_timer.h>
@@ -28,7 +29,7 @@ class SSLWSPeer
 
     std::unique_ptr<beast::asio::ssl_bundle> ssl_bundle_;
     boost::beast::websocket::stream<
-        beast::asio::ssl_bundle::stream_type&> ws_;
+        MeteredStream<beast::asio::ssl_bundle::stream_type&>> ws_;
 
 public:
     template<class Body, class Headers>
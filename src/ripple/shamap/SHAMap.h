@@ -131,6 +131,12 @@ public:
 
     const_iterator upper_bound(uint256 const& id) const;
 
+    /** Start reading the nodes on the path to a key in the background.
+        Nodes already in memory are walked; the first missing node is
+        requested from the NodeStore without waiting for it.
+    */
+    void prefetch (uint256 const& id) const;
+
     
     void visitNodes (std::function<bool (
         SHAMapAbstractNode&)> const& function) const;
@@ -642,6 +642,29 @@ SHAMap::peekItem (uint256 const& id) const
     return leaf->peekItem ();
 }
 
+void
+SHAMap::prefetch (uint256 const& id) const
+{
+    if (! backed_ || is_v2 ())
+        return;
+
+    SHAMapAbstractNode* node = root_.get ();
+    SHAMapNodeID nodeID;
+    while (node && node->isInner ())
+    {
+        auto const inner = static_cast<SHAMapInnerNode*> (node);
+        auto const branch = nodeID.selectBranch (id);
+        if (inner->isEmptyBranch (branch))
+            return;
+
+        bool pending = false;
+        node = descendAsync (inner, branch, nullptr, pending);
+        if (pending)
+            return;
+        nodeID = nodeID.getChildNodeID (branch);
+    }
+}
+
 std::shared_ptr<SHAMapItem const> const&
 SHAMap::peekItem (uint256 const& id, SHAMapTreeNode::TNType& type) const
 {
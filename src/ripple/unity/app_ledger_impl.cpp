@@ -1,3 +1,4 @@
+#include <ripple/app/ledger/impl/AcquireScheduler.cpp>
 
 
 
@@ -11,6 +12,7 @@
 #include <ripple/app/ledger/impl/LocalTxs.cpp>
 #include <ripple/app/ledger/impl/OpenLedger.cpp>
 #include <ripple/app/ledger/impl/LedgerToJson.cpp>
+#include <ripple/app/ledger/impl/ParallelApply.cpp>
 #include <ripple/app/ledger/impl/TransactionAcquire.cpp>
 #include <ripple/app/ledger/impl/TransactionMaster.cpp>
 
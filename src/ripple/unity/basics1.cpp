@@ -1,6 +1,7 @@
 
 
 
+#include <ripple/basics/impl/Arena.cpp>
 #include <ripple/basics/impl/base64.cpp>
 #include <ripple/basics/impl/contract.cpp>
 #include <ripple/basics/impl/CountedObject.cpp>
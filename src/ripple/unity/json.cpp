@@ -13,6 +13,7 @@
 #include <ripple/json/impl/json_writer.cpp>
 #include <ripple/json/impl/to_string.cpp>
 
+#include <ripple/json/impl/IndexedReader.cpp>
 #include <ripple/json/impl/JsonPropertyStream.cpp>
 #include <ripple/json/impl/Writer.cpp>
 #include <ripple/json/impl/Object.cpp>
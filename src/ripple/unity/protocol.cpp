@@ -2,6 +2,7 @@
 
 
 #include <ripple/protocol/impl/AccountID.cpp>
+#include <ripple/protocol/impl/BatchVerifier.cpp>
 #include <ripple/protocol/impl/Book.cpp>
 #include <ripple/protocol/impl/BuildInfo.cpp>
 #include <ripple/protocol/impl/digest.cpp>
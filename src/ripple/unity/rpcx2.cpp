@@ -32,9 +32,12 @@
 #include <ripple/rpc/handlers/ValidatorListSites.cpp>
 #include <ripple/rpc/handlers/WalletPropose.cpp>
 
+#include <ripple/rpc/impl/BinaryFrames.cpp>
+#include <ripple/rpc/impl/Coalescer.cpp>
 #include <ripple/rpc/impl/DeliveredAmount.cpp>
 #include <ripple/rpc/impl/Handler.cpp>
 #include <ripple/rpc/impl/LegacyPathFind.cpp>
+#include <ripple/rpc/impl/ResultCache.cpp>
 #include <ripple/rpc/impl/Role.cpp>
 #include <ripple/rpc/impl/RPCHandler.cpp>
 #include <ripple/rpc/impl/RPCHelpers.cpp>
@@ -0,0 +1,463 @@
+
+
+#include <ripple/app/ledger/AcquireScheduler.h>
+#include <ripple/beast/unit_test.h>
+#include <ripple/protocol/digest.h>
+#include <test/csf/BasicNetwork.h>
+#include <test/csf/Scheduler.h>
+#include <algorithm>
+#include <cstring>
+#include <set>
+
+namespace ripple {
+namespace test {
+
+namespace {
+
+AcquireScheduler::Node
+makeNode (std::uint32_t i)
+{
+    auto const digest = sha512Half (i);
+    uint256 id;
+    std::memcpy (id.begin (), digest.begin (), 4);
+    return {SHAMapNodeID (8, id), digest};
+}
+
+std::vector<AcquireScheduler::Node>
+makeNodes (std::uint32_t first, std::uint32_t count)
+{
+    std::vector<AcquireScheduler::Node> ret;
+    for (auto i = first; i < first + count; ++i)
+        ret.push_back (makeNode (i));
+    std::sort (ret.begin (), ret.end ());
+    return ret;
+}
+
+std::vector<SHAMapNodeID>
+idsOf (std::vector<AcquireScheduler::Node> const& nodes)
+{
+    std::vector<SHAMapNodeID> ret;
+    for (auto const& n : nodes)
+        ret.push_back (n.first);
+    return ret;
+}
+
+}
+
+class AcquireScheduler_test : public beast::unit_test::suite
+{
+    using time_point = AcquireScheduler::time_point;
+    using Batch = AcquireScheduler::Batch;
+
+    static
+    std::size_t
+    countFor (std::vector<Batch> const& batches, AcquireScheduler::peer_id id)
+    {
+        for (auto const& b : batches)
+        {
+            if (b.first == id)
+                return b.second.size ();
+        }
+        return 0;
+    }
+
+    void
+    testPartition ()
+    {
+        testcase ("partition");
+        using namespace std::chrono_literals;
+
+        AcquireScheduler s (128);
+        s.setPeers ({1, 2, 3, 4});
+
+        time_point const now {};
+        auto const missing = makeNodes (0, 64);
+        auto const batches = s.assign (missing, now);
+
+        BEAST_EXPECT (batches.size () == 4);
+        BEAST_EXPECT (s.outstanding () == 64);
+
+        std::set<unsigned char> seen;
+        for (auto const& b : batches)
+        {
+            BEAST_EXPECT (b.second.size () == 16);
+            BEAST_EXPECT (std::is_sorted (b.second.begin (), b.second.end ()));
+
+            std::set<unsigned char> mine;
+            for (auto const& n : b.second)
+                mine.insert (*n.first.getNodeID ().begin ());
+
+            auto overlap = 0;
+            for (auto const key : mine)
+                overlap += seen.count (key);
+            BEAST_EXPECT (overlap <= 1);
+            seen.insert (mine.begin (), mine.end ());
+        }
+
+        BEAST_EXPECT (s.assign (missing, now).empty ());
+    }
+
+    void
+    testRebalance ()
+    {
+        testcase ("rebalance");
+        using namespace std::chrono_literals;
+
+        AcquireScheduler s (128);
+        s.setPeers ({1, 2});
+
+        time_point const start {};
+        auto const batches = s.assign (makeNodes (0, 64), start);
+        BEAST_EXPECT (countFor (batches, 1) == 32);
+        BEAST_EXPECT (countFor (batches, 2) == 32);
+
+        for (auto const& b : batches)
+        {
+            auto const delay = (b.first == 1) ? 10ms : 500ms;
+            BEAST_EXPECT (s.onReply (b.first, idsOf (b.second),
+                b.second.size () * 500, start + delay) == 32);
+        }
+
+        auto const fast = s.getStats (1);
+        auto const slow = s.getStats (2);
+        if (! BEAST_EXPECT (fast && slow))
+            return;
+        BEAST_EXPECT (fast->rate > 10 * slow->rate);
+        BEAST_EXPECT (fast->latency == 10ms);
+        BEAST_EXPECT (slow->latency == 500ms);
+        BEAST_EXPECT (s.outstanding () == 0);
+
+        auto const next = s.assign (makeNodes (1000, 100), start + 1s);
+        BEAST_EXPECT (countFor (next, 1) > 4 * countFor (next, 2));
+        BEAST_EXPECT (countFor (next, 1) + countFor (next, 2) == 100);
+    }
+
+    void
+    testCapacity ()
+    {
+        testcase ("capacity");
+
+        AcquireScheduler s (8);
+        s.setPeers ({1, 2});
+
+        time_point const now {};
+        auto const batches = s.assign (makeNodes (0, 64), now);
+        BEAST_EXPECT (countFor (batches, 1) == 8);
+        BEAST_EXPECT (countFor (batches, 2) == 8);
+        BEAST_EXPECT (s.outstanding () == 16);
+        BEAST_EXPECT (s.assign (makeNodes (0, 64), now).empty ());
+    }
+
+    void
+    testStragglers ()
+    {
+        testcase ("stragglers");
+        using namespace std::chrono_literals;
+
+        AcquireScheduler s (128, 1s);
+        s.setPeers ({1, 2});
+
+        time_point const start {};
+        auto const missing = makeNodes (0, 32);
+        auto const batches = s.assign (missing, start);
+        BEAST_EXPECT (batches.size () == 2);
+
+        std::vector<AcquireScheduler::Node> lost;
+        for (auto const& b : batches)
+        {
+            if (b.first == 1)
+                s.onReply (1, idsOf (b.second), 1000, start + 100ms);
+            else
+                lost = b.second;
+        }
+        BEAST_EXPECT (lost.size () == 16);
+
+        BEAST_EXPECT (s.expire (start + 500ms) == 0);
+        BEAST_EXPECT (s.expire (start + 2s) == lost.size ());
+        BEAST_EXPECT (s.outstanding () == 0);
+        BEAST_EXPECT (s.getStats (2)->stragglers == lost.size ());
+
+        auto const retry = s.assign (lost, start + 2s);
+        BEAST_EXPECT (retry.size () == 1);
+        BEAST_EXPECT (countFor (retry, 1) == lost.size ());
+
+        s.onReply (1, idsOf (lost), 1000, start + 2100ms);
+        BEAST_EXPECT (s.outstanding () == 0);
+    }
+
+    void
+    testPeerLoss ()
+    {
+        testcase ("peer loss");
+
+        AcquireScheduler s (128);
+        s.setPeers ({1, 2, 3});
+
+        time_point const now {};
+        auto const missing = makeNodes (0, 30);
+        auto const batches = s.assign (missing, now);
+        BEAST_EXPECT (s.outstanding () == 30);
+
+        s.setPeers ({1, 4});
+        BEAST_EXPECT (s.peerCount () == 2);
+        BEAST_EXPECT (s.outstanding () == countFor (batches, 1));
+        BEAST_EXPECT (! s.getStats (2));
+
+        auto const next = s.assign (missing, now);
+        BEAST_EXPECT (countFor (next, 4) > countFor (next, 1));
+        BEAST_EXPECT (countFor (next, 1) + countFor (next, 4) ==
+            30 - countFor (batches, 1));
+    }
+
+public:
+    void
+    run () override
+    {
+        testPartition ();
+        testRebalance ();
+        testCapacity ();
+        testStragglers ();
+        testPeerLoss ();
+    }
+};
+
+class AcquireSchedulerSim_test : public beast::unit_test::suite
+{
+    using clock_type = csf::Scheduler::clock_type;
+    using duration = clock_type::duration;
+    using Node = AcquireScheduler::Node;
+
+    struct Server
+    {
+        duration delay;
+        duration perNode;
+        int dropEvery;
+        int received = 0;
+        clock_type::time_point busyUntil {};
+    };
+
+    struct Result
+    {
+        duration elapsed {};
+        std::size_t requests = 0;
+        std::size_t delivered = 0;
+    };
+
+    static std::size_t constexpr nodeSize = 512;
+
+    std::vector<Server>
+    makeServers () const
+    {
+        using namespace std::chrono_literals;
+        return {
+            {400ms, 2ms, 0},
+            {250ms, 1ms, 4},
+            {150ms, 500us, 0},
+            {80ms, 200us, 0},
+            {40ms, 100us, 0},
+            {20ms, 50us, 0},
+            {60ms, 100us, 0},
+            {120ms, 300us, 0}};
+    }
+
+    template <class Request>
+    Result
+    simulate (std::size_t total, Request&& request)
+    {
+        using namespace std::chrono_literals;
+
+        csf::Scheduler sched;
+        csf::BasicNetwork<int> net (sched);
+        auto servers = makeServers ();
+        for (std::size_t i = 0; i < servers.size (); ++i)
+            net.connect (0, static_cast<int> (i + 1), servers[i].delay);
+
+        std::set<Node> remaining;
+        for (std::uint32_t i = 0; i < total; ++i)
+            remaining.insert (makeNode (i));
+
+        Result result;
+        auto const start = sched.now ();
+
+        std::function<void(int, std::vector<Node>)> send;
+        std::function<void(int, std::vector<Node>)> deliver;
+
+        send = [&](int peer, std::vector<Node> nodes)
+        {
+            ++result.requests;
+            net.send (0, peer, [&, peer, nodes = std::move (nodes)]
+            {
+                auto& srv = servers[peer - 1];
+                if (srv.dropEvery && (++srv.received % srv.dropEvery) == 0)
+                    return;
+                srv.busyUntil = std::max (srv.busyUntil, sched.now ()) +
+                    nodes.size () * srv.perNode;
+                sched.at (srv.busyUntil, [&, peer, nodes]
+                {
+                    net.send (peer, 0, [&, peer, nodes]
+                    {
+                        deliver (peer, nodes);
+                    });
+                });
+            });
+        };
+
+        auto missing = [&](std::size_t max)
+        {
+            std::vector<Node> ret;
+            for (auto const& n : remaining)
+            {
+                if (ret.size () >= max)
+                    break;
+                ret.push_back (n);
+            }
+            return ret;
+        };
+
+        request (sched, remaining, missing, send, deliver, result);
+
+        sched.step_while ([&] { return ! remaining.empty (); });
+        result.elapsed = sched.now () - start;
+        return result;
+    }
+
+    Result
+    runScheduled (std::size_t total)
+    {
+        using namespace std::chrono_literals;
+
+        AcquireScheduler acq (128);
+        std::vector<AcquireScheduler::peer_id> peers;
+        for (std::size_t i = 0; i < makeServers ().size (); ++i)
+            peers.push_back (i + 1);
+        acq.setPeers (peers);
+
+        std::function<void()> tick;
+
+        return simulate (total,
+            [&](csf::Scheduler& sched, std::set<Node>& remaining,
+                auto& missing, auto& send, auto& deliver, Result& result)
+            {
+                auto fill = [&]
+                {
+                    auto const nodes = missing (256 + acq.outstanding ());
+                    for (auto& b : acq.assign (nodes, sched.now ()))
+                        send (b.first, std::move (b.second));
+                };
+
+                deliver = [&, fill](int peer, std::vector<Node> nodes)
+                {
+                    for (auto const& n : nodes)
+                        result.delivered += remaining.erase (n);
+                    acq.onReply (peer, idsOf (nodes),
+                        nodes.size () * nodeSize, sched.now ());
+                    fill ();
+                };
+
+                tick = [&, fill]
+                {
+                    acq.expire (sched.now ());
+                    fill ();
+                    sched.in (250ms, tick);
+                };
+
+                fill ();
+                sched.in (250ms, tick);
+            });
+    }
+
+    Result
+    runLegacy (std::size_t total)
+    {
+        using namespace std::chrono_literals;
+
+        std::set<uint256> recent;
+        bool progress = false;
+        std::function<void()> tick;
+
+        return simulate (total,
+            [&](csf::Scheduler& sched, std::set<Node>& remaining,
+                auto& missing, auto& send, auto& deliver, Result& result)
+            {
+                auto filter = [&](std::size_t limit)
+                {
+                    std::vector<Node> ret;
+                    for (auto const& n : missing (256))
+                    {
+                        if (ret.size () >= limit)
+                            break;
+                        if (recent.insert (n.second).second)
+                            ret.push_back (n);
+                    }
+                    return ret;
+                };
+
+                deliver = [&, filter](int peer, std::vector<Node> nodes)
+                {
+                    for (auto const& n : nodes)
+                    {
+                        if (remaining.erase (n))
+                        {
+                            ++result.delivered;
+                            progress = true;
+                        }
+                    }
+                    auto next = filter (128);
+                    if (! next.empty ())
+                        send (peer, std::move (next));
+                };
+
+                tick = [&, filter]
+                {
+                    recent.clear ();
+                    if (! progress)
+                    {
+                        auto const nodes = filter (8);
+                        for (int peer = 1; peer <= 4; ++peer)
+                            send (peer, nodes);
+                    }
+                    progress = false;
+                    sched.in (2500ms, tick);
+                };
+
+                auto const nodes = filter (8);
+                for (int peer = 1; peer <= 4; ++peer)
+                    send (peer, nodes);
+                sched.in (2500ms, tick);
+            });
+    }
+
+    void
+    report (char const* name, std::size_t total, Result const& r)
+    {
+        using namespace std::chrono;
+        auto const ms = duration_cast<milliseconds> (r.elapsed).count ();
+        log << name << ": " << total << " nodes in " << ms << " ms"
+            << ", " << r.requests << " requests"
+            << ", " << (ms ? (r.delivered * nodeSize / ms) : 0) << " KB/s"
+            << std::endl;
+    }
+
+public:
+    void
+    run () override
+    {
+        for (std::size_t const total : {5000, 20000})
+        {
+            auto const legacy = runLegacy (total);
+            auto const scheduled = runScheduled (total);
+            report ("legacy   ", total, legacy);
+            report ("scheduled", total, scheduled);
+            BEAST_EXPECT (legacy.delivered == total);
+            BEAST_EXPECT (scheduled.delivered == total);
+            BEAST_EXPECT (scheduled.elapsed < legacy.elapsed);
+        }
+    }
+};
+
+BEAST_DEFINE_TESTSUITE (AcquireScheduler, app, ripple);
+BEAST_DEFINE_TESTSUITE_MANUAL_PRIO (AcquireSchedulerSim, app, ripple, 10);
+
+}
+}
+
@@ -0,0 +1,208 @@
+#include <ripple/app/ledger/Ledger.h>
+#include <ripple/basics/Arena.h>
+#include <ripple/beast/unit_test.h>
+#include <test/jtx.h>
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace ripple {
+namespace test {
+
+class ApplyArena_test : public beast::unit_test::suite
+{
+protected:
+    static
+    std::unique_ptr<Config>
+    makeConfig(bool arena)
+    {
+        return jtx::envconfig([arena](std::unique_ptr<Config> cfg)
+        {
+            cfg->APPLY_ARENA = arena;
+            return cfg;
+        });
+    }
+
+    static
+    std::vector<jtx::Account>
+    makeAccounts(std::size_t n)
+    {
+        std::vector<jtx::Account> accounts;
+        accounts.reserve(n);
+        for (std::size_t i = 0; i < n; ++i)
+            accounts.emplace_back("acct" + std::to_string(i));
+        return accounts;
+    }
+
+    // Payments and offer crossings against a single IOU.
+    static
+    void
+    workload(jtx::Env& env, std::size_t n)
+    {
+        using namespace jtx;
+        auto const gw = Account("gateway");
+        auto const USD = gw["USD"];
+        auto const accounts = makeAccounts(32);
+
+        env.fund(XRP(1000000), gw);
+        for (auto const& a : accounts)
+            env.fund(XRP(1000000), a);
+        env.close();
+        for (auto const& a : accounts)
+        {
+            env.trust(USD(1000000), a);
+            env(pay(gw, a, USD(10000)));
+        }
+        env.close();
+
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            auto const& a = accounts[i % accounts.size()];
+            auto const& b = accounts[(i * 7 + 3) % accounts.size()];
+            switch (i % 4)
+            {
+            case 0:
+                env(pay(a, b, USD(1 + i % 10)));
+                break;
+            case 1:
+                env(offer(a, XRP(100), USD(1)));
+                break;
+            case 2:
+                env(offer(b, USD(1), XRP(100)));
+                break;
+            default:
+                env(pay(a, b, XRP(10)));
+                break;
+            }
+            if (i % 100 == 99)
+                env.close();
+        }
+        env.close();
+    }
+
+    void
+    testIdentical()
+    {
+        testcase("Identical ledgers");
+
+        auto const build = [this](bool arena)
+        {
+            jtx::Env env(*this, makeConfig(arena));
+            workload(env, 400);
+            return env.closed()->info();
+        };
+
+        auto const heap = build(false);
+        auto const arena = build(true);
+        BEAST_EXPECT(arena.seq == heap.seq);
+        BEAST_EXPECT(arena.hash == heap.hash);
+        BEAST_EXPECT(arena.accountHash == heap.accountHash);
+        BEAST_EXPECT(arena.txHash == heap.txHash);
+    }
+
+    void
+    testScope()
+    {
+        testcase("Scope");
+
+        auto const before = Arena::totals();
+        auto const arena = Arena::create();
+        {
+            Arena::Scope const scope(arena);
+            auto v = std::make_shared<std::vector<int,
+                ArenaAllocator<int>>>(100, 7);
+            {
+                Arena::Scope const outside(nullptr);
+                std::vector<int, ArenaAllocator<int>> heap(50, 1);
+                BEAST_EXPECT(arena->stats().allocations == 1);
+            }
+            BEAST_EXPECT(arena->stats().allocations == 1);
+            arena->release();
+            BEAST_EXPECT(v->size() == 100 && v->back() == 7);
+        }
+        auto const after = Arena::totals();
+        BEAST_EXPECT(after.allocations == before.allocations + 1);
+    }
+
+    void
+    testOpenView()
+    {
+        testcase("Open view");
+
+        using namespace jtx;
+        Env env(*this, makeConfig(true));
+        auto const gw = Account("gateway");
+        auto const USD = gw["USD"];
+        auto const alice = Account("alice");
+        env.fund(XRP(10000), gw, alice);
+        env.close();
+
+        // Entries left in the open view must not pin the arenas
+        // of the transactions that produced them.
+        auto const before = Arena::totals();
+        env.trust(USD(1000), alice);
+        env(pay(gw, alice, USD(100)));
+        env(offer(alice, XRP(100), USD(1)));
+        auto const after = Arena::totals();
+        BEAST_EXPECT(after.allocations > before.allocations);
+
+        std::size_t count = 0;
+        for (auto const& sle : env.current()->sles)
+        {
+            BEAST_EXPECT(! Arena::owns(sle.get()));
+            ++count;
+        }
+        BEAST_EXPECT(count > 0);
+        BEAST_EXPECT(env.balance(alice, USD) == USD(100));
+    }
+
+public:
+    void
+    run() override
+    {
+        testScope();
+        testIdentical();
+        testOpenView();
+    }
+};
+
+class ApplyArenaBench_test : public ApplyArena_test
+{
+    void
+    bench(bool arena, std::size_t n)
+    {
+        using clock_type = std::chrono::steady_clock;
+
+        auto const before = Arena::totals();
+        auto const start = clock_type::now();
+        {
+            jtx::Env env(*this, makeConfig(arena));
+            workload(env, n);
+        }
+        auto const elapsed = std::chrono::duration_cast<
+            std::chrono::milliseconds>(clock_type::now() - start);
+        auto const after = Arena::totals();
+
+        log << "apply_arena " << (arena ? "on" : "off") << ": " << n <<
+            " transactions in " << elapsed.count() << "ms, " <<
+            (after.allocations - before.allocations) / n <<
+            " arena allocations and " <<
+            (after.bytes - before.bytes) / n << " bytes per tx" <<
+            std::endl;
+    }
+
+public:
+    void
+    run() override
+    {
+        for (bool arena : {false, true})
+            bench(arena, 4000);
+        pass();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(ApplyArena,app,ripple);
+BEAST_DEFINE_TESTSUITE_MANUAL_PRIO(ApplyArenaBench,app,ripple,10);
+
+}
+}
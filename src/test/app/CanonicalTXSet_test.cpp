@@ -0,0 +1,367 @@
+#include <ripple/app/misc/CanonicalTXSet.h>
+#include <ripple/beast/unit_test.h>
+#include <ripple/beast/xor_shift_engine.h>
+#include <ripple/protocol/digest.h>
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+namespace ripple {
+namespace test {
+
+class CanonicalTXSet_test : public beast::unit_test::suite
+{
+protected:
+    using Txs = std::vector<std::shared_ptr<STTx const>>;
+
+    static
+    AccountID
+    makeAccount (std::size_t i)
+    {
+        auto const h = sha512Half (i);
+        AccountID id;
+        std::copy (h.begin (), h.begin () + id.size (), id.begin ());
+        return id;
+    }
+
+    static
+    std::shared_ptr<STTx const>
+    makeTx (AccountID const& account, std::uint32_t seq,
+        std::uint32_t variant = 0)
+    {
+        return std::make_shared<STTx const> (ttACCOUNT_SET,
+            [&](auto& obj)
+            {
+                obj.setAccountID (sfAccount, account);
+                obj.setFieldU32 (sfSequence, seq);
+                obj.setFieldU32 (sfSetFlag, variant);
+            });
+    }
+
+    static
+    Txs
+    makeTxs (std::size_t accounts, std::size_t perAccount)
+    {
+        Txs txs;
+        txs.reserve (accounts * perAccount);
+        for (std::size_t a = 0; a < accounts; ++a)
+        {
+            auto const account = makeAccount (a);
+            for (std::size_t s = 0; s < perAccount; ++s)
+                txs.push_back (makeTx (account, 10 + s));
+        }
+        return txs;
+    }
+
+    static
+    std::vector<uint256>
+    expected (uint256 const& salt, Txs const& txs)
+    {
+        std::map<std::tuple<uint256, std::uint32_t, uint256>, uint256> ref;
+        for (auto const& tx : txs)
+        {
+            uint256 key = beast::zero;
+            auto const account = tx->getAccountID (sfAccount);
+            std::copy (account.begin (), account.end (), key.begin ());
+            key ^= salt;
+            ref.emplace (std::make_tuple (key, tx->getSequence (),
+                tx->getTransactionID ()), tx->getTransactionID ());
+        }
+
+        std::vector<uint256> ret;
+        for (auto const& item : ref)
+            ret.push_back (item.second);
+        return ret;
+    }
+
+    static
+    std::vector<uint256>
+    ids (CanonicalTXSet const& set)
+    {
+        std::vector<uint256> ret;
+        for (auto const& item : set)
+            ret.push_back (item.first.getTXID ());
+        return ret;
+    }
+
+    void
+    testOrder ()
+    {
+        testcase ("Order");
+
+        uint256 const salt = sha512Half (std::string ("salt"));
+        auto txs = makeTxs (50, 4);
+        auto const want = expected (salt, txs);
+
+        beast::xor_shift_engine rng (1);
+        for (int round = 0; round < 4; ++round)
+        {
+            std::shuffle (txs.begin (), txs.end (), rng);
+
+            CanonicalTXSet set (salt);
+            for (auto const& tx : txs)
+                set.insert (tx);
+
+            BEAST_EXPECT (set.size () == txs.size ());
+            BEAST_EXPECT (ids (set) == want);
+        }
+    }
+
+    void
+    testDuplicates ()
+    {
+        testcase ("Duplicates");
+
+        auto const txs = makeTxs (5, 3);
+        CanonicalTXSet set (uint256 {});
+        for (auto const& tx : txs)
+            set.insert (tx);
+        BEAST_EXPECT (set.size () == txs.size ());
+
+        for (auto const& tx : txs)
+            set.insert (tx);
+        BEAST_EXPECT (set.size () == txs.size ());
+        BEAST_EXPECT (ids (set) == expected (uint256 {}, txs));
+    }
+
+    void
+    testErase ()
+    {
+        testcase ("Erase");
+
+        auto const txs = makeTxs (10, 5);
+        CanonicalTXSet set (uint256 {});
+        for (auto const& tx : txs)
+            set.insert (tx);
+
+        std::vector<uint256> kept;
+        std::size_t i = 0;
+        for (auto it = set.begin (); it != set.end (); ++i)
+        {
+            if (i % 3 == 0)
+            {
+                it = set.erase (it);
+            }
+            else
+            {
+                kept.push_back (it->first.getTXID ());
+                ++it;
+            }
+        }
+        BEAST_EXPECT (set.size () == kept.size ());
+        BEAST_EXPECT (ids (set) == kept);
+
+        for (auto const& tx : txs)
+            set.insert (tx);
+        BEAST_EXPECT (set.size () == txs.size ());
+        BEAST_EXPECT (ids (set) == expected (uint256 {}, txs));
+
+        for (auto it = set.begin (); it != set.end ();)
+            it = set.erase (it);
+        BEAST_EXPECT (set.empty ());
+        BEAST_EXPECT (set.begin () == set.end ());
+
+        set.insert (txs.front ());
+        BEAST_EXPECT (set.size () == 1);
+
+        set.reset (uint256 {});
+        BEAST_EXPECT (set.empty ());
+    }
+
+    void
+    testPrune ()
+    {
+        testcase ("Prune");
+
+        auto const account = makeAccount (7);
+        CanonicalTXSet set (uint256 {});
+        set.insert (makeTx (account, 5));
+        set.insert (makeTx (account, 6));
+        set.insert (makeTx (account, 6, 1));
+        set.insert (makeTx (account, 7));
+        set.insert (makeTx (makeAccount (8), 6));
+
+        auto const pruned = set.prune (account, 6);
+        BEAST_EXPECT (pruned.size () == 2);
+        for (auto const& tx : pruned)
+            BEAST_EXPECT (tx->getSequence () == 6 &&
+                tx->getAccountID (sfAccount) == account);
+        BEAST_EXPECT (set.size () == 3);
+        BEAST_EXPECT (set.prune (account, 6).empty ());
+        BEAST_EXPECT (set.prune (account, 5).size () == 1);
+        BEAST_EXPECT (set.size () == 2);
+    }
+
+    void
+    testInterleave ()
+    {
+        testcase ("Interleave");
+
+        uint256 const salt = sha512Half (std::string ("interleave"));
+        auto txs = makeTxs (20, 5);
+        beast::xor_shift_engine rng (2);
+        std::shuffle (txs.begin (), txs.end (), rng);
+
+        // Insert a few at a time, walking the set between inserts and
+        // erasing every transaction that has been seen twice.
+        CanonicalTXSet set (salt);
+        std::map<uint256, int> seen;
+        std::size_t erased = 0;
+        for (std::size_t i = 0; i < txs.size (); i += 7)
+        {
+            auto const last = std::min (i + 7, txs.size ());
+            for (auto j = i; j < last; ++j)
+                set.insert (txs[j]);
+
+            Txs const inserted (txs.begin (), txs.begin () + last);
+            auto want = expected (salt, inserted);
+            want.erase (std::remove_if (want.begin (), want.end (),
+                [&](uint256 const& id) { return seen[id] >= 2; }),
+                    want.end ());
+            BEAST_EXPECT (ids (set) == want);
+
+            for (auto it = set.begin (); it != set.end ();)
+            {
+                if (++seen[it->first.getTXID ()] == 2)
+                {
+                    it = set.erase (it);
+                    ++erased;
+                }
+                else
+                {
+                    ++it;
+                }
+            }
+            BEAST_EXPECT (set.size () == last - erased);
+        }
+    }
+
+    void
+    testConcurrentReads ()
+    {
+        testcase ("Concurrent reads");
+
+        uint256 const salt = sha512Half (std::string ("readers"));
+        auto txs = makeTxs (100, 4);
+        beast::xor_shift_engine rng (3);
+        std::shuffle (txs.begin (), txs.end (), rng);
+        auto const want = expected (salt, txs);
+
+        for (int round = 0; round < 10; ++round)
+        {
+            CanonicalTXSet set (salt);
+            for (auto const& tx : txs)
+                set.insert (tx);
+
+            // The first readers race to sort the set
+            CanonicalTXSet const& reader = set;
+            std::vector<std::vector<uint256>> results (4);
+            std::vector<std::size_t> sizes (results.size ());
+            std::vector<std::thread> threads;
+            for (std::size_t i = 0; i < results.size (); ++i)
+            {
+                threads.emplace_back ([&, i]
+                {
+                    sizes[i] = reader.size ();
+                    results[i] = ids (reader);
+                });
+            }
+            for (auto& thread : threads)
+                thread.join ();
+
+            for (std::size_t i = 0; i < results.size (); ++i)
+            {
+                BEAST_EXPECT (sizes[i] == txs.size ());
+                BEAST_EXPECT (results[i] == want);
+            }
+        }
+    }
+
+public:
+    void
+    run () override
+    {
+        testOrder ();
+        testDuplicates ();
+        testErase ();
+        testPrune ();
+        testInterleave ();
+        testConcurrentReads ();
+    }
+};
+
+class CanonicalTXSetBench_test : public CanonicalTXSet_test
+{
+    using clock_type = std::chrono::steady_clock;
+
+    template <class F>
+    std::chrono::microseconds::rep
+    time (F&& f)
+    {
+        auto const start = clock_type::now ();
+        f ();
+        return std::chrono::duration_cast<std::chrono::microseconds> (
+            clock_type::now () - start).count ();
+    }
+
+public:
+    void
+    run () override
+    {
+        auto txs = makeTxs (12500, 4);
+        beast::xor_shift_engine rng (1);
+        std::shuffle (txs.begin (), txs.end (), rng);
+
+        uint256 const salt = sha512Half (std::string ("salt"));
+
+        for (int round = 0; round < 3; ++round)
+        {
+            CanonicalTXSet set (salt);
+            std::size_t seen = 0;
+
+            auto const build = time ([&]
+                {
+                    for (auto const& tx : txs)
+                        set.insert (tx);
+                    set.begin ();
+                });
+
+            auto const iterate = time ([&]
+                {
+                    for (auto const& item : set)
+                        seen += item.second->getSequence () != 0;
+                });
+
+            auto const erase = time ([&]
+                {
+                    std::size_t i = 0;
+                    for (int pass = 0; pass < 3; ++pass)
+                    {
+                        for (auto it = set.begin (); it != set.end (); ++i)
+                        {
+                            if (pass == 2 || i % 2 == 0)
+                                it = set.erase (it);
+                            else
+                                ++it;
+                        }
+                    }
+                });
+
+            BEAST_EXPECT (seen == txs.size ());
+            BEAST_EXPECT (set.empty ());
+
+            log << txs.size () << " transactions: build " << build <<
+                "us, iterate " << iterate << "us, erase " << erase <<
+                    "us" << std::endl;
+        }
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(CanonicalTXSet,app,ripple);
+BEAST_DEFINE_TESTSUITE_MANUAL_PRIO(CanonicalTXSetBench,app,ripple,5);
+
+}
+}
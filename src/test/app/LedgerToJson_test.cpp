@@ -0,0 +1,192 @@
+#include <ripple/app/ledger/LedgerToJson.h>
+#include <ripple/basics/Arena.h>
+#include <ripple/beast/unit_test.h>
+#include <ripple/json/to_string.h>
+#include <ripple/protocol/jss.h>
+#include <ripple/resource/Fees.h>
+#include <ripple/rpc/Context.h>
+#include <ripple/rpc/RPCHandler.h>
+#include <test/jtx.h>
+#include <boost/optional.hpp>
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace ripple {
+namespace test {
+
+class LedgerToJson_test : public beast::unit_test::suite
+{
+protected:
+    // Accounts with a trust line each, and a ledger of IOU payments.
+    static
+    void
+    populate(jtx::Env& env, std::size_t accounts, std::size_t payments)
+    {
+        using namespace jtx;
+        Account const gw{"gateway"};
+        auto const USD = gw["USD"];
+        env.fund(XRP(100000), gw);
+        std::vector<Account> holders;
+        for (std::size_t i = 0; i < accounts; ++i)
+        {
+            holders.emplace_back("holder" + std::to_string(i));
+            env.fund(XRP(10000), holders.back());
+            if (i % 100 == 99)
+                env.close();
+        }
+        env.close();
+        for (std::size_t i = 0; i < accounts; ++i)
+        {
+            env.trust(USD(1000), holders[i]);
+            if (i % 100 == 99)
+                env.close();
+        }
+        env.close();
+        for (std::size_t i = 0; i < payments; ++i)
+            env(pay(gw, holders[i % accounts], USD(1)));
+        env.close();
+    }
+
+    static
+    Json::Value
+    fill(ReadView const& ledger, Arena* arena)
+    {
+        boost::optional<Arena::Scope> scope;
+        if (arena)
+            scope.emplace(arena, Arena::json);
+        return getJson(LedgerFill(ledger, LedgerFill::full));
+    }
+
+    void
+    testArena()
+    {
+        testcase("Arena");
+        using namespace jtx;
+        Env env{*this};
+        populate(env, 10, 20);
+
+        auto const ledger = env.closed();
+        auto const heap = fill(*ledger, nullptr);
+        BEAST_EXPECT(heap[jss::transactions].size() == 20);
+
+        Json::Value json;
+        {
+            auto const arena = Arena::create();
+            json = fill(*ledger, arena);
+            BEAST_EXPECT(arena->stats().allocations > 0);
+            arena->release();
+        }
+        BEAST_EXPECT(json == heap);
+        BEAST_EXPECT(to_string(json) == to_string(heap));
+    }
+
+    void
+    testRPC()
+    {
+        testcase("rpc_arena");
+        using namespace jtx;
+        Env env{*this};
+        populate(env, 10, 20);
+
+        auto const request = R"({"ledger_index":"closed","full":true})";
+        auto const heap = env.rpc("json", "ledger", request)[jss::result];
+        env.app().config().RPC_ARENA = true;
+        auto const pooled = env.rpc("json", "ledger", request)[jss::result];
+        BEAST_EXPECT(pooled[jss::status] == jss::success);
+        BEAST_EXPECT(pooled[jss::ledger][jss::transactions].size() == 20);
+        BEAST_EXPECT(pooled[jss::ledger] == heap[jss::ledger]);
+
+        // Results handed back by doCommand do not pin the arena
+        auto& app = env.app();
+        Json::Value params;
+        params[jss::command] = "ledger";
+        params[jss::ledger_index] = "closed";
+        params[jss::full] = true;
+        Resource::Charge loadType = Resource::feeReferenceRPC;
+        Resource::Consumer c;
+        RPC::Context context {env.journal, params, app, loadType,
+            app.getOPs(), app.getLedgerMaster(), c, Role::ADMIN};
+        auto const before = Arena::totals();
+        Json::Value result;
+        RPC::doCommand(context, result);
+        auto const after = Arena::totals();
+        BEAST_EXPECT(after.allocations > before.allocations);
+        auto const& hash = result[jss::ledger][jss::ledger_hash];
+        BEAST_EXPECT(hash == heap[jss::ledger][jss::ledger_hash]);
+        BEAST_EXPECT(! Arena::owns(hash.asCString()));
+    }
+
+public:
+    void
+    run() override
+    {
+        testArena();
+        testRPC();
+    }
+};
+
+// Builds, serializes and destroys the JSON for a large ledger with and
+// without an arena.
+class LedgerToJsonBench_test : public LedgerToJson_test
+{
+    using clock_type = std::chrono::steady_clock;
+
+    void
+    bench(ReadView const& ledger, bool useArena, int rounds)
+    {
+        std::chrono::duration<double, std::milli> build{0};
+        std::chrono::duration<double, std::milli> serialize{0};
+        std::chrono::duration<double, std::milli> destroy{0};
+        std::size_t bytes = 0;
+
+        auto const before = Arena::totals();
+        for (int round = 0; round < rounds; ++round)
+        {
+            auto const arena = useArena ? Arena::create() : nullptr;
+            auto const start = clock_type::now();
+            auto json = std::make_unique<Json::Value>(fill(ledger, arena));
+            auto const built = clock_type::now();
+            bytes = to_string(*json).size();
+            auto const serialized = clock_type::now();
+            json.reset();
+            auto const destroyed = clock_type::now();
+            if (arena)
+                arena->release();
+
+            build += built - start;
+            serialize += serialized - built;
+            destroy += destroyed - serialized;
+        }
+        auto const after = Arena::totals();
+
+        log << "arena " << (useArena ? "on" : "off") << ": " << bytes <<
+            " bytes, build " << build.count() / rounds << "ms, serialize " <<
+            serialize.count() / rounds << "ms, destroy " <<
+            destroy.count() / rounds << "ms";
+        if (useArena)
+            log << ", " << (after.allocations - before.allocations) / rounds <<
+                " allocations in " << (after.blocks - before.blocks) / rounds <<
+                " blocks";
+        log << std::endl;
+    }
+
+public:
+    void
+    run() override
+    {
+        jtx::Env env{*this};
+        populate(env, 5000, 2000);
+
+        auto const ledger = env.closed();
+        for (bool arena : {false, true})
+            bench(*ledger, arena, 10);
+        pass();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(LedgerToJson,app,ripple);
+BEAST_DEFINE_TESTSUITE_MANUAL_PRIO(LedgerToJsonBench,app,ripple,10);
+
+}
+}
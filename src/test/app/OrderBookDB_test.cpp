@@ -0,0 +1,171 @@
+#include <ripple/app/ledger/OrderBookDB.h>
+#include <ripple/core/DatabaseCon.h>
+#include <ripple/core/Stoppable.h>
+#include <ripple/protocol/Indexes.h>
+#include <ripple/beast/unit_test.h>
+#include <test/jtx.h>
+#include <set>
+#include <vector>
+
+namespace ripple {
+namespace test {
+
+class OrderBookDB_test : public beast::unit_test::suite
+{
+    static
+    std::set<uint256>
+    fullRebuild (ReadView const& ledger)
+    {
+        std::set<uint256> books;
+        for (auto const& sle : ledger.sles)
+        {
+            if (sle->getType () == ltDIR_NODE &&
+                sle->isFieldPresent (sfExchangeRate) &&
+                sle->getFieldH256 (sfRootIndex) == sle->key())
+            {
+                Book book;
+                book.in.currency = sle->getFieldH160 (sfTakerPaysCurrency);
+                book.in.account = sle->getFieldH160 (sfTakerPaysIssuer);
+                book.out.account = sle->getFieldH160 (sfTakerGetsIssuer);
+                book.out.currency = sle->getFieldH160 (sfTakerGetsCurrency);
+                books.insert (getBookBase (book));
+            }
+        }
+        return books;
+    }
+
+    void
+    check (OrderBookDB& db, ReadView const& ledger,
+        std::vector<Issue> const& issues)
+    {
+        std::set<uint256> books;
+        for (auto const& issue : issues)
+        {
+            for (auto const& ob : db.getBooksByTakerPays (issue))
+            {
+                BEAST_EXPECT (ob->book().in == issue);
+                BEAST_EXPECT (books.insert (ob->getBookBase ()).second);
+            }
+
+            bool toXRP = false;
+            for (auto const& ob : db.getBooksByTakerPays (issue))
+                toXRP = toXRP || isXRP (ob->book().out);
+            BEAST_EXPECT (db.isBookToXRP (issue) == toXRP);
+        }
+        BEAST_EXPECT (books == fullRebuild (ledger));
+    }
+
+    void
+    testIncremental ()
+    {
+        testcase ("Incremental matches full rebuild");
+
+        using namespace jtx;
+        Env env (*this);
+
+        auto const gw = Account ("gateway");
+        auto const alice = Account ("alice");
+        auto const bob = Account ("bob");
+        auto const USD = gw["USD"];
+        auto const EUR = gw["EUR"];
+        auto const BTC = gw["BTC"];
+        std::vector<Issue> const issues {
+            xrpIssue (), USD.issue (), EUR.issue (), BTC.issue ()};
+
+        env.fund (XRP (100000), gw, alice, bob);
+        env.close ();
+        for (auto const& a : {alice, bob})
+        {
+            env.trust (USD (10000), a);
+            env.trust (EUR (10000), a);
+            env.trust (BTC (10000), a);
+        }
+        env.close ();
+        for (auto const& a : {alice, bob})
+        {
+            env (pay (gw, a, USD (1000)));
+            env (pay (gw, a, EUR (1000)));
+            env (pay (gw, a, BTC (1000)));
+        }
+        env.close ();
+
+        RootStoppable root ("OrderBookDB_test");
+        OrderBookDB db (env.app (), root);
+        db.setup (env.closed ());
+        check (db, *env.closed (), issues);
+
+        auto close = [&]
+        {
+            env.close ();
+            db.setup (env.closed ());
+            check (db, *env.closed (), issues);
+        };
+
+        auto const a1 = env.seq (alice);
+        env (offer (alice, XRP (100), USD (10)));
+        env (offer (alice, XRP (100), USD (20)));
+        env (offer (alice, USD (10), EUR (10)));
+        close ();
+
+        auto const b1 = env.seq (bob);
+        env (offer (bob, EUR (10), BTC (1)));
+        env (offer (bob, BTC (1), XRP (1000)));
+        env (offer_cancel (alice, a1));
+        close ();
+
+        env (offer_cancel (alice, a1 + 1));
+        env (offer_cancel (bob, b1 + 1));
+        close ();
+
+        env (offer (bob, USD (10), XRP (100)));
+        env (offer (alice, XRP (100), USD (10)));
+        close ();
+
+        env (offer_cancel (alice, a1 + 2));
+        env (offer_cancel (bob, b1));
+        close ();
+        BEAST_EXPECT (fullRebuild (*env.closed ()).empty ());
+
+        // A gap of a few ledgers is rolled forward from the current index
+        env (offer (bob, USD (5), XRP (50)));
+        env.close ();
+        env (offer_cancel (bob, env.seq (bob) - 1));
+        env.close ();
+        env (offer (alice, EUR (5), XRP (50)));
+        close ();
+
+        env (offer (alice, XRP (100), BTC (1)));
+        close ();
+
+        db.saveSnapshot ();
+        {
+            auto wdb = env.app ().getWalletDB ().checkoutDb ();
+            boost::optional<std::uint64_t> seq;
+            *wdb << "SELECT LedgerSeq FROM OrderBookSnapshot;",
+                soci::into (seq);
+            BEAST_EXPECT (seq && *seq == env.closed ()->info().seq);
+        }
+
+        env (offer (bob, EUR (10), USD (10)));
+        env (offer (bob, EUR (10), USD (9)));
+        close ();
+        env (offer_cancel (alice, env.seq (alice) - 1));
+        close ();
+
+        OrderBookDB restored (env.app (), root);
+        restored.setup (env.closed ());
+        check (restored, *env.closed (), issues);
+    }
+
+public:
+    void
+    run () override
+    {
+        testIncremental ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(OrderBookDB,app,ripple);
+
+}
+}
@@ -0,0 +1,193 @@
+#include <ripple/app/ledger/Ledger.h>
+#include <ripple/core/JobQueue.h>
+#include <ripple/beast/unit_test.h>
+#include <test/jtx.h>
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace ripple {
+namespace test {
+
+class ParallelApply_test : public beast::unit_test::suite
+{
+protected:
+    static
+    std::unique_ptr<Config>
+    makeConfig(std::size_t parallel)
+    {
+        return jtx::envconfig([parallel](std::unique_ptr<Config> cfg)
+        {
+            cfg->PARALLEL_APPLY = parallel;
+            return cfg;
+        });
+    }
+
+    static
+    std::vector<jtx::Account>
+    makeAccounts(std::size_t n)
+    {
+        std::vector<jtx::Account> accounts;
+        accounts.reserve(n);
+        for (std::size_t i = 0; i < n; ++i)
+            accounts.emplace_back("acct" + std::to_string(i));
+        return accounts;
+    }
+
+    static
+    void
+    fund(jtx::Env& env, std::vector<jtx::Account> const& accounts)
+    {
+        using namespace jtx;
+        for (std::size_t i = 0; i < accounts.size(); ++i)
+        {
+            env.fund(XRP(100000), accounts[i]);
+            if (i % 100 == 99)
+                env.close();
+        }
+        env.close();
+    }
+
+    template <class Submit>
+    LedgerInfo
+    build(std::size_t parallel, Submit&& submit)
+    {
+        jtx::Env env(*this, makeConfig(parallel));
+        submit(env);
+        env.close();
+        return env.closed()->info();
+    }
+
+    template <class Submit>
+    void
+    compare(Submit&& submit)
+    {
+        auto const serial = build(0, submit);
+        for (std::size_t parallel : {2, 4, 8})
+        {
+            auto const info = build(parallel, submit);
+            BEAST_EXPECT(info.seq == serial.seq);
+            BEAST_EXPECT(info.accountHash == serial.accountHash);
+            BEAST_EXPECT(info.txHash == serial.txHash);
+            BEAST_EXPECT(info.drops == serial.drops);
+        }
+    }
+
+    void
+    testIndependent()
+    {
+        testcase("Independent payments");
+
+        using namespace jtx;
+        compare([](Env& env)
+        {
+            auto const accounts = makeAccounts(64);
+            fund(env, accounts);
+            for (std::size_t i = 0; i < accounts.size(); i += 2)
+                env(pay(accounts[i], accounts[i + 1], XRP(10 + i)));
+        });
+    }
+
+    void
+    testMixed()
+    {
+        testcase("Mixed transactions");
+
+        using namespace jtx;
+        compare([](Env& env)
+        {
+            auto const gw = Account("gateway");
+            auto const USD = gw["USD"];
+            auto const accounts = makeAccounts(48);
+            env.fund(XRP(100000), gw);
+            fund(env, accounts);
+            for (std::size_t i = 0; i < 8; ++i)
+            {
+                env.trust(USD(1000), accounts[i]);
+                env(pay(gw, accounts[i], USD(100)));
+            }
+            env.close();
+
+            for (std::size_t i = 0; i < 8; ++i)
+                env(pay(accounts[i], accounts[(i + 1) % 8], USD(1 + i)));
+            for (std::size_t i = 8; i < 16; ++i)
+                env(offer(accounts[i - 8], XRP(10 + i), USD(1)));
+            for (std::size_t i = 16; i < 40; ++i)
+                env(pay(accounts[i], accounts[i + 8], XRP(i)));
+            for (std::size_t i = 40; i < 48; ++i)
+                env(noop(accounts[i]));
+        });
+    }
+
+    void
+    testSequenceGap()
+    {
+        testcase("Sequence gap");
+
+        using namespace jtx;
+        compare([](Env& env)
+        {
+            auto const accounts = makeAccounts(32);
+            fund(env, accounts);
+            env.app().getJobQueue().setThreadCount(0, false);
+
+            auto const seq0 = env.seq(accounts[0]);
+            env(noop(accounts[0]), seq(seq0 + 1), ter(terPRE_SEQ));
+            for (std::size_t i = 1; i < accounts.size(); ++i)
+                env(pay(accounts[i], accounts[(i + 7) % accounts.size()],
+                    XRP(1)));
+            env(noop(accounts[0]), seq(seq0));
+            env.app().getJobQueue().rendezvous();
+        });
+    }
+
+public:
+    void
+    run() override
+    {
+        testIndependent();
+        testMixed();
+        testSequenceGap();
+    }
+};
+
+class ParallelApplyBench_test : public ParallelApply_test
+{
+    void
+    bench(std::size_t parallel, std::size_t n)
+    {
+        using namespace jtx;
+        using clock_type = std::chrono::steady_clock;
+
+        Env env(*this, makeConfig(parallel));
+        auto const accounts = makeAccounts(2 * n);
+        fund(env, accounts);
+
+        for (std::size_t i = 0; i < n; ++i)
+            env(pay(accounts[2 * i], accounts[2 * i + 1], XRP(1)));
+
+        auto const start = clock_type::now();
+        env.close();
+        auto const elapsed = std::chrono::duration_cast<
+            std::chrono::milliseconds>(clock_type::now() - start);
+
+        log << "parallel_apply " << parallel << ": " << n
+            << " payments closed in " << elapsed.count() << "ms"
+            << std::endl;
+    }
+
+public:
+    void
+    run() override
+    {
+        for (std::size_t parallel : {0, 2, 4, 8})
+            bench(parallel, 1000);
+        pass();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(ParallelApply,app,ripple);
+BEAST_DEFINE_TESTSUITE_MANUAL_PRIO(ParallelApplyBench,app,ripple,10);
+
+}
+}
@@ -1,6 +1,7 @@
 
 
 #include <ripple/app/paths/AccountCurrencies.h>
+#include <ripple/app/paths/Pathfinder.h>
 #include <ripple/basics/contract.h>
 #include <ripple/core/JobQueue.h>
 #include <ripple/json/json_reader.h>
@@ -14,6 +15,7 @@
 #include <ripple/rpc/RPCHandler.h>
 #include <test/jtx.h>
 #include <ripple/beast/unit_test.h>
+#include <atomic>
 #include <chrono>
 #include <condition_variable>
 #include <mutex>
@@ -1300,6 +1302,121 @@ public:
             stpath(IPE(G2["HKD"]), G2)));
     }
 
+    void
+    shared_discovery()
+    {
+        testcase("shared path discovery");
+        using namespace jtx;
+        Env env(*this);
+        auto const gw = Account("gateway");
+        auto const USD = gw["USD"];
+        auto const gw2 = Account("gateway2");
+        auto const gw2_USD = gw2["USD"];
+        env.fund(XRP(10000), "alice", "bob", "carol", gw, gw2);
+        env.trust(USD(600), "alice", "bob", "carol");
+        env.trust(gw2_USD(800), "alice", "bob", "carol");
+        env(pay(gw, "alice", USD(70)));
+        env(pay(gw2, "alice", gw2_USD(70)));
+        env.close();
+
+        auto const cache =
+            std::make_shared<RippleLineCache>(env.closed());
+        auto best = [&](Account const& dst, STAmount const& amount,
+            PathDiscoveryCache* shared)
+        {
+            Pathfinder pf (cache, Account("alice"), dst,
+                USD.currency, boost::none, amount, boost::none,
+                    env.app());
+            if (! pf.findPaths(7, shared))
+                return Json::Value{};
+            pf.computePathRanks(4);
+            STPath fp;
+            return pf.getBestPaths(4, fp, {}, xrpAccount()).getJson(
+                JsonOptions::none);
+        };
+
+        PathDiscoveryCache discovery;
+        for (auto const& amount : {USD(5), USD(50), USD(100)})
+        {
+            auto const alone = best(Account("bob"), amount, nullptr);
+            BEAST_EXPECT(best(Account("bob"), amount, &discovery) == alone);
+        }
+        BEAST_EXPECT(discovery.misses() == 1);
+        BEAST_EXPECT(discovery.hits() == 2);
+
+        best(Account("carol"), USD(5), &discovery);
+        best(Account("bob"), gw2_USD(5), &discovery);
+        BEAST_EXPECT(discovery.misses() == 3);
+        BEAST_EXPECT(discovery.hits() == 2);
+
+        BEAST_EXPECT(best(Account("bob"), USD(0), &discovery).isNull());
+        BEAST_EXPECT(discovery.misses() == 3);
+    }
+
+    void
+    parallel_ranking()
+    {
+        testcase("parallel path ranking");
+        using namespace jtx;
+        Env env(*this);
+        auto const gw = Account("gateway");
+        auto const gw2 = Account("gateway2");
+        auto const gw3 = Account("gateway3");
+        env.fund(XRP(10000), "alice", "bob", gw, gw2, gw3);
+        for (auto const& g : {gw, gw2, gw3})
+        {
+            env.trust(g["USD"](600), "alice", "bob");
+            env(pay(g, "alice", g["USD"](70)));
+        }
+        env(rate(gw2, 1.1));
+        env.close();
+
+        auto const cache =
+            std::make_shared<RippleLineCache>(env.closed());
+        auto best = [&](std::size_t threads,
+            std::shared_ptr<PathSearchBudget> const& budget)
+        {
+            Pathfinder pf (cache, Account("alice"), Account("bob"),
+                gw["USD"].currency, boost::none, Account("bob")["USD"](100),
+                    boost::none, env.app());
+            if (! pf.findPaths(7))
+                return Json::Value{};
+            pf.computePathRanks(4, threads, budget);
+            STPath fp;
+            return pf.getBestPaths(4, fp, {}, xrpAccount()).getJson(
+                JsonOptions::none);
+        };
+
+        auto const serial = best(1, {});
+        BEAST_EXPECT(serial.size() > 1);
+        for (std::size_t threads : {2, 4, 8})
+            BEAST_EXPECT(best(threads, {}) == serial);
+
+        auto const unlimited = std::make_shared<PathSearchBudget>(
+            std::chrono::microseconds(0));
+        BEAST_EXPECT(best(4, unlimited) == serial);
+        BEAST_EXPECT(! unlimited->exhausted());
+        BEAST_EXPECT(unlimited->used().count() > 0);
+
+        auto const tiny = std::make_shared<PathSearchBudget>(
+            std::chrono::microseconds(1));
+        BEAST_EXPECT(best(1, tiny).size() < serial.size());
+        BEAST_EXPECT(tiny->exhausted());
+
+        // A throw on any thread reaches the caller after all have joined
+        std::atomic<int> calls {0};
+        except<std::runtime_error>([&]
+        {
+            parallelPathSearch(100, 4, [&](std::size_t i)
+            {
+                ++calls;
+                if (i == 10)
+                    Throw<std::runtime_error>("path search");
+            });
+        });
+        BEAST_EXPECT(calls >= 11 && calls <= 100);
+    }
+
     void
     run() override
     {
@@ -1322,6 +1439,8 @@ public:
         trust_auto_clear_trust_normal_clear();
         trust_auto_clear_trust_auto_clear();
         xrp_to_xrp();
+        shared_discovery();
+        parallel_ranking();
 
 
         path_find_01();
@@ -0,0 +1,364 @@
+#include <ripple/app/ledger/OpenLedger.h>
+#include <ripple/app/tx/apply.h>
+#include <ripple/basics/Arena.h>
+#include <ripple/beast/unit_test.h>
+#include <ripple/json/to_string.h>
+#include <ripple/ledger/OpenView.h>
+#include <ripple/protocol/Feature.h>
+#include <test/jtx.h>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ripple {
+namespace test {
+
+// Counts the ledger entry lookups that reach the wrapped view.
+class CountingView : public ReadView
+{
+public:
+    explicit
+    CountingView (ReadView const& base)
+        : base_ (base)
+    {
+    }
+
+    LedgerInfo const&
+    info() const override
+    {
+        return base_.info();
+    }
+
+    bool
+    open() const override
+    {
+        return base_.open();
+    }
+
+    Fees const&
+    fees() const override
+    {
+        return base_.fees();
+    }
+
+    Rules const&
+    rules() const override
+    {
+        return base_.rules();
+    }
+
+    bool
+    exists (Keylet const& k) const override
+    {
+        ++lookups_;
+        return base_.exists (k);
+    }
+
+    boost::optional<key_type>
+    succ (key_type const& key, boost::optional<
+        key_type> const& last = boost::none) const override
+    {
+        ++lookups_;
+        return base_.succ (key, last);
+    }
+
+    std::shared_ptr<SLE const>
+    read (Keylet const& k) const override
+    {
+        ++lookups_;
+        return base_.read (k);
+    }
+
+    std::unique_ptr<sles_type::iter_base>
+    slesBegin() const override
+    {
+        return base_.slesBegin();
+    }
+
+    std::unique_ptr<sles_type::iter_base>
+    slesEnd() const override
+    {
+        return base_.slesEnd();
+    }
+
+    std::unique_ptr<sles_type::iter_base>
+    slesUpperBound (key_type const& key) const override
+    {
+        return base_.slesUpperBound (key);
+    }
+
+    std::unique_ptr<txs_type::iter_base>
+    txsBegin() const override
+    {
+        return base_.txsBegin();
+    }
+
+    std::unique_ptr<txs_type::iter_base>
+    txsEnd() const override
+    {
+        return base_.txsEnd();
+    }
+
+    bool
+    txExists (key_type const& key) const override
+    {
+        return base_.txExists (key);
+    }
+
+    tx_type
+    txRead (key_type const& key) const override
+    {
+        return base_.txRead (key);
+    }
+
+    std::size_t
+    lookups() const
+    {
+        return lookups_;
+    }
+
+private:
+    ReadView const& base_;
+    mutable std::size_t lookups_ = 0;
+};
+
+// Throughput of the payment engine and offer crossing over deep books.
+// Each scenario prints one JSON object per line so results can be
+// collected by scripts and compared between builds.
+class PaymentEngineBench_test : public beast::unit_test::suite
+{
+    using clock_type = std::chrono::steady_clock;
+
+    static std::size_t constexpr closeInterval = 100;
+
+    static
+    std::unique_ptr<Config>
+    makeConfig()
+    {
+        return jtx::envconfig([](std::unique_ptr<Config> cfg)
+        {
+            cfg->APPLY_ARENA = true;
+            return cfg;
+        });
+    }
+
+    static
+    std::vector<jtx::Account>
+    makeAccounts(std::string const& prefix, std::size_t n)
+    {
+        std::vector<jtx::Account> accounts;
+        accounts.reserve(n);
+        for (std::size_t i = 0; i < n; ++i)
+            accounts.emplace_back(prefix + std::to_string(i));
+        return accounts;
+    }
+
+    // Places `count` offers round robin over the makers, each giving `out`
+    // for `in(level)` with the level cycling through `levels` values.
+    static
+    void
+    fillBook(jtx::Env& env, std::vector<jtx::Account> const& makers,
+        std::size_t count, std::size_t levels,
+        std::function<STAmount(std::size_t)> const& in,
+        STAmount const& out)
+    {
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            env(jtx::offer(makers[i % makers.size()], in(i % levels), out));
+            if (i % closeInterval == closeInterval - 1)
+                env.close();
+        }
+        env.close();
+    }
+
+    // Applies `n` transactions to the open ledger directly, timing only
+    // the transactor, and reports the scenario as a JSON object. Lookups
+    // are counted by applying each transaction once more to a discarded
+    // view, outside the timed section.
+    void
+    measure(jtx::Env& env, std::string const& scenario,
+        std::string const& engine, std::size_t n,
+        std::function<jtx::JTx(std::size_t)> const& next)
+    {
+        std::size_t lookups = 0;
+        std::size_t arenaAllocations = 0;
+        std::size_t arenaBytes = 0;
+
+        clock_type::duration elapsed {};
+        std::size_t succeeded = 0;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            auto const jt = next(i);
+            TER ter = temUNKNOWN;
+            {
+                auto const current = env.current();
+                CountingView const counting(*current);
+                OpenView probe(&counting);
+                ripple::apply(
+                    env.app(), probe, *jt.stx, tapNONE, env.journal);
+                lookups += counting.lookups();
+            }
+            auto const arenaBefore = Arena::totals();
+            auto const start = clock_type::now();
+            env.app().openLedger().modify(
+                [&](OpenView& view, beast::Journal)
+                {
+                    bool applied;
+                    std::tie(ter, applied) = ripple::apply(
+                        env.app(), view, *jt.stx, tapNONE, env.journal);
+                    return applied;
+                });
+            elapsed += clock_type::now() - start;
+            auto const arenaAfter = Arena::totals();
+            arenaAllocations +=
+                arenaAfter.allocations - arenaBefore.allocations;
+            arenaBytes += arenaAfter.bytes - arenaBefore.bytes;
+            if (isTesSuccess(ter))
+                ++succeeded;
+            if (i % closeInterval == closeInterval - 1)
+                env.close();
+        }
+        env.close();
+
+        auto const ms = std::chrono::duration<double, std::milli>(
+            elapsed).count();
+
+        Json::Value jv(Json::objectValue);
+        jv["scenario"] = scenario;
+        jv["engine"] = engine;
+        jv["ops"] = static_cast<Json::UInt>(n);
+        jv["succeeded"] = static_cast<Json::UInt>(succeeded);
+        jv["ms"] = ms;
+        jv["ops_per_sec"] = ms > 0 ? n * 1000.0 / ms : 0.0;
+        jv["arena_allocations_per_op"] =
+            static_cast<double>(arenaAllocations) / n;
+        jv["arena_bytes_per_op"] = static_cast<double>(arenaBytes) / n;
+        jv["lookups_per_op"] = static_cast<double>(lookups) / n;
+        log << Json::to_string(jv) << std::endl;
+
+        BEAST_EXPECT(succeeded > 0);
+    }
+
+    // XRP to USD payments that each consume several offers from a book
+    // of `offers` offers over `levels` qualities.
+    void
+    deepBookPayment(std::size_t offers, std::size_t levels, std::size_t n)
+    {
+        using namespace jtx;
+        Env env(*this, makeConfig());
+        auto const gw = Account("gateway");
+        auto const USD = gw["USD"];
+        auto const alice = Account("alice");
+        auto const carol = Account("carol");
+        auto const makers = makeAccounts("maker", 10);
+
+        env.fund(XRP(100000000), gw, alice, carol);
+        for (auto const& m : makers)
+            env.fund(XRP(100000000), m);
+        env.close();
+        env.trust(USD(100000000), carol);
+        for (auto const& m : makers)
+        {
+            env.trust(USD(100000000), m);
+            env(pay(gw, m, USD(1000000)));
+        }
+        env.close();
+
+        fillBook(env, makers, offers, levels,
+            [&](std::size_t level) { return XRP(100 + level); }, USD(10));
+
+        measure(env, "deep_book_payment", "flow", n,
+            [&](std::size_t)
+            {
+                return env.jt(pay(alice, carol, USD(25)),
+                    sendmax(XRP(100000)), txflags(tfPartialPayment));
+            });
+    }
+
+    // Payments rippling through a chain of six accounts.
+    void
+    multiHopPayment(std::size_t n)
+    {
+        using namespace jtx;
+        Env env(*this, makeConfig());
+        auto const chain = makeAccounts("hop", 6);
+
+        for (auto const& a : chain)
+            env.fund(XRP(1000000), a);
+        env.close();
+        for (std::size_t i = 1; i < chain.size(); ++i)
+            env.trust(chain[i - 1]["USD"](100000000), chain[i]);
+        env.close();
+
+        path const route(chain[1], chain[2], chain[3], chain[4]);
+        auto const& src = chain.front();
+        auto const& dst = chain.back();
+        measure(env, "multi_hop_payment", "flow", n,
+            [&](std::size_t)
+            {
+                return env.jt(pay(src, dst, dst["USD"](1)),
+                    sendmax(src["USD"](2)), route);
+            });
+    }
+
+    // EUR for USD offers that cross through XRP, against two books of
+    // `offers` offers each.
+    void
+    autobridgeCross(FeatureBitset features, std::string const& engine,
+        std::size_t offers, std::size_t levels, std::size_t n)
+    {
+        using namespace jtx;
+        Env env(*this, makeConfig(), features);
+        auto const gw = Account("gateway");
+        auto const USD = gw["USD"];
+        auto const EUR = gw["EUR"];
+        auto const alice = Account("alice");
+        auto const makers = makeAccounts("maker", 10);
+
+        env.fund(XRP(100000000), gw, alice);
+        for (auto const& m : makers)
+            env.fund(XRP(100000000), m);
+        env.close();
+        env.trust(USD(100000000), alice);
+        env.trust(EUR(100000000), alice);
+        env(pay(gw, alice, EUR(10000000)));
+        for (auto const& m : makers)
+        {
+            env.trust(USD(100000000), m);
+            env.trust(EUR(100000000), m);
+            env(pay(gw, m, USD(1000000)));
+        }
+        env.close();
+
+        fillBook(env, makers, offers, levels,
+            [&](std::size_t) { return EUR(10); }, XRP(1100));
+        fillBook(env, makers, offers, levels,
+            [&](std::size_t level) { return XRP(1000 + level); }, USD(10));
+
+        measure(env, "autobridge_cross", engine, n,
+            [&](std::size_t)
+            {
+                return env.jt(offer(alice, USD(25), EUR(25)));
+            });
+    }
+
+public:
+    void
+    run() override
+    {
+        using namespace jtx;
+        auto const all = supported_amendments();
+
+        deepBookPayment(4000, 200, 1000);
+        multiHopPayment(1000);
+        autobridgeCross(all, "flow", 2000, 100, 1000);
+        autobridgeCross(all - featureFlowCross, "taker", 2000, 100, 1000);
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL_PRIO(PaymentEngineBench,app,ripple,10);
+
+}
+}
@@ -0,0 +1,146 @@
+#include <ripple/app/paths/RippleLineCache.h>
+#include <ripple/beast/unit_test.h>
+#include <test/jtx.h>
+
+namespace ripple {
+namespace test {
+
+class RippleLineCache_test : public beast::unit_test::suite
+{
+    static
+    bool
+    same (std::vector<RippleState::pointer> const& a,
+        std::vector<RippleState::pointer> const& b)
+    {
+        if (a.size () != b.size ())
+            return false;
+        for (std::size_t i = 0; i < a.size (); ++i)
+        {
+            if (a[i]->key () != b[i]->key () ||
+                    a[i]->getBalance () != b[i]->getBalance () ||
+                    a[i]->getLimit () != b[i]->getLimit ())
+                return false;
+        }
+        return true;
+    }
+
+    void
+    testCarryForward ()
+    {
+        testcase ("Carry forward");
+
+        using namespace jtx;
+        Env env (*this);
+
+        auto const gw = Account ("gateway");
+        auto const alice = Account ("alice");
+        auto const bob = Account ("bob");
+        auto const carol = Account ("carol");
+        auto const USD = gw["USD"];
+
+        env.fund (XRP (10000), gw, alice, bob, carol);
+        env.close ();
+        env.trust (USD (1000), alice, bob, carol);
+        env.close ();
+        env (pay (gw, alice, USD (100)));
+        env (pay (gw, carol, USD (100)));
+        env.close ();
+
+        auto const stats = std::make_shared<RippleLineCache::Stats> ();
+        auto first = std::make_shared<RippleLineCache> (
+            env.closed (), stats);
+        for (auto const& a : {gw, alice, bob, carol})
+            first->getRippleLines (a.id ());
+        BEAST_EXPECT (stats->misses == 4);
+        BEAST_EXPECT (stats->hits == 0);
+        BEAST_EXPECT (first->size () == 6);
+
+        first->getRippleLines (carol.id ());
+        BEAST_EXPECT (stats->hits == 1);
+
+        env (pay (alice, bob, USD (10)));
+        env (noop (carol));
+        env.close ();
+
+        hash_set<AccountID> changed;
+        BEAST_EXPECT (RippleLineCache::getChangedAccounts (
+            *env.closed (), changed));
+        BEAST_EXPECT (changed.count (alice.id ()) == 1);
+        BEAST_EXPECT (changed.count (bob.id ()) == 1);
+        BEAST_EXPECT (changed.count (gw.id ()) == 1);
+        BEAST_EXPECT (changed.count (carol.id ()) == 0);
+
+        RippleLineCache next (env.closed (), *first, changed, 1000, 16);
+        BEAST_EXPECT (next.size () == 1);
+
+        RippleLineCache fresh (env.closed ());
+        auto const hits = stats->hits.load ();
+        BEAST_EXPECT (same (next.getRippleLines (carol.id ()),
+            fresh.getRippleLines (carol.id ())));
+        BEAST_EXPECT (stats->hits == hits + 1);
+        for (auto const& a : {gw, alice, bob})
+        {
+            BEAST_EXPECT (same (next.getRippleLines (a.id ()),
+                fresh.getRippleLines (a.id ())));
+        }
+        BEAST_EXPECT (stats->hits == hits + 1);
+        BEAST_EXPECT (stats->misses == 7);
+    }
+
+    void
+    testBounds ()
+    {
+        testcase ("Bounds");
+
+        using namespace jtx;
+        Env env (*this);
+
+        auto const gw = Account ("gateway");
+        auto const alice = Account ("alice");
+        auto const bob = Account ("bob");
+        auto const USD = gw["USD"];
+        auto const EUR = gw["EUR"];
+
+        env.fund (XRP (10000), gw, alice, bob);
+        env.close ();
+        env.trust (USD (1000), alice, bob);
+        env.trust (EUR (1000), alice);
+        env.close ();
+
+        RippleLineCache first (env.closed ());
+        first.getRippleLines (alice.id ());
+        first.getRippleLines (bob.id ());
+        BEAST_EXPECT (first.size () == 3);
+
+        env.close ();
+        hash_set<AccountID> changed;
+        BEAST_EXPECT (RippleLineCache::getChangedAccounts (
+            *env.closed (), changed));
+        BEAST_EXPECT (changed.empty ());
+
+        BEAST_EXPECT (RippleLineCache (
+            env.closed (), first, changed, 3, 16).size () == 3);
+        BEAST_EXPECT (RippleLineCache (
+            env.closed (), first, changed, 1, 16).size () == 1);
+        BEAST_EXPECT (RippleLineCache (
+            env.closed (), first, changed, 0, 16).size () == 0);
+
+        for (int i = 0; i < 3; ++i)
+            env.close ();
+        BEAST_EXPECT (RippleLineCache (
+            env.closed (), first, changed, 3, 2).size () == 0);
+    }
+
+public:
+    void
+    run () override
+    {
+        testCarryForward ();
+        testBounds ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(RippleLineCache,app,ripple);
+
+}
+}
@@ -9,11 +9,22 @@ namespace test {
 
 struct Transaction_ordering_test : public beast::unit_test::suite
 {
-    void testCorrectOrder()
+    static
+    std::unique_ptr<Config>
+    makeConfig(std::size_t parallel)
+    {
+        return jtx::envconfig([parallel](std::unique_ptr<Config> cfg)
+        {
+            cfg->PARALLEL_APPLY = parallel;
+            return cfg;
+        });
+    }
+
+    void testCorrectOrder(std::size_t parallel)
     {
         using namespace jtx;
 
-        Env env(*this);
+        Env env(*this, makeConfig(parallel));
         auto const alice = Account("alice");
         env.fund(XRP(1000), noripple(alice));
 
@@ -42,11 +53,11 @@ struct Transaction_ordering_test : public beast::unit_test::suite
         }
     }
 
-    void testIncorrectOrder()
+    void testIncorrectOrder(std::size_t parallel)
     {
         using namespace jtx;
 
-        Env env(*this);
+        Env env(*this, makeConfig(parallel));
         env.app().getJobQueue().setThreadCount(0, false);
         auto const alice = Account("alice");
         env.fund(XRP(1000), noripple(alice));
@@ -75,11 +86,11 @@ struct Transaction_ordering_test : public beast::unit_test::suite
         }
     }
 
-    void testIncorrectOrderMultipleIntermediaries()
+    void testIncorrectOrderMultipleIntermediaries(std::size_t parallel)
     {
         using namespace jtx;
 
-        Env env(*this);
+        Env env(*this, makeConfig(parallel));
         env.app().getJobQueue().setThreadCount(0, false);
         auto const alice = Account("alice");
         env.fund(XRP(1000), noripple(alice));
@@ -116,9 +127,12 @@ struct Transaction_ordering_test : public beast::unit_test::suite
 
     void run() override
     {
-        testCorrectOrder();
-        testIncorrectOrder();
-        testIncorrectOrderMultipleIntermediaries();
+        for (std::size_t parallel : {0, 4})
+        {
+            testCorrectOrder(parallel);
+            testIncorrectOrder(parallel);
+            testIncorrectOrderMultipleIntermediaries(parallel);
+        }
     }
 };
 
@@ -16,6 +16,7 @@ namespace test {
 namespace csf {
 class Validations_test : public beast::unit_test::suite
 {
+protected:
     using clock_type = beast::abstract_clock<std::chrono::steady_clock> const;
 
     static NetClock::time_point
@@ -886,6 +887,8 @@ class Validations_test : public beast::unit_test::suite
     void
     testNumTrustedForLedger()
     {
+        using namespace std::chrono_literals;
+
         testcase("NumTrustedForLedger");
         LedgerHistoryHelper h;
         TestHarness harness(h.oracle);
@@ -898,6 +901,24 @@ class Validations_test : public beast::unit_test::suite
 
         BEAST_EXPECT(ValStatus::current == harness.add(b.validate(ledgerA)));
         BEAST_EXPECT(harness.vals().numTrustedForLedger(ledgerA.id()) == 1);
+
+        harness.vals().trustChanged({}, {b.nodeID()});
+        BEAST_EXPECT(harness.vals().numTrustedForLedger(ledgerA.id()) == 0);
+
+        harness.vals().trustChanged({a.nodeID(), b.nodeID()}, {});
+        BEAST_EXPECT(harness.vals().numTrustedForLedger(ledgerA.id()) == 1);
+
+        Node c = harness.makeNode();
+        c.untrust();
+        Ledger ledgerAB = h["ab"];
+        harness.clock().advance(1s);
+        BEAST_EXPECT(ValStatus::current == harness.add(b.validate(ledgerAB)));
+        BEAST_EXPECT(ValStatus::current == harness.add(c.validate(ledgerAB)));
+        BEAST_EXPECT(harness.vals().numTrustedForLedger(ledgerA.id()) == 1);
+        BEAST_EXPECT(harness.vals().numTrustedForLedger(ledgerAB.id()) == 1);
+
+        harness.vals().trustChanged({c.nodeID()}, {});
+        BEAST_EXPECT(harness.vals().numTrustedForLedger(ledgerAB.id()) == 2);
     }
 
     void
@@ -1032,7 +1053,123 @@ class Validations_test : public beast::unit_test::suite
     }
 };
 
+class ValidationsBench_test : public Validations_test
+{
+    using steady = std::chrono::steady_clock;
+
+    template <class F>
+    static std::chrono::microseconds::rep
+    time(F&& f)
+    {
+        auto const start = steady::now();
+        f();
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+                   steady::now() - start)
+            .count();
+    }
+
+    void
+    bench(std::size_t numNodes, std::size_t numTrusted, std::size_t rounds)
+    {
+        using namespace std::chrono_literals;
+
+        LedgerHistoryHelper h;
+        TestHarness harness(h.oracle);
+        TestValidations& vals = harness.vals();
+
+        std::vector<Node> nodes;
+        std::vector<bool> isTrusted;
+        nodes.reserve(numNodes);
+        for (std::size_t i = 0; i < numNodes; ++i)
+        {
+            nodes.push_back(harness.makeNode());
+            isTrusted.push_back(i < numTrusted);
+            if (!isTrusted.back())
+                nodes.back().untrust();
+        }
+
+        Ledger ledger = genesisLedger;
+        Tx::ID nextTx{0};
+        std::chrono::microseconds::rep addTime = 0;
+        std::chrono::microseconds::rep queryTime = 0;
+        std::chrono::microseconds::rep trustTime = 0;
+        std::size_t trusted = numTrusted;
+
+        for (std::size_t round = 0; round < rounds; ++round)
+        {
+            Ledger const parent = ledger;
+            ledger = h.oracle.accept(parent, Tx{++nextTx});
+            harness.clock().advance(1s);
+
+            std::vector<Validation> batch;
+            batch.reserve(numNodes);
+            for (auto const& n : nodes)
+                batch.push_back(n.validate(ledger));
+
+            addTime += time([&] {
+                for (auto const& v : batch)
+                    BEAST_EXPECT(ValStatus::current == harness.add(v));
+            });
+
+            std::size_t numCurrent = 0;
+            queryTime += time([&] {
+                for (int q = 0; q < 10; ++q)
+                {
+                    BEAST_EXPECT(
+                        vals.numTrustedForLedger(ledger.id()) == trusted);
+                    BEAST_EXPECT(
+                        vals.getPreferred(parent, Ledger::Seq{0}) ==
+                        parent.id());
+                    BEAST_EXPECT(
+                        vals.getNodesAfter(parent, parent.id()) == trusted);
+                    numCurrent = vals.currentTrusted().size();
+                }
+            });
+            BEAST_EXPECT(numCurrent == trusted);
+
+            if (round % 10 == 9)
+            {
+                hash_set<PeerID> added;
+                hash_set<PeerID> removed;
+                for (std::size_t i = (round / 10) % 10; i < numNodes; i += 10)
+                {
+                    if (isTrusted[i])
+                    {
+                        nodes[i].untrust();
+                        removed.insert(nodes[i].nodeID());
+                        --trusted;
+                    }
+                    else
+                    {
+                        nodes[i].trust();
+                        added.insert(nodes[i].nodeID());
+                        ++trusted;
+                    }
+                    isTrusted[i] = !isTrusted[i];
+                }
+                trustTime += time([&] { vals.trustChanged(added, removed); });
+                BEAST_EXPECT(
+                    vals.numTrustedForLedger(ledger.id()) == trusted);
+            }
+        }
+
+        log << numNodes << " validators (" << numTrusted << " trusted), "
+            << rounds << " ledgers: add " << addTime << "us, query "
+            << queryTime << "us, trustChanged " << trustTime << "us"
+            << std::endl;
+    }
+
+public:
+    void
+    run() override
+    {
+        bench(1000, 800, 100);
+        bench(1000, 400, 100);
+    }
+};
+
 BEAST_DEFINE_TESTSUITE(Validations, consensus, ripple);
+BEAST_DEFINE_TESTSUITE_MANUAL_PRIO(ValidationsBench, consensus, ripple, 5);
 }  
 }  
 }  
@@ -1,5 +1,6 @@
 
 
+#include <ripple/basics/Arena.h>
 #include <ripple/core/JobQueue.h>
 #include <test/jtx.h>
 #include <chrono>
@@ -150,12 +151,66 @@ public:
         BEAST_EXPECT(*lv == -1);
     }
 
+    void
+    arena_scope()
+    {
+        using namespace std::chrono_literals;
+        using namespace jtx;
+        Env env(*this);
+        auto& jq = env.app().getJobQueue();
+        jq.setThreadCount(0, true);
+
+        auto const inArena = []
+        {
+            auto const p = Arena::allocate(1, Arena::json);
+            if (p)
+                Arena::deallocate(p);
+            return p != nullptr;
+        };
+
+        gate g;
+        std::shared_ptr<JobQueue::Coro> c;
+        jq.postCoro(jtCLIENT, "Coroutine-Test",
+            [&](auto const& cr)
+            {
+                c = cr;
+                auto const arena = Arena::create();
+                {
+                    Arena::Scope const scope(arena, Arena::json);
+                    this->BEAST_EXPECT(inArena());
+                    g.signal();
+                    c->yield();
+                    this->BEAST_EXPECT(inArena());
+                }
+                this->BEAST_EXPECT(! inArena());
+                arena->release();
+                g.signal();
+            });
+        BEAST_EXPECT(g.wait_for(5s));
+        c->join();
+
+        // The suspended coroutine's arena is not left on the thread
+        jq.addJob(jtCLIENT, "Arena-Test",
+            [&](auto const& job)
+            {
+                this->BEAST_EXPECT(! inArena());
+                g.signal();
+            });
+        BEAST_EXPECT(g.wait_for(5s));
+
+        c->post();
+        BEAST_EXPECT(g.wait_for(5s));
+        c->join();
+        BEAST_EXPECT(! inArena());
+    }
+
     void
     run() override
     {
         correct_order();
         incorrect_order();
         thread_specific_storage();
+        arena_scope();
     }
 };
 
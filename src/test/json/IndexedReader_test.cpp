@@ -0,0 +1,272 @@
+#include <ripple/json/json_reader.h>
+#include <ripple/json/json_value.h>
+#include <ripple/json/to_string.h>
+#include <ripple/beast/unit_test.h>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace ripple {
+
+class IndexedReader_test : public beast::unit_test::suite
+{
+    // Both parsers must agree, and the indexed one may only decline.
+    void
+    check (std::string const& doc, bool indexed)
+    {
+        Json::Value expected;
+        Json::Reader legacy (false);
+        auto const ok = legacy.parse (doc, expected);
+
+        Json::Value root ("untouched");
+        auto const accepted = Json::parseIndexed (
+            doc.data (), doc.data () + doc.size (), root);
+        BEAST_EXPECTS (accepted == indexed, doc);
+        if (accepted)
+            BEAST_EXPECTS (ok && root == expected, doc);
+        else
+            BEAST_EXPECTS (root == "untouched", doc);
+
+        Json::Value value;
+        Json::Reader reader;
+        BEAST_EXPECTS (reader.parse (doc, value) == ok, doc);
+        BEAST_EXPECTS (value == expected, doc);
+        BEAST_EXPECTS (reader.getFormatedErrorMessages () ==
+            legacy.getFormatedErrorMessages (), doc);
+    }
+
+    void
+    testAccepted ()
+    {
+        testcase ("Accepted");
+
+        check ("{}", true);
+        check (" [ ] ", true);
+        check ("{\"a\":1,\"b\":[true,false,null],\"c\":{}}", true);
+        check ("\t{\r\n\"a\" : \"b\" , \"c\":[ 1 , 2 ]\n}\n", true);
+        check ("[\"\\\"\\\\\\/\\b\\f\\n\\r\\t\"]", true);
+        check ("[\"a\\\\\",\"\\\\\\\"\"]", true);
+        check ("[\"\xc3\xa9\t\x01\"]", true);
+        check ("[0,-0,007,-2147483648,2147483647,4294967295]", true);
+        check ("[1.5,-2e10,3E-2,1e300,-.5,5.]", true);
+        check ("[1.2.3]", true);
+        check ("{\"\":\"\"}", true);
+        check (std::string (26, '[') + std::string (26, ']'), true);
+        check (std::string (25, '[') + "1" + std::string (25, ']'), true);
+    }
+
+    void
+    testDeclined ()
+    {
+        testcase ("Declined");
+
+        // Not containers
+        check ("", false);
+        check ("   ", false);
+        check ("5", false);
+        check ("\"s\"", false);
+        check ("null", false);
+
+        // Extensions and quirks that Reader handles itself
+        check ("// comment\n{}", false);
+        check ("{\"a\":/* comment */1}", false);
+        check ("[\"\\u00e9\"]", false);
+        check ("{\"\":1,}", false);
+        check ("{\"a\":1} trailing", false);
+        check ("{}{}", false);
+
+        // Errors
+        check ("{\"a\":1,}", false);
+        check ("[1,]", false);
+        check ("[,1]", false);
+        check ("[1 2]", false);
+        check ("{\"a\" 1}", false);
+        check ("{\"a\"::1}", false);
+        check ("{\"a\":1,\"a\":2}", false);
+        check ("{\"k\":\"v\"\"w\"}", false);
+        check ("[1]]", false);
+        check ("[1}", false);
+        check ("{]", false);
+        check ("[\"unterminated]", false);
+        check ("[\"\\q\"]", false);
+        check ("[1\\]", false);
+        check ("[\"a\"\\]", false);
+        check ("[truex]", false);
+        check ("[tru]", false);
+        check ("[nul]", false);
+        check ("[-]", false);
+        check ("[+5]", false);
+        check ("[.5]", false);
+        check ("[5-3]", false);
+        check ("[--5]", false);
+        check ("[4294967296]", false);
+        check ("[-2147483649]", false);
+        check (std::string ("[1,\0 2]", 7), false);
+        check (std::string (27, '[') + std::string (27, ']'), false);
+        check (std::string (26, '[') + "1" + std::string (26, ']'), false);
+    }
+
+    void
+    testBlocks ()
+    {
+        testcase ("Block boundaries");
+
+        // Quotes, escapes and tokens falling on either side of the 64 byte
+        // blocks that the index is built from
+        for (std::size_t pad = 0; pad < 140; ++pad)
+        {
+            std::string const space (pad, ' ');
+            check (space + "{\"" + std::string (pad, 'x') +
+                "\\\\\\\"\":[" + space + "123" + space + ",true]}", true);
+            check ("[\"" + std::string (pad, '\\') + "\"]", pad % 2 == 0);
+        }
+    }
+
+    void
+    testMutations ()
+    {
+        testcase ("Mutations");
+
+        std::string const doc = "{\"tx_json\":{\"Account\":"
+            "\"rHb9CJAWyB4rj91VRWn96DkukG4bwdtyTh\",\"Amount\":\"1000\","
+            "\"Flags\":2147483648,\"Memos\":[{\"Memo\":{\"MemoData\":"
+            "\"a\\\"b\\\\c\"}}],\"x\":[1,-2,3.5e2,true,false,null]},"
+            "\"secret\":\"s\",\"fee_mult_max\":1000}";
+        std::string const alphabet = "{}[]:,\"\\ \n01-.eEtrufalsn/*x";
+
+        // Every variation must either be declined or agree with Reader
+        std::mt19937 gen (1);
+        for (int i = 0; i < 20000; ++i)
+        {
+            auto s = doc;
+            auto const pos = gen () % s.size ();
+            auto const c = alphabet[gen () % alphabet.size ()];
+            switch (gen () % 3)
+            {
+            case 0: s[pos] = c; break;
+            case 1: s.erase (pos, 1); break;
+            default: s.insert (pos, 1, c); break;
+            }
+
+            Json::Value expected;
+            auto const ok = Json::Reader (false).parse (s, expected);
+            Json::Value root;
+            if (Json::parseIndexed (s.data (), s.data () + s.size (), root))
+            {
+                if (! BEAST_EXPECTS (ok && root == expected, s))
+                    return;
+            }
+        }
+        pass ();
+    }
+
+public:
+    void
+    run () override
+    {
+        testAccepted ();
+        testDeclined ();
+        testBlocks ();
+        testMutations ();
+    }
+};
+
+// Parses typical submit requests and a large ledger response with and
+// without the structural index.
+class IndexedReaderBench_test : public beast::unit_test::suite
+{
+    using clock_type = std::chrono::steady_clock;
+
+    static
+    std::string
+    submitRequest (int i)
+    {
+        Json::Value tx;
+        tx["TransactionType"] = "Payment";
+        tx["Account"] = "rHb9CJAWyB4rj91VRWn96DkukG4bwdtyTh";
+        tx["Destination"] = "rPMh7Pi9ct699iZUTWaytJUoHcJ7cgyziK";
+        tx["Amount"]["currency"] = "USD";
+        tx["Amount"]["issuer"] = "rhub8VRN55s94qWKDv6jmDy1pUykJzF3wq";
+        tx["Amount"]["value"] = std::to_string (i) + ".25";
+        tx["SendMax"] = std::to_string (1000000 + i);
+        tx["Fee"] = "12";
+        tx["Sequence"] = i;
+        tx["Flags"] = 2147483648u;
+        tx["Memos"][0u]["Memo"]["MemoData"] = std::string (64, 'A');
+
+        Json::Value request;
+        request["method"] = "sign";
+        request["params"][0u]["tx_json"] = tx;
+        request["params"][0u]["secret"] = "snoPBrXtMeMyMHUVTgbuqAfg1SUTb";
+        request["params"][0u]["fee_mult_max"] = 1000;
+        return to_string (request);
+    }
+
+    static
+    std::string
+    ledgerResponse (int transactions)
+    {
+        Json::Value txs (Json::arrayValue);
+        for (int i = 0; i < transactions; ++i)
+        {
+            Json::Value request;
+            Json::Reader ().parse (submitRequest (i), request);
+            auto tx = request["params"][0u]["tx_json"];
+            tx["hash"] = std::string (64, 'F');
+            tx["metaData"]["TransactionIndex"] = i;
+            tx["metaData"]["TransactionResult"] = "tesSUCCESS";
+            txs.append (tx);
+        }
+        Json::Value response;
+        response["result"]["ledger"]["transactions"] = txs;
+        response["result"]["status"] = "success";
+        return response.toStyledString ();
+    }
+
+    void
+    bench (char const* name, std::vector<std::string> const& docs,
+        int rounds)
+    {
+        std::size_t bytes = 0;
+        for (auto const& doc : docs)
+            bytes += doc.size ();
+
+        for (bool indexed : {false, true})
+        {
+            auto const start = clock_type::now ();
+            for (int round = 0; round < rounds; ++round)
+            {
+                for (auto const& doc : docs)
+                {
+                    Json::Value root;
+                    Json::Reader (indexed).parse (doc, root);
+                }
+            }
+            std::chrono::duration<double> const elapsed =
+                clock_type::now () - start;
+            log << name << (indexed ? " indexed: " : " reader: ") <<
+                (bytes * rounds / elapsed.count () / (1024 * 1024)) <<
+                " MB/s, " << (docs.size () * rounds / elapsed.count ()) <<
+                " documents/s" << std::endl;
+        }
+    }
+
+public:
+    void
+    run () override
+    {
+        std::vector<std::string> requests;
+        for (int i = 0; i < 1000; ++i)
+            requests.push_back (submitRequest (i));
+        bench ("sign", requests, 100);
+
+        bench ("ledger", {ledgerResponse (5000)}, 10);
+        pass ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(IndexedReader,json,ripple);
+BEAST_DEFINE_TESTSUITE_MANUAL_PRIO(IndexedReaderBench,json,ripple,10);
+
+}
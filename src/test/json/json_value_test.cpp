@@ -1,5 +1,6 @@
 
 
+#include <ripple/basics/Arena.h>
 #include <ripple/json/json_value.h>
 #include <ripple/json/json_reader.h>
 #include <ripple/json/json_writer.h>
@@ -7,7 +8,9 @@
 #include <ripple/beast/type_name.h>
 
 #include <algorithm>
+#include <cstring>
 #include <regex>
+#include <string>
 
 namespace ripple {
 
@@ -303,6 +306,105 @@ struct json_value_test : beast::unit_test::suite
         }
     }
 
+    void test_small_strings ()
+    {
+        for (std::size_t size = 0; size < 40; ++size)
+        {
+            std::string const s (size, 'x');
+            Json::Value const a (s);
+            Json::Value const b (s.data(), s.data() + s.size());
+            Json::Value c = a;
+            Json::Value d = std::move(c);
+            BEAST_EXPECT(a.asString() == s);
+            BEAST_EXPECT(std::strlen(a.asCString()) == size);
+            BEAST_EXPECT(a == b && b == d && a == s.c_str());
+            BEAST_EXPECT(c.isNull());
+
+            Json::Value e (std::string (size + 1, 'y'));
+            d.swap(e);
+            BEAST_EXPECT(d.asString() == std::string (size + 1, 'y'));
+            BEAST_EXPECT(e == a);
+            BEAST_EXPECT(! (a < e) && a < d);
+        }
+
+        Json::Value const empty (Json::stringValue);
+        BEAST_EXPECT(empty.asString() == "");
+        BEAST_EXPECT(Json::Value (empty).asString() == "");
+
+        // Inline strings do not make other values larger
+        BEAST_EXPECT(sizeof (Json::Value) <= 2 * sizeof (double));
+        for (Json::Value v : {Json::Value (7), Json::Value (7u),
+            Json::Value (7.5), Json::Value (true)})
+        {
+            Json::Value s ("short");
+            s.swap (v);
+            Json::Value const copy = v;
+            BEAST_EXPECT(copy == "short" && v.asString() == "short");
+            BEAST_EXPECT(Json::Value (s) == s);
+        }
+    }
+
+    void test_interned_names ()
+    {
+        static char const name[] = "json_value_test_interned";
+        Json::intern (Json::StaticString (name));
+
+        Json::Value v;
+        v[std::string ("json_value_test_interned")] = 1;
+        v[std::string ("json_value_test_copied")] = 2;
+        Json::Value const copy = v;
+
+        auto it = copy.begin();
+        BEAST_EXPECT(std::strcmp(it.memberName(), "json_value_test_copied") == 0);
+        BEAST_EXPECT(*it == 2);
+        ++it;
+        BEAST_EXPECT(it.memberName() == name);
+        BEAST_EXPECT(it.key().asCString() == name);
+        BEAST_EXPECT(*it == 1);
+
+        Json::Value parsed;
+        BEAST_EXPECT(Json::Reader().parse(
+            "{\"json_value_test_interned\":3}", parsed));
+        BEAST_EXPECT(parsed.begin().memberName() == name);
+        BEAST_EXPECT(parsed[name] == 3);
+    }
+
+    void test_arena ()
+    {
+        auto build = []
+        {
+            Json::Value v;
+            v["short"] = "abc";
+            v["long"] = std::string (100, 'z');
+            for (int i = 0; i < 100; ++i)
+                v["list"].append(std::to_string(i) + std::string (20, 'a'));
+            return v;
+        };
+
+        auto const heap = build();
+        auto const before = ripple::Arena::totals();
+        Json::Value kept;
+        {
+            auto const arena = ripple::Arena::create();
+            {
+                ripple::Arena::Scope const scope (arena, ripple::Arena::json);
+                auto const pooled = build();
+                BEAST_EXPECT(pooled == heap);
+                BEAST_EXPECT(arena->stats().allocations > 200);
+                kept = pooled["list"];
+            }
+            auto const allocations = arena->stats().allocations;
+            Json::Value outside = build();
+            BEAST_EXPECT(arena->stats().allocations == allocations);
+            arena->release();
+        }
+
+        // Values keep their arena alive after it is released
+        BEAST_EXPECT(kept == heap["list"]);
+        kept = Json::Value();
+        BEAST_EXPECT(ripple::Arena::totals().allocations > before.allocations);
+    }
+
   void
     test_leak()
     {
@@ -323,6 +425,9 @@ struct json_value_test : beast::unit_test::suite
         test_compact ();
         test_conversions();
         test_nest_limits ();
+        test_small_strings ();
+        test_interned_names ();
+        test_arena ();
         test_leak();
     }
 };
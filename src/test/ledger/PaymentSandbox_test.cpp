@@ -6,6 +6,7 @@
 #include <ripple/ledger/View.h>
 #include <ripple/protocol/AmountConversions.h>
 #include <ripple/protocol/Feature.h>
+#include <chrono>
 
 namespace ripple {
 namespace test {
@@ -306,6 +307,76 @@ class PaymentSandbox_test : public beast::unit_test::suite
         BEAST_EXPECT (balance.getIssuer() == USD.issue().account);
     }
 
+    void testMerge(FeatureBitset features)
+    {
+        testcase ("merge");
+
+        using namespace jtx;
+        Env env (*this, features);
+
+        std::vector<Account> accounts;
+        for (int i = 0; i < 12; ++i)
+            accounts.emplace_back ("acct" + std::to_string (i));
+        std::vector<Currency> const currencies {
+            to_currency ("USD"), to_currency ("EUR"), to_currency ("JPY")};
+
+        auto const closeTime = fix1274Time () +
+                100 * env.closed ()->info ().closeTimeResolution;
+        env.close (closeTime);
+
+        ApplyViewImpl av (&*env.current (), tapNONE);
+
+        // Apply the same credits through nested sandboxes and through a
+        // single sandbox, then compare what each reports.
+        PaymentSandbox flat (&av);
+        PaymentSandbox parent (&av);
+
+        auto credit = [&](PaymentSandbox& sb, int i)
+        {
+            auto const& from = accounts[(i * 5) % accounts.size ()];
+            auto const& to = accounts[(i * 7 + 1) % accounts.size ()];
+            if (from == to)
+                return;
+            Issue const issue (currencies[i % currencies.size ()], from);
+            Issue tlIssue = noIssue();
+            tlIssue.currency = issue.currency;
+            sb.creditHook (from, to, {issue, 10 + i}, {tlIssue, 1000 + i});
+            sb.adjustOwnerCountHook (to, i % 4, (i * 3) % 5);
+        };
+
+        for (int i = 0; i < 20; ++i)
+        {
+            credit (flat, i);
+            credit (parent, i);
+        }
+        {
+            PaymentSandbox child (&parent);
+            for (int i = 10; i < 40; ++i)
+            {
+                credit (flat, i);
+                credit (child, i);
+            }
+            child.apply (parent);
+        }
+
+        for (auto const& a : accounts)
+        {
+            BEAST_EXPECT (parent.ownerCountHook (a, 1) ==
+                flat.ownerCountHook (a, 1));
+            for (auto const& b : accounts)
+            {
+                if (a == b)
+                    continue;
+                for (auto const& c : currencies)
+                {
+                    STAmount const amount ({c, b}, 5000);
+                    BEAST_EXPECT (parent.balanceHook (a, b, amount) ==
+                        flat.balanceHook (a, b, amount));
+                }
+            }
+        }
+    }
+
 public:
     void run () override
     {
@@ -315,6 +386,7 @@ public:
             testTinyBalance(features);
             testReserve(features);
             testBalanceHook(features);
+            testMerge(features);
         };
         using namespace jtx;
         auto const sa = supported_amendments();
@@ -324,7 +396,89 @@ public:
     }
 };
 
+class PaymentSandboxBench_test : public beast::unit_test::suite
+{
+    using clock_type = std::chrono::steady_clock;
+
+    template <class F>
+    void
+    measure (char const* name, std::size_t count, F&& f)
+    {
+        auto const start = clock_type::now ();
+        for (std::size_t i = 0; i < count; ++i)
+            f (i);
+        auto const elapsed = std::chrono::duration_cast<
+            std::chrono::milliseconds> (clock_type::now () - start);
+        log << name << ": " << count << " in " << elapsed.count () << "ms" <<
+            std::endl;
+    }
+
+public:
+    void run () override
+    {
+        using namespace jtx;
+        Env env (*this);
+
+        // Bridged and direct books between two gateways' currencies, in
+        // the spirit of PayStrand_test, so every payment evaluates several
+        // strands and each step runs in its own nested sandbox.
+        Account const gw1 ("gw1");
+        Account const gw2 ("gw2");
+        Account const alice ("alice");
+        Account const bob ("bob");
+        Account const carol ("carol");
+        auto const USD = gw1["USD"];
+        auto const EUR = gw2["EUR"];
+
+        env.fund (XRP (10000000), gw1, gw2, alice, bob, carol);
+        env.trust (USD (10000000), alice, bob, carol);
+        env.trust (EUR (10000000), alice, bob, carol);
+        env (pay (gw1, alice, USD (1000000)));
+        env (pay (gw2, bob, EUR (1000000)));
+        env (pay (gw1, bob, USD (1000000)));
+        env.close ();
+
+        for (int i = 0; i < 50; ++i)
+        {
+            env (offer (bob, USD (100), EUR (100 - i % 5)));
+            env (offer (bob, USD (100), XRP (100 + i % 7)));
+            env (offer (bob, XRP (100), EUR (100 - i % 3)));
+        }
+        env.close ();
+
+        measure ("strand-heavy payments", 2000, [&](std::size_t i)
+        {
+            env (pay (alice, carol, EUR (1)), sendmax (USD (2)),
+                path (~EUR), path (~XRP, ~EUR), txflags (tfPartialPayment));
+            if (i % 100 == 99)
+                env.close ();
+        });
+
+        auto const closeTime = fix1274Time () +
+                100 * env.closed ()->info ().closeTimeResolution;
+        env.close (closeTime);
+        ApplyViewImpl av (&*env.current (), tapNONE);
+        Issue tlIssue = noIssue();
+        tlIssue.currency = USD.issue().currency;
+
+        measure ("nested sandboxes", 200000, [&](std::size_t i)
+        {
+            PaymentSandbox outer (&av);
+            for (int j = 0; j < 4; ++j)
+            {
+                PaymentSandbox inner (&outer);
+                inner.creditHook (gw1.id (), (j % 2 ? alice : bob).id (),
+                    {USD, 1 + j}, {tlIssue, 100});
+                inner.balanceHook (alice.id (), gw1.id (), {USD, 100});
+                inner.apply (outer);
+            }
+        });
+        pass ();
+    }
+};
+
 BEAST_DEFINE_TESTSUITE (PaymentSandbox, ledger, ripple);
+BEAST_DEFINE_TESTSUITE_MANUAL_PRIO (PaymentSandboxBench, ledger, ripple, 10);
 
 }  
 }  
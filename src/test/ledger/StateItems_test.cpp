@@ -0,0 +1,318 @@
+#include <ripple/ledger/detail/StateItems.h>
+#include <ripple/ledger/OpenView.h>
+#include <ripple/beast/unit_test.h>
+#include <ripple/beast/xor_shift_engine.h>
+#include <ripple/protocol/digest.h>
+#include <test/jtx.h>
+#include <chrono>
+#include <map>
+#include <thread>
+#include <vector>
+
+namespace ripple {
+namespace test {
+
+class StateItems_test : public beast::unit_test::suite
+{
+    using Items = detail::StateItems<int>;
+
+    static
+    uint256
+    makeKey (std::size_t i)
+    {
+        return sha512Half (i);
+    }
+
+    void
+    check (Items const& items, std::map<uint256, int> const& ref)
+    {
+        BEAST_EXPECT (items.size () == ref.size ());
+
+        std::vector<std::pair<uint256, int>> sorted;
+        items.forEachSorted ([&](uint256 const& key, int value)
+            {
+                sorted.emplace_back (key, value);
+            });
+        std::vector<std::pair<uint256, int>> const expected (
+            ref.begin (), ref.end ());
+        BEAST_EXPECT (sorted == expected);
+
+        for (auto const& item : ref)
+        {
+            auto const v = items.find (item.first);
+            BEAST_EXPECT (v && *v == item.second);
+        }
+    }
+
+    void
+    testInsertionOrder ()
+    {
+        testcase ("Insertion order");
+
+        Items items;
+        std::vector<uint256> keys;
+        for (std::size_t i = 0; i < 100; ++i)
+        {
+            keys.push_back (makeKey (i));
+            BEAST_EXPECT (items.emplace (keys.back (), i).second);
+            BEAST_EXPECT (! items.emplace (keys.back (), 0).second);
+        }
+
+        for (std::size_t i = 0; i < keys.size (); i += 3)
+            items.erase (keys[i]);
+        BEAST_EXPECT (items.emplace (keys[0], 1000).second);
+
+        std::vector<uint256> inserted;
+        items.forEachInserted ([&](uint256 const& key, int)
+            {
+                inserted.push_back (key);
+            });
+
+        std::vector<uint256> expected;
+        for (std::size_t i = 0; i < keys.size (); ++i)
+        {
+            if (i % 3 != 0)
+                expected.push_back (keys[i]);
+        }
+        expected.push_back (keys[0]);
+        BEAST_EXPECT (inserted == expected);
+        BEAST_EXPECT (*items.find (keys[0]) == 1000);
+        BEAST_EXPECT (items.find (keys[3]) == nullptr);
+    }
+
+    void
+    testRandom ()
+    {
+        testcase ("Random operations");
+
+        beast::xor_shift_engine rng (7);
+        Items items;
+        std::map<uint256, int> ref;
+        for (int round = 0; round < 20000; ++round)
+        {
+            auto const key = makeKey (rng () % 500);
+            switch (rng () % 4)
+            {
+            case 0:
+                items.erase (key);
+                ref.erase (key);
+                break;
+            case 1:
+                if (auto const v = items.find (key))
+                    *v = round;
+                if (ref.count (key))
+                    ref[key] = round;
+                break;
+            default:
+                BEAST_EXPECT (items.emplace (key, round).second ==
+                    ref.emplace (key, round).second);
+                break;
+            }
+
+            if (round % 1000 == 0)
+            {
+                check (items, ref);
+
+                auto const& keys = items.keys ();
+                auto const pivot = makeKey (rng () % 500);
+                auto iter = std::upper_bound (
+                    keys.begin (), keys.end (), pivot);
+                while (iter != keys.end () && ! items.find (*iter))
+                    ++iter;
+                auto const want = ref.upper_bound (pivot);
+                BEAST_EXPECT ((iter == keys.end ()) == (want == ref.end ()));
+                if (iter != keys.end () && want != ref.end ())
+                    BEAST_EXPECT (*iter == want->first);
+            }
+        }
+        check (items, ref);
+
+        auto copy = items;
+        check (copy, ref);
+    }
+
+    void
+    testConcurrentKeys ()
+    {
+        testcase ("Concurrent keys");
+
+        std::map<uint256, int> ref;
+        for (int i = 0; i < 2000; ++i)
+            ref.emplace (makeKey (i), i);
+        std::vector<std::pair<uint256, int>> const expected (
+            ref.begin (), ref.end ());
+
+        for (int round = 0; round < 10; ++round)
+        {
+            Items items;
+            for (auto const& item : ref)
+                items.emplace (item.first, item.second);
+            items.emplace (makeKey (5000 + round), 0);
+            items.erase (makeKey (5000 + round));
+
+            // The first readers race to sort the keys
+            Items const& reader = items;
+            std::vector<std::vector<std::pair<uint256, int>>> results (4);
+            std::vector<std::thread> threads;
+            for (auto& result : results)
+            {
+                threads.emplace_back ([&]
+                {
+                    reader.forEachSorted ([&](uint256 const& key, int v)
+                        {
+                            result.emplace_back (key, v);
+                        });
+                });
+            }
+            for (auto& thread : threads)
+                thread.join ();
+            for (auto const& result : results)
+                BEAST_EXPECT (result == expected);
+        }
+    }
+
+    void
+    testConcurrentView ()
+    {
+        testcase ("Concurrent view reads");
+        using namespace jtx;
+
+        Env env (*this);
+        OpenView view (&*env.closed ());
+        for (std::size_t i = 0; i < 1000; ++i)
+            view.rawInsert (std::make_shared<SLE> (
+                Keylet (ltACCOUNT_ROOT, makeKey (i))));
+
+        auto const walkSucc = [&]
+        {
+            std::vector<uint256> keys;
+            for (auto key = view.succ (uint256 {}); key;
+                    key = view.succ (*key))
+                keys.push_back (*key);
+            return keys;
+        };
+        auto const walkSles = [&]
+        {
+            std::vector<uint256> keys;
+            for (auto const& sle : view.sles)
+                keys.push_back (sle->key ());
+            return keys;
+        };
+
+        // succ and sles run on the view from several threads while its
+        // new keys have not been sorted yet.
+        std::vector<std::vector<uint256>> succs (4);
+        std::vector<std::vector<uint256>> sles (4);
+        std::vector<std::thread> threads;
+        for (std::size_t i = 0; i < succs.size (); ++i)
+        {
+            threads.emplace_back ([&, i]
+            {
+                succs[i] = walkSucc ();
+                sles[i] = walkSles ();
+            });
+        }
+        for (auto& thread : threads)
+            thread.join ();
+
+        BEAST_EXPECT (succs[0].size () > 1000);
+        BEAST_EXPECT (std::is_sorted (succs[0].begin (), succs[0].end ()));
+        for (std::size_t i = 0; i < succs.size (); ++i)
+        {
+            BEAST_EXPECT (succs[i] == succs[0]);
+            BEAST_EXPECT (sles[i] == succs[0]);
+        }
+
+        // An iterator keeps its place when new keys are sorted in
+        std::vector<uint256> seen;
+        auto iter = view.sles.begin ();
+        for (int i = 0; i < 10; ++i, ++iter)
+            seen.push_back ((*iter)->key ());
+        std::vector<uint256> added;
+        for (std::size_t i = 1000; i < 1100; ++i)
+        {
+            added.push_back (makeKey (i));
+            view.rawInsert (std::make_shared<SLE> (
+                Keylet (ltACCOUNT_ROOT, added.back ())));
+        }
+        BEAST_EXPECT (view.succ (uint256 {}));
+        for (; iter != view.sles.end (); ++iter)
+            seen.push_back ((*iter)->key ());
+
+        auto want = succs[0];
+        for (auto const& key : added)
+        {
+            if (key > want[9])
+                want.push_back (key);
+        }
+        std::sort (want.begin () + 10, want.end ());
+        BEAST_EXPECT (seen == want);
+    }
+
+public:
+    void
+    run () override
+    {
+        testInsertionOrder ();
+        testRandom ();
+        testConcurrentKeys ();
+        testConcurrentView ();
+    }
+};
+
+class StateTableBench_test : public beast::unit_test::suite
+{
+    using clock_type = std::chrono::steady_clock;
+
+public:
+    void
+    run () override
+    {
+        using namespace jtx;
+        Env env (*this);
+
+        auto const gw = Account ("gateway");
+        auto const USD = gw["USD"];
+        std::vector<Account> accounts;
+        for (int i = 0; i < 100; ++i)
+            accounts.emplace_back ("a" + std::to_string (i));
+
+        env.fund (XRP (1000000), gw);
+        for (auto const& a : accounts)
+            env.fund (XRP (1000000), a);
+        env.close ();
+        for (auto const& a : accounts)
+            env.trust (USD (1000000), a);
+        env.close ();
+        for (auto const& a : accounts)
+            env (pay (gw, a, USD (10000)));
+        env.close ();
+
+        std::size_t const total = 10000;
+        auto const start = clock_type::now ();
+        for (std::size_t i = 0; i < total; ++i)
+        {
+            auto const& from = accounts[i % accounts.size ()];
+            auto const& to = accounts[(i * 7 + 1) % accounts.size ()];
+            if (i % 2 == 0)
+                env (pay (from, to, USD (1)));
+            else
+                env (offer (from, XRP (10 + i % 5), USD (1)));
+            if (i % 500 == 499)
+                env.close ();
+        }
+        env.close ();
+        auto const elapsed = std::chrono::duration_cast<
+            std::chrono::milliseconds> (clock_type::now () - start);
+
+        log << total << " payments and offers: " << elapsed.count () <<
+            "ms, " << (total * 1000 / std::max<std::int64_t> (
+                1, elapsed.count ())) << " tx/s" << std::endl;
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(StateItems,ledger,ripple);
+BEAST_DEFINE_TESTSUITE_MANUAL_PRIO(StateTableBench,ledger,ripple,10);
+
+}
+}
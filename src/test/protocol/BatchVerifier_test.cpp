@@ -0,0 +1,248 @@
+
+
+#include <ripple/protocol/BatchVerifier.h>
+#include <ripple/protocol/SecretKey.h>
+#include <ripple/protocol/STTx.h>
+#include <ripple/protocol/digest.h>
+#include <ripple/beast/unit_test.h>
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace ripple {
+
+class BatchVerifier_test : public beast::unit_test::suite
+{
+protected:
+    struct Signed
+    {
+        PublicKey publicKey;
+        std::string message;
+        Buffer sig;
+    };
+
+    static
+    std::vector<Signed>
+    makeSigned (KeyType type, std::size_t n)
+    {
+        std::vector<Signed> ret;
+        ret.reserve (n);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            auto const kp = randomKeyPair (type);
+            auto message = "message " + std::to_string (i);
+            auto sig = sign (kp.first, kp.second, makeSlice (message));
+            ret.push_back ({kp.first, std::move (message), std::move (sig)});
+        }
+        return ret;
+    }
+
+    void
+    testEmpty()
+    {
+        testcase ("Empty");
+
+        BatchVerifier batch;
+        BEAST_EXPECT (batch.empty());
+        BEAST_EXPECT (batch.verify().empty());
+        BEAST_EXPECT (batch.verify (4).empty());
+    }
+
+    void
+    testMixed (std::size_t threads)
+    {
+        testcase ("Mixed, " + std::to_string (threads) + " threads");
+
+        auto const ed = makeSigned (KeyType::ed25519, 150);
+        auto const ec = makeSigned (KeyType::secp256k1, 50);
+
+        BatchVerifier batch;
+        std::vector<bool> expected;
+        for (std::size_t i = 0; i < 200; ++i)
+        {
+            auto const& s = (i % 4 == 3) ? ec[i / 4] : ed[i - i / 4];
+            auto message = s.message;
+            if (i % 7 == 0)
+                message += "!";
+
+            batch.add (s.publicKey, makeSlice (message), s.sig);
+            expected.push_back (
+                verify (s.publicKey, makeSlice (message), s.sig));
+        }
+
+        BEAST_EXPECT (batch.size() == 200);
+        BEAST_EXPECT (batch.verify (threads) == expected);
+    }
+
+    void
+    testNonCanonical()
+    {
+        testcase ("Non-canonical");
+
+        auto const ed = makeSigned (KeyType::ed25519, 8);
+
+        BatchVerifier batch;
+        for (auto const& s : ed)
+        {
+            Buffer sig (s.sig.data(), s.sig.size());
+            sig.data()[63] |= 0xf0;
+            batch.add (s.publicKey, makeSlice (s.message), sig);
+        }
+        batch.add (ed[0].publicKey, makeSlice (ed[0].message),
+            Slice (ed[0].sig.data(), 32));
+
+        for (auto const valid : batch.verify())
+            BEAST_EXPECT (! valid);
+    }
+
+    void
+    testDigest()
+    {
+        testcase ("Digest");
+
+        auto const ec = randomKeyPair (KeyType::secp256k1);
+        auto const ed = randomKeyPair (KeyType::ed25519);
+        auto const digest = sha512Half (std::string ("digest"));
+        auto const sig = signDigest (ec.first, ec.second, digest);
+
+        BatchVerifier batch;
+        batch.addDigest (ec.first, digest, sig);
+        batch.addDigest (ec.first, sha512Half (std::string ("other")), sig);
+        batch.addDigest (ed.first, digest, sig);
+
+        auto const valid = batch.verify();
+        BEAST_EXPECT (valid.size() == 3);
+        BEAST_EXPECT (valid[0]);
+        BEAST_EXPECT (! valid[1]);
+        BEAST_EXPECT (! valid[2]);
+    }
+
+    void
+    testSplice()
+    {
+        testcase ("Splice");
+
+        auto const ed = makeSigned (KeyType::ed25519, 4);
+
+        BatchVerifier batch;
+        for (auto const& s : ed)
+        {
+            BatchVerifier one;
+            one.add (s.publicKey, makeSlice (s.message), s.sig);
+            batch.splice (one);
+            BEAST_EXPECT (one.empty());
+        }
+
+        BEAST_EXPECT (batch.size() == ed.size());
+        for (auto const valid : batch.verify())
+            BEAST_EXPECT (valid);
+    }
+
+    void
+    testTransaction (KeyType type)
+    {
+        testcase (std::string ("Transaction, ") +
+            (type == KeyType::ed25519 ? "ed25519" : "secp256k1"));
+
+        auto const kp = randomKeyPair (type);
+        STTx tx (ttACCOUNT_SET,
+            [&kp](auto& obj)
+            {
+                obj.setAccountID (sfAccount, calcAccountID (kp.first));
+                obj.setFieldVL (sfSigningPubKey, kp.first.slice());
+            });
+        tx.sign (kp.first, kp.second);
+
+        STTx unsigned_ (ttACCOUNT_SET,
+            [&kp](auto& obj)
+            {
+                obj.setAccountID (sfAccount, calcAccountID (kp.first));
+                obj.setFieldVL (sfSigningPubKey, Slice ());
+            });
+
+        BatchVerifier batch;
+        BEAST_EXPECT (tx.addSingleSign (batch));
+        BEAST_EXPECT (! unsigned_.addSingleSign (batch));
+        BEAST_EXPECT (batch.size() == 1);
+
+        auto const valid = batch.verify();
+        BEAST_EXPECT (valid.size() == 1 && valid[0]);
+        BEAST_EXPECT (tx.checkSign (true).first);
+    }
+
+public:
+    void
+    run() override
+    {
+        testEmpty();
+        testMixed (1);
+        testMixed (4);
+        testNonCanonical();
+        testDigest();
+        testSplice();
+        testTransaction (KeyType::ed25519);
+        testTransaction (KeyType::secp256k1);
+    }
+};
+
+class BatchVerifierBench_test : public BatchVerifier_test
+{
+    using clock_type = std::chrono::steady_clock;
+
+    template <class F>
+    double
+    rate (std::size_t n, F&& f)
+    {
+        auto const start = clock_type::now();
+        f();
+        auto const elapsed = std::chrono::duration_cast<
+            std::chrono::microseconds> (clock_type::now() - start);
+        return n * 1e6 / std::max<std::int64_t> (1, elapsed.count());
+    }
+
+    void
+    bench (KeyType type, std::size_t n)
+    {
+        auto const name =
+            (type == KeyType::ed25519) ? "ed25519" : "secp256k1";
+        auto const items = makeSigned (type, n);
+
+        BatchVerifier batch;
+        for (auto const& s : items)
+            batch.add (s.publicKey, makeSlice (s.message), s.sig);
+
+        auto const single = rate (n, [&]
+            {
+                for (auto const& s : items)
+                    BEAST_EXPECT (verify (s.publicKey,
+                        makeSlice (s.message), s.sig));
+            });
+        log << name << " single: " <<
+            static_cast<std::uint64_t> (single) << " sigs/s" << std::endl;
+
+        for (std::size_t threads : {1, 2, 4, 8})
+        {
+            auto const batched = rate (n, [&]
+                {
+                    for (auto const valid : batch.verify (threads))
+                        BEAST_EXPECT (valid);
+                });
+            log << name << " batch, " << threads << " threads: " <<
+                static_cast<std::uint64_t> (batched) << " sigs/s" <<
+                    std::endl;
+        }
+    }
+
+public:
+    void
+    run() override
+    {
+        bench (KeyType::ed25519, 4096);
+        bench (KeyType::secp256k1, 4096);
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(BatchVerifier,protocol,ripple);
+BEAST_DEFINE_TESTSUITE_MANUAL_PRIO(BatchVerifierBench,protocol,ripple,10);
+
+}
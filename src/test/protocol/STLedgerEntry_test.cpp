@@ -0,0 +1,313 @@
+#include <ripple/basics/Buffer.h>
+#include <ripple/beast/unit_test.h>
+#include <ripple/protocol/Indexes.h>
+#include <ripple/protocol/STArray.h>
+#include <ripple/protocol/STLedgerEntry.h>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace ripple {
+
+class STLedgerEntry_test : public beast::unit_test::suite
+{
+protected:
+    static
+    AccountID
+    makeAccount (std::uint64_t i)
+    {
+        AccountID id;
+        id = i + 1;
+        return id;
+    }
+
+    static
+    std::shared_ptr<SLE>
+    makeOffer (std::uint64_t i)
+    {
+        auto const account = makeAccount (i);
+        auto const issuer = makeAccount (1000);
+        auto sle = std::make_shared<SLE> (keylet::offer (account, i));
+        sle->setAccountID (sfAccount, account);
+        sle->setFieldU32 (sfSequence, i);
+        sle->setFieldAmount (sfTakerPays, STAmount (1000 + i));
+        sle->setFieldAmount (sfTakerGets, STAmount (
+            Issue (to_currency ("USD"), issuer), 10 + i, -1));
+        sle->setFieldH256 (sfBookDirectory, uint256 (i * 7));
+        sle->setFieldU64 (sfOwnerNode, i % 3);
+        sle->setFieldU32 (sfExpiration, 100000 + i);
+        return sle;
+    }
+
+    static
+    std::shared_ptr<SLE>
+    makeAccountRoot ()
+    {
+        auto const account = makeAccount (7);
+        auto sle = std::make_shared<SLE> (keylet::account (account));
+        sle->setAccountID (sfAccount, account);
+        sle->setFieldAmount (sfBalance, STAmount (123456789));
+        sle->setFieldU32 (sfSequence, 42);
+        sle->setFieldVL (sfDomain, Blob (64, 'x'));
+        return sle;
+    }
+
+    static
+    std::shared_ptr<SLE>
+    makeSignerList ()
+    {
+        auto sle = std::make_shared<SLE> (
+            keylet::signers (makeAccount (3)));
+        STArray entries (sfSignerEntries);
+        for (std::uint64_t i = 0; i < 4; ++i)
+        {
+            entries.push_back (STObject (sfSignerEntry));
+            auto& entry = entries.back ();
+            entry.setAccountID (sfAccount, makeAccount (100 + i));
+            entry.setFieldU16 (sfSignerWeight, 1 + i);
+        }
+        sle->setFieldArray (sfSignerEntries, entries);
+        sle->setFieldU32 (sfSignerQuorum, 3);
+        return sle;
+    }
+
+    static
+    std::shared_ptr<Buffer const>
+    serialize (SLE const& sle)
+    {
+        auto const s = sle.getSerializer ();
+        return std::make_shared<Buffer const> (s.data (), s.size ());
+    }
+
+    static
+    std::shared_ptr<SLE const>
+    makeLazy (std::shared_ptr<Buffer const> const& data, uint256 const& key)
+    {
+        return std::make_shared<SLE const> (
+            Slice (data->data (), data->size ()), data, key);
+    }
+
+    void
+    expectSame (SLE const& lazy, SLE const& eager)
+    {
+        BEAST_EXPECT (lazy.getType () == eager.getType ());
+        BEAST_EXPECT (lazy.key () == eager.key ());
+        BEAST_EXPECT (lazy == eager);
+        BEAST_EXPECT (lazy.getJson (JsonOptions::none) ==
+            eager.getJson (JsonOptions::none));
+        BEAST_EXPECT (lazy.getSerializer () == eager.getSerializer ());
+    }
+
+    void
+    testRoundTrip ()
+    {
+        testcase ("Round trip");
+
+        for (auto const& sle : { makeOffer (5), makeAccountRoot (),
+            makeSignerList () })
+        {
+            auto const data = serialize (*sle);
+            expectSame (*makeLazy (data, sle->key ()), *sle);
+
+            SerialIter sit (data->data (), data->size ());
+            SLE const eager (sit, sle->key ());
+            expectSame (*makeLazy (data, sle->key ()), eager);
+
+            // Without an owner the entry keeps its own copy
+            auto const copied = std::make_shared<SLE const> (
+                Slice (data->data (), data->size ()), nullptr, sle->key ());
+            expectSame (*copied, *sle);
+        }
+    }
+
+    void
+    testFields ()
+    {
+        testcase ("Fields");
+
+        auto const offer = makeOffer (9);
+        auto const lazy = makeLazy (serialize (*offer), offer->key ());
+        BEAST_EXPECT (lazy->getAccountID (sfAccount) == makeAccount (9));
+        BEAST_EXPECT (lazy->getFieldAmount (sfTakerGets) ==
+            offer->getFieldAmount (sfTakerGets));
+        BEAST_EXPECT ((*lazy)[sfTakerPays] == (*offer)[sfTakerPays]);
+        BEAST_EXPECT ((*lazy)[~sfExpiration] == 100009u);
+        BEAST_EXPECT (! lazy->isFieldPresent (sfPreviousTxnID) ||
+            lazy->getFieldH256 (sfPreviousTxnID) ==
+                offer->getFieldH256 (sfPreviousTxnID));
+        BEAST_EXPECT (! lazy->isFieldPresent (sfDomain));
+        BEAST_EXPECT (lazy->getFieldU64 (sfOwnerNode) == 0);
+
+        auto const account = makeAccountRoot ();
+        auto const root = makeLazy (serialize (*account), account->key ());
+        BEAST_EXPECT (root->getFieldVL (sfDomain) == Blob (64, 'x'));
+        BEAST_EXPECT (root->getFieldAmount (sfBalance) ==
+            STAmount (123456789));
+
+        auto const list = makeSignerList ();
+        auto const signers = makeLazy (serialize (*list), list->key ());
+        BEAST_EXPECT (signers->getFieldArray (sfSignerEntries).size () == 4);
+        BEAST_EXPECT (signers->getFieldU32 (sfSignerQuorum) == 3);
+    }
+
+    void
+    testModify ()
+    {
+        testcase ("Modify");
+
+        auto const offer = makeOffer (11);
+        auto const data = serialize (*offer);
+        auto const lazy = makeLazy (data, offer->key ());
+
+        auto copy = std::make_shared<SLE> (*lazy);
+        copy->setFieldAmount (sfTakerPays, STAmount (1));
+        copy->makeFieldAbsent (sfExpiration);
+        (*copy)[sfSequence] = 99u;
+
+        auto expected = std::make_shared<SLE> (*offer);
+        expected->setFieldAmount (sfTakerPays, STAmount (1));
+        expected->makeFieldAbsent (sfExpiration);
+        (*expected)[sfSequence] = 99u;
+
+        expectSame (*copy, *expected);
+        expectSame (*lazy, *offer);
+
+        auto assigned = std::make_shared<SLE> (*makeAccountRoot ());
+        *assigned = *lazy;
+        expectSame (*assigned, *offer);
+    }
+
+    void
+    testMalformed ()
+    {
+        testcase ("Malformed");
+
+        auto const offer = makeOffer (13);
+        auto const s = offer->getSerializer ();
+
+        auto const fails = [&](Slice slice)
+        {
+            try
+            {
+                SLE const sle (slice, nullptr, offer->key ());
+                // Deferred fields are only checked when read
+                sle.getJson (JsonOptions::none);
+            }
+            catch (std::exception const&)
+            {
+                return true;
+            }
+            return false;
+        };
+
+        BEAST_EXPECT (! fails (s.slice ()));
+        BEAST_EXPECT (fails (Slice (s.data (), s.size () - 3)));
+
+        // A duplicated field
+        Serializer dup;
+        dup.addRaw (s.data (), s.size ());
+        offer->peekAtField (sfSequence).addFieldID (dup);
+        offer->peekAtField (sfSequence).add (dup);
+        BEAST_EXPECT (fails (dup.slice ()));
+
+        // A required field that is missing
+        auto partial = std::make_shared<SLE> (*offer);
+        partial->delField (partial->getFieldIndex (sfTakerGets));
+        BEAST_EXPECT (fails (partial->getSerializer ().slice ()));
+    }
+
+    void
+    testConcurrent ()
+    {
+        testcase ("Concurrent reads");
+
+        auto const offer = makeOffer (17);
+        auto const expected = offer->getFieldAmount (sfTakerGets);
+        for (int round = 0; round < 50; ++round)
+        {
+            auto const lazy = makeLazy (serialize (*offer), offer->key ());
+            std::atomic<int> mismatches {0};
+            std::vector<std::thread> threads;
+            for (int i = 0; i < 4; ++i)
+            {
+                threads.emplace_back ([&]
+                {
+                    auto const index = lazy->getFieldIndex (sfTakerGets);
+                    if (! lazy->isFieldPresent (sfTakerGets) ||
+                            lazy->getFieldSType (index) != sfTakerGets)
+                        ++mismatches;
+                    if (lazy->getFieldAmount (sfTakerGets) != expected)
+                        ++mismatches;
+                    if (lazy->getFieldU32 (sfSequence) != 17)
+                        ++mismatches;
+                    SLE const copy (*lazy);
+                    if (copy.getFieldH256 (sfBookDirectory) !=
+                            uint256 (17 * 7))
+                        ++mismatches;
+                });
+            }
+            for (auto& t : threads)
+                t.join ();
+            BEAST_EXPECT (mismatches == 0);
+        }
+    }
+
+public:
+    void
+    run () override
+    {
+        testRoundTrip ();
+        testFields ();
+        testModify ();
+        testMalformed ();
+        testConcurrent ();
+    }
+};
+
+class STLedgerEntryBench_test : public STLedgerEntry_test
+{
+public:
+    void
+    run () override
+    {
+        using clock_type = std::chrono::steady_clock;
+        std::size_t const count = 200000;
+
+        std::vector<std::shared_ptr<Buffer const>> offers;
+        offers.reserve (1000);
+        for (std::uint64_t i = 0; i < 1000; ++i)
+            offers.push_back (serialize (*makeOffer (i)));
+
+        auto const measure = [&](char const* name, auto&& read)
+        {
+            std::uint64_t sum = 0;
+            auto const start = clock_type::now ();
+            for (std::size_t i = 0; i < count; ++i)
+                sum += read (offers[i % offers.size ()]);
+            auto const elapsed = std::chrono::duration_cast<
+                std::chrono::milliseconds> (clock_type::now () - start);
+            log << name << ": " << count << " offers read in " <<
+                elapsed.count () << "ms (" << sum << ")" << std::endl;
+        };
+
+        uint256 const key;
+        measure ("eager", [&](std::shared_ptr<Buffer const> const& data)
+        {
+            SLE const sle (SerialIter (data->data (), data->size ()), key);
+            return sle.getFieldAmount (sfTakerPays).mantissa () +
+                sle.getFieldU32 (sfSequence);
+        });
+        measure ("lazy", [&](std::shared_ptr<Buffer const> const& data)
+        {
+            SLE const sle (Slice (data->data (), data->size ()), data, key);
+            return sle.getFieldAmount (sfTakerPays).mantissa () +
+                sle.getFieldU32 (sfSequence);
+        });
+        pass ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(STLedgerEntry,protocol,ripple);
+BEAST_DEFINE_TESTSUITE_MANUAL_PRIO(STLedgerEntryBench,protocol,ripple,10);
+
+}
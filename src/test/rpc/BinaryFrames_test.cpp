@@ -0,0 +1,526 @@
+#include <ripple/basics/StringUtilities.h>
+#include <ripple/beast/unit_test.h>
+#include <ripple/json/json_reader.h>
+#include <ripple/json/to_string.h>
+#include <ripple/protocol/jss.h>
+#include <ripple/protocol/Serializer.h>
+#include <ripple/protocol/STTx.h>
+#include <ripple/resource/Fees.h>
+#include <ripple/rpc/BinaryFrames.h>
+#include <ripple/rpc/Context.h>
+#include <ripple/rpc/RPCHandler.h>
+#include <test/jtx.h>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/beast/core/buffers_to_string.hpp>
+#include <boost/beast/core/multi_buffer.hpp>
+#include <boost/beast/http.hpp>
+#include <boost/beast/websocket.hpp>
+#include <chrono>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace ripple {
+namespace test {
+
+class BinaryFrames_test : public beast::unit_test::suite
+{
+protected:
+    struct Frame
+    {
+        std::uint8_t type;
+        Blob payload;
+    };
+
+    static
+    std::vector<Frame>
+    parse (std::string const& data)
+    {
+        std::vector<Frame> frames;
+        SerialIter sit (data.data (), data.size ());
+        while (! sit.empty ())
+        {
+            auto const size = sit.get32 ();
+            Frame frame;
+            frame.type = sit.get8 ();
+            frame.payload = sit.getRaw (size);
+            frames.push_back (std::move (frame));
+        }
+        return frames;
+    }
+
+    Json::Value
+    parseHeader (Frame const& frame)
+    {
+        Json::Value header;
+        BEAST_EXPECT (frame.type == RPC::BinaryFrames::header);
+        BEAST_EXPECT (Json::Reader ().parse (std::string (
+            frame.payload.begin (), frame.payload.end ()), header));
+        return header;
+    }
+
+    static
+    Json::Value
+    call (jtx::Env& env, std::string const& method, Json::Value params,
+        RPC::BinaryFrames* frames = nullptr)
+    {
+        auto& app = env.app ();
+        Resource::Charge loadType = Resource::feeReferenceRPC;
+        Resource::Consumer c;
+        params[jss::command] = method;
+        RPC::Context context {env.journal, params, app, loadType,
+            app.getOPs (), app.getLedgerMaster (), c, Role::ADMIN,
+            {}, {}, {}, frames};
+
+        Json::Value result;
+        RPC::doCommand (context, result);
+        if (! result.isMember (jss::error))
+            result[jss::status] = jss::success;
+        return result;
+    }
+
+    using response_type =
+        boost::beast::http::response<boost::beast::http::string_body>;
+
+    // Posts `body` to the server's RPC port.
+    static
+    response_type
+    httpRequest (jtx::Env& env, std::string const& body, unsigned version)
+    {
+        namespace http = boost::beast::http;
+        auto const& section = env.app ().config ()["port_rpc"];
+        auto const addr = *section.get<std::string> ("ip");
+        auto const port = *section.get<std::uint16_t> ("port");
+
+        boost::asio::io_service ios;
+        boost::asio::ip::tcp::socket sock {ios};
+        sock.connect ({boost::asio::ip::address::from_string (addr), port});
+
+        http::request<http::string_body> req {http::verb::post, "/", version};
+        req.set (http::field::host, addr);
+        req.set (http::field::content_type, "application/json");
+        req.body () = body;
+        req.prepare_payload ();
+        http::write (sock, req);
+
+        boost::beast::multi_buffer buffer;
+        response_type resp;
+        http::read (sock, buffer, resp);
+        return resp;
+    }
+
+    // Sends `text` to the server's websocket port and returns the reply.
+    static
+    std::string
+    wsRequest (jtx::Env& env, std::string const& text, bool& binary)
+    {
+        auto const& section = env.app ().config ()["port_ws"];
+        auto const addr = *section.get<std::string> ("ip");
+        auto const port = *section.get<std::uint16_t> ("port");
+
+        boost::asio::io_service ios;
+        boost::beast::websocket::stream<boost::asio::ip::tcp::socket> ws {ios};
+        ws.next_layer ().connect (
+            {boost::asio::ip::address::from_string (addr), port});
+        ws.handshake (addr + ":" + std::to_string (port), "/");
+        ws.write (boost::asio::buffer (text));
+
+        boost::beast::multi_buffer buffer;
+        ws.read (buffer);
+        binary = ws.got_binary ();
+        return boost::beast::buffers_to_string (buffer.data ());
+    }
+
+    // Accounts with a trust line each, and a ledger of payments.
+    static
+    void
+    populate (jtx::Env& env, std::size_t accounts, std::size_t payments)
+    {
+        using namespace jtx;
+        Account const gw {"gateway"};
+        auto const USD = gw["USD"];
+        env.fund (XRP (100000), gw);
+        std::vector<Account> holders;
+        for (std::size_t i = 0; i < accounts; ++i)
+        {
+            holders.emplace_back ("holder" + std::to_string (i));
+            env.fund (XRP (10000), holders.back ());
+            if (i % 100 == 99)
+                env.close ();
+        }
+        env.close ();
+        for (std::size_t i = 0; i < accounts; ++i)
+        {
+            env.trust (USD (1000), holders[i]);
+            if (i % 100 == 99)
+                env.close ();
+        }
+        env.close ();
+        for (std::size_t i = 0; i < payments; ++i)
+            env (pay (gw, holders[i % accounts], USD (1)));
+        env.close ();
+    }
+
+    void
+    testLedgerData ()
+    {
+        testcase ("ledger_data");
+        using namespace jtx;
+        Env env {*this};
+        populate (env, 10, 5);
+
+        Json::Value params;
+        params[jss::ledger_index] = "validated";
+        params[jss::binary] = true;
+        auto const json = call (env, "ledger_data", params);
+
+        RPC::BinaryFrames frames;
+        auto const result = call (env, "ledger_data", params, &frames);
+        BEAST_EXPECT (frames.accepted ());
+        BEAST_EXPECT (! result.isMember (jss::state));
+        BEAST_EXPECT (! result.isMember (jss::ledger));
+
+        auto const parsed = parse (frames.finish (result));
+        if (! BEAST_EXPECT (parsed.size () == frames.count () + 1))
+            return;
+
+        // The last frame is the JSON result without the bulk array
+        auto const header = parseHeader (parsed.back ());
+        BEAST_EXPECT (header[jss::ledger_hash] == json[jss::ledger_hash]);
+        BEAST_EXPECT (header[jss::status] == "success");
+
+        BEAST_EXPECT (parsed[0].type == RPC::BinaryFrames::ledger);
+        BEAST_EXPECT (strHex (parsed[0].payload) ==
+            json[jss::ledger][jss::ledger_data].asString ());
+
+        auto const& state = json[jss::state];
+        if (! BEAST_EXPECT (parsed.size () == state.size () + 2))
+            return;
+        for (std::size_t i = 0; i < state.size (); ++i)
+        {
+            auto const& frame = parsed[i + 1];
+            BEAST_EXPECT (frame.type == RPC::BinaryFrames::entry);
+            auto const& node = state[static_cast<Json::UInt> (i)];
+            Blob const key (frame.payload.begin (),
+                frame.payload.begin () + 32);
+            Blob const data (frame.payload.begin () + 32,
+                frame.payload.end ());
+            BEAST_EXPECT (strHex (key) == node[jss::index].asString ());
+            BEAST_EXPECT (strHex (data) == node[jss::data].asString ());
+        }
+    }
+
+    void
+    testLedger ()
+    {
+        testcase ("ledger");
+        using namespace jtx;
+        Env env {*this};
+        populate (env, 10, 8);
+
+        Json::Value params;
+        params[jss::ledger_index] = "validated";
+        params[jss::transactions] = true;
+        params[jss::accounts] = true;
+        auto const json = call (env, "ledger", params);
+        auto const& ledger = json[jss::ledger];
+
+        RPC::BinaryFrames frames;
+        auto const result = call (env, "ledger", params, &frames);
+        BEAST_EXPECT (frames.accepted ());
+        BEAST_EXPECT (result[jss::ledger][jss::ledger_hash] ==
+            ledger[jss::ledger_hash]);
+        BEAST_EXPECT (! result[jss::ledger].isMember (jss::transactions));
+        BEAST_EXPECT (! result[jss::ledger].isMember (jss::accountState));
+
+        std::set<std::string> txIds;
+        for (auto const& id : ledger[jss::transactions])
+            txIds.insert (id.asString ());
+        std::set<std::string> keys;
+        for (auto const& key : ledger[jss::accountState])
+            keys.insert (key.asString ());
+        BEAST_EXPECT (txIds.size () == 8);
+
+        std::size_t txns = 0;
+        std::size_t entries = 0;
+        auto const seq = env.closed ()->info ().seq;
+        for (auto const& frame : parse (frames.finish (result)))
+        {
+            SerialIter sit (frame.payload.data (), frame.payload.size ());
+            if (frame.type == RPC::BinaryFrames::transaction)
+            {
+                ++txns;
+                BEAST_EXPECT (sit.get32 () == seq);
+                auto const size = sit.get32 ();
+                SerialIter txSit (sit.getSlice (size));
+                STTx const tx (txSit);
+                BEAST_EXPECT (txIds.count (to_string (
+                    tx.getTransactionID ())) == 1);
+                BEAST_EXPECT (sit.getBytesLeft () > 0);
+            }
+            else if (frame.type == RPC::BinaryFrames::entry)
+            {
+                ++entries;
+                BEAST_EXPECT (keys.count (to_string (sit.get256 ())) == 1);
+            }
+        }
+        BEAST_EXPECT (txns == txIds.size ());
+        BEAST_EXPECT (entries == keys.size ());
+    }
+
+    void
+    testAccountTx ()
+    {
+        testcase ("account_tx");
+        using namespace jtx;
+        Env env {*this};
+        populate (env, 3, 6);
+
+        Json::Value params;
+        params[jss::account] = Account ("holder1").human ();
+        params[jss::binary] = true;
+        auto const json = call (env, "account_tx", params);
+        auto const& txs = json[jss::transactions];
+        BEAST_EXPECT (txs.size () > 2);
+
+        RPC::BinaryFrames frames;
+        auto const result = call (env, "account_tx", params, &frames);
+        BEAST_EXPECT (frames.accepted ());
+        BEAST_EXPECT (! result.isMember (jss::transactions));
+        BEAST_EXPECT (result[jss::account] == json[jss::account]);
+
+        auto const parsed = parse (frames.finish (result));
+        if (! BEAST_EXPECT (parsed.size () == txs.size () + 1))
+            return;
+        BEAST_EXPECT (parsed.back ().type == RPC::BinaryFrames::header);
+        for (std::size_t i = 0; i < txs.size (); ++i)
+        {
+            auto const& tx = txs[static_cast<Json::UInt> (i)];
+            auto const& frame = parsed[i];
+            BEAST_EXPECT (frame.type == RPC::BinaryFrames::transaction);
+            SerialIter sit (frame.payload.data (), frame.payload.size ());
+            BEAST_EXPECT (sit.get32 () == tx[jss::ledger_index].asUInt ());
+            auto const blob = sit.getSlice (sit.get32 ());
+            auto const meta = sit.getSlice (sit.getBytesLeft ());
+            BEAST_EXPECT (strHex (blob) == tx[jss::tx_blob].asString ());
+            BEAST_EXPECT (strHex (meta) == tx[jss::meta].asString ());
+        }
+    }
+
+    void
+    testServer ()
+    {
+        testcase ("HTTP and websocket");
+        using namespace jtx;
+        namespace http = boost::beast::http;
+        Env env {*this};
+        populate (env, 10, 5);
+
+        Json::Value params;
+        params[jss::ledger_index] = "validated";
+        params[jss::binary] = true;
+        auto const json = call (env, "ledger_data", params);
+        auto const entries = json[jss::state].size ();
+
+        // Returns the header of a response holding the ledger's frames
+        auto const check = [&](std::string const& body)
+        {
+            auto const parsed = parse (body);
+            if (! BEAST_EXPECT (parsed.size () == entries + 2))
+                return Json::Value ();
+            BEAST_EXPECT (parsed[0].type == RPC::BinaryFrames::ledger);
+            for (std::size_t i = 1; i <= entries; ++i)
+                BEAST_EXPECT (parsed[i].type == RPC::BinaryFrames::entry);
+            return parseHeader (parsed.back ());
+        };
+
+        params[jss::frames] = true;
+        Json::Value request;
+        request[jss::method] = "ledger_data";
+        request[jss::params] = Json::arrayValue;
+        request[jss::params].append (params);
+
+        // HTTP/1.1 replies are sent in chunks as the frames are added,
+        // HTTP/1.0 replies in one piece.
+        for (unsigned version : {11, 10})
+        {
+            auto const resp = httpRequest (env, to_string (request), version);
+            BEAST_EXPECT (resp.result () == http::status::ok);
+            BEAST_EXPECT (resp[http::field::content_type] ==
+                "application/octet-stream");
+            BEAST_EXPECT (resp.chunked () == (version == 11));
+            auto const header = check (resp.body ());
+            BEAST_EXPECT (header[jss::result][jss::status] == "success");
+            BEAST_EXPECT (header[jss::result][jss::ledger_hash] ==
+                json[jss::ledger_hash]);
+        }
+
+        {
+            auto message = params;
+            message[jss::command] = "ledger_data";
+            message[jss::id] = 7;
+            bool binary = false;
+            auto const header = check (
+                wsRequest (env, to_string (message), binary));
+            BEAST_EXPECT (binary);
+            BEAST_EXPECT (header[jss::status] == "success");
+            BEAST_EXPECT (header[jss::id] == 7);
+            BEAST_EXPECT (header[jss::result][jss::ledger_hash] ==
+                json[jss::ledger_hash]);
+        }
+
+        // Errors before the first frame are answered in JSON
+        request[jss::params][0u][jss::ledger_index] = 1000u;
+        auto const resp = httpRequest (env, to_string (request), 11);
+        BEAST_EXPECT (resp[http::field::content_type] ==
+            "application/json; charset=UTF-8");
+        Json::Value error;
+        BEAST_EXPECT (Json::Reader ().parse (resp.body (), error));
+        BEAST_EXPECT (error[jss::result][jss::error] == "lgrNotFound");
+
+        auto message = params;
+        message[jss::command] = "ledger_data";
+        message[jss::ledger_index] = 1000u;
+        bool binary = true;
+        auto const text = wsRequest (env, to_string (message), binary);
+        BEAST_EXPECT (! binary);
+        BEAST_EXPECT (Json::Reader ().parse (text, error));
+        BEAST_EXPECT (error[jss::error] == "lgrNotFound");
+
+        // So are errors found after the ledger has been looked up
+        request[jss::params][0u][jss::ledger_index] = "validated";
+        request[jss::params][0u][jss::type] = "no_such_type";
+        auto const typeResp = httpRequest (env, to_string (request), 11);
+        BEAST_EXPECT (typeResp[http::field::content_type] ==
+            "application/json; charset=UTF-8");
+        BEAST_EXPECT (Json::Reader ().parse (typeResp.body (), error));
+        BEAST_EXPECT (error[jss::result][jss::error] == "invalidParams");
+    }
+
+    void
+    testUnsupported ()
+    {
+        testcase ("Unsupported");
+        using namespace jtx;
+        Env env {*this};
+        env.fund (XRP (10000), "alice");
+        env.close ();
+
+        Json::Value params;
+        params[jss::account] = Account ("alice").human ();
+        RPC::BinaryFrames frames;
+        auto const result = call (env, "account_info", params, &frames);
+        BEAST_EXPECT (! frames.accepted ());
+        BEAST_EXPECT (frames.count () == 0);
+        BEAST_EXPECT (result.isMember (jss::account_data));
+
+        // Errors are reported in JSON
+        params[jss::ledger_index] = 1000u;
+        auto const error = call (env, "ledger_data", params, &frames);
+        BEAST_EXPECT (error[jss::error] == "lgrNotFound");
+        BEAST_EXPECT (frames.count () == 0);
+
+        // Frames are held until the handler accepts them
+        std::string sent;
+        RPC::BinaryFrames held (Json::Output (
+            [&sent](boost::beast::string_view const& bytes)
+            {
+                sent.append (bytes.data (), bytes.size ());
+            }));
+        held.addEntry (uint256 (1), Slice ("data", 4));
+        BEAST_EXPECT (sent.empty () && ! held.streamed ());
+        held.accept ();
+        held.addEntry (uint256 (2), Slice ("data", 4));
+        BEAST_EXPECT (held.streamed ());
+        auto const rest = held.finish (Json::objectValue);
+        auto const parsed = parse (sent + rest);
+        BEAST_EXPECT (parsed.size () == 3);
+        BEAST_EXPECT (parse (sent).size () == 2);
+    }
+
+public:
+    void
+    run () override
+    {
+        testLedgerData ();
+        testLedger ();
+        testAccountTx ();
+        testServer ();
+        testUnsupported ();
+    }
+};
+
+// Encodes and decodes a full ledger dump as JSON, as hex in JSON and as
+// binary frames.
+class BinaryFramesBench_test : public BinaryFrames_test
+{
+    using clock_type = std::chrono::steady_clock;
+
+    template <class F>
+    static
+    double
+    time (F&& f)
+    {
+        auto const start = clock_type::now ();
+        f ();
+        return std::chrono::duration<double, std::milli> (
+            clock_type::now () - start).count ();
+    }
+
+    void
+    bench (jtx::Env& env, char const* name, bool binary, bool useFrames)
+    {
+        Json::Value params;
+        params[jss::ledger_index] = "validated";
+        params[jss::full] = true;
+        params[jss::expand] = true;
+        params[jss::binary] = binary;
+
+        std::string response;
+        RPC::BinaryFrames frames;
+        auto const encode = time ([&]
+        {
+            auto const result = call (env, "ledger", params,
+                useFrames ? &frames : nullptr);
+            response = useFrames ? frames.finish (result) :
+                to_string (result);
+        });
+
+        std::size_t objects = 0;
+        auto const decode = time ([&]
+        {
+            if (useFrames)
+            {
+                objects = parse (response).size ();
+                return;
+            }
+            Json::Value jv;
+            Json::Reader ().parse (response, jv);
+            objects = jv[jss::ledger][jss::accountState].size () +
+                jv[jss::ledger][jss::transactions].size ();
+        });
+
+        log << name << ": " << response.size () << " bytes, " <<
+            objects << " objects, encode " << encode << "ms, decode " <<
+            decode << "ms" << std::endl;
+    }
+
+public:
+    void
+    run () override
+    {
+        jtx::Env env {*this};
+        populate (env, 5000, 2000);
+
+        bench (env, "json", false, false);
+        bench (env, "json_binary", true, false);
+        bench (env, "frames", false, true);
+        pass ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(BinaryFrames,rpc,ripple);
+BEAST_DEFINE_TESTSUITE_MANUAL_PRIO(BinaryFramesBench,rpc,ripple,10);
+
+}
+}
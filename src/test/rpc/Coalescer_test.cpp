@@ -0,0 +1,219 @@
+#include <ripple/beast/unit_test.h>
+#include <ripple/protocol/jss.h>
+#include <ripple/resource/Fees.h>
+#include <ripple/rpc/Coalescer.h>
+#include <test/jtx.h>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace ripple {
+namespace test {
+
+class Coalescer_test : public beast::unit_test::suite
+{
+    using Result = RPC::Coalescer::Result;
+
+    static
+    std::shared_ptr<Result const>
+    makeResult (int value)
+    {
+        return std::make_shared<Result const> (Result {
+            "{\"ledger_index\":" + std::to_string (value) + "}",
+            false, Resource::feeMediumBurdenRPC});
+    }
+
+    static
+    std::string
+    count (RPC::Coalescer const& coalescer, char const* method,
+        Json::StaticString const& field)
+    {
+        return coalescer.getJson ()[method][field].asString ();
+    }
+
+    void
+    testJoin ()
+    {
+        testcase ("Join");
+
+        RPC::Coalescer coalescer;
+        std::atomic<int> computed {0};
+        std::promise<void> release;
+        auto const released = release.get_future ().share ();
+        auto const compute = [&]
+        {
+            ++computed;
+            released.wait ();
+            return makeResult (7);
+        };
+
+        std::vector<std::shared_ptr<Result const>> results (4);
+        std::vector<std::thread> threads;
+        for (auto& result : results)
+        {
+            threads.emplace_back ([&]
+            {
+                result = coalescer.join ("ledger", "key", nullptr, compute);
+            });
+        }
+
+        // Wait until every request but the computing one has attached
+        while (count (coalescer, "ledger", jss::coalesced) != "3")
+            std::this_thread::yield ();
+        release.set_value ();
+        for (auto& thread : threads)
+            thread.join ();
+
+        BEAST_EXPECT (computed == 1);
+        BEAST_EXPECT (count (coalescer, "ledger", jss::computed) == "1");
+        for (auto const& result : results)
+        {
+            BEAST_EXPECT (result == results[0]);
+            BEAST_EXPECT (result->text == "{\"ledger_index\":7}");
+            BEAST_EXPECT (result->loadType == Resource::feeMediumBurdenRPC);
+        }
+
+        // Finished computations are not reused
+        coalescer.join ("ledger", "key", nullptr, compute);
+        BEAST_EXPECT (computed == 2);
+        coalescer.join ("server_info", "other", nullptr, compute);
+        BEAST_EXPECT (computed == 3);
+        BEAST_EXPECT (count (coalescer, "server_info", jss::computed) == "1");
+        BEAST_EXPECT (count (coalescer, "server_info", jss::coalesced) == "0");
+    }
+
+    void
+    testException ()
+    {
+        testcase ("Exception");
+
+        RPC::Coalescer coalescer;
+        std::promise<void> release;
+        auto const released = release.get_future ().share ();
+        auto const compute = [&] () -> std::shared_ptr<Result const>
+        {
+            released.wait ();
+            Throw<std::runtime_error> ("failed");
+            return nullptr;
+        };
+
+        std::atomic<int> thrown {0};
+        std::vector<std::thread> threads;
+        for (int i = 0; i < 3; ++i)
+        {
+            threads.emplace_back ([&]
+            {
+                try
+                {
+                    coalescer.join ("fee", "key", nullptr, compute);
+                }
+                catch (std::runtime_error const&)
+                {
+                    ++thrown;
+                }
+            });
+        }
+
+        while (count (coalescer, "fee", jss::coalesced) != "2")
+            std::this_thread::yield ();
+        release.set_value ();
+        for (auto& thread : threads)
+            thread.join ();
+        BEAST_EXPECT (thrown == 3);
+
+        // A failed computation is not left in flight
+        auto const result = coalescer.join ("fee", "key", nullptr, []
+        {
+            return makeResult (1);
+        });
+        BEAST_EXPECT (result->text == "{\"ledger_index\":1}");
+    }
+
+    void
+    testCoro ()
+    {
+        testcase ("Coroutines");
+        using namespace jtx;
+
+        // A standalone Env has a single job thread, so the waiters can
+        // only all attach if each one gives its thread up while waiting.
+        Env env {*this};
+        RPC::Coalescer coalescer;
+        std::promise<void> release;
+        auto const released = release.get_future ().share ();
+        auto const compute = [&]
+        {
+            released.wait ();
+            return makeResult (3);
+        };
+
+        std::thread leader ([&]
+        {
+            coalescer.join ("ledger", "key", nullptr, compute);
+        });
+        while (count (coalescer, "ledger", jss::computed) != "1")
+            std::this_thread::yield ();
+
+        std::atomic<int> finished {0};
+        std::vector<std::shared_ptr<Result const>> results (4);
+        for (auto& result : results)
+        {
+            env.app ().getJobQueue ().postCoro (jtCLIENT, "Coalescer_test",
+                [&](std::shared_ptr<JobQueue::Coro> const& coro)
+                {
+                    result = coalescer.join ("ledger", "key", coro, compute);
+                    ++finished;
+                });
+        }
+
+        using namespace std::chrono_literals;
+        auto const deadline = std::chrono::steady_clock::now () + 10s;
+        while (count (coalescer, "ledger", jss::coalesced) != "4" &&
+            std::chrono::steady_clock::now () < deadline)
+            std::this_thread::sleep_for (1ms);
+        BEAST_EXPECT (count (coalescer, "ledger", jss::coalesced) == "4");
+
+        release.set_value ();
+        leader.join ();
+        while (finished != 4)
+            std::this_thread::sleep_for (1ms);
+        for (auto const& result : results)
+            BEAST_EXPECT (result && result->text == "{\"ledger_index\":3}");
+    }
+
+    void
+    testCounts ()
+    {
+        testcase ("get_counts");
+        using namespace jtx;
+
+        Env env {*this};
+        env.rpc ("server_info");
+        env.rpc ("server_info");
+        env.rpc ("account_info", Account::master.human ());
+
+        auto const result = env.rpc ("get_counts")[jss::result];
+        auto const& coalesced = result[jss::rpc_coalesced];
+        BEAST_EXPECT (coalesced["server_info"][jss::computed] == "2");
+        BEAST_EXPECT (coalesced["server_info"][jss::coalesced] == "0");
+        BEAST_EXPECT (! coalesced.isMember ("account_info"));
+    }
+
+public:
+    void
+    run () override
+    {
+        testJoin ();
+        testException ();
+        testCoro ();
+        testCounts ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(Coalescer,rpc,ripple);
+
+}
+}
@@ -207,6 +207,54 @@ class LedgerRPC_test : public beast::unit_test::suite
         BEAST_EXPECT(jrr[jss::ledger][jss::accountState].size() == 2u);
     }
 
+    void testStreamedResponse()
+    {
+        testcase("Streamed Response");
+        using namespace test::jtx;
+
+        Env env {*this};
+        Account const alice {"alice"};
+        Account const bob {"bob"};
+        env.fund(XRP(10000), alice, bob);
+        env.close();
+        for (int i = 0; i < 20; ++i)
+            env(pay(alice, bob, XRP(1 + i)));
+        env.close();
+
+        // HTTP/1.1 requests are answered with a chunked body, which
+        // must carry the same result as a buffered HTTP/1.0 reply.
+        auto const compare = [&](std::string const& method,
+            Json::Value const& params)
+        {
+            auto const buffered = env.rpc("json", method,
+                to_string(params))[jss::result];
+            auto const streamed = env.client().invoke(
+                method, params)[jss::result];
+            BEAST_EXPECT(streamed[jss::status] == "success");
+            BEAST_EXPECT(streamed == buffered);
+            return streamed;
+        };
+
+        Json::Value jvParams;
+        jvParams[jss::ledger_index] = "validated";
+        jvParams[jss::full] = true;
+        auto jrr = compare("ledger", jvParams);
+        BEAST_EXPECT(jrr[jss::ledger][jss::accountState].size() == 4u);
+        BEAST_EXPECT(jrr[jss::ledger][jss::transactions].size() == 20u);
+
+        jvParams.removeMember(jss::full);
+        jvParams[jss::transactions] = true;
+        jvParams[jss::expand] = true;
+        compare("ledger", jvParams);
+
+        // Errors are reported in the same form as a buffered reply
+        jvParams.clear();
+        jvParams[jss::ledger_index] = 1000u;
+        jrr = env.client().invoke("ledger", jvParams)[jss::result];
+        checkErrorValue(jrr, "lgrNotFound", "ledgerNotFound");
+        BEAST_EXPECT(jrr[jss::request][jss::ledger_index] == 1000u);
+    }
+
     void testLedgerEntryAccountRoot()
     {
         testcase ("ledger_entry Request AccountRoot");
@@ -1377,6 +1425,7 @@ public:
         testLedgerFull();
         testLedgerFullNonAdmin();
         testLedgerAccounts();
+        testStreamedResponse();
         testLedgerEntryAccountRoot();
         testLedgerEntryCheck();
         testLedgerEntryDepositPreauth();
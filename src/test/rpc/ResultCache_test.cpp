@@ -0,0 +1,153 @@
+#include <ripple/beast/unit_test.h>
+#include <ripple/json/json_value.h>
+#include <ripple/json/to_string.h>
+#include <ripple/protocol/jss.h>
+#include <ripple/resource/Fees.h>
+#include <ripple/rpc/ResultCache.h>
+#include <test/jtx.h>
+
+namespace ripple {
+namespace test {
+
+class ResultCache_test : public beast::unit_test::suite
+{
+    void
+    testEviction ()
+    {
+        testcase ("Eviction");
+
+        RPC::ResultCache disabled {0};
+        BEAST_EXPECT (! disabled.enabled ());
+
+        Json::Value value;
+        value[jss::data] = std::string (90, 'x');
+        auto const bytes = 2 + to_string (value).size ();
+
+        RPC::ResultCache cache {bytes * 3};
+        BEAST_EXPECT (cache.enabled ());
+        BEAST_EXPECT (! cache.fetch ("k1"));
+
+        auto const fee = Resource::feeMediumBurdenRPC;
+        cache.insert ("k1", value, fee);
+        cache.insert ("k2", value, fee);
+        cache.insert ("k3", value, fee);
+        BEAST_EXPECT (cache.size () == 3);
+        BEAST_EXPECT (cache.bytes () == bytes * 3);
+
+        auto const cached = cache.fetch ("k1");
+        BEAST_EXPECT (cached && cached->value == value);
+        BEAST_EXPECT (cached && cached->loadType == fee);
+        BEAST_EXPECT (cache.getHitRate () == 50);
+
+        // The least recently used entry goes first
+        cache.insert ("k4", value, fee);
+        BEAST_EXPECT (cache.size () == 3);
+        BEAST_EXPECT (cache.fetch ("k1"));
+        BEAST_EXPECT (! cache.fetch ("k2"));
+        BEAST_EXPECT (cache.fetch ("k4"));
+
+        // Results larger than the budget are not kept
+        Json::Value large;
+        large[jss::data] = std::string (bytes * 3, 'x');
+        cache.insert ("k5", large, fee);
+        BEAST_EXPECT (! cache.fetch ("k5"));
+        BEAST_EXPECT (cache.size () == 3);
+    }
+
+    void
+    testRequests ()
+    {
+        testcase ("Requests");
+        using namespace jtx;
+
+        Env env {*this, envconfig ([](std::unique_ptr<Config> cfg)
+        {
+            cfg->RPC_CACHE_SIZE = 1;
+            return cfg;
+        })};
+        Account const alice {"alice"};
+        Account const bob {"bob"};
+        env.fund (XRP (10000), alice, bob);
+        env.close ();
+
+        auto const counts = [&]
+        {
+            return env.rpc ("get_counts")[jss::result];
+        };
+        auto const request = [&](std::string const& method,
+            Json::Value const& params)
+        {
+            return env.rpc ("json", method, to_string (params))[jss::result];
+        };
+        BEAST_EXPECT (counts ()[jss::rpc_cache_size] == 0);
+
+        Json::Value params;
+        params[jss::ledger_index] = "validated";
+        params[jss::accounts] = true;
+        auto const first = request ("ledger", params);
+        BEAST_EXPECT (first[jss::status] == "success");
+        BEAST_EXPECT (counts ()[jss::rpc_cache_size] == 1);
+        BEAST_EXPECT (request ("ledger", params) == first);
+
+        // The same ledger by sequence shares the entry
+        params[jss::ledger_index] = env.closed ()->info ().seq;
+        BEAST_EXPECT (request ("ledger", params) == first);
+        BEAST_EXPECT (counts ()[jss::rpc_cache_size] == 1);
+        BEAST_EXPECT (counts ()[jss::rpc_cache_hit_rate].asDouble () > 0);
+
+        // A streamed reply is written from the cached result
+        auto const streamed = env.client ().invoke ("ledger", params);
+        BEAST_EXPECT (streamed[jss::result] == first);
+        BEAST_EXPECT (counts ()[jss::rpc_cache_size] == 1);
+
+        // The current and closed ledgers may still change
+        params[jss::ledger_index] = "current";
+        request ("ledger", params);
+        params[jss::ledger_index] = "closed";
+        request ("ledger", params);
+        params.clear ();
+        params[jss::account] = alice.human ();
+        request ("account_objects", params);
+        BEAST_EXPECT (counts ()[jss::rpc_cache_size] == 1);
+
+        // Errors are not kept
+        params[jss::ledger_index] = "validated";
+        params[jss::account] = Account ("carol").human ();
+        auto const error = request ("account_objects", params);
+        BEAST_EXPECT (error[jss::error] == "actNotFound");
+        BEAST_EXPECT (counts ()[jss::rpc_cache_size] == 1);
+
+        // A transaction is kept once it is validated
+        env (pay (alice, bob, XRP (10)));
+        Json::Value tx;
+        tx[jss::transaction] = to_string (env.tx ()->getTransactionID ());
+        BEAST_EXPECT (! request ("tx", tx)[jss::validated].asBool ());
+        BEAST_EXPECT (counts ()[jss::rpc_cache_size] == 1);
+        env.close ();
+        auto const validated = request ("tx", tx);
+        BEAST_EXPECT (validated[jss::validated].asBool ());
+        BEAST_EXPECT (request ("tx", tx) == validated);
+        BEAST_EXPECT (counts ()[jss::rpc_cache_size] == 2);
+
+        // "validated" now names the newer ledger
+        params[jss::account] = alice.human ();
+        auto const objects = request ("account_objects", params);
+        BEAST_EXPECT (objects[jss::ledger_hash] ==
+            to_string (env.closed ()->info ().hash));
+        BEAST_EXPECT (request ("account_objects", params) == objects);
+        BEAST_EXPECT (counts ()[jss::rpc_cache_size] == 3);
+    }
+
+public:
+    void
+    run () override
+    {
+        testEviction ();
+        testRequests ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(ResultCache,rpc,ripple);
+
+}
+}
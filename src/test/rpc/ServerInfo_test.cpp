@@ -2,6 +2,7 @@
 
 #include <ripple/protocol/jss.h>
 #include <test/jtx.h>
+#include <test/jtx/WSClient.h>
 #include <ripple/beast/unit_test.h>
 
 #include <boost/format.hpp>
@@ -71,9 +72,64 @@ public:
         }
     }
 
+    void testWebsocketSessions()
+    {
+        using namespace std::chrono_literals;
+        using namespace test::jtx;
+
+        Env env(*this);
+        auto wsc = makeWSClient(env.app().config());
+        Json::Value stream;
+        stream[jss::streams] = Json::arrayValue;
+        stream[jss::streams].append("ledger");
+        BEAST_EXPECT(wsc->invoke("subscribe", stream)[jss::status] ==
+            "success");
+        env.close();
+        BEAST_EXPECT(wsc->findMsg(5s,
+            [](auto const& jv)
+            {
+                return jv[jss::type] == "ledgerClosed";
+            }));
+
+        {
+            auto const result = env.rpc("server_info");
+            BEAST_EXPECT(! result[jss::result][jss::info].isMember(
+                jss::websocket_sessions));
+        }
+        {
+            auto const result = env.rpc(
+                "json", "server_info", R"({"counters": true})");
+            auto const& sessions =
+                result[jss::result][jss::info][jss::websocket_sessions];
+            if (BEAST_EXPECT(sessions.isArray() && sessions.size() == 1))
+            {
+                BEAST_EXPECT(sessions[0u][jss::dropped] == "0");
+                BEAST_EXPECT(sessions[0u].isMember(jss::queued_bytes));
+                BEAST_EXPECT(sessions[0u][jss::queued].isString());
+                BEAST_EXPECT(sessions[0u][jss::lag_ms].isString());
+                BEAST_EXPECT(sessions[0u][jss::wire_bytes] != "0");
+
+                // Only message frames are counted, not the handshake. A
+                // server frame header is at most 10 bytes.
+                auto const number = [&](Json::StaticString const& field)
+                {
+                    return std::stoull(sessions[0u][field].asString());
+                };
+                BEAST_EXPECT(number(jss::wire_bytes) <=
+                    number(jss::sent_bytes) + 10 * number(jss::sent));
+            }
+            auto const& compression =
+                result[jss::result][jss::info][jss::websocket_compression];
+            BEAST_EXPECT(compression[jss::wire_bytes] != "0");
+            BEAST_EXPECT(compression.isMember(jss::saved_bytes));
+            BEAST_EXPECT(compression.isMember(jss::write_us));
+        }
+    }
+
     void run () override
     {
         testServerInfo ();
+        testWebsocketSessions ();
     }
 };
 
@@ -245,6 +245,54 @@ public:
         BEAST_EXPECT(jv[jss::status] == "success");
     }
 
+    void testSharedPayload()
+    {
+        using namespace std::chrono_literals;
+        using namespace jtx;
+        Env env(*this);
+
+        // Every subscriber receives the same serialized event
+        std::vector<std::unique_ptr<WSClient>> clients;
+        Json::Value stream;
+        stream[jss::streams] = Json::arrayValue;
+        stream[jss::streams].append("transactions");
+        stream[jss::streams].append("ledger");
+        for (int i = 0; i < 4; ++i)
+        {
+            clients.push_back(makeWSClient(env.app().config()));
+            auto jv = clients.back()->invoke("subscribe", stream);
+            BEAST_EXPECT(jv[jss::status] == "success");
+        }
+
+        env.fund(XRP(10000), "alice");
+        env.close();
+
+        boost::optional<Json::Value> first;
+        for (auto& wsc : clients)
+        {
+            auto const jv = wsc->findMsg(5s,
+                [&](auto const& jv)
+                {
+                    return jv[jss::type] == "transaction" &&
+                        jv[jss::transaction][jss::TransactionType] ==
+                            "AccountSet";
+                });
+            if (! BEAST_EXPECT(jv))
+                continue;
+            if (! first)
+                first = *jv;
+            else
+                BEAST_EXPECT(*jv == *first);
+
+            BEAST_EXPECT(wsc->findMsg(5s,
+                [&](auto const& jv)
+                {
+                    return jv[jss::type] == "ledgerClosed" &&
+                        jv[jss::ledger_index] == 3;
+                }));
+        }
+    }
+
     void testManifests()
     {
         using namespace jtx;
@@ -614,6 +662,7 @@ public:
         testServer();
         testLedger();
         testTransactions();
+        testSharedPayload();
         testManifests();
         testValidations();
         testSubErrors(true);
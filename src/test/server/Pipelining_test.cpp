@@ -0,0 +1,356 @@
+#include <ripple/beast/unit_test.h>
+#include <ripple/core/JobQueue.h>
+#include <ripple/json/json_reader.h>
+#include <ripple/json/to_string.h>
+#include <ripple/protocol/jss.h>
+#include <test/jtx.h>
+#include <test/jtx/envconfig.h>
+#include <test/jtx/WSClient.h>
+#include <boost/asio.hpp>
+#include <boost/beast/core/flat_buffer.hpp>
+#include <boost/beast/http.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ripple {
+namespace test {
+
+class Pipelining_test : public beast::unit_test::suite
+{
+protected:
+    using socket_type = boost::asio::ip::tcp::socket;
+
+    static
+    std::unique_ptr<Config>
+    makeConfig(std::string const& key = "", std::string const& value = "")
+    {
+        auto cfg = jtx::envconfig();
+        if (! key.empty())
+            (*cfg)["port_rpc"].set(key, value);
+        return cfg;
+    }
+
+    static
+    void
+    connect(jtx::Env& env, socket_type& sock)
+    {
+        auto const& section = env.app().config()["port_rpc"];
+        auto const ip = section.get<std::string>("ip");
+        auto const port = section.get<std::uint16_t>("port");
+        sock.connect({boost::asio::ip::address::from_string(*ip), *port});
+    }
+
+    static
+    std::string
+    makeRequest(std::string const& method, int id, bool keepAlive = true)
+    {
+        using namespace boost::beast::http;
+        Json::Value params;
+        params[jss::id] = id;
+        Json::Value jv;
+        jv[jss::method] = method;
+        jv[jss::params].append(params);
+
+        request<string_body> req{verb::post, "/", 11};
+        req.set(field::host, "localhost");
+        req.set(field::content_type, "application/json");
+        req.keep_alive(keepAlive);
+        req.body() = to_string(jv);
+        req.prepare_payload();
+
+        std::ostringstream ss;
+        ss << req;
+        return ss.str();
+    }
+
+    static
+    Json::Value
+    readResponse(socket_type& sock, boost::beast::flat_buffer& buffer,
+        boost::system::error_code& ec)
+    {
+        using namespace boost::beast::http;
+        response<string_body> resp;
+        read(sock, buffer, resp, ec);
+        Json::Value jv;
+        if (! ec)
+            Json::Reader().parse(resp.body(), jv);
+        return jv;
+    }
+
+    void
+    testOrder()
+    {
+        testcase("Responses in order");
+        using namespace jtx;
+        Env env{*this, makeConfig()};
+
+        boost::asio::io_service ios;
+        socket_type sock{ios};
+        connect(env, sock);
+
+        // Slow and fast requests interleaved, sent before reading anything
+        std::string batch;
+        for (int i = 0; i < 20; ++i)
+            batch += makeRequest(i % 2 ? "ping" : "server_info", i);
+        boost::asio::write(sock, boost::asio::buffer(batch));
+
+        boost::beast::flat_buffer buffer;
+        for (int i = 0; i < 20; ++i)
+        {
+            boost::system::error_code ec;
+            auto const jv = readResponse(sock, buffer, ec);
+            if (! BEAST_EXPECTS(! ec, ec.message()))
+                return;
+            BEAST_EXPECT(jv[jss::id] == i);
+            BEAST_EXPECT(jv[jss::result][jss::status] == "success");
+            BEAST_EXPECT(jv[jss::result].isMember(jss::info) == (i % 2 == 0));
+        }
+    }
+
+    void
+    testClose()
+    {
+        testcase("Connection close");
+        using namespace jtx;
+        Env env{*this, makeConfig()};
+
+        boost::asio::io_service ios;
+        socket_type sock{ios};
+        connect(env, sock);
+
+        // Nothing after a request that closes the connection is answered
+        auto const batch = makeRequest("server_info", 0) +
+            makeRequest("ping", 1, false) + makeRequest("ping", 2);
+        boost::asio::write(sock, boost::asio::buffer(batch));
+
+        boost::beast::flat_buffer buffer;
+        boost::system::error_code ec;
+        BEAST_EXPECT(readResponse(sock, buffer, ec)[jss::id] == 0);
+        BEAST_EXPECT(! ec);
+        BEAST_EXPECT(readResponse(sock, buffer, ec)[jss::id] == 1);
+        BEAST_EXPECT(! ec);
+        readResponse(sock, buffer, ec);
+        BEAST_EXPECT(ec);
+    }
+
+    // Occupies the job queue's only thread until the returned promise is
+    // set, so client jobs wait on the queue instead of running.
+    static
+    std::shared_ptr<std::promise<void>>
+    blockJobs(jtx::Env& env)
+    {
+        auto const started = std::make_shared<std::promise<void>>();
+        auto const release = std::make_shared<std::promise<void>>();
+        auto ready = started->get_future();
+        env.app().getJobQueue().addJob(jtCLIENT, "blockJobs",
+            [started, wait = release->get_future().share()](Job&)
+            {
+                started->set_value();
+                wait.wait();
+            });
+        ready.wait();
+        return release;
+    }
+
+    // The most client jobs seen waiting on the queue at once.
+    static
+    int
+    maxWaiting(jtx::Env& env)
+    {
+        using namespace std::chrono;
+        int most = 0;
+        auto const end = steady_clock::now() + milliseconds(500);
+        while (steady_clock::now() < end)
+        {
+            most = std::max(most,
+                env.app().getJobQueue().getJobCount(jtCLIENT));
+            std::this_thread::sleep_for(milliseconds(5));
+        }
+        return most;
+    }
+
+    // Sends 20 requests over 4 connections while the job queue is held,
+    // and returns the most that were handed to it at once.
+    int
+    runHTTP(std::unique_ptr<Config> cfg)
+    {
+        using namespace jtx;
+        Env env{*this, std::move(cfg)};
+
+        auto const release = blockJobs(env);
+        boost::asio::io_service ios;
+        std::vector<std::unique_ptr<socket_type>> sockets;
+        for (int i = 0; i < 4; ++i)
+        {
+            sockets.push_back(std::make_unique<socket_type>(ios));
+            connect(env, *sockets.back());
+            std::string batch;
+            for (int j = 0; j < 5; ++j)
+                batch += makeRequest("ping", i * 5 + j);
+            boost::asio::write(*sockets.back(), boost::asio::buffer(batch));
+        }
+        auto const most = maxWaiting(env);
+        release->set_value();
+
+        for (int i = 0; i < 4; ++i)
+        {
+            boost::beast::flat_buffer buffer;
+            for (int j = 0; j < 5; ++j)
+            {
+                boost::system::error_code ec;
+                auto const jv = readResponse(*sockets[i], buffer, ec);
+                BEAST_EXPECT(! ec);
+                BEAST_EXPECT(jv[jss::id] == i * 5 + j);
+                BEAST_EXPECT(jv[jss::result][jss::status] == "success");
+            }
+        }
+        return most;
+    }
+
+    // The same over 4 websocket clients.
+    int
+    runWS(std::unique_ptr<Config> cfg)
+    {
+        using namespace jtx;
+        Env env{*this, std::move(cfg)};
+
+        auto const release = blockJobs(env);
+        std::atomic<int> succeeded{0};
+        std::vector<std::thread> threads;
+        for (int i = 0; i < 4; ++i)
+        {
+            threads.emplace_back([&]
+            {
+                auto const client = makeWSClient(env.app().config());
+                for (int j = 0; j < 5; ++j)
+                {
+                    if (client->invoke("ping")[jss::status] == "success")
+                        ++succeeded;
+                }
+            });
+        }
+        auto const most = maxWaiting(env);
+        release->set_value();
+
+        for (auto& thread : threads)
+            thread.join();
+        BEAST_EXPECT(succeeded == 20);
+        return most;
+    }
+
+    void
+    testWorkers()
+    {
+        testcase("Worker limit");
+
+        // Without a limit every request goes to the job queue at once
+        BEAST_EXPECT(runHTTP(makeConfig()) > 1);
+        BEAST_EXPECT(runHTTP(makeConfig("workers", "1")) == 1);
+
+        // Websocket requests wait for the port's workers too
+        BEAST_EXPECT(runWS(makeConfig()) > 1);
+        auto cfg = makeConfig();
+        (*cfg)["port_ws"].set("workers", "1");
+        BEAST_EXPECT(runWS(std::move(cfg)) == 1);
+    }
+
+    void
+    testConfig()
+    {
+        testcase("Config");
+        using namespace jtx;
+        except([&]
+        {
+            Env env{*this, makeConfig("pipeline", "0")};
+        });
+        except([&]
+        {
+            Env env{*this, makeConfig("workers", "many")};
+        });
+    }
+
+public:
+    void
+    run() override
+    {
+        testOrder();
+        testClose();
+        testWorkers();
+        testConfig();
+    }
+};
+
+// Requests per second over 1, 10 and 100 connections, sending one request
+// at a time and pipelining eight.
+class PipeliningBench_test : public Pipelining_test
+{
+    using clock_type = std::chrono::steady_clock;
+
+    void
+    bench(jtx::Env& env, std::size_t connections, int depth, int total)
+    {
+        boost::asio::io_service ios;
+        std::vector<std::unique_ptr<socket_type>> sockets;
+        std::vector<boost::beast::flat_buffer> buffers(connections);
+        for (std::size_t i = 0; i < connections; ++i)
+        {
+            sockets.push_back(std::make_unique<socket_type>(ios));
+            connect(env, *sockets.back());
+        }
+
+        std::string batch;
+        for (int i = 0; i < depth; ++i)
+            batch += makeRequest("ping", i);
+
+        auto const rounds = std::max<int>(1, total / (connections * depth));
+        std::size_t failed = 0;
+        auto const start = clock_type::now();
+        for (int round = 0; round < rounds; ++round)
+        {
+            for (auto& sock : sockets)
+                boost::asio::write(*sock, boost::asio::buffer(batch));
+            for (std::size_t i = 0; i < connections; ++i)
+            {
+                for (int j = 0; j < depth; ++j)
+                {
+                    boost::system::error_code ec;
+                    auto const jv = readResponse(*sockets[i], buffers[i], ec);
+                    if (ec || jv[jss::id] != j)
+                        ++failed;
+                }
+            }
+        }
+        std::chrono::duration<double> const elapsed =
+            clock_type::now() - start;
+
+        log << connections << " connections, " << depth << " pipelined: " <<
+            (rounds * connections * depth / elapsed.count()) <<
+            " requests/s, " << failed << " failed" << std::endl;
+    }
+
+public:
+    void
+    run() override
+    {
+        jtx::Env env{*this, makeConfig()};
+        for (std::size_t connections : {1, 10, 100})
+        {
+            bench(env, connections, 1, 20000);
+            bench(env, connections, 8, 20000);
+        }
+        pass();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(Pipelining,server,ripple);
+BEAST_DEFINE_TESTSUITE_MANUAL_PRIO(PipeliningBench,server,ripple,10);
+
+}
+}
@@ -10,9 +10,14 @@
 #include <test/jtx/envconfig.h>
 #include <test/unit_test/SuiteJournal.h>
 #include <boost/asio.hpp>
+#include <boost/beast/core/buffers_to_string.hpp>
+#include <boost/beast/core/multi_buffer.hpp>
+#include <boost/beast/websocket.hpp>
 #include <boost/optional.hpp>
 #include <boost/utility/in_place_factory.hpp>
 #include <chrono>
+#include <condition_variable>
+#include <mutex>
 #include <stdexcept>
 #include <thread>
 
@@ -341,6 +346,206 @@ public:
         pass();
     }
 
+    // Sends a burst of messages from the session's strand, so the first is
+    // still being written while the others queue, and records the session
+    // counters straight after.
+    struct QueueHandler : TestHandler
+    {
+        std::string stream;
+        bool coalesce = false;
+        std::mutex mutex;
+        std::condition_variable cv;
+        boost::optional<WSSendStats> stats;
+
+        using TestHandler::onHandoff;
+
+        Handoff
+        onHandoff (Session& session, http_request_type&& request,
+            boost::asio::ip::tcp::endpoint remote_address)
+        {
+            if (! boost::beast::websocket::is_upgrade (request))
+                return Handoff{};
+            session.websocketUpgrade()->run();
+            Handoff handoff;
+            handoff.moved = true;
+            return handoff;
+        }
+
+        void
+        onWSMessage(std::shared_ptr<WSSession> session,
+            std::vector<boost::asio::const_buffer> const&)
+        {
+            for (int i = 0; i < 10; ++i)
+                session->send (std::make_shared<SharedWSMsg>(
+                    std::make_shared<std::string const>(std::to_string (i)),
+                        stream, coalesce));
+            std::lock_guard<std::mutex> lock (mutex);
+            stats = session->stats();
+            cv.notify_all();
+        }
+    };
+
+    void
+    testSendQueue (WSOverflow policy, bool coalesce,
+        std::vector<std::string> const& received,
+        std::size_t dropped, std::size_t coalesced)
+    {
+        SuiteJournal journal ("Server_test", *this);
+        TestThread thread;
+        QueueHandler handler;
+        handler.stream = "transactions";
+        handler.coalesce = coalesce;
+        auto s = make_Server (handler, thread.get_io_service(), journal);
+        std::vector<Port> serverPort(1);
+        serverPort.back().ip =
+            beast::IP::Address::from_string (getEnvLocalhostAddr());
+        serverPort.back().port = 0;
+        serverPort.back().protocol.insert("ws");
+        serverPort.back().ws_queue_limit = coalesce ? 100 : 4;
+        serverPort.back().ws_stream_overflow["transactions"] = policy;
+        auto const eps = s->ports (serverPort);
+
+        boost::asio::io_service ios;
+        boost::beast::websocket::stream<boost::asio::ip::tcp::socket> ws (ios);
+        ws.next_layer().connect (eps[0]);
+        ws.handshake (getEnvLocalhostAddr(), "/");
+        ws.write (boost::asio::buffer (std::string ("go")));
+
+        {
+            std::unique_lock<std::mutex> lock (handler.mutex);
+            BEAST_EXPECT (handler.cv.wait_for (lock, std::chrono::seconds (5),
+                [&] { return handler.stats != boost::none; }));
+        }
+        if (! handler.stats)
+            return;
+        BEAST_EXPECT (handler.stats->queued == received.size());
+        BEAST_EXPECT (handler.stats->dropped == dropped);
+        BEAST_EXPECT (handler.stats->coalesced == coalesced);
+
+        for (auto const& expected : received)
+        {
+            boost::beast::multi_buffer b;
+            boost::system::error_code ec;
+            ws.read (b, ec);
+            if (! BEAST_EXPECTS (! ec, ec.message()))
+                break;
+            BEAST_EXPECT (boost::beast::buffers_to_string (b.data()) ==
+                expected);
+        }
+    }
+
+    void
+    testSendQueue ()
+    {
+        testcase ("Websocket send queue");
+        testSendQueue (WSOverflow::drop_oldest, false,
+            {"0", "7", "8", "9"}, 6, 0);
+        testSendQueue (WSOverflow::drop_stream, false,
+            {"0", "9"}, 8, 0);
+        testSendQueue (WSOverflow::pause, false,
+            {"0", "1", "2", "3"}, 6, 0);
+        testSendQueue (WSOverflow::close, true,
+            {"0", "9"}, 0, 8);
+    }
+
+    // Sends one shared text twice to every session that asks, as a
+    // broadcast to several subscribers does.
+    struct BroadcastHandler : TestHandler
+    {
+        std::shared_ptr<WSSharedText const> text;
+        std::mutex mutex;
+        std::weak_ptr<WSSession> session;
+
+        using TestHandler::onHandoff;
+
+        Handoff
+        onHandoff (Session& session, http_request_type&& request,
+            boost::asio::ip::tcp::endpoint remote_address)
+        {
+            if (! boost::beast::websocket::is_upgrade (request))
+                return Handoff{};
+            session.websocketUpgrade()->run();
+            Handoff handoff;
+            handoff.moved = true;
+            return handoff;
+        }
+
+        void
+        onWSMessage(std::shared_ptr<WSSession> session,
+            std::vector<boost::asio::const_buffer> const&)
+        {
+            session->send (std::make_shared<SharedWSMsg>(text));
+            session->send (std::make_shared<SharedWSMsg>(text));
+            std::lock_guard<std::mutex> lock (mutex);
+            this->session = session;
+        }
+    };
+
+    void
+    testSharedDeflate (bool noContext)
+    {
+        SuiteJournal journal ("Server_test", *this);
+        TestThread thread;
+        BroadcastHandler handler;
+        std::string text;
+        for (int i = 0; i < 1000; ++i)
+            text += "{\"type\":\"transaction\",\"seq\":" +
+                std::to_string (i) + "}";
+        handler.text = std::make_shared<WSSharedText>(text);
+        auto s = make_Server (handler, thread.get_io_service(), journal);
+        std::vector<Port> serverPort(1);
+        serverPort.back().ip =
+            beast::IP::Address::from_string (getEnvLocalhostAddr());
+        serverPort.back().port = 0;
+        serverPort.back().protocol.insert("ws");
+        serverPort.back().pmd_options.server_enable = true;
+        auto const eps = s->ports (serverPort);
+
+        boost::asio::io_service ios;
+        boost::beast::websocket::stream<boost::asio::ip::tcp::socket> ws (ios);
+        boost::beast::websocket::permessage_deflate pmd;
+        pmd.client_enable = true;
+        pmd.server_no_context_takeover = noContext;
+        ws.set_option (pmd);
+        ws.next_layer().connect (eps[0]);
+        ws.handshake (getEnvLocalhostAddr(), "/");
+        ws.write (boost::asio::buffer (std::string ("go")));
+
+        for (int i = 0; i < 2; ++i)
+        {
+            boost::beast::multi_buffer b;
+            boost::system::error_code ec;
+            ws.read (b, ec);
+            if (! BEAST_EXPECTS (! ec, ec.message()))
+                return;
+            BEAST_EXPECT (boost::beast::buffers_to_string (b.data()) == text);
+        }
+
+        // The session counts a message once it is written, which may be
+        // after the client has read it.
+        WSSendStats stats;
+        auto const timeout =
+            std::chrono::steady_clock::now() + std::chrono::seconds (5);
+        while (stats.sent < 2 && std::chrono::steady_clock::now() < timeout)
+        {
+            std::this_thread::sleep_for (std::chrono::milliseconds (10));
+            std::lock_guard<std::mutex> lock (handler.mutex);
+            if (auto const session = handler.session.lock())
+                stats = session->stats();
+        }
+        BEAST_EXPECT (stats.sent == 2);
+        BEAST_EXPECT (stats.sharedDeflated == (noContext ? 2 : 0));
+        BEAST_EXPECT (stats.wireBytes < stats.sentBytes / 4);
+    }
+
+    void
+    testSharedDeflate ()
+    {
+        testcase ("Websocket shared deflate");
+        testSharedDeflate (true);
+        testSharedDeflate (false);
+    }
+
     
     class CaptureSink : public beast::Journal::Sink
     {
@@ -452,6 +657,21 @@ public:
             messages.find ("Missing 'protocol' in [port_rpc]")
             != std::string::npos);
 
+        except ([&]
+        {
+            Env env {*this,
+                envconfig([](std::unique_ptr<Config> cfg) {
+                    (*cfg)["port_ws"].set("send_queue_overflow",
+                        "drop_oldest, transactions:sometimes");
+                    return cfg;
+                }),
+                std::make_unique<CaptureLogs>(messages)};
+        });
+        BEAST_EXPECT (
+            messages.find ("Invalid value 'transactions:sometimes' for key "
+                "'send_queue_overflow' in [port_ws]")
+            != std::string::npos);
+
         except ([&] 
         {
             Env env {*this,
@@ -511,6 +731,8 @@ public:
     {
         basicTests();
         stressTest();
+        testSendQueue();
+        testSharedDeflate();
         testBadConfig();
     }
 };
@@ -5,6 +5,7 @@
 #include <ripple/basics/StringUtilities.h>
 #include <ripple/beast/unit_test.h>
 #include <ripple/beast/utility/Journal.h>
+#include <ripple/protocol/digest.h>
 #include <test/shamap/common.h>
 #include <test/unit_test/SuiteJournal.h>
 
@@ -110,6 +111,52 @@ public:
         run (false, SHAMap::version{1}, journal);
         run (true,  SHAMap::version{2}, journal);
         run (false, SHAMap::version{2}, journal);
+        testPrefetch (journal);
+    }
+
+    void testPrefetch (beast::Journal const& journal)
+    {
+        testcase ("prefetch");
+
+        tests::TestFamily f(journal);
+        std::vector<uint256> keys;
+        SHAMapHash hash;
+        {
+            SHAMap source (SHAMapType::STATE, f, SHAMap::version{1});
+            for (int i = 0; i < 1000; ++i)
+            {
+                keys.push_back (sha512Half (i));
+                source.addItem (
+                    SHAMapItem{keys.back (), IntToVUC (i)}, false, false);
+            }
+            source.flushDirty (hotACCOUNT_NODE, 1);
+            hash = source.getHash ();
+        }
+        f.reset ();
+
+        SHAMap map (SHAMapType::STATE, f, SHAMap::version{1});
+        BEAST_EXPECT (map.fetchRoot (hash, nullptr));
+        map.setImmutable ();
+
+        // Prefetch a few levels at a time, as repeated reads would
+        for (int pass = 0; pass < 8; ++pass)
+        {
+            for (auto const& key : keys)
+                map.prefetch (key);
+            f.db ().waitReads ();
+        }
+        map.prefetch (sha512Half (-1));
+
+        for (int i = 0; i < keys.size (); ++i)
+        {
+            auto const& item = map.peekItem (keys[i]);
+            BEAST_EXPECT (item && item->peekData () == IntToVUC (i));
+        }
+
+        SHAMap unbacked (SHAMapType::FREE, f, SHAMap::version{1});
+        unbacked.setUnbacked ();
+        unbacked.prefetch (keys[0]);
+        BEAST_EXPECT (! unbacked.hasItem (keys[0]));
     }
 
     void run (bool backed, SHAMap::version v, beast::Journal const& journal)
@@ -2,7 +2,10 @@
 
 
 #include <test/app/AccountTxPaging_test.cpp>
+#include <test/app/AcquireScheduler_test.cpp>
 #include <test/app/AmendmentTable_test.cpp>
+#include <test/app/ApplyArena_test.cpp>
+#include <test/app/CanonicalTXSet_test.cpp>
 #include <test/app/Check_test.cpp>
 #include <test/app/CrossingLimits_test.cpp>
 #include <test/app/DeliverMin_test.cpp>
@@ -15,11 +18,13 @@
 #include <test/app/LedgerHistory_test.cpp>
 #include <test/app/LedgerLoad_test.cpp>
 #include <test/app/LedgerReplay_test.cpp>
+#include <test/app/LedgerToJson_test.cpp>
 #include <test/app/LoadFeeTrack_test.cpp>
 #include <test/app/Manifest_test.cpp>
 #include <test/app/MultiSign_test.cpp>
 #include <test/app/OfferStream_test.cpp>
 #include <test/app/Offer_test.cpp>
+#include <test/app/OrderBookDB_test.cpp>
 #include <test/app/OversizeMeta_test.cpp>
 
 #include <test/unit_test/multi_runner.cpp>
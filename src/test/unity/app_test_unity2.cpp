@@ -1,13 +1,16 @@
 
 
 
+#include <test/app/ParallelApply_test.cpp>
 #include <test/app/Path_test.cpp>
 #include <test/app/PayChan_test.cpp>
 #include <test/app/PayStrand_test.cpp>
+#include <test/app/PaymentEngineBench_test.cpp>
 #include <test/app/PseudoTx_test.cpp>
 #include <test/app/RCLCensorshipDetector_test.cpp>
 #include <test/app/RCLValidations_test.cpp>
 #include <test/app/Regression_test.cpp>
+#include <test/app/RippleLineCache_test.cpp>
 #include <test/app/SetAuth_test.cpp>
 #include <test/app/SetRegularKey_test.cpp>
 #include <test/app/SetTrust_test.cpp>
@@ -2,6 +2,7 @@
 
 
 #include <test/json/json_value_test.cpp>
+#include <test/json/IndexedReader_test.cpp>
 #include <test/json/Object_test.cpp>
 #include <test/json/Output_test.cpp>
 #include <test/json/Writer_test.cpp>
@@ -1,6 +1,7 @@
 
 
 
+#include <test/protocol/BatchVerifier_test.cpp>
 #include <test/protocol/BuildInfo_test.cpp>
 #include <test/protocol/digest_test.cpp>
 #include <test/protocol/InnerObjectFormats_test.cpp>
@@ -12,6 +13,7 @@
 #include <test/protocol/Seed_test.cpp>
 #include <test/protocol/STAccount_test.cpp>
 #include <test/protocol/STAmount_test.cpp>
+#include <test/protocol/STLedgerEntry_test.cpp>
 #include <test/protocol/STObject_test.cpp>
 #include <test/protocol/STTx_test.cpp>
 #include <test/protocol/STValidation_test.cpp>
@@ -9,7 +9,9 @@
 #include <test/rpc/AccountSet_test.cpp>
 #include <test/rpc/AccountTx_test.cpp>
 #include <test/rpc/AmendmentBlocked_test.cpp>
+#include <test/rpc/BinaryFrames_test.cpp>
 #include <test/rpc/Book_test.cpp>
+#include <test/rpc/Coalescer_test.cpp>
 #include <test/rpc/DepositAuthorized_test.cpp>
 #include <test/rpc/DeliveredAmount_test.cpp>
 #include <test/rpc/Feature_test.cpp>
@@ -29,6 +31,7 @@
 #include <test/rpc/Roles_test.cpp>
 #include <test/rpc/RPCCall_test.cpp>
 #include <test/rpc/RPCOverload_test.cpp>
+#include <test/rpc/ResultCache_test.cpp>
 #include <test/rpc/ServerInfo_test.cpp>
 #include <test/rpc/Status_test.cpp>
 #include <test/rpc/Subscribe_test.cpp>
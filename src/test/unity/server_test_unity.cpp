@@ -1,6 +1,7 @@
 
 
 
+#include <test/server/Pipelining_test.cpp>
 #include <test/server/Server_test.cpp>
 
 